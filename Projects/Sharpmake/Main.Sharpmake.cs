@@ -1,7 +1,10 @@
 using System.IO; // for Path.Combine
 using Sharpmake; // contains the entire Sharpmake object library.
 
+[module: Sharpmake.Include("Tools/AssetPacker.Sharpmake.cs")]
+[module: Sharpmake.Include("Tools/Benchmarks.Sharpmake.cs")]
 [module: Sharpmake.Include("Tools/ShaderCompiler.Sharpmake.cs")]
+[module: Sharpmake.Include("Tools/UnitTests.Sharpmake.cs")]
 
 [Generate]
 class AmigoEngine : Project
@@ -121,6 +124,9 @@ public class AmigoSolution : Solution
 
 		conf.AddProject<AmigoEngine>(target);
 		conf.AddProject<ShaderCompiler>(target);
+		conf.AddProject<AssetPacker>(target);
+		conf.AddProject<Benchmarks>(target);
+		conf.AddProject<UnitTests>(target);
 	}
 	
 	[Sharpmake.Main]
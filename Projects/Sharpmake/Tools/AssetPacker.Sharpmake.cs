@@ -0,0 +1,62 @@
+using System.IO; // for Path.Combine
+using Sharpmake; // contains the entire Sharpmake object library.
+
+[Generate]
+class AssetPacker : Project
+{
+	public AssetPacker()
+	{
+		Name = "AssetPacker";
+
+		RootPath = @"[project.SharpmakeCsPath]\..\..\..\";
+		SourceRootPath = @"[project.RootPath]\Source\Tools\[project.Name]";
+
+		// Pack files are written with the engine code that reads them
+		SourceFiles.Add(@"[project.RootPath]\Source\Engine\Utils\Compression.cpp");
+		SourceFiles.Add(@"[project.RootPath]\Source\Engine\Utils\Exceptions.cpp");
+		SourceFiles.Add(@"[project.RootPath]\Source\Engine\Utils\JobSystem.cpp");
+		SourceFiles.Add(@"[project.RootPath]\Source\Engine\Utils\Logger.cpp");
+		SourceFiles.Add(@"[project.RootPath]\Source\Engine\Utils\MappedFile.cpp");
+		SourceFiles.Add(@"[project.RootPath]\Source\Engine\Utils\PackFile.cpp");
+
+		AddTargets(new Target(
+			Platform.win64,
+			DevEnv.vs2017,
+			Optimization.Debug | Optimization.Release,
+			OutputType.Lib,
+			Blob.NoBlob,
+			BuildSystem.MSBuild,
+			DotNetFramework.v4_5));
+	}
+
+	[Configure()]
+	public void ConfigureAll(Configuration conf, Target target)
+	{
+		conf.ProjectPath		= @"[project.RootPath]\Projects\Tools\";
+		conf.ProjectFileName	= @"[project.Name].[target.DevEnv].[target.Platform]";
+		conf.IntermediatePath	= @"[project.RootPath]\Output\Temp\[target.DevEnv]\[target.Platform]\[target.Optimization]\[project.Name]";
+		conf.TargetPath			= @"[project.RootPath]\Tools\[project.Name]";
+
+		// Command line executable
+		conf.Output = Project.Configuration.OutputType.Exe;
+		conf.Options.Add(Options.Vc.Linker.SubSystem.Console);
+
+		// Engine.h and its dependencies
+		conf.IncludePaths.Add(@"[project.RootPath]\Source\Engine\");
+		conf.IncludePaths.Add(@"[project.RootPath]\External\mathfu\include\");
+	}
+
+	[Configure(Platform.win64)]
+	public void ConfigurePC(Configuration conf, Target target)
+	{
+		// Same settings as the engine
+		conf.Options.Add(Options.Vc.Compiler.CppLanguageStandard.CPP17);
+
+		if (target.Optimization == Optimization.Debug)
+			conf.Options.Add(Options.Vc.Compiler.RuntimeLibrary.MultiThreadedDebugDLL);
+		else
+			conf.Options.Add(Options.Vc.Compiler.RuntimeLibrary.MultiThreadedDLL);
+
+		conf.Defines.Add("_HAS_EXCEPTIONS=0");
+	}
+}
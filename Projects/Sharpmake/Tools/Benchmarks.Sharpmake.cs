@@ -0,0 +1,79 @@
+using System.IO; // for Path.Combine
+using Sharpmake; // contains the entire Sharpmake object library.
+
+[Generate]
+class Benchmarks : Project
+{
+	public Benchmarks()
+	{
+		Name = "Benchmarks";
+
+		RootPath = @"[project.SharpmakeCsPath]\..\..\..\";
+		SourceRootPath = @"[project.RootPath]\Source\Tools\[project.Name]";
+
+		// Engine code under measurement, without the renderer. The Gfx files only need the D3D12 headers
+		SourceFiles.Add(@"[project.RootPath]\Source\Engine\Gfx\BakedMesh.cpp");
+		SourceFiles.Add(@"[project.RootPath]\Source\Engine\Gfx\DrawKey.cpp");
+		SourceFiles.Add(@"[project.RootPath]\Source\Engine\Gfx\MeshLoader.cpp");
+		SourceFiles.Add(@"[project.RootPath]\Source\Engine\Gfx\MeshOptimizer.cpp");
+		SourceFiles.Add(@"[project.RootPath]\Source\Engine\Gfx\Meshlet.cpp");
+		SourceFiles.Add(@"[project.RootPath]\Source\Engine\Gfx\RecordingCommandList.cpp");
+		SourceFiles.Add(@"[project.RootPath]\Source\Engine\Gfx\VertexCompression.cpp");
+		SourceFiles.Add(@"[project.RootPath]\Source\Engine\Math\BoundingVolumes.cpp");
+		SourceFiles.Add(@"[project.RootPath]\Source\Engine\Utils\AssetCache.cpp");
+		SourceFiles.Add(@"[project.RootPath]\Source\Engine\Utils\AsyncIO.cpp");
+		SourceFiles.Add(@"[project.RootPath]\Source\Engine\Utils\Compression.cpp");
+		SourceFiles.Add(@"[project.RootPath]\Source\Engine\Utils\Exceptions.cpp");
+		SourceFiles.Add(@"[project.RootPath]\Source\Engine\Utils\FileReader.cpp");
+		SourceFiles.Add(@"[project.RootPath]\Source\Engine\Utils\Hash.cpp");
+		SourceFiles.Add(@"[project.RootPath]\Source\Engine\Utils\JobSystem.cpp");
+		SourceFiles.Add(@"[project.RootPath]\Source\Engine\Utils\Logger.cpp");
+		SourceFiles.Add(@"[project.RootPath]\Source\Engine\Utils\MappedFile.cpp");
+		SourceFiles.Add(@"[project.RootPath]\Source\Engine\Utils\PackFile.cpp");
+		SourceFiles.Add(@"[project.RootPath]\Source\Engine\Utils\RadixSort.cpp");
+		SourceFiles.Add(@"[project.RootPath]\Source\Engine\Utils\String.cpp");
+
+		AddTargets(new Target(
+			Platform.win64,
+			DevEnv.vs2017,
+			Optimization.Debug | Optimization.Release,
+			OutputType.Lib,
+			Blob.NoBlob,
+			BuildSystem.MSBuild,
+			DotNetFramework.v4_5));
+	}
+
+	[Configure()]
+	public void ConfigureAll(Configuration conf, Target target)
+	{
+		conf.ProjectPath		= @"[project.RootPath]\Projects\Tools\";
+		conf.ProjectFileName	= @"[project.Name].[target.DevEnv].[target.Platform]";
+		conf.IntermediatePath	= @"[project.RootPath]\Output\Temp\[target.DevEnv]\[target.Platform]\[target.Optimization]\[project.Name]";
+		conf.TargetPath			= @"[project.RootPath]\Tools\[project.Name]";
+
+		// Command line executable
+		conf.Output = Project.Configuration.OutputType.Exe;
+		conf.Options.Add(Options.Vc.Linker.SubSystem.Console);
+
+		// Engine.h and its dependencies
+		conf.IncludePaths.Add(@"[project.RootPath]\Source\Engine\");
+		conf.IncludePaths.Add(@"[project.RootPath]\External\mathfu\include\");
+	}
+
+	[Configure(Platform.win64)]
+	public void ConfigurePC(Configuration conf, Target target)
+	{
+		// Same settings as the engine
+		conf.Options.Add(Options.Vc.Compiler.CppLanguageStandard.CPP17);
+
+		if (target.Optimization == Optimization.Debug)
+			conf.Options.Add(Options.Vc.Compiler.RuntimeLibrary.MultiThreadedDebugDLL);
+		else
+			conf.Options.Add(Options.Vc.Compiler.RuntimeLibrary.MultiThreadedDLL);
+
+		conf.Defines.Add("_HAS_EXCEPTIONS=0");
+
+		// D3D12 types in engine headers, nothing is linked
+		conf.IncludePaths.Add(@"[project.RootPath]\External\D3D12\Include");
+	}
+}
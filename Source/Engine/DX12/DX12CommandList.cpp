@@ -0,0 +1,108 @@
+#include "Engine.h"
+#include "DX12/DX12CommandList.h"
+
+#include "DX12/DX12DescriptorHeap.h"
+#include "DX12/DX12Device.h"
+
+DX12CommandList::DX12CommandList(ID3D12GraphicsCommandList2& inCommandList, DX12DescriptorHeap& inDescriptorHeap) :
+	m_CommandList(inCommandList),
+	m_DescriptorHeap(inDescriptorHeap)
+{
+}
+
+void DX12CommandList::ResourceBarrier(uint32 inNumBarriers, const D3D12_RESOURCE_BARRIER* inBarriers)
+{
+	m_CommandList.ResourceBarrier(inNumBarriers, inBarriers);
+}
+
+void DX12CommandList::SetDescriptorHeaps(uint32 inNumHeaps, ID3D12DescriptorHeap* const* inHeaps)
+{
+	m_CommandList.SetDescriptorHeaps(inNumHeaps, inHeaps);
+}
+
+void DX12CommandList::SetGraphicsRootSignature(ID3D12RootSignature* inRootSignature)
+{
+	m_CommandList.SetGraphicsRootSignature(inRootSignature);
+}
+
+void DX12CommandList::SetPipelineState(ID3D12PipelineState* inPipelineState)
+{
+	m_CommandList.SetPipelineState(inPipelineState);
+}
+
+void DX12CommandList::SetGraphicsRootDescriptorTable(uint32 inRootParameterIndex, D3D12_GPU_DESCRIPTOR_HANDLE inBaseDescriptor)
+{
+	m_CommandList.SetGraphicsRootDescriptorTable(inRootParameterIndex, inBaseDescriptor);
+}
+
+void DX12CommandList::SetGraphicsRootConstantBufferView(uint32 inRootParameterIndex, D3D12_GPU_VIRTUAL_ADDRESS inBufferLocation)
+{
+	m_CommandList.SetGraphicsRootConstantBufferView(inRootParameterIndex, inBufferLocation);
+}
+
+void DX12CommandList::IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY inTopology)
+{
+	m_CommandList.IASetPrimitiveTopology(inTopology);
+}
+
+void DX12CommandList::IASetVertexBuffers(uint32 inStartSlot, uint32 inNumViews, const D3D12_VERTEX_BUFFER_VIEW* inViews)
+{
+	m_CommandList.IASetVertexBuffers(inStartSlot, inNumViews, inViews);
+}
+
+void DX12CommandList::IASetIndexBuffer(const D3D12_INDEX_BUFFER_VIEW* inView)
+{
+	m_CommandList.IASetIndexBuffer(inView);
+}
+
+void DX12CommandList::RSSetViewports(uint32 inNumViewports, const D3D12_VIEWPORT* inViewports)
+{
+	m_CommandList.RSSetViewports(inNumViewports, inViewports);
+}
+
+void DX12CommandList::RSSetScissorRects(uint32 inNumRects, const D3D12_RECT* inRects)
+{
+	m_CommandList.RSSetScissorRects(inNumRects, inRects);
+}
+
+void DX12CommandList::OMSetRenderTargets(uint32 inNumRenderTargets, const D3D12_CPU_DESCRIPTOR_HANDLE* inRenderTargets,
+										 bool inSingleHandleToDescriptorRange, const D3D12_CPU_DESCRIPTOR_HANDLE* inDepthStencil)
+{
+	m_CommandList.OMSetRenderTargets(inNumRenderTargets, inRenderTargets, inSingleHandleToDescriptorRange, inDepthStencil);
+}
+
+void DX12CommandList::ClearRenderTargetView(D3D12_CPU_DESCRIPTOR_HANDLE inRenderTarget, const float inColor[4])
+{
+	m_CommandList.ClearRenderTargetView(inRenderTarget, inColor, 0, nullptr);
+}
+
+void DX12CommandList::ClearDepthStencilView(D3D12_CPU_DESCRIPTOR_HANDLE inDepthStencil, D3D12_CLEAR_FLAGS inFlags, float inDepth, uint8 inStencil)
+{
+	m_CommandList.ClearDepthStencilView(inDepthStencil, inFlags, inDepth, inStencil, 0, nullptr);
+}
+
+void DX12CommandList::DrawInstanced(uint32 inVertexCountPerInstance, uint32 inInstanceCount, uint32 inStartVertex, uint32 inStartInstance)
+{
+	m_CommandList.DrawInstanced(inVertexCountPerInstance, inInstanceCount, inStartVertex, inStartInstance);
+}
+
+void DX12CommandList::DrawIndexedInstanced(uint32 inIndexCountPerInstance, uint32 inInstanceCount, uint32 inStartIndex, int32 inBaseVertex, uint32 inStartInstance)
+{
+	m_CommandList.DrawIndexedInstanced(inIndexCountPerInstance, inInstanceCount, inStartIndex, inBaseVertex, inStartInstance);
+}
+
+D3D12_GPU_DESCRIPTOR_HANDLE DX12CommandList::CopyDescriptor(D3D12_CPU_DESCRIPTOR_HANDLE inDescriptor)
+{
+	const uint32 descriptor_index = m_DescriptorHeap.Allocate();
+	g_RenderingDevice.GetD3DDevice().CopyDescriptorsSimple(1, m_DescriptorHeap.GetCPUHandle(descriptor_index), inDescriptor, D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
+
+	return m_DescriptorHeap.GetGPUHandle(descriptor_index);
+}
+
+D3D12_GPU_DESCRIPTOR_HANDLE DX12CommandList::CreateShaderResourceView(ID3D12Resource* inResource)
+{
+	const uint32 descriptor_index = m_DescriptorHeap.Allocate();
+	g_RenderingDevice.GetD3DDevice().CreateShaderResourceView(inResource, nullptr, m_DescriptorHeap.GetCPUHandle(descriptor_index));
+
+	return m_DescriptorHeap.GetGPUHandle(descriptor_index);
+}
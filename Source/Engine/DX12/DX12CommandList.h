@@ -0,0 +1,45 @@
+#pragma once
+
+#include "Gfx/CommandList.h"
+
+class DX12DescriptorHeap;
+
+// Forwards frame commands to a D3D12 command list. Shader visible descriptors come from inDescriptorHeap,
+// the heap of the frame the command list belongs to
+class DX12CommandList final : public CommandList
+{
+public:
+	DX12CommandList(ID3D12GraphicsCommandList2& inCommandList, DX12DescriptorHeap& inDescriptorHeap);
+
+	inline ID3D12GraphicsCommandList2&	GetD3DCommandList() const	{ return m_CommandList; }
+
+	void	ResourceBarrier(uint32 inNumBarriers, const D3D12_RESOURCE_BARRIER* inBarriers) override;
+
+	void	SetDescriptorHeaps(uint32 inNumHeaps, ID3D12DescriptorHeap* const* inHeaps) override;
+	void	SetGraphicsRootSignature(ID3D12RootSignature* inRootSignature) override;
+	void	SetPipelineState(ID3D12PipelineState* inPipelineState) override;
+	void	SetGraphicsRootDescriptorTable(uint32 inRootParameterIndex, D3D12_GPU_DESCRIPTOR_HANDLE inBaseDescriptor) override;
+	void	SetGraphicsRootConstantBufferView(uint32 inRootParameterIndex, D3D12_GPU_VIRTUAL_ADDRESS inBufferLocation) override;
+
+	void	IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY inTopology) override;
+	void	IASetVertexBuffers(uint32 inStartSlot, uint32 inNumViews, const D3D12_VERTEX_BUFFER_VIEW* inViews) override;
+	void	IASetIndexBuffer(const D3D12_INDEX_BUFFER_VIEW* inView) override;
+
+	void	RSSetViewports(uint32 inNumViewports, const D3D12_VIEWPORT* inViewports) override;
+	void	RSSetScissorRects(uint32 inNumRects, const D3D12_RECT* inRects) override;
+	void	OMSetRenderTargets(uint32 inNumRenderTargets, const D3D12_CPU_DESCRIPTOR_HANDLE* inRenderTargets,
+							   bool inSingleHandleToDescriptorRange, const D3D12_CPU_DESCRIPTOR_HANDLE* inDepthStencil) override;
+
+	void	ClearRenderTargetView(D3D12_CPU_DESCRIPTOR_HANDLE inRenderTarget, const float inColor[4]) override;
+	void	ClearDepthStencilView(D3D12_CPU_DESCRIPTOR_HANDLE inDepthStencil, D3D12_CLEAR_FLAGS inFlags, float inDepth, uint8 inStencil) override;
+
+	void	DrawInstanced(uint32 inVertexCountPerInstance, uint32 inInstanceCount, uint32 inStartVertex, uint32 inStartInstance) override;
+	void	DrawIndexedInstanced(uint32 inIndexCountPerInstance, uint32 inInstanceCount, uint32 inStartIndex, int32 inBaseVertex, uint32 inStartInstance) override;
+
+	D3D12_GPU_DESCRIPTOR_HANDLE	CopyDescriptor(D3D12_CPU_DESCRIPTOR_HANDLE inDescriptor) override;
+	D3D12_GPU_DESCRIPTOR_HANDLE	CreateShaderResourceView(ID3D12Resource* inResource) override;
+
+private:
+	ID3D12GraphicsCommandList2&		m_CommandList;
+	DX12DescriptorHeap&				m_DescriptorHeap;
+};
@@ -53,6 +53,11 @@ bool DX12CommandQueue::IsFenceComplete(uint64 inFenceValue) const
 	return m_Fence.IsFenceComplete(inFenceValue);
 }
 
+uint64 DX12CommandQueue::GetCompletedFenceValue() const
+{
+	return m_Fence.GetCompletedValue();
+}
+
 void DX12CommandQueue::WaitForFenceValue(uint64 inFenceValue) const
 {
 	m_Fence.WaitForFenceValue(inFenceValue);
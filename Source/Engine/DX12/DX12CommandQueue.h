@@ -27,6 +27,8 @@ public:
 
 	uint64	Signal();
 	bool	IsFenceComplete(uint64 fenceValue) const;
+	// Every fence value up to this one is complete
+	uint64	GetCompletedFenceValue() const;
 	void	WaitForFenceValue(uint64 fenceValue) const;
 	void	Flush();
 
@@ -40,4 +40,9 @@ void DX12Fence::WaitForFenceValue(uint64 inFenceValue, std::chrono::milliseconds
 bool DX12Fence::IsFenceComplete(uint64 inFenceValue) const
 {
 	return m_D3DFence->GetCompletedValue() >= inFenceValue;
+}
+
+uint64 DX12Fence::GetCompletedValue() const
+{
+	return m_D3DFence->GetCompletedValue();
 }
\ No newline at end of file
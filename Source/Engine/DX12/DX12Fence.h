@@ -18,6 +18,7 @@ public:
 	uint64					Increment();
 	void					WaitForFenceValue(uint64 inFenceValue, std::chrono::milliseconds inDuration = (std::chrono::milliseconds::max)()) const;
 	bool					IsFenceComplete(uint64 inFenceValue) const;
+	uint64					GetCompletedValue() const;
 
 private:
 	ID3D12Fence*	m_D3DFence;
@@ -3,6 +3,7 @@
 
 #include "DX12/DX12DescriptorHeap.h"
 #include "DX12/DX12Device.h"
+#include "Gfx/CommandList.h"
 
 void DX12RenderTarget::InitAsRenderTarget(
 	uint32 inWidth, uint32 inHeight, DXGI_FORMAT inFormat/* = DXGI_FORMAT_UNKNOWN*/,
@@ -83,9 +84,9 @@ void DX12RenderTarget::OnReleased()
 	descriptor_heap.Release(m_RTVDescriptorHandle);
 }
 
-void DX12RenderTarget::ClearBuffer(ID3D12GraphicsCommandList2& inCommandList) const
+void DX12RenderTarget::ClearBuffer(CommandList& inCommandList) const
 {
-	inCommandList.ClearRenderTargetView(m_RTVDescriptorHandle, &m_ClearValue[0], 0, nullptr);
+	inCommandList.ClearRenderTargetView(m_RTVDescriptorHandle, &m_ClearValue[0]);
 }
 
 void DX12DepthBuffer::InitAsDepthStencilBuffer(
@@ -141,7 +142,7 @@ void DX12DepthBuffer::OnReleased()
 	descriptor_heap.Release(m_DSVDescriptorHandle);
 }
 
-void DX12DepthBuffer::ClearBuffer(ID3D12GraphicsCommandList2& inCommandList) const
+void DX12DepthBuffer::ClearBuffer(CommandList& inCommandList) const
 {
-	inCommandList.ClearDepthStencilView(m_DSVDescriptorHandle, D3D12_CLEAR_FLAG_DEPTH | D3D12_CLEAR_FLAG_STENCIL, m_ClearValue, m_StencilClearValue, 0, nullptr);
+	inCommandList.ClearDepthStencilView(m_DSVDescriptorHandle, D3D12_CLEAR_FLAG_DEPTH | D3D12_CLEAR_FLAG_STENCIL, m_ClearValue, m_StencilClearValue);
 }
\ No newline at end of file
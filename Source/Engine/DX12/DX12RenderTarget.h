@@ -3,6 +3,8 @@
 #include "DX12/DX12Device.h"
 #include "DX12/DX12Resource.h"
 
+class CommandList;
+
 // TODO: extend from texture
 class DX12RenderTarget final : public DX12Resource
 {
@@ -22,7 +24,7 @@ public:
 		DXGI_FORMAT inFormat = DXGI_FORMAT_UNKNOWN,
 		Vec4 inClearValue = Vec4(0.0f));
 
-	void ClearBuffer(ID3D12GraphicsCommandList2& inCommandList) const;
+	void ClearBuffer(CommandList& inCommandList) const;
 
 	inline D3D12_CPU_DESCRIPTOR_HANDLE		GetCPUDescriptorHandle() const	{ return m_RTVDescriptorHandle; }
 	inline DXGI_FORMAT						GetFormat() const				{ return m_Format; }
@@ -51,7 +53,7 @@ public:
 		float inClearValue = 1.0f, uint8 inStencilClearValue = 0,
 		DXGI_FORMAT inDepthFormat = DXGI_FORMAT_D24_UNORM_S8_UINT);
 
-	void ClearBuffer(ID3D12GraphicsCommandList2& inCommandList) const;
+	void ClearBuffer(CommandList& inCommandList) const;
 
 	D3D12_CPU_DESCRIPTOR_HANDLE GetCPUDescriptorHandle() const		{ return m_DSVDescriptorHandle; }
 
@@ -3,6 +3,8 @@
 
 #include "DX12/DX12Device.h"
 
+#include <cstdlib>
+
 void DX12Resource::InitAsResource(
 	ID3D12GraphicsCommandList2& inCommandList,
 	size_t inBufferSize/* = 0*/, const void* inBufferData/* = nullptr*/,
@@ -106,13 +108,15 @@ void DX12VertexBuffer::SetVertexBuffer(ID3D12GraphicsCommandList2& inCommandList
 
 void DX12IndexBuffer::InitAsIndexBuffer(
 	ID3D12GraphicsCommandList2& inCommandList,
-	size_t inBufferSize, const void* inBufferData,
+	size_t inBufferSize, const void* inBufferData, DXGI_FORMAT inFormat,
 	D3D12_RESOURCE_FLAGS inFlags/* = D3D12_RESOURCE_FLAG_NONE*/)
 {
+	Assert(inFormat == DXGI_FORMAT_R16_UINT || inFormat == DXGI_FORMAT_R32_UINT);
+
 	DX12Resource::InitAsResource(inCommandList, inBufferSize, inBufferData, inFlags);
 
 	m_IndexBufferView.BufferLocation	= m_Resource->GetGPUVirtualAddress();
-	m_IndexBufferView.Format			= DXGI_FORMAT_R16_UINT;
+	m_IndexBufferView.Format			= inFormat;
 	m_IndexBufferView.SizeInBytes		= (uint32) inBufferSize;
 
 	const CD3DX12_RESOURCE_BARRIER barrier = CD3DX12_RESOURCE_BARRIER::Transition(
@@ -129,12 +133,17 @@ void DX12IndexBuffer::SetIndexBuffer(ID3D12GraphicsCommandList2& inCommandList)
 	inCommandList.IASetIndexBuffer(&m_IndexBufferView);
 }
 
-void DX12ConstantBuffer::InitAsConstantBuffer(size_t inBufferSize)
+uint32 DX12IndexBuffer::GetIndexSize(DXGI_FORMAT inFormat)
+{
+	Assert(inFormat == DXGI_FORMAT_R16_UINT || inFormat == DXGI_FORMAT_R32_UINT);
+	return (inFormat == DXGI_FORMAT_R32_UINT) ? sizeof(uint32) : sizeof(uint16);
+}
+
+void DX12UploadRing::InitAsUploadRing(uint64 inSize)
 {
 	D3D12_HEAP_PROPERTIES	heap_properties	= CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD);
-	D3D12_RESOURCE_DESC		resource_desc	= CD3DX12_RESOURCE_DESC::Buffer(inBufferSize);
+	D3D12_RESOURCE_DESC		resource_desc	= CD3DX12_RESOURCE_DESC::Buffer(inSize);
 
-	// These will remain in upload heap because we use them only once per frame
 	ThrowIfFailed(g_RenderingDevice.GetD3DDevice().CreateCommittedResource(
 		&heap_properties,
 		D3D12_HEAP_FLAG_NONE,
@@ -143,27 +152,49 @@ void DX12ConstantBuffer::InitAsConstantBuffer(size_t inBufferSize)
 		nullptr,
 		IID_PPV_ARGS(&m_Resource)));
 
-	SetResourceName(*m_Resource, "DX12ConstantBuffer::InitAsConstantBuffer");
+	SetResourceName(*m_Resource, "DX12UploadRing::InitAsUploadRing");
+
+	// Upload heaps can stay mapped while the GPU reads them. The CPU never reads back
+	D3D12_RANGE read_range = { 0, 0 };
+	void* cpu_address;
+	ThrowIfFailed(m_Resource->Map(0, &read_range, &cpu_address));
+
+	m_CPUAddress	= static_cast<Byte*>(cpu_address);
+	m_GPUAddress	= m_Resource->GetGPUVirtualAddress();
+	m_Allocator.Init(inSize);
 }
 
-void DX12ConstantBuffer::UpdateBufferResource(
-	ID3D12GraphicsCommandList2& inCommandList,
-	size_t inBufferSize/* = 0*/, const void* inBufferData/* = nullptr*/)
+DX12UploadRing::Allocation DX12UploadRing::Allocate(uint64 inSize, uint64 inAlignment/* = D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT*/)
 {
-	// TODO: Ignore unused arguments
-	(void) inCommandList;
-
-	// Perform Map/Unmap with the new data
-	if (inBufferData)
+	const uint64 offset = m_Allocator.Allocate(inSize, inAlignment);
+	if (offset == RingAllocator::InvalidOffset)
 	{
-		void* p;
-		m_Resource->Map(0, nullptr, &p);
-		::memcpy(p, inBufferData, inBufferSize);
-		m_Resource->Unmap(0, nullptr);
+		// A null address bound as a root CBV would remove the device, stop here instead
+		Trace("DX12UploadRing: %llu bytes don't fit, %llu bytes in use", inSize, m_Allocator.GetStatistics().m_UsedSize);
+		Assert(false, "Upload ring is full, frames in flight use more than its size");
+		std::abort();
 	}
+
+	Allocation allocation;
+	allocation.m_CPUAddress	= m_CPUAddress + offset;
+	allocation.m_GPUAddress	= m_GPUAddress + offset;
+	return allocation;
+}
+
+void DX12UploadRing::TraceStatistics() const
+{
+	const RingAllocator::Statistics statistics = m_Allocator.GetStatistics();
+
+	Trace("DX12UploadRing: %.2f/%.2f MB used, peak %.2f MB, %u frames in flight, %u failed allocations",
+		  statistics.m_UsedSize / (1024.0 * 1024.0), statistics.m_Capacity / (1024.0 * 1024.0), statistics.m_PeakUsedSize / (1024.0 * 1024.0),
+		  statistics.m_NumPendingFrames, statistics.m_NumFailedAllocations);
 }
 
-void DX12ConstantBuffer::SetConstantBuffer(ID3D12GraphicsCommandList2& inCommandList, uint32 inRootParameterIndex) const
+void DX12UploadRing::OnReleased()
 {
-	inCommandList.SetGraphicsRootConstantBufferView(inRootParameterIndex, m_Resource->GetGPUVirtualAddress());
-}
\ No newline at end of file
+	if (m_Resource != nullptr && m_CPUAddress != nullptr)
+		m_Resource->Unmap(0, nullptr);
+
+	m_CPUAddress	= nullptr;
+	m_GPUAddress	= 0;
+}
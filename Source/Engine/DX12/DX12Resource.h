@@ -1,6 +1,9 @@
 #pragma once
 
 #include "DX12/DX12Includes.h"
+#include "Utils/RingAllocator.h"
+
+#include <cstring>
 #include <string>
 
 class DX12Resource
@@ -58,25 +61,59 @@ public:
 public:
 	void InitAsIndexBuffer(
 		ID3D12GraphicsCommandList2& inCommandList,
-		size_t inBufferSize, const void* inBufferData,
+		size_t inBufferSize, const void* inBufferData, DXGI_FORMAT inFormat,
 		D3D12_RESOURCE_FLAGS inFlags = D3D12_RESOURCE_FLAG_NONE);
 
 	void SetIndexBuffer(ID3D12GraphicsCommandList2& inCommandList) const;
 
+	// Size in bytes of a single index. Only 16 and 32 bit indices are supported
+	static uint32 GetIndexSize(DXGI_FORMAT inFormat);
+
 protected:
 	D3D12_INDEX_BUFFER_VIEW m_IndexBufferView;
 };
 
-class DX12ConstantBuffer final : public DX12Resource
+// Upload heap buffer mapped for its whole life, handing out ranges for data the GPU reads in a single frame such as
+// constant buffers. Ranges are given back once the fence of their frame is complete, see RingAllocator
+class DX12UploadRing final : public DX12Resource
 {
 public:
+	struct Allocation
+	{
+		Byte*						m_CPUAddress	= nullptr;
+		D3D12_GPU_VIRTUAL_ADDRESS	m_GPUAddress	= 0;
+	};
+
 	using DX12Resource::DX12Resource;
 
-	virtual void UpdateBufferResource(
-		ID3D12GraphicsCommandList2& inCommandList,
-		size_t inBufferSize = 0, const void* inBufferData = nullptr) override;
+	// inSize must be a power of two
+	void InitAsUploadRing(uint64 inSize);
+
+	// Can be called from several threads while recording. Constant buffer alignment by default.
+	// Running out of space is fatal: the frames in flight need a bigger ring
+	Allocation Allocate(uint64 inSize, uint64 inAlignment = D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT);
 
-	void SetConstantBuffer(ID3D12GraphicsCommandList2& inCommandList, uint32 inRootParameterIndex) const;
+	// Copy inData to a new range and return its address, for SetGraphicsRootConstantBufferView
+	template <typename T>
+	D3D12_GPU_VIRTUAL_ADDRESS Upload(const T& inData)
+	{
+		const Allocation allocation = Allocate(sizeof(T));
+		::memcpy(allocation.m_CPUAddress, &inData, sizeof(T));
+		return allocation.m_GPUAddress;
+	}
 
-	void InitAsConstantBuffer(size_t inBufferSize);
-};
\ No newline at end of file
+	// Ranges allocated so far are in use until inFenceValue, signaled after the frame that uses them, is complete
+	inline void	EndFrame(uint64 inFenceValue)						{ m_Allocator.EndFrame(inFenceValue); }
+	inline void	Reclaim(uint64 inCompletedFenceValue)				{ m_Allocator.Reclaim(inCompletedFenceValue); }
+
+	inline RingAllocator::Statistics	GetStatistics() const		{ return m_Allocator.GetStatistics(); }
+	void TraceStatistics() const;
+
+protected:
+	void OnReleased() override;
+
+private:
+	RingAllocator				m_Allocator;
+	Byte*						m_CPUAddress	= nullptr;
+	D3D12_GPU_VIRTUAL_ADDRESS	m_GPUAddress	= 0;
+};
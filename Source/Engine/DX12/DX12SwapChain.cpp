@@ -3,6 +3,7 @@
 
 #include "DX12/DX12DescriptorHeap.h"
 #include "DX12/DX12Device.h"
+#include "Gfx/CommandList.h"
 
 bool CheckTearingSupport()
 {
@@ -131,7 +132,7 @@ void DX12SwapChain::UpdateRenderTargetViews(uint32 inWidth, uint32 inHeight, boo
 	}
 }
 
-void DX12SwapChain::ClearBackBuffer(ID3D12GraphicsCommandList2& inCommandList) const
+void DX12SwapChain::ClearBackBuffer(CommandList& inCommandList) const
 {
 	auto back_buffer = m_BackBuffers[m_CurrentBackBufferIndex];
 
@@ -168,7 +169,7 @@ void DX12SwapChain::Present(ID3D12GraphicsCommandList2& inCommandList, DX12Comma
 	inCommandQueue.WaitForFenceValue(m_FrameFenceValues[m_CurrentBackBufferIndex]);
 }
 
-void DX12SwapChain::SetRenderTarget(ID3D12GraphicsCommandList2& inCommandList)
+void DX12SwapChain::SetRenderTarget(CommandList& inCommandList)
 {
 	D3D12_CPU_DESCRIPTOR_HANDLE rtv = m_BackBuffers[m_CurrentBackBufferIndex]->GetCPUDescriptorHandle();
 	inCommandList.OMSetRenderTargets(1, &rtv, false, nullptr);
@@ -4,6 +4,8 @@
 #include "DX12/DX12CommandQueue.h"
 #include "DX12/DX12RenderTarget.h"
 
+class CommandList;
+
 class DX12SwapChain final
 {
 	friend class DX12Device;
@@ -13,10 +15,10 @@ private:
 
 public:
 	void UpdateRenderTargetViews(uint32 inClientWidth, uint32 inClientHeight, bool inFirstCall = false);
-	void ClearBackBuffer(ID3D12GraphicsCommandList2& inCommandList) const;
+	void ClearBackBuffer(CommandList& inCommandList) const;
 	void Present(ID3D12GraphicsCommandList2& commandList, DX12CommandQueue& commandQueue);
 
-	void SetRenderTarget(ID3D12GraphicsCommandList2& inCommandList);
+	void SetRenderTarget(CommandList& inCommandList);
 
 private:
 	enum
@@ -0,0 +1,267 @@
+#include "Engine.h"
+#include "AssetManager.h"
+
+#include "Utils/AsyncIO.h"
+#include "Utils/FileReader.h"
+#include "Utils/PackFile.h"
+
+AssetManager g_AssetManager;
+
+void Asset::ReleaseRef()
+{
+	uint32 ref_count = m_RefCount.load(std::memory_order_relaxed);
+	while (ref_count > 1)
+	{
+		if (m_RefCount.compare_exchange_weak(ref_count, ref_count - 1, std::memory_order_acq_rel))
+			return;
+	}
+
+	// The last reference is dropped under the lock, so a Load of the same path can't revive the asset while it's being released
+	g_AssetManager.ReleaseLastRef(this);
+}
+
+AssetManager::~AssetManager()
+{
+	Shutdown();
+}
+
+Asset* AssetManager::FindOrLoad(std::string_view inPath, const char* inTypeName, Asset* (*inCreateAsset)())
+{
+	const std::string path	= PackFileFormat::NormalizePath(inPath);
+	const uint64 path_hash	= PackFileFormat::HashPath(path);
+
+	Asset* asset = nullptr;
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+
+		m_NumRequests++;
+
+		const auto range = m_Assets.equal_range(path_hash);
+		for (auto it = range.first; it != range.second; ++it)
+		{
+			Asset* existing_asset = it->second;
+			if (existing_asset->m_TypeName == inTypeName && PackFileFormat::NormalizePath(existing_asset->m_Path) == path)
+			{
+				// Could be unreferenced and about to be deleted, Update keeps it now that it's referenced again
+				existing_asset->AddRef();
+				m_NumDeduplicated++;
+				return existing_asset;
+			}
+		}
+
+		asset = inCreateAsset();
+		asset->m_Path		= std::string(inPath);
+		asset->m_TypeName	= inTypeName;
+		asset->m_PathHash	= path_hash;
+		// One for the handle, one for the load until Update uploads it
+		asset->m_RefCount.store(2, std::memory_order_relaxed);
+
+		m_Assets.emplace(path_hash, asset);
+	}
+
+	StartLoad(asset);
+
+	return asset;
+}
+
+void AssetManager::StartLoad(Asset* inAsset)
+{
+	if (!inAsset->ReadsWholeFile())
+	{
+		g_JobSystem.Schedule([this, inAsset]() { LoadAsset(inAsset, true, AssetFile()); }, &m_LoadCounter);
+		return;
+	}
+
+	if (!g_AsyncIO.IsInitialized())
+	{
+		g_JobSystem.Schedule([this, inAsset]()
+		{
+			FileReader file_reader;
+			const bool is_file_read = file_reader.ReadFile(inAsset->m_Path);
+
+			AssetFile file;
+			file.m_Data		= static_cast<const Byte*>(file_reader.GetContentAsBinary());
+			file.m_Size		= file_reader.GetContentSize();
+			LoadAsset(inAsset, is_file_read, file);
+		}, &m_LoadCounter);
+		return;
+	}
+
+	AsyncReadRequest request;
+	request.m_Filename = inAsset->m_Path;
+
+	// On the I/O thread, the decoding goes to a job so the next reads aren't held up.
+	// The job is scheduled before the read completes, WaitForLoads relies on it
+	request.m_Callback = [this, inAsset](AsyncReadResult& ioResult)
+	{
+		const bool is_file_read = ioResult.m_Success;
+		const uint64 file_size	= ioResult.m_Size;
+		std::shared_ptr<Byte[]> file_content(ioResult.m_FileContent.release());
+
+		g_JobSystem.Schedule([this, inAsset, is_file_read, file_size, file_content]()
+		{
+			AssetFile file;
+			file.m_Data		= file_content.get();
+			file.m_Size		= file_size;
+			LoadAsset(inAsset, is_file_read, file);
+		}, &m_LoadCounter);
+	};
+
+	// The callback takes the result, the future has nothing left
+	g_AsyncIO.Submit(std::move(request));
+}
+
+void AssetManager::LoadAsset(Asset* inAsset, bool inIsFileRead, const AssetFile& inFile)
+{
+	if (!inIsFileRead || !inAsset->Load(inFile))
+	{
+		Trace("AssetManager: Can't load %s", inAsset->m_Path.c_str());
+		inAsset->m_State.store(AssetState::Failed, std::memory_order_release);
+		inAsset->ReleaseRef();
+		return;
+	}
+
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	m_LoadedAssets.push_back(inAsset);
+}
+
+void AssetManager::ReleaseLastRef(Asset* inAsset)
+{
+	std::lock_guard<std::mutex> lock(m_Mutex);
+
+	// Another handle could have been copied since
+	if (inAsset->m_RefCount.fetch_sub(1, std::memory_order_acq_rel) != 1)
+		return;
+
+	if (!inAsset->m_IsUnreferenced)
+	{
+		inAsset->m_IsUnreferenced = true;
+		m_UnreferencedAssets.push_back(inAsset);
+	}
+	inAsset->m_UnreferencedFrame = m_FrameIndex;
+}
+
+uint32 AssetManager::Update(const AssetUploadContext& inContext)
+{
+	std::vector<Asset*> loaded_assets;
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_FrameIndex++;
+		loaded_assets.swap(m_LoadedAssets);
+	}
+
+	for (Asset* asset : loaded_assets)
+	{
+		const bool uploaded = asset->Upload(inContext);
+		if (!uploaded)
+			Trace("AssetManager: Can't upload %s", asset->m_Path.c_str());
+
+		asset->m_State.store(uploaded ? AssetState::Ready : AssetState::Failed, std::memory_order_release);
+		asset->ReleaseRef();
+	}
+
+	std::vector<Asset*> released_assets;
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+
+		for (size_t i = 0; i < m_UnreferencedAssets.size();)
+		{
+			Asset* asset			= m_UnreferencedAssets[i];
+			const bool referenced	= asset->m_RefCount.load(std::memory_order_acquire) != 0;
+
+			if (!referenced && m_FrameIndex - asset->m_UnreferencedFrame < FramesBeforeRelease)
+			{
+				i++;
+				continue;
+			}
+
+			asset->m_IsUnreferenced = false;
+			m_UnreferencedAssets[i] = m_UnreferencedAssets.back();
+			m_UnreferencedAssets.pop_back();
+
+			if (referenced)
+				continue;
+
+			const auto range = m_Assets.equal_range(asset->m_PathHash);
+			for (auto it = range.first; it != range.second; ++it)
+			{
+				if (it->second == asset)
+				{
+					m_Assets.erase(it);
+					break;
+				}
+			}
+			released_assets.push_back(asset);
+		}
+	}
+
+	// Outside of the lock, releasing GPU resources can take a while
+	for (Asset* asset : released_assets)
+		delete asset;
+
+	return static_cast<uint32>(loaded_assets.size());
+}
+
+void AssetManager::WaitForLoads()
+{
+	// Completed reads have scheduled their load job, it's counted from then on
+	if (g_AsyncIO.IsInitialized())
+		g_AsyncIO.WaitIdle();
+
+	g_JobSystem.Wait(m_LoadCounter);
+}
+
+void AssetManager::Shutdown()
+{
+	WaitForLoads();
+
+	std::lock_guard<std::mutex> lock(m_Mutex);
+
+	// Never uploaded, drop the reference of their load
+	for (Asset* asset : m_LoadedAssets)
+		asset->m_RefCount.fetch_sub(1, std::memory_order_relaxed);
+	m_LoadedAssets.clear();
+
+	for (auto& pair : m_Assets)
+	{
+		Asset* asset = pair.second;
+		if (asset->m_RefCount.load(std::memory_order_relaxed) != 0)
+			Trace("AssetManager: %s is still referenced", asset->m_Path.c_str());
+		Assert(asset->m_RefCount.load(std::memory_order_relaxed) == 0, "Release every handle before Shutdown");
+		delete asset;
+	}
+	m_Assets.clear();
+	m_UnreferencedAssets.clear();
+}
+
+AssetManagerStatistics AssetManager::GetStatistics() const
+{
+	AssetManagerStatistics statistics;
+
+	std::lock_guard<std::mutex> lock(m_Mutex);
+
+	statistics.m_NumAssets			= static_cast<uint32>(m_Assets.size());
+	statistics.m_NumRequests		= m_NumRequests;
+	statistics.m_NumDeduplicated	= m_NumDeduplicated;
+
+	for (const auto& pair : m_Assets)
+	{
+		switch (pair.second->GetState())
+		{
+		case AssetState::Pending:	statistics.m_NumPending++;	break;
+		case AssetState::Ready:		statistics.m_NumReady++;	break;
+		case AssetState::Failed:	statistics.m_NumFailed++;	break;
+		}
+	}
+
+	return statistics;
+}
+
+void AssetManager::TraceStatistics() const
+{
+	const AssetManagerStatistics statistics = GetStatistics();
+
+	Trace("AssetManager: %u assets (%u pending, %u ready, %u failed), %llu requests (%llu deduplicated)",
+		  statistics.m_NumAssets, statistics.m_NumPending, statistics.m_NumReady, statistics.m_NumFailed,
+		  statistics.m_NumRequests, statistics.m_NumDeduplicated);
+}
@@ -0,0 +1,206 @@
+#pragma once
+
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "DX12/DX12Includes.h"
+#include "Utils/JobSystem.h"
+
+class ShaderObject;
+
+enum class AssetState : uint32
+{
+	Pending,	// Loading, or loaded and waiting for AssetManager::Update to upload it
+	Ready,
+	Failed		// Missing or invalid file. Not retried while the asset is alive
+};
+
+// What uploads need from the renderer
+struct AssetUploadContext
+{
+	ID3D12GraphicsCommandList2*					m_CommandList	= nullptr;
+	const std::map<std::string, ShaderObject*>*	m_ShaderObjects	= nullptr;
+};
+
+// Content of the file of an asset, read by the AssetManager. Only valid during Asset::Load
+struct AssetFile
+{
+	const Byte*		m_Data	= nullptr;
+	uint64			m_Size	= 0;
+};
+
+// Base of everything loaded by the AssetManager. Derived types declare a TypeName: the same file loaded
+// as two different types is two different assets
+class Asset
+{
+public:
+	Asset() = default;
+	virtual ~Asset() = default;
+
+	Asset(const Asset&) = delete;
+	Asset& operator=(const Asset&) = delete;
+
+	inline AssetState			GetState() const	{ return m_State.load(std::memory_order_acquire); }
+	inline const std::string&	GetPath() const		{ return m_Path; }
+
+protected:
+	// Assets decoding their whole file get it read by the AssetManager through AsyncIO, so jobs don't wait on the disk.
+	// Others read their files in Load, e.g. to map them
+	virtual bool	ReadsWholeFile() const	{ return false; }
+	// Decode the file, on a job. Must not touch the GPU. Returns false if the asset can't be loaded.
+	// inFile is the content of the file when ReadsWholeFile, empty otherwise
+	virtual bool	Load(const AssetFile& inFile) = 0;
+	// Create the GPU resources from what Load decoded, on the render thread. The CPU copy can go once this returns
+	virtual bool	Upload(const AssetUploadContext& inContext) = 0;
+
+private:
+	friend class AssetManager;
+	template <typename T> friend class AssetHandle;
+
+	inline void		AddRef()			{ m_RefCount.fetch_add(1, std::memory_order_relaxed); }
+	void			ReleaseRef();
+
+	std::string					m_Path;
+	const char*					m_TypeName			= nullptr;
+	uint64						m_PathHash			= 0;
+	std::atomic<AssetState>		m_State				= AssetState::Pending;
+	std::atomic<uint32>			m_RefCount			= 0;
+
+	// Guarded by the AssetManager mutex
+	bool						m_IsUnreferenced	= false;
+	uint64						m_UnreferencedFrame	= 0;
+};
+
+// Shared reference to an asset, returned right away by AssetManager::Load. Copies share the asset,
+// it's released once the last handle is gone. Only use the asset once it's Ready
+template <typename T>
+class AssetHandle final
+{
+public:
+	AssetHandle() = default;
+	AssetHandle(const AssetHandle& inOther) : m_Asset(inOther.m_Asset)	{ if (m_Asset != nullptr) m_Asset->AddRef(); }
+	AssetHandle(AssetHandle&& ioOther) : m_Asset(ioOther.m_Asset)		{ ioOther.m_Asset = nullptr; }
+	~AssetHandle()														{ Reset(); }
+
+	AssetHandle& operator=(const AssetHandle& inOther)
+	{
+		AssetHandle copy(inOther);
+		std::swap(m_Asset, copy.m_Asset);
+		return *this;
+	}
+
+	AssetHandle& operator=(AssetHandle&& ioOther)
+	{
+		if (this != &ioOther)
+		{
+			Reset();
+			std::swap(m_Asset, ioOther.m_Asset);
+		}
+		return *this;
+	}
+
+	void Reset()
+	{
+		if (m_Asset != nullptr)
+			m_Asset->ReleaseRef();
+		m_Asset = nullptr;
+	}
+
+	inline bool			IsValid() const		{ return m_Asset != nullptr; }
+	// An empty handle is Failed
+	inline AssetState	GetState() const	{ return m_Asset != nullptr ? m_Asset->GetState() : AssetState::Failed; }
+	inline bool			IsReady() const		{ return GetState() == AssetState::Ready; }
+
+	inline T*			Get() const			{ Assert(IsReady()); return m_Asset; }
+	inline T*			operator->() const	{ return Get(); }
+
+private:
+	friend class AssetManager;
+
+	// Takes over the reference added by the AssetManager
+	explicit AssetHandle(T* inAsset) : m_Asset(inAsset) {}
+
+	T*		m_Asset		= nullptr;
+};
+
+struct AssetManagerStatistics
+{
+	uint32	m_NumAssets			= 0;
+	uint32	m_NumPending		= 0;
+	uint32	m_NumReady			= 0;
+	uint32	m_NumFailed			= 0;
+	uint64	m_NumRequests		= 0;	// Calls to Load
+	uint64	m_NumDeduplicated	= 0;	// Calls to Load that got an asset already loaded or loading
+};
+
+// Loads assets in the background and shares them. Load returns a handle right away, the file is read by AsyncIO and
+// decoded by a job then uploaded by Update on the render thread, so frames keep rendering while assets stream in.
+// Files are read by the job itself when AsyncIO isn't initialized.
+// Requests are deduplicated by type and path hash, all handles to a file share one asset.
+// Unreferenced assets are deleted a few frames later, once the GPU is done with them
+class AssetManager final
+{
+public:
+	// Frames the GPU can be behind. Unreferenced assets survive this many calls to Update
+	static constexpr uint32 FramesBeforeRelease = 3;
+
+	AssetManager() = default;
+	~AssetManager();
+
+	AssetManager(const AssetManager&) = delete;
+	AssetManager& operator=(const AssetManager&) = delete;
+
+	// Can be called from any thread
+	template <typename T>
+	AssetHandle<T>	Load(std::string_view inPath)
+	{
+		static_assert(std::is_base_of_v<Asset, T>, "Assets derive from Asset");
+		return AssetHandle<T>(static_cast<T*>(FindOrLoad(inPath, T::TypeName, []() -> Asset* { return new T; })));
+	}
+
+	// Upload the assets that finished loading and delete the ones unreferenced for long enough.
+	// Once per frame, on the render thread. Returns the number of assets uploaded
+	uint32			Update(const AssetUploadContext& inContext);
+
+	// Wait for every requested asset to be loaded. They still need Update to be Ready
+	void			WaitForLoads();
+
+	// Every handle must be released. Deletes all assets
+	void			Shutdown();
+
+	AssetManagerStatistics	GetStatistics() const;
+	void			TraceStatistics() const;
+
+private:
+	friend class Asset;
+
+	Asset*			FindOrLoad(std::string_view inPath, const char* inTypeName, Asset* (*inCreateAsset)());
+	// Read the file if needed, then schedule the job calling LoadAsset
+	void			StartLoad(Asset* inAsset);
+	// inIsFileRead is false when the file of a ReadsWholeFile asset couldn't be read
+	void			LoadAsset(Asset* inAsset, bool inIsFileRead, const AssetFile& inFile);
+	void			ReleaseLastRef(Asset* inAsset);
+
+	mutable std::mutex						m_Mutex;
+	// By path hash, different types can share a path
+	std::unordered_multimap<uint64, Asset*>	m_Assets;
+	// Loaded and waiting for Update, they hold a reference until uploaded
+	std::vector<Asset*>						m_LoadedAssets;
+	// Deleted by Update after FramesBeforeRelease frames, unless they are loaded again in between
+	std::vector<Asset*>						m_UnreferencedAssets;
+	uint64									m_FrameIndex		= 0;
+
+	uint64									m_NumRequests		= 0;
+	uint64									m_NumDeduplicated	= 0;
+
+	JobCounter								m_LoadCounter;
+};
+
+extern AssetManager g_AssetManager;
@@ -0,0 +1,411 @@
+#include "Engine.h"
+#include "BakedMesh.h"
+
+#include "Gfx/Mesh.h"
+#include "Gfx/MeshLoader.h"
+
+#include "Utils/AssetCache.h"
+
+#include <fstream>
+
+using namespace BakedMeshFormat;
+
+// Meshlets and their bounds are written as is
+static_assert(sizeof(Meshlet) == 4 * sizeof(uint32), "Unexpected Meshlet layout");
+static_assert(sizeof(MeshletBounds) == 17 * sizeof(float), "Unexpected MeshletBounds layout");
+
+static void WritePadding(std::ofstream& ioStream, uint64 inAlignedOffset)
+{
+	static const char zeros[Alignment] = {};
+
+	const uint64 current_offset = static_cast<uint64>(ioStream.tellp());
+	Assert(inAlignedOffset >= current_offset && inAlignedOffset - current_offset < Alignment);
+
+	ioStream.write(zeros, static_cast<std::streamsize>(inAlignedOffset - current_offset));
+}
+
+bool BakedMesh::Bake(const MeshLoader& inMeshLoader, const std::string& inFile)
+{
+	Assert(inMeshLoader.m_VertexData.size() > 0);
+
+	std::vector<Object>		objects;
+	std::vector<SubMesh>	sub_meshes;
+	std::vector<LOD>		lods;
+	std::vector<Byte>		index_data;
+	std::string				strings;
+
+	// Compressed copy of the vertex data, if the loader made one
+	const VertexCompressionMode compression = inMeshLoader.m_Settings.m_VertexCompression;
+	const Byte* compressed_vertex_data		= nullptr;
+	uint32 compressed_vertex_stride			= 0;
+
+	if (compression == VertexCompressionMode::Packed)
+	{
+		compressed_vertex_data		= reinterpret_cast<const Byte*>(inMeshLoader.m_PackedVertexData.data());
+		compressed_vertex_stride	= sizeof(VertexPosUVNormalPacked);
+	}
+	else if (compression == VertexCompressionMode::Quantized)
+	{
+		compressed_vertex_data		= reinterpret_cast<const Byte*>(inMeshLoader.m_QuantizedVertexData.data());
+		compressed_vertex_stride	= sizeof(VertexPosUVNormalQuantized);
+	}
+
+	for (size_t i = 0; i <= inMeshLoader.m_CurrentMeshInfo; i++)
+	{
+		const MeshInfo& mesh_info	= *inMeshLoader.m_MeshInfos[i];
+		const Range vertex_range	= mesh_info.m_VertexBuffeRange;
+		const Range index_range		= mesh_info.m_IndexBufferRange;
+
+		// Objects without any triangle have nothing to draw
+		if (index_range.m_End == index_range.m_Start)
+			continue;
+
+		Object object = {};
+		object.m_VertexOffset			= static_cast<uint64>(vertex_range.m_Start) * sizeof(VertexPosUVNormal);
+		object.m_CompressedVertexOffset	= static_cast<uint64>(vertex_range.m_Start) * compressed_vertex_stride;
+		object.m_NumVertices			= static_cast<uint32>(vertex_range.m_End - vertex_range.m_Start);
+		object.m_IndexFormat			= Mesh::GetIndexFormat(object.m_NumVertices);
+		object.m_FirstSubMesh			= static_cast<uint32>(sub_meshes.size());
+
+		// Store indices in their final format so they can be uploaded as is
+		index_data.resize(Math::AlignUp<size_t>(index_data.size(), Alignment));
+		object.m_IndexOffset = index_data.size();
+
+		auto append_indices = [&](const uint32* inIndices, uint32 inNumIndices)
+		{
+			if (object.m_IndexFormat == DXGI_FORMAT_R16_UINT)
+			{
+				for (uint32 index = 0; index < inNumIndices; index++)
+				{
+					const uint16 index_16 = static_cast<uint16>(inIndices[index]);
+					index_data.insert(index_data.end(), reinterpret_cast<const Byte*>(&index_16), reinterpret_cast<const Byte*>(&index_16 + 1));
+				}
+			}
+			else
+			{
+				index_data.insert(index_data.end(), reinterpret_cast<const Byte*>(inIndices), reinterpret_cast<const Byte*>(inIndices + inNumIndices));
+			}
+
+			object.m_NumIndices += inNumIndices;
+		};
+
+		// Full resolution indices of all submeshes first, like MeshLoader::Finalize
+		append_indices(inMeshLoader.m_IndexData.data() + index_range.m_Start, static_cast<uint32>(index_range.m_End - index_range.m_Start));
+
+		for (const SubMeshInfo& sub_mesh_info : mesh_info.m_SubMeshes)
+		{
+			const Range sub_mesh_range = sub_mesh_info.m_IndexBufferRange;
+
+			SubMesh sub_mesh = {};
+			sub_mesh.m_FirstLOD = static_cast<uint32>(lods.size());
+
+			LOD lod;
+			lod.m_StartIndex	= static_cast<uint32>(sub_mesh_range.m_Start - index_range.m_Start);
+			lod.m_NumIndices	= static_cast<uint32>(sub_mesh_range.m_End - sub_mesh_range.m_Start);
+			lod.m_Error			= 0.0f;
+			lods.push_back(lod);
+
+			for (const LODInfo& lod_info : sub_mesh_info.m_LODs)
+			{
+				const Range lod_range = lod_info.m_IndexBufferRange;
+
+				lod.m_StartIndex	= object.m_NumIndices;
+				lod.m_NumIndices	= static_cast<uint32>(lod_range.m_End - lod_range.m_Start);
+				lod.m_Error			= lod_info.m_Error;
+				lods.push_back(lod);
+
+				append_indices(inMeshLoader.m_LODIndexData.data() + lod_range.m_Start, lod.m_NumIndices);
+			}
+
+			sub_mesh.m_NumLODs = static_cast<uint32>(lods.size()) - sub_mesh.m_FirstLOD;
+
+			// Meshlet data is written whole, ranges don't move
+			if (inMeshLoader.m_Settings.m_BuildMeshlets)
+			{
+				sub_mesh.m_FirstMeshlet	= static_cast<uint32>(sub_mesh_info.m_MeshletRange.m_Start);
+				sub_mesh.m_NumMeshlets	= static_cast<uint32>(sub_mesh_info.m_MeshletRange.m_End - sub_mesh_info.m_MeshletRange.m_Start);
+			}
+
+			sub_mesh.m_MaterialNameOffset	= static_cast<uint32>(strings.size());
+			sub_mesh.m_MaterialNameLength	= static_cast<uint32>(sub_mesh_info.m_MaterialName.size());
+			strings += sub_mesh_info.m_MaterialName;
+
+			if (inMeshLoader.IsMaterialTransparent(sub_mesh_info.m_MaterialName))
+				sub_mesh.m_Flags |= SubMeshFlags::Transparent;
+
+			for (int32 k = 0; k < 3; k++)
+			{
+				sub_mesh.m_AABBMin[k]		= sub_mesh_info.m_AABB.m_Min[k];
+				sub_mesh.m_AABBMax[k]		= sub_mesh_info.m_AABB.m_Max[k];
+				sub_mesh.m_SphereCenter[k]	= sub_mesh_info.m_BoundingSphere.m_Center[k];
+			}
+			sub_mesh.m_SphereRadius = sub_mesh_info.m_BoundingSphere.m_Radius;
+
+			sub_meshes.push_back(sub_mesh);
+		}
+
+		object.m_NumSubMeshes		= static_cast<uint32>(sub_meshes.size()) - object.m_FirstSubMesh;
+
+		object.m_NameOffset			= static_cast<uint32>(strings.size());
+		object.m_NameLength			= static_cast<uint32>(mesh_info.m_ObjectName.size());
+		strings += mesh_info.m_ObjectName;
+
+		if (compression == VertexCompressionMode::Quantized)
+		{
+			for (int32 k = 0; k < 3; k++)
+			{
+				object.m_QuantizationCenter[k]	= mesh_info.m_QuantizationBounds.m_Center[k];
+				object.m_QuantizationExtents[k]	= mesh_info.m_QuantizationBounds.m_Extents[k];
+			}
+		}
+
+		objects.push_back(object);
+	}
+
+	const MeshletData& meshlet_data = inMeshLoader.m_MeshletData;
+
+	Header header = {};
+	header.m_Magic							= Magic;
+	header.m_Version						= Version;
+	header.m_NumObjects						= static_cast<uint32>(objects.size());
+	header.m_NumSubMeshes					= static_cast<uint32>(sub_meshes.size());
+	header.m_NumLODs						= static_cast<uint32>(lods.size());
+	header.m_VertexStride					= sizeof(VertexPosUVNormal);
+	header.m_CompressedVertexFormat			= static_cast<uint32>(compression);
+	header.m_CompressedVertexStride			= compressed_vertex_stride;
+	header.m_NumMeshlets					= static_cast<uint32>(meshlet_data.m_Meshlets.size());
+
+	header.m_ObjectsOffset					= Math::AlignUp<uint64>(sizeof(Header), Alignment);
+	header.m_SubMeshesOffset				= Math::AlignUp<uint64>(header.m_ObjectsOffset + objects.size() * sizeof(Object), Alignment);
+	header.m_LODsOffset						= Math::AlignUp<uint64>(header.m_SubMeshesOffset + sub_meshes.size() * sizeof(SubMesh), Alignment);
+	header.m_VertexDataOffset				= Math::AlignUp<uint64>(header.m_LODsOffset + lods.size() * sizeof(LOD), Alignment);
+	header.m_VertexDataSize					= inMeshLoader.m_VertexData.size() * sizeof(VertexPosUVNormal);
+	header.m_CompressedVertexDataOffset		= Math::AlignUp<uint64>(header.m_VertexDataOffset + header.m_VertexDataSize, Alignment);
+	header.m_CompressedVertexDataSize		= inMeshLoader.m_VertexData.size() * compressed_vertex_stride;
+	header.m_IndexDataOffset				= Math::AlignUp<uint64>(header.m_CompressedVertexDataOffset + header.m_CompressedVertexDataSize, Alignment);
+	header.m_IndexDataSize					= index_data.size();
+	header.m_MeshletsOffset					= Math::AlignUp<uint64>(header.m_IndexDataOffset + header.m_IndexDataSize, Alignment);
+	header.m_MeshletBoundsOffset			= Math::AlignUp<uint64>(header.m_MeshletsOffset + meshlet_data.m_Meshlets.size() * sizeof(Meshlet), Alignment);
+	header.m_MeshletVertexIndicesOffset		= Math::AlignUp<uint64>(header.m_MeshletBoundsOffset + meshlet_data.m_Bounds.size() * sizeof(MeshletBounds), Alignment);
+	header.m_MeshletVertexIndicesSize		= meshlet_data.m_VertexIndices.size() * sizeof(uint32);
+	header.m_MeshletTriangleIndicesOffset	= Math::AlignUp<uint64>(header.m_MeshletVertexIndicesOffset + header.m_MeshletVertexIndicesSize, Alignment);
+	header.m_MeshletTriangleIndicesSize		= meshlet_data.m_TriangleIndices.size();
+	header.m_StringsOffset					= Math::AlignUp<uint64>(header.m_MeshletTriangleIndicesOffset + header.m_MeshletTriangleIndicesSize, Alignment);
+	header.m_StringsSize					= strings.size();
+
+	std::ofstream stream(inFile, std::ios::binary | std::ios::trunc);
+	if (!stream.is_open())
+		return false;
+
+	stream.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+
+	WritePadding(stream, header.m_ObjectsOffset);
+	stream.write(reinterpret_cast<const char*>(objects.data()), objects.size() * sizeof(Object));
+
+	WritePadding(stream, header.m_SubMeshesOffset);
+	stream.write(reinterpret_cast<const char*>(sub_meshes.data()), sub_meshes.size() * sizeof(SubMesh));
+
+	WritePadding(stream, header.m_LODsOffset);
+	stream.write(reinterpret_cast<const char*>(lods.data()), lods.size() * sizeof(LOD));
+
+	WritePadding(stream, header.m_VertexDataOffset);
+	stream.write(reinterpret_cast<const char*>(inMeshLoader.m_VertexData.data()), header.m_VertexDataSize);
+
+	WritePadding(stream, header.m_CompressedVertexDataOffset);
+	stream.write(reinterpret_cast<const char*>(compressed_vertex_data), header.m_CompressedVertexDataSize);
+
+	WritePadding(stream, header.m_IndexDataOffset);
+	stream.write(reinterpret_cast<const char*>(index_data.data()), header.m_IndexDataSize);
+
+	WritePadding(stream, header.m_MeshletsOffset);
+	stream.write(reinterpret_cast<const char*>(meshlet_data.m_Meshlets.data()), meshlet_data.m_Meshlets.size() * sizeof(Meshlet));
+
+	WritePadding(stream, header.m_MeshletBoundsOffset);
+	stream.write(reinterpret_cast<const char*>(meshlet_data.m_Bounds.data()), meshlet_data.m_Bounds.size() * sizeof(MeshletBounds));
+
+	WritePadding(stream, header.m_MeshletVertexIndicesOffset);
+	stream.write(reinterpret_cast<const char*>(meshlet_data.m_VertexIndices.data()), header.m_MeshletVertexIndicesSize);
+
+	WritePadding(stream, header.m_MeshletTriangleIndicesOffset);
+	stream.write(reinterpret_cast<const char*>(meshlet_data.m_TriangleIndices.data()), header.m_MeshletTriangleIndicesSize);
+
+	WritePadding(stream, header.m_StringsOffset);
+	stream.write(strings.data(), header.m_StringsSize);
+
+	return stream.good();
+}
+
+bool BakedMesh::AddToCacheKey(const std::string& inFile, const MeshImportSettings& inSettings, AssetCacheKey& ioKey)
+{
+	ioKey.AddValue(MeshLoader::ImporterVersion);
+
+	ioKey.AddValue(inSettings.m_OptimizeVertexCache);
+	ioKey.AddValue(inSettings.m_OptimizeOverdraw);
+	ioKey.AddValue(inSettings.m_OverdrawACMRThreshold);
+	ioKey.AddValue(inSettings.m_NumLODs);
+	ioKey.AddValue(inSettings.m_LODTriangleRatio);
+	ioKey.AddValue(inSettings.m_LODMaxError);
+	ioKey.AddValue(inSettings.m_BuildMeshlets);
+	ioKey.AddValue(inSettings.m_VertexCompression);
+
+	std::vector<std::string> source_files;
+	if (!MeshLoader::GetSourceFiles(inFile, source_files))
+		return false;
+
+	for (const std::string& source_file : source_files)
+	{
+		if (!ioKey.AddFile(source_file))
+			return false;
+	}
+
+	return true;
+}
+
+// 0 for VertexCompressionMode::None and unknown formats
+static uint32 GetCompressedVertexStride(uint32 inFormat)
+{
+	switch (static_cast<VertexCompressionMode>(inFormat))
+	{
+	case VertexCompressionMode::Packed:		return sizeof(VertexPosUVNormalPacked);
+	case VertexCompressionMode::Quantized:	return sizeof(VertexPosUVNormalQuantized);
+	default:								return 0;
+	}
+}
+
+// Without overflow, unlike inOffset + inSize <= inLimit
+static inline bool IsRangeValid(uint64 inOffset, uint64 inSize, uint64 inLimit)
+{
+	return inOffset <= inLimit && inSize <= inLimit - inOffset;
+}
+
+bool BakedMesh::LoadFromFile(const std::string& inFile)
+{
+	if (!m_File.Open(inFile, MappedFile::AccessHints::Sequential))
+		return false;
+
+	// Validate the header before trusting any offset
+	bool is_valid = (m_File.GetSize() >= sizeof(Header));
+	if (is_valid)
+	{
+		const Header& header = GetHeader();
+		is_valid = header.m_Magic == Magic && header.m_Version == Version &&
+				   header.m_VertexStride == sizeof(VertexPosUVNormal) &&
+				   header.m_CompressedVertexStride == GetCompressedVertexStride(header.m_CompressedVertexFormat) &&
+				   IsRangeValid(header.m_ObjectsOffset, uint64(header.m_NumObjects) * sizeof(Object), m_File.GetSize()) &&
+				   IsRangeValid(header.m_SubMeshesOffset, uint64(header.m_NumSubMeshes) * sizeof(SubMesh), m_File.GetSize()) &&
+				   IsRangeValid(header.m_LODsOffset, uint64(header.m_NumLODs) * sizeof(LOD), m_File.GetSize()) &&
+				   IsRangeValid(header.m_VertexDataOffset, header.m_VertexDataSize, m_File.GetSize()) &&
+				   IsRangeValid(header.m_CompressedVertexDataOffset, header.m_CompressedVertexDataSize, m_File.GetSize()) &&
+				   IsRangeValid(header.m_IndexDataOffset, header.m_IndexDataSize, m_File.GetSize()) &&
+				   IsRangeValid(header.m_MeshletsOffset, uint64(header.m_NumMeshlets) * sizeof(Meshlet), m_File.GetSize()) &&
+				   IsRangeValid(header.m_MeshletBoundsOffset, uint64(header.m_NumMeshlets) * sizeof(MeshletBounds), m_File.GetSize()) &&
+				   IsRangeValid(header.m_MeshletVertexIndicesOffset, header.m_MeshletVertexIndicesSize, m_File.GetSize()) &&
+				   IsRangeValid(header.m_MeshletTriangleIndicesOffset, header.m_MeshletTriangleIndicesSize, m_File.GetSize()) &&
+				   IsRangeValid(header.m_StringsOffset, header.m_StringsSize, m_File.GetSize());
+	}
+
+	// Finalize reads straight from the mapping, every range it uses must be in its section
+	if (is_valid)
+	{
+		const Header& header		= GetHeader();
+		const Object* objects		= GetObjects();
+		const SubMesh* sub_meshes	= GetSubMeshes();
+		const LOD* lods				= GetLODs();
+		const Meshlet* meshlets		= GetMeshlets();
+
+		const uint32* meshlet_vertex_indices	= reinterpret_cast<const uint32*>(GetSection(header.m_MeshletVertexIndicesOffset));
+		const uint64 num_meshlet_vertex_indices	= header.m_MeshletVertexIndicesSize / sizeof(uint32);
+
+		for (uint32 i = 0; is_valid && i < header.m_NumObjects; i++)
+		{
+			const Object& object = objects[i];
+
+			const bool is_index_format_valid = object.m_IndexFormat == DXGI_FORMAT_R16_UINT || object.m_IndexFormat == DXGI_FORMAT_R32_UINT;
+			const uint64 index_size = (object.m_IndexFormat == DXGI_FORMAT_R32_UINT) ? sizeof(uint32) : sizeof(uint16);
+
+			is_valid = is_index_format_valid &&
+					   IsRangeValid(object.m_VertexOffset, uint64(object.m_NumVertices) * header.m_VertexStride, header.m_VertexDataSize) &&
+					   IsRangeValid(object.m_CompressedVertexOffset, uint64(object.m_NumVertices) * header.m_CompressedVertexStride, header.m_CompressedVertexDataSize) &&
+					   IsRangeValid(object.m_IndexOffset, uint64(object.m_NumIndices) * index_size, header.m_IndexDataSize) &&
+					   IsRangeValid(object.m_NameOffset, object.m_NameLength, header.m_StringsSize) &&
+					   object.m_NumSubMeshes > 0 && IsRangeValid(object.m_FirstSubMesh, object.m_NumSubMeshes, header.m_NumSubMeshes);
+
+			for (uint32 s = 0; is_valid && s < object.m_NumSubMeshes; s++)
+			{
+				const SubMesh& sub_mesh = sub_meshes[object.m_FirstSubMesh + s];
+				is_valid = IsRangeValid(sub_mesh.m_MaterialNameOffset, sub_mesh.m_MaterialNameLength, header.m_StringsSize) &&
+						   sub_mesh.m_NumLODs > 0 && IsRangeValid(sub_mesh.m_FirstLOD, sub_mesh.m_NumLODs, header.m_NumLODs);
+
+				for (uint32 l = 0; is_valid && l < sub_mesh.m_NumLODs; l++)
+				{
+					const LOD& lod = lods[sub_mesh.m_FirstLOD + l];
+					is_valid = IsRangeValid(lod.m_StartIndex, lod.m_NumIndices, object.m_NumIndices);
+				}
+
+				// Meshlets index the vertices of this object
+				is_valid = is_valid && IsRangeValid(sub_mesh.m_FirstMeshlet, sub_mesh.m_NumMeshlets, header.m_NumMeshlets);
+				for (uint32 m = 0; is_valid && m < sub_mesh.m_NumMeshlets; m++)
+				{
+					const Meshlet& meshlet = meshlets[sub_mesh.m_FirstMeshlet + m];
+					is_valid = meshlet.m_NumVertices <= Meshlets::MaxVertices && meshlet.m_NumTriangles <= Meshlets::MaxTriangles &&
+							   IsRangeValid(meshlet.m_VertexOffset, meshlet.m_NumVertices, num_meshlet_vertex_indices) &&
+							   IsRangeValid(meshlet.m_TriangleOffset, uint64(meshlet.m_NumTriangles) * 3, header.m_MeshletTriangleIndicesSize);
+
+					for (uint32 v = 0; is_valid && v < meshlet.m_NumVertices; v++)
+						is_valid = meshlet_vertex_indices[meshlet.m_VertexOffset + v] < object.m_NumVertices;
+				}
+			}
+		}
+	}
+
+	if (!is_valid)
+	{
+		Trace("BakedMesh: %s is invalid or was baked with another version", inFile.c_str());
+		m_File.Close();
+	}
+
+	return is_valid;
+}
+
+const Header& BakedMesh::GetHeader() const
+{
+	return *reinterpret_cast<const Header*>(m_File.GetData());
+}
+
+const Object* BakedMesh::GetObjects() const
+{
+	return reinterpret_cast<const Object*>(GetSection(GetHeader().m_ObjectsOffset));
+}
+
+const SubMesh* BakedMesh::GetSubMeshes() const
+{
+	return reinterpret_cast<const SubMesh*>(GetSection(GetHeader().m_SubMeshesOffset));
+}
+
+const LOD* BakedMesh::GetLODs() const
+{
+	return reinterpret_cast<const LOD*>(GetSection(GetHeader().m_LODsOffset));
+}
+
+const Meshlet* BakedMesh::GetMeshlets() const
+{
+	return reinterpret_cast<const Meshlet*>(GetSection(GetHeader().m_MeshletsOffset));
+}
+
+const MeshletBounds* BakedMesh::GetMeshletBounds() const
+{
+	return reinterpret_cast<const MeshletBounds*>(GetSection(GetHeader().m_MeshletBoundsOffset));
+}
+
+const Byte* BakedMesh::GetSection(uint64 inOffset) const
+{
+	return static_cast<const Byte*>(m_File.GetData()) + inOffset;
+}
+
+std::string BakedMesh::GetString(uint32 inOffset, uint32 inLength) const
+{
+	const Header& header = GetHeader();
+	Assert(inOffset + inLength <= header.m_StringsSize);
+
+	return std::string(reinterpret_cast<const char*>(GetSection(header.m_StringsOffset)) + inOffset, inLength);
+}
@@ -0,0 +1,145 @@
+#pragma once
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "Gfx/Meshlet.h"
+#include "Gfx/RenderPass.h"
+#include "Utils/MappedFile.h"
+
+class AssetCacheKey;
+class DrawableObject;
+class MeshLoader;
+class ShaderObject;
+struct MeshImportSettings;
+
+// Layout of baked mesh files (.amesh).
+// Everything is stored exactly as it gets uploaded to the GPU so the file can be mapped and used without any parsing.
+// Sections are aligned on BakedMeshFormat::Alignment bytes from the start of the file.
+namespace BakedMeshFormat
+{
+	constexpr uint32 Magic		= 0x48534D41; // "AMSH"
+	constexpr uint32 Version	= 6;
+	constexpr uint32 Alignment	= 16;
+
+	enum SubMeshFlags : uint32
+	{
+		Transparent = 1 << 0,
+	};
+
+	struct Header
+	{
+		uint32	m_Magic;
+		uint32	m_Version;
+		uint32	m_NumObjects;
+		uint32	m_NumSubMeshes;
+		uint32	m_NumLODs;
+		uint32	m_VertexStride;
+		uint32	m_CompressedVertexFormat;	// VertexCompressionMode, None when the file has no compressed vertices
+		uint32	m_CompressedVertexStride;
+		uint32	m_NumMeshlets;				// 0 when the mesh was imported without MeshImportSettings::m_BuildMeshlets
+		uint32	m_Padding;
+
+		uint64	m_ObjectsOffset;
+		uint64	m_SubMeshesOffset;
+		uint64	m_LODsOffset;
+		uint64	m_VertexDataOffset;
+		uint64	m_VertexDataSize;
+		uint64	m_CompressedVertexDataOffset;	// Same vertices in the same order as the vertex data
+		uint64	m_CompressedVertexDataSize;
+		uint64	m_IndexDataOffset;
+		uint64	m_IndexDataSize;
+		uint64	m_MeshletsOffset;					// Meshlet, offsets are relative to the meshlet vertex and triangle sections
+		uint64	m_MeshletBoundsOffset;				// MeshletBounds, one per meshlet, in object space
+		uint64	m_MeshletVertexIndicesOffset;		// uint32, relative to the vertices of the Object
+		uint64	m_MeshletVertexIndicesSize;
+		uint64	m_MeshletTriangleIndicesOffset;		// uint8, relative to the vertices of the Meshlet
+		uint64	m_MeshletTriangleIndicesSize;
+		uint64	m_StringsOffset;
+		uint64	m_StringsSize;
+	};
+
+	// Index range of a level of detail. Start index is relative to the indices of the Object
+	struct LOD
+	{
+		uint32	m_StartIndex;
+		uint32	m_NumIndices;
+		float	m_Error;
+	};
+
+	// Part of an Object drawn with a single material. LOD 0 is the full resolution
+	struct SubMesh
+	{
+		uint32	m_FirstLOD;
+		uint32	m_NumLODs;
+
+		// Meshlets of LOD 0, in the same triangle order
+		uint32	m_FirstMeshlet;
+		uint32	m_NumMeshlets;
+
+		uint32	m_MaterialNameOffset;
+		uint32	m_MaterialNameLength;
+
+		uint32	m_Flags;			// SubMeshFlags
+
+		// Object space bounds of LOD 0
+		float	m_AABBMin[3];
+		float	m_AABBMax[3];
+		float	m_SphereCenter[3];
+		float	m_SphereRadius;
+	};
+
+	// One vertex buffer and one index buffer shared by all its submeshes
+	struct Object
+	{
+		// Offsets are relative to the start of their section
+		uint64	m_VertexOffset;
+		uint64	m_CompressedVertexOffset;
+		uint64	m_IndexOffset;
+		uint32	m_NumVertices;
+		uint32	m_NumIndices;		// All submeshes and LODs included
+		uint32	m_IndexFormat;		// DXGI_FORMAT
+
+		uint32	m_FirstSubMesh;
+		uint32	m_NumSubMeshes;
+
+		uint32	m_NameOffset;
+		uint32	m_NameLength;
+
+		// Decoded position = center + position * extents. Only set with VertexCompressionMode::Quantized
+		float	m_QuantizationCenter[3];
+		float	m_QuantizationExtents[3];
+
+		uint32	m_Padding;
+	};
+}
+
+class BakedMesh final
+{
+public:
+	// Write the result of a MeshLoader to disk. Must be called before MeshLoader::Finalize
+	static bool	Bake(const MeshLoader& inMeshLoader, const std::string& inFile);
+	// Add what the baked file depends on to its AssetCache key, created with BakedMeshFormat::Version:
+	// the OBJ file, its material libraries, the import settings and the loader version.
+	// Returns false if a source file can't be read
+	static bool	AddToCacheKey(const std::string& inFile, const MeshImportSettings& inSettings, AssetCacheKey& ioKey);
+
+	bool		LoadFromFile(const std::string& inFile);
+	// In MeshFinalize.cpp, with the rest of the renderer dependencies
+	void		Finalize(ID3D12GraphicsCommandList2& inCommandList,
+						 const std::map<std::string, ShaderObject*>& inShaderObjects, std::vector<DrawableObject*>& ioDrawableObjects);
+
+	// Sections of the loaded file, valid until Finalize
+	const BakedMeshFormat::Header&	GetHeader() const;
+	const BakedMeshFormat::Object*	GetObjects() const;
+	const BakedMeshFormat::SubMesh*	GetSubMeshes() const;
+	const BakedMeshFormat::LOD*		GetLODs() const;
+	const Meshlet*					GetMeshlets() const;
+	const MeshletBounds*			GetMeshletBounds() const;
+	const Byte*						GetSection(uint64 inOffset) const;
+	std::string						GetString(uint32 inOffset, uint32 inLength) const;
+
+private:
+	MappedFile	m_File;
+};
@@ -0,0 +1,42 @@
+#pragma once
+
+#include "DX12/DX12Includes.h"
+
+// Commands used to build a frame, in the shape of ID3D12GraphicsCommandList2.
+// DX12CommandList forwards them to D3D12. RecordingCommandList checks and stores them without a device,
+// so frame building can run and be measured headless.
+// Uploads and resource creation still use the D3D12 command list directly
+class CommandList
+{
+public:
+	virtual ~CommandList() = default;
+
+	virtual void	ResourceBarrier(uint32 inNumBarriers, const D3D12_RESOURCE_BARRIER* inBarriers) = 0;
+
+	virtual void	SetDescriptorHeaps(uint32 inNumHeaps, ID3D12DescriptorHeap* const* inHeaps) = 0;
+	virtual void	SetGraphicsRootSignature(ID3D12RootSignature* inRootSignature) = 0;
+	virtual void	SetPipelineState(ID3D12PipelineState* inPipelineState) = 0;
+	virtual void	SetGraphicsRootDescriptorTable(uint32 inRootParameterIndex, D3D12_GPU_DESCRIPTOR_HANDLE inBaseDescriptor) = 0;
+	virtual void	SetGraphicsRootConstantBufferView(uint32 inRootParameterIndex, D3D12_GPU_VIRTUAL_ADDRESS inBufferLocation) = 0;
+
+	virtual void	IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY inTopology) = 0;
+	virtual void	IASetVertexBuffers(uint32 inStartSlot, uint32 inNumViews, const D3D12_VERTEX_BUFFER_VIEW* inViews) = 0;
+	virtual void	IASetIndexBuffer(const D3D12_INDEX_BUFFER_VIEW* inView) = 0;
+
+	virtual void	RSSetViewports(uint32 inNumViewports, const D3D12_VIEWPORT* inViewports) = 0;
+	virtual void	RSSetScissorRects(uint32 inNumRects, const D3D12_RECT* inRects) = 0;
+	virtual void	OMSetRenderTargets(uint32 inNumRenderTargets, const D3D12_CPU_DESCRIPTOR_HANDLE* inRenderTargets,
+									   bool inSingleHandleToDescriptorRange, const D3D12_CPU_DESCRIPTOR_HANDLE* inDepthStencil) = 0;
+
+	virtual void	ClearRenderTargetView(D3D12_CPU_DESCRIPTOR_HANDLE inRenderTarget, const float inColor[4]) = 0;
+	virtual void	ClearDepthStencilView(D3D12_CPU_DESCRIPTOR_HANDLE inDepthStencil, D3D12_CLEAR_FLAGS inFlags, float inDepth, uint8 inStencil) = 0;
+
+	virtual void	DrawInstanced(uint32 inVertexCountPerInstance, uint32 inInstanceCount, uint32 inStartVertex, uint32 inStartInstance) = 0;
+	virtual void	DrawIndexedInstanced(uint32 inIndexCountPerInstance, uint32 inInstanceCount, uint32 inStartIndex, int32 inBaseVertex, uint32 inStartInstance) = 0;
+
+	// Shader visible descriptors, allocated for the frame being recorded.
+	// Copy of an existing descriptor
+	virtual D3D12_GPU_DESCRIPTOR_HANDLE	CopyDescriptor(D3D12_CPU_DESCRIPTOR_HANDLE inDescriptor) = 0;
+	// Default view of the whole resource
+	virtual D3D12_GPU_DESCRIPTOR_HANDLE	CreateShaderResourceView(ID3D12Resource* inResource) = 0;
+};
@@ -0,0 +1,42 @@
+#include "Engine.h"
+#include "DrawKey.h"
+
+#include <cstring>
+
+namespace DrawKey
+{
+	constexpr uint64 PipelineMask	= (1ull << PipelineBits) - 1;
+	constexpr uint64 MaterialMask	= (1ull << MaterialBits) - 1;
+	constexpr uint64 GeometryMask	= (1ull << GeometryBits) - 1;
+	constexpr uint64 DepthMask		= (1ull << DepthBits) - 1;
+
+	constexpr uint32 StateBits		= PipelineBits + MaterialBits + GeometryBits;
+
+	uint32 QuantizeDepth(float inDepth)
+	{
+		// Positive floats compare like their bits. NaN fails the test too
+		if (!(inDepth > 0.0f))
+			return 0;
+
+		uint32 bits;
+		::memcpy(&bits, &inDepth, sizeof(bits));
+
+		// The sign bit is 0, keep the DepthBits bits below it
+		return bits >> (31 - DepthBits);
+	}
+
+	uint64 Make(RenderPass inPass, uint32 inPipelineID, uint32 inMaterialID, uint32 inGeometryID, float inDepth)
+	{
+		const uint64 pass	= static_cast<uint64>(inPass) << (64 - PassBits);
+		const uint64 depth	= QuantizeDepth(inDepth);
+		const uint64 state	= ((inPipelineID & PipelineMask) << (MaterialBits + GeometryBits)) |
+							  ((inMaterialID & MaterialMask) << GeometryBits) |
+							  (inGeometryID & GeometryMask);
+
+		// Blended draws must be back to front whatever the cost in state changes
+		if (inPass == RenderPass::Transparent)
+			return pass | ((DepthMask - depth) << StateBits) | state;
+
+		return pass | (state << DepthBits) | depth;
+	}
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include "Gfx/RenderPass.h"
+
+// 64 bit sort key of a draw. Sorting the keys as integers gives the submission order, fields from the highest bits:
+//   Opaque:		pass | pipeline | material | geometry | depth				State changes first, then front to back
+//   Transparent:	pass | inverted depth | pipeline | material | geometry	Back to front, then state changes
+// IDs wider than their field are truncated, which only costs sorting quality
+namespace DrawKey
+{
+	constexpr uint32 PassBits		= 2;
+	constexpr uint32 PipelineBits	= 12;
+	constexpr uint32 MaterialBits	= 12;
+	constexpr uint32 GeometryBits	= 16;
+	constexpr uint32 DepthBits		= 22;
+	static_assert(PassBits + PipelineBits + MaterialBits + GeometryBits + DepthBits == 64, "Fields must fill the key");
+	static_assert(RenderPass::Count <= (1u << PassBits), "Not enough bits for the render passes");
+
+	// Nearer is smaller. Keeps the exponent and the top of the mantissa, so precision follows the distance.
+	// Negative depths are clamped to 0
+	uint32			QuantizeDepth(float inDepth);
+
+	uint64			Make(RenderPass inPass, uint32 inPipelineID, uint32 inMaterialID, uint32 inGeometryID, float inDepth);
+	inline RenderPass	GetPass(uint64 inKey)	{ return static_cast<RenderPass>(inKey >> (64 - PassBits)); }
+}
@@ -0,0 +1,80 @@
+#include "Engine.h"
+#include "DrawQueue.h"
+
+#include "Gfx/CommandList.h"
+#include "Gfx/DrawableObject.h"
+#include "Gfx/Mesh.h"
+#include "Gfx/ShaderObject.h"
+
+#include "Utils/RadixSort.h"
+
+void DrawQueue::Reset()
+{
+	m_Keys.clear();
+	m_PacketIndices.clear();
+	m_Packets.clear();
+	m_IsSorted = true;
+}
+
+void DrawQueue::Reserve(size_t inNumDraws)
+{
+	m_Keys.reserve(inNumDraws);
+	m_PacketIndices.reserve(inNumDraws);
+	m_Packets.reserve(inNumDraws);
+}
+
+void DrawQueue::Add(uint64 inKey, const DrawPacket& inPacket)
+{
+	m_PacketIndices.push_back(static_cast<uint32>(m_Packets.size()));
+	m_Keys.push_back(inKey);
+	m_Packets.push_back(inPacket);
+	m_IsSorted = false;
+}
+
+void DrawQueue::Add(const DrawableObject& inObject, float inDepth, uint32 inMaterialID/* = 0*/, uint32 inUserData/* = 0*/)
+{
+	const ShaderObject* shader_object	= inObject.GetShaderObject();
+	const Mesh& mesh					= inObject.GetMesh();
+	const MeshLOD& lod					= mesh.GetLOD(inObject.GetSubMesh(), inObject.GetLOD());
+
+	DrawPacket packet;
+	packet.m_ShaderObject	= shader_object;
+	packet.m_Mesh			= &mesh;
+	packet.m_StartIndex		= mesh.GetStartIndex() + lod.m_StartIndex;
+	packet.m_NumIndices		= lod.m_NumIndices;
+	packet.m_BaseVertex		= mesh.GetBaseVertex();
+	packet.m_UserData		= inUserData;
+
+	Add(DrawKey::Make(shader_object->GetRenderPass(), shader_object->GetID(), inMaterialID, mesh.GetGeometryID(), inDepth), packet);
+}
+
+void DrawQueue::Sort()
+{
+	if (m_IsSorted)
+		return;
+
+	m_TempKeys.resize(m_Keys.size());
+	m_TempPacketIndices.resize(m_PacketIndices.size());
+
+	RadixSort::Sort(m_Keys.data(), m_PacketIndices.data(), m_Keys.size(), m_TempKeys.data(), m_TempPacketIndices.data());
+
+	m_IsSorted = true;
+}
+
+void DrawQueue::Submit(CommandList& inCommandList, const SetupBindingsFunction& inSetupBindings) const
+{
+	Assert(m_IsSorted, "Sort the queue before submitting it");
+
+	for (uint32 packet_index : m_PacketIndices)
+	{
+		const DrawPacket& packet = m_Packets[packet_index];
+
+		packet.m_ShaderObject->Set(inCommandList);
+		packet.m_Mesh->Set(inCommandList);
+
+		if (inSetupBindings)
+			inSetupBindings(inCommandList, packet);
+
+		inCommandList.DrawIndexedInstanced(packet.m_NumIndices, 1, packet.m_StartIndex, packet.m_BaseVertex, 0);
+	}
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "Gfx/DrawKey.h"
+
+#include <functional>
+#include <vector>
+
+class CommandList;
+class DrawableObject;
+class Mesh;
+class ShaderObject;
+
+// What a draw needs, resolved when it's added so submission doesn't go back to the DrawableObject
+struct DrawPacket
+{
+	const ShaderObject*	m_ShaderObject	= nullptr;
+	const Mesh*			m_Mesh			= nullptr;
+	uint32				m_StartIndex	= 0;
+	uint32				m_NumIndices	= 0;
+	uint32				m_BaseVertex	= 0;
+	uint32				m_UserData		= 0;	// Free for the caller, e.g. an index into per draw data
+};
+
+// Draws of a frame, sorted by key then submitted in order. Replaces walking each object's draws pass by pass.
+// Reset at the start of every frame, memory is kept from one frame to the next
+class DrawQueue final
+{
+public:
+	// Called for every draw, after its shader and mesh are set and before the draw call. Binds what's left
+	using SetupBindingsFunction = std::function<void(CommandList&, const DrawPacket&)>;
+
+	void			Reset();
+	void			Reserve(size_t inNumDraws);
+
+	void			Add(uint64 inKey, const DrawPacket& inPacket);
+	// The current LOD of inObject, keyed with its shader, material and mesh. inDepth is the distance to the camera
+	void			Add(const DrawableObject& inObject, float inDepth, uint32 inMaterialID = 0, uint32 inUserData = 0);
+
+	// Radix sort of the keys. Large queues are sorted by the job system
+	void			Sort();
+
+	// Shader, mesh, inSetupBindings then the draw call, for every draw in sorted order
+	void			Submit(CommandList& inCommandList, const SetupBindingsFunction& inSetupBindings) const;
+
+	inline size_t	GetNumDraws() const						{ return m_Keys.size(); }
+	// In sorted order once Sort has been called, in the order they were added before
+	inline uint64				GetKey(size_t inIndex) const	{ return m_Keys[inIndex]; }
+	inline const DrawPacket&	GetPacket(size_t inIndex) const	{ return m_Packets[m_PacketIndices[inIndex]]; }
+
+private:
+	std::vector<uint64>			m_Keys;
+	std::vector<uint32>			m_PacketIndices;	// Sorted along with the keys
+	std::vector<DrawPacket>		m_Packets;			// In the order they were added
+
+	std::vector<uint64>			m_TempKeys;
+	std::vector<uint32>			m_TempPacketIndices;
+
+	bool						m_IsSorted			= true;
+};
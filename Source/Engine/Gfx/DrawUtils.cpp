@@ -1,10 +1,10 @@
 #include "Engine.h"
 #include "DrawUtils.h"
 
-#include "DX12/DX12CommandQueue.h"
 #include "DX12/DX12Device.h"
 #include "DX12/DX12RenderTarget.h"
 
+#include "Gfx/CommandList.h"
 #include "Gfx/Mesh.h"
 
 #include "Shaders/Include/Shaders.h"
@@ -171,21 +171,16 @@ void DrawUtils::Destroy()
 	s_RootSignature = nullptr;
 }
 
-void SetupBindings(ID3D12GraphicsCommandList2& inCommandList, DX12RenderTarget& inRenderTarget)
+void SetupBindings(CommandList& inCommandList, DX12RenderTarget& inRenderTarget)
 {
-	// TODO: This is whack
-	auto& descriptor_heap = g_RenderingDevice.GetCommandQueue(D3D12_COMMAND_LIST_TYPE_DIRECT).GetDescriptorHeap();
-	uint32 descriptor_index = descriptor_heap.Allocate();
-	D3D12_CPU_DESCRIPTOR_HANDLE descriptor_handle = descriptor_heap.GetCPUHandle(descriptor_index);
-
 	// Create temporary SRV of the render target
-	g_RenderingDevice.GetD3DDevice().CreateShaderResourceView(inRenderTarget.GetResource(), nullptr, descriptor_handle);
+	D3D12_GPU_DESCRIPTOR_HANDLE descriptor_handle = inCommandList.CreateShaderResourceView(inRenderTarget.GetResource());
 
 	// Set slot 0 of our root signature to point to our descriptor heap with the texture SRV
-	inCommandList.SetGraphicsRootDescriptorTable(0, descriptor_heap.GetGPUHandle(descriptor_index));
+	inCommandList.SetGraphicsRootDescriptorTable(0, descriptor_handle);
 }
 
-void DrawUtils::DrawFullScreenTriangle(ID3D12GraphicsCommandList2& inCommandList, DX12Resource& inTexture)
+void DrawUtils::DrawFullScreenTriangle(CommandList& inCommandList, DX12Resource& inTexture)
 {
 	DX12RenderTarget* render_target = dynamic_cast<DX12RenderTarget*>(&inTexture);
 	Assert(render_target != nullptr);
@@ -204,7 +199,7 @@ void DrawUtils::DrawFullScreenTriangle(ID3D12GraphicsCommandList2& inCommandList
 
 	SetupBindings(inCommandList, *render_target);
 
-	inCommandList.DrawInstanced(3, 1, 0, 0);
+	inCommandList.DrawInstanced(3, 1, s_FullScreenTriangle.GetBaseVertex(), 0);
 
 	// Transition from back to Render target
 	{
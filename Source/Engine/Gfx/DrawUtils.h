@@ -2,6 +2,7 @@
 
 #include "DX12/DX12Includes.h"
 
+class CommandList;
 class Mesh;
 class ShaderObject;
 class DX12Resource;
@@ -18,5 +19,5 @@ public:
 	static void Init(ID3D12GraphicsCommandList2& inCommandList);
 	static void Destroy();
 
-	static void DrawFullScreenTriangle(ID3D12GraphicsCommandList2& inCommandList, DX12Resource& inTexture);
+	static void DrawFullScreenTriangle(CommandList& inCommandList, DX12Resource& inTexture);
 };
\ No newline at end of file
@@ -3,32 +3,39 @@
 
 #include "DX12/DX12Includes.h"
 
+#include "Gfx/CommandList.h"
 #include "Gfx/Mesh.h"
 #include "Gfx/RenderPass.h"
 #include "Gfx/ShaderObject.h"
 
-DrawableObject::DrawableObject(Mesh* inMesh, const ShaderObject* inShaderObjet) :
+DrawableObject::DrawableObject(const std::shared_ptr<Mesh>& inMesh, uint32 inSubMesh, const ShaderObject* inShaderObjet) :
 	m_Mesh(inMesh),
+	m_SubMesh(inSubMesh),
 	m_Shader(inShaderObjet)
 {
 	Assert(m_Mesh != nullptr);
+	Assert(m_SubMesh < m_Mesh->GetNumSubMeshes());
 	Assert(m_Shader != nullptr);
-}
 
-DrawableObject::~DrawableObject()
-{
-	m_Mesh->Release();
-	delete m_Mesh;
+	const Mesh::SubMesh& sub_mesh = m_Mesh->GetSubMesh(m_SubMesh);
+	m_AABB				= sub_mesh.m_AABB;
+	m_BoundingSphere	= sub_mesh.m_BoundingSphere;
 }
 
-void DrawableObject::SetupBindings(ID3D12GraphicsCommandList2& inCommandList)
+void DrawableObject::SetupBindings(CommandList& inCommandList)
 {
 	m_Shader->Set(inCommandList);
 	m_Mesh->Set(inCommandList);
 }
 
-void DrawableObject::Render(ID3D12GraphicsCommandList2& inCommandList)
+void DrawableObject::Render(CommandList& inCommandList)
+{
+	const MeshLOD& lod = m_Mesh->GetLOD(m_SubMesh, m_LOD);
+	inCommandList.DrawIndexedInstanced(lod.m_NumIndices, 1, m_Mesh->GetStartIndex() + lod.m_StartIndex, m_Mesh->GetBaseVertex(), 0);
+}
+
+void DrawableObject::SelectLOD(float inMaxError)
 {
-	inCommandList.DrawIndexedInstanced(m_Mesh->GetNumIndices(), 1, 0, 0, 0);
+	m_LOD = m_Mesh->SelectLOD(m_SubMesh, inMaxError);
 }
 
@@ -1,21 +1,42 @@
 #pragma once
 
 #include "DX12/DX12Includes.h"
+#include "Math/BoundingVolumes.h"
 
+#include <memory>
+
+class CommandList;
 class Mesh;
 class ShaderObject;
 
 class DrawableObject final
 {
 public:
-	DrawableObject(Mesh* inMesh, const ShaderObject* inShaderObjet);
-	~DrawableObject();
+	DrawableObject(const std::shared_ptr<Mesh>& inMesh, uint32 inSubMesh, const ShaderObject* inShaderObjet);
+
+	void SetupBindings(CommandList& inCommandList);
+	void Render(CommandList& inCommandList);
+
+	// Pick the least detailed LOD of the submesh with an error below inMaxError
+	void SelectLOD(float inMaxError);
 
-	void SetupBindings(ID3D12GraphicsCommandList2& inCommandList);
-	void Render(ID3D12GraphicsCommandList2& inCommandList);
+	inline const ShaderObject*		GetShaderObject() const		{ return m_Shader; }
+	inline const Mesh&				GetMesh() const				{ return *m_Mesh; }
+	inline uint32					GetSubMesh() const			{ return m_SubMesh; }
+	inline uint32					GetLOD() const				{ return m_LOD; }
+
+	// Object space bounds of the submesh. Use BoundingVolumes::Transform to move them to world space
+	inline const AABB&				GetAABB() const				{ return m_AABB; }
+	inline const BoundingSphere&	GetBoundingSphere() const	{ return m_BoundingSphere; }
 
 private:
-	// TODO: The DrawableObject currently has ownership of the Mesh
-	Mesh*				m_Mesh		= nullptr;
-	const ShaderObject*	m_Shader	= nullptr;
+	// Every submesh of an object is a DrawableObject. They share the Mesh
+	std::shared_ptr<Mesh>	m_Mesh;
+	uint32					m_SubMesh	= 0;
+	const ShaderObject*		m_Shader	= nullptr;
+	uint32					m_LOD		= 0;
+
+	// Copied from the submesh so culling doesn't go through the Mesh
+	AABB					m_AABB;
+	BoundingSphere			m_BoundingSphere;
 };
\ No newline at end of file
@@ -1,6 +1,8 @@
 #include "Engine.h"
 #include "Gfx/GBuffer.h"
 
+#include "Gfx/CommandList.h"
+
 #include "DX12/DX12RenderTarget.h"
 #include "DX12/DX12DescriptorHeap.h"
 
@@ -52,7 +54,7 @@ void GBuffer::AllocateResources(uint32 inTargetWidth, uint32 inTargetHeight)
 		m_RenderTargets[i]->InitAsRenderTarget(m_Width, m_Height, DXGI_FORMAT_R8G8B8A8_UNORM);
 }
 
-void GBuffer::Set(ID3D12GraphicsCommandList2& inCommandList) const
+void GBuffer::Set(CommandList& inCommandList) const
 {
 	D3D12_CPU_DESCRIPTOR_HANDLE rtv_handles[D3D12_SIMULTANEOUS_RENDER_TARGET_COUNT];
 	for (uint32 i = 0; i < m_NumRenderTargets; ++i)
@@ -72,12 +74,12 @@ void GBuffer::Set(ID3D12GraphicsCommandList2& inCommandList) const
 	inCommandList.RSSetScissorRects(1, &scissor_rect);
 }
 
-void GBuffer::ClearDepthBuffer(ID3D12GraphicsCommandList2& inCommandList) const
+void GBuffer::ClearDepthBuffer(CommandList& inCommandList) const
 {
 	m_DepthBuffer->ClearBuffer(inCommandList);
 }
 
-void GBuffer::ClearRenderTargets(ID3D12GraphicsCommandList2& inCommandList) const
+void GBuffer::ClearRenderTargets(CommandList& inCommandList) const
 {
 	// TODO: Can we clear all targets at once?
 	for (uint32 i = 0; i < m_NumRenderTargets; ++i)
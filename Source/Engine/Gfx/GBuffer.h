@@ -2,6 +2,7 @@
 
 #include "DX12/DX12Includes.h"
 
+class CommandList;
 class DX12DepthBuffer;
 class DX12RenderTarget;
 
@@ -14,9 +15,9 @@ public:
 	void ReleaseResources();
 	void AllocateResources(uint32 inTargetWidth, uint32 inTargetHeight);
 	
-	void Set(ID3D12GraphicsCommandList2& inCommandList) const;
-	void ClearDepthBuffer(ID3D12GraphicsCommandList2& inCommandList) const;
-	void ClearRenderTargets(ID3D12GraphicsCommandList2& inCommandList) const;
+	void Set(CommandList& inCommandList) const;
+	void ClearDepthBuffer(CommandList& inCommandList) const;
+	void ClearRenderTargets(CommandList& inCommandList) const;
 
 	inline DX12DepthBuffer* GetDepthBuffer()					{ return m_DepthBuffer; }
 	inline DX12RenderTarget* GetRenderTarget(uint32 inIndex)	{ return m_RenderTargets[inIndex]; }
@@ -0,0 +1,243 @@
+#include "Engine.h"
+#include "GeometryPool.h"
+
+#include "DX12/DX12Device.h"
+#include "Gfx/CommandList.h"
+
+#include <string>
+
+GeometryPool g_GeometryPool;
+
+void GeometryPool::Release()
+{
+	for (Page& page : m_Pages)
+	{
+		Assert(page.m_Allocator.IsEmpty(), "Meshes must be released before the GeometryPool");
+		page.m_Resource->Release();
+	}
+	m_Pages.clear();
+
+	ReleaseUploadBuffers();
+}
+
+GeometryPool::Allocation GeometryPool::AllocateVertices(ID3D12GraphicsCommandList2& inCommandList, const void* inData, uint32 inNumVertices, uint32 inStride)
+{
+	return Allocate(inCommandList, inData, static_cast<uint64>(inNumVertices) * inStride, PageType::Vertex, inStride, DXGI_FORMAT_UNKNOWN);
+}
+
+GeometryPool::Allocation GeometryPool::AllocateIndices(ID3D12GraphicsCommandList2& inCommandList, const void* inData, uint32 inNumIndices, DXGI_FORMAT inFormat)
+{
+	Assert(inFormat == DXGI_FORMAT_R16_UINT || inFormat == DXGI_FORMAT_R32_UINT);
+
+	const uint32 index_size = (inFormat == DXGI_FORMAT_R32_UINT) ? sizeof(uint32) : sizeof(uint16);
+	return Allocate(inCommandList, inData, static_cast<uint64>(inNumIndices) * index_size, PageType::Index, index_size, inFormat);
+}
+
+GeometryPool::Allocation GeometryPool::Allocate(ID3D12GraphicsCommandList2& inCommandList, const void* inData, uint64 inSize,
+												PageType inType, uint32 inElementSize, DXGI_FORMAT inIndexFormat)
+{
+	Assert(inSize > 0 && inData != nullptr);
+
+	Allocation allocation;
+	allocation.m_Size = inSize;
+
+	// Ranges are aligned on the element size so they can be addressed with a base vertex or a start index
+	for (uint32 i = 0; i < static_cast<uint32>(m_Pages.size()) && !allocation.IsValid(); i++)
+	{
+		Page& page = m_Pages[i];
+		if (page.m_Type != inType || page.m_ElementSize != inElementSize)
+			continue;
+
+		const uint64 offset = page.m_Allocator.Allocate(inSize, inElementSize);
+		if (offset != RangeAllocator::InvalidOffset)
+		{
+			allocation.m_Page	= i;
+			allocation.m_Offset	= offset;
+		}
+	}
+
+	if (!allocation.IsValid())
+	{
+		allocation.m_Page	= CreatePage(inType, inElementSize, inIndexFormat, inSize);
+		allocation.m_Offset	= m_Pages[allocation.m_Page].m_Allocator.Allocate(inSize, inElementSize);
+		Assert(allocation.m_Offset != RangeAllocator::InvalidOffset);
+	}
+
+	Upload(inCommandList, m_Pages[allocation.m_Page], allocation.m_Offset, inData, inSize);
+
+	return allocation;
+}
+
+void GeometryPool::Free(const Allocation& inAllocation)
+{
+	Assert(inAllocation.IsValid() && inAllocation.m_Page < m_Pages.size());
+
+	// Empty pages are kept around, static meshes tend to be reloaded with similar sizes
+	m_Pages[inAllocation.m_Page].m_Allocator.Free(inAllocation.m_Offset, inAllocation.m_Size);
+}
+
+uint32 GeometryPool::CreatePage(PageType inType, uint32 inElementSize, DXGI_FORMAT inIndexFormat, uint64 inMinSize)
+{
+	// Each new page of a kind is twice as big as the previous one
+	uint64 page_size = MinPageSize;
+	for (const Page& page : m_Pages)
+	{
+		if (page.m_Type == inType && page.m_ElementSize == inElementSize)
+			page_size = Math::Min(Math::Max(page_size, page.m_Allocator.GetCapacity() * 2), MaxPageSize);
+	}
+	page_size = Math::Max(page_size, Math::AlignUp<uint64>(inMinSize, inElementSize));
+
+	Page page;
+	page.m_Type			= inType;
+	page.m_ElementSize	= inElementSize;
+	page.m_State		= D3D12_RESOURCE_STATE_COPY_DEST;
+	page.m_Allocator.Init(page_size);
+
+	D3D12_HEAP_PROPERTIES	heap_properties	= CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_DEFAULT);
+	D3D12_RESOURCE_DESC		resource_desc	= CD3DX12_RESOURCE_DESC::Buffer(page_size);
+
+	ThrowIfFailed(g_RenderingDevice.GetD3DDevice().CreateCommittedResource(
+		&heap_properties,
+		D3D12_HEAP_FLAG_NONE,
+		&resource_desc,
+		page.m_State,
+		nullptr,
+		IID_PPV_ARGS(&page.m_Resource)));
+
+	// Views cover the whole page
+	if (inType == PageType::Vertex)
+	{
+		page.m_VertexBufferView.BufferLocation	= page.m_Resource->GetGPUVirtualAddress();
+		page.m_VertexBufferView.SizeInBytes		= static_cast<uint32>(page_size);
+		page.m_VertexBufferView.StrideInBytes	= inElementSize;
+	}
+	else
+	{
+		page.m_IndexBufferView.BufferLocation	= page.m_Resource->GetGPUVirtualAddress();
+		page.m_IndexBufferView.SizeInBytes		= static_cast<uint32>(page_size);
+		page.m_IndexBufferView.Format			= inIndexFormat;
+	}
+
+	const uint32 page_index = static_cast<uint32>(m_Pages.size());
+
+	const std::string name = std::string("GeometryPool_") + (inType == PageType::Vertex ? "Vertices" : "Indices") + "_" +
+							 std::to_string(inElementSize) + "_" + std::to_string(page_index);
+	const std::wstring wide_name(name.begin(), name.end());
+	page.m_Resource->SetName(wide_name.c_str());
+
+	m_Pages.push_back(page);
+	return page_index;
+}
+
+void GeometryPool::Upload(ID3D12GraphicsCommandList2& inCommandList, Page& ioPage, uint64 inOffset, const void* inData, uint64 inSize)
+{
+	// Staging memory is sub-allocated linearly from large upload buffers
+	if (m_UploadPages.empty() || m_UploadPages.back().m_UsedSize + inSize > m_UploadPages.back().m_Size)
+	{
+		UploadPage upload_page;
+		upload_page.m_Size = Math::Max(UploadPageSize, inSize);
+
+		D3D12_HEAP_PROPERTIES	heap_properties	= CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD);
+		D3D12_RESOURCE_DESC		resource_desc	= CD3DX12_RESOURCE_DESC::Buffer(upload_page.m_Size);
+
+		ThrowIfFailed(g_RenderingDevice.GetD3DDevice().CreateCommittedResource(
+			&heap_properties,
+			D3D12_HEAP_FLAG_NONE,
+			&resource_desc,
+			D3D12_RESOURCE_STATE_GENERIC_READ,
+			nullptr,
+			IID_PPV_ARGS(&upload_page.m_Resource)));
+
+		upload_page.m_Resource->SetName(L"GeometryPool_Upload");
+
+		// Upload heaps can stay mapped
+		void* mapped_data = nullptr;
+		ThrowIfFailed(upload_page.m_Resource->Map(0, nullptr, &mapped_data));
+		upload_page.m_MappedData = static_cast<Byte*>(mapped_data);
+
+		m_UploadPages.push_back(upload_page);
+	}
+
+	UploadPage& upload_page = m_UploadPages.back();
+	::memcpy(upload_page.m_MappedData + upload_page.m_UsedSize, inData, inSize);
+
+	if (ioPage.m_State != D3D12_RESOURCE_STATE_COPY_DEST)
+	{
+		const CD3DX12_RESOURCE_BARRIER barrier = CD3DX12_RESOURCE_BARRIER::Transition(ioPage.m_Resource, ioPage.m_State, D3D12_RESOURCE_STATE_COPY_DEST);
+		inCommandList.ResourceBarrier(1, &barrier);
+	}
+
+	inCommandList.CopyBufferRegion(ioPage.m_Resource, inOffset, upload_page.m_Resource, upload_page.m_UsedSize, inSize);
+	upload_page.m_UsedSize += inSize;
+
+	// Pages go back to their read state right away so they can be drawn from in the same command list
+	ioPage.m_State = (ioPage.m_Type == PageType::Vertex) ? D3D12_RESOURCE_STATE_VERTEX_AND_CONSTANT_BUFFER : D3D12_RESOURCE_STATE_INDEX_BUFFER;
+
+	const CD3DX12_RESOURCE_BARRIER barrier = CD3DX12_RESOURCE_BARRIER::Transition(ioPage.m_Resource, D3D12_RESOURCE_STATE_COPY_DEST, ioPage.m_State);
+	inCommandList.ResourceBarrier(1, &barrier);
+}
+
+void GeometryPool::ReleaseUploadBuffers()
+{
+	for (UploadPage& upload_page : m_UploadPages)
+	{
+		upload_page.m_Resource->Unmap(0, nullptr);
+		upload_page.m_Resource->Release();
+	}
+	m_UploadPages.clear();
+}
+
+void GeometryPool::SetBuffers(CommandList& inCommandList, D3D_PRIMITIVE_TOPOLOGY inTopology, uint32 inVertexPage, uint32 inIndexPage) const
+{
+	inCommandList.IASetPrimitiveTopology(inTopology);
+
+	Assert(inVertexPage < m_Pages.size() && m_Pages[inVertexPage].m_Type == PageType::Vertex);
+	inCommandList.IASetVertexBuffers(0, 1, &m_Pages[inVertexPage].m_VertexBufferView);
+
+	// Non indexed meshes leave the current index buffer bound, it isn't used anyway
+	if (inIndexPage != InvalidPage)
+	{
+		Assert(inIndexPage < m_Pages.size() && m_Pages[inIndexPage].m_Type == PageType::Index);
+		inCommandList.IASetIndexBuffer(&m_Pages[inIndexPage].m_IndexBufferView);
+	}
+}
+
+uint32 GeometryPool::GetBaseVertex(const Allocation& inAllocation) const
+{
+	const Page& page = m_Pages[inAllocation.m_Page];
+	Assert(page.m_Type == PageType::Vertex);
+
+	return static_cast<uint32>(inAllocation.m_Offset / page.m_ElementSize);
+}
+
+uint32 GeometryPool::GetStartIndex(const Allocation& inAllocation) const
+{
+	const Page& page = m_Pages[inAllocation.m_Page];
+	Assert(page.m_Type == PageType::Index);
+
+	return static_cast<uint32>(inAllocation.m_Offset / page.m_ElementSize);
+}
+
+void GeometryPool::TraceStatistics() const
+{
+	uint64 capacity		= 0;
+	uint64 used_size	= 0;
+	for (const Page& page : m_Pages)
+	{
+		capacity	+= page.m_Allocator.GetCapacity();
+		used_size	+= page.m_Allocator.GetUsedSize();
+	}
+
+	Trace("GeometryPool: %zu pages, %.2f MB used out of %.2f MB", m_Pages.size(), used_size / (1024.0 * 1024.0), capacity / (1024.0 * 1024.0));
+
+	for (size_t i = 0; i < m_Pages.size(); i++)
+	{
+		const Page& page = m_Pages[i];
+		const RangeAllocator::Statistics statistics = page.m_Allocator.GetStatistics();
+
+		Trace("GeometryPool:   Page %zu (%s, %u bytes): %u allocations, %.2f/%.2f MB, %u free blocks, largest %.2f MB, fragmentation %.1f%%",
+			  i, page.m_Type == PageType::Vertex ? "vertices" : "indices", page.m_ElementSize, statistics.m_NumAllocations,
+			  statistics.m_UsedSize / (1024.0 * 1024.0), statistics.m_Capacity / (1024.0 * 1024.0),
+			  statistics.m_NumFreeBlocks, statistics.m_LargestFreeBlock / (1024.0 * 1024.0), 100.0f * statistics.GetFragmentation());
+	}
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#include "DX12/DX12Includes.h"
+#include "Utils/RangeAllocator.h"
+
+#include <vector>
+
+class CommandList;
+
+// Vertex and index data of static meshes, sub-allocated out of a few large buffers.
+// A page only holds one vertex stride or one index format so it is bound as a whole,
+// meshes are then drawn with a base vertex and a start index and consecutive draws don't need to rebind anything.
+class GeometryPool final
+{
+public:
+	static constexpr uint32 InvalidPage = ~0u;
+
+	// Pages start small and double up to MaxPageSize. Bigger allocations get a page of their own
+	static constexpr uint64 MinPageSize		= 1ull << 20;
+	static constexpr uint64 MaxPageSize		= 64ull << 20;
+	static constexpr uint64 UploadPageSize	= 4ull << 20;
+
+	struct Allocation
+	{
+		uint32	m_Page		= InvalidPage;
+		uint64	m_Offset	= 0;	// In bytes, from the start of the page
+		uint64	m_Size		= 0;
+
+		inline bool IsValid() const		{ return m_Page != InvalidPage; }
+	};
+
+public:
+	void		Release();
+
+	// Copy data to a new range of the pool. The copy is recorded in inCommandList
+	Allocation	AllocateVertices(ID3D12GraphicsCommandList2& inCommandList, const void* inData, uint32 inNumVertices, uint32 inStride);
+	Allocation	AllocateIndices(ID3D12GraphicsCommandList2& inCommandList, const void* inData, uint32 inNumIndices, DXGI_FORMAT inFormat);
+	void		Free(const Allocation& inAllocation);
+
+	// Upload buffers must stay alive until the command lists recording the copies have been executed
+	void		ReleaseUploadBuffers();
+
+	// Bind pages to the input assembler. Redundant calls are left to StateCacheCommandList
+	void		SetBuffers(CommandList& inCommandList, D3D_PRIMITIVE_TOPOLOGY inTopology, uint32 inVertexPage, uint32 inIndexPage) const;
+
+	// Position of an allocation in its page, in vertices or indices
+	uint32		GetBaseVertex(const Allocation& inAllocation) const;
+	uint32		GetStartIndex(const Allocation& inAllocation) const;
+
+	void		TraceStatistics() const;
+
+private:
+	enum class PageType
+	{
+		Vertex,
+		Index
+	};
+
+	struct Page
+	{
+		ID3D12Resource*				m_Resource		= nullptr;
+		RangeAllocator				m_Allocator;
+		PageType					m_Type			= PageType::Vertex;
+		uint32						m_ElementSize	= 0;		// Vertex stride or index size
+		D3D12_RESOURCE_STATES		m_State			= D3D12_RESOURCE_STATE_COPY_DEST;
+		D3D12_VERTEX_BUFFER_VIEW	m_VertexBufferView	= {};
+		D3D12_INDEX_BUFFER_VIEW		m_IndexBufferView	= {};
+	};
+
+	struct UploadPage
+	{
+		ID3D12Resource*		m_Resource		= nullptr;
+		Byte*				m_MappedData	= nullptr;
+		uint64				m_Size			= 0;
+		uint64				m_UsedSize		= 0;
+	};
+
+	Allocation	Allocate(ID3D12GraphicsCommandList2& inCommandList, const void* inData, uint64 inSize,
+						 PageType inType, uint32 inElementSize, DXGI_FORMAT inIndexFormat);
+	uint32		CreatePage(PageType inType, uint32 inElementSize, DXGI_FORMAT inIndexFormat, uint64 inMinSize);
+	void		Upload(ID3D12GraphicsCommandList2& inCommandList, Page& ioPage, uint64 inOffset, const void* inData, uint64 inSize);
+
+private:
+	std::vector<Page>			m_Pages;
+	std::vector<UploadPage>		m_UploadPages;
+};
+
+extern GeometryPool g_GeometryPool;
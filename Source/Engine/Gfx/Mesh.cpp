@@ -1,54 +1,91 @@
 #include "Engine.h"
 #include "Mesh.h"
 
+#include "DX12/DX12Resource.h"
+
+Mesh::~Mesh()
+{
+	Release();
+}
+
 void Mesh::Init(
 	ID3D12GraphicsCommandList2& inCommandList,
 	D3D_PRIMITIVE_TOPOLOGY inPrimitiveTopology,
-	void* inVertexBuffer, int32 inVertexBufferSize, int32 inStride,
-	void* inIndexBuffer/* = nullptr*/, int32 inIndexBufferSize/* = 0*/)
+	const void* inVertexBuffer, int32 inVertexBufferSize, int32 inStride,
+	const void* inIndexBuffer/* = nullptr*/, int32 inIndexBufferSize/* = 0*/, DXGI_FORMAT inIndexFormat/* = DXGI_FORMAT_R16_UINT*/)
 {
-	m_VertexBuffer = new DX12VertexBuffer;
-	m_VertexBuffer->InitAsVertexBuffer(inCommandList, inVertexBufferSize, inVertexBuffer, inStride);
+	Assert(m_Pool == nullptr);
+	Assert(inVertexBufferSize % inStride == 0);
+
+	// All static meshes live in the same pool
+	m_Pool = &g_GeometryPool;
+
+	m_VertexAllocation	= m_Pool->AllocateVertices(inCommandList, inVertexBuffer, inVertexBufferSize / inStride, inStride);
+	m_BaseVertex		= m_Pool->GetBaseVertex(m_VertexAllocation);
 
 	if (inIndexBuffer != nullptr)
 	{
-		m_IndexBuffer = new DX12IndexBuffer;
-		m_IndexBuffer->InitAsIndexBuffer(inCommandList, inIndexBufferSize, inIndexBuffer);
-		m_NumIndices = inIndexBufferSize / sizeof(uint16);
+		m_NumIndices		= inIndexBufferSize / DX12IndexBuffer::GetIndexSize(inIndexFormat);
+		m_IndexAllocation	= m_Pool->AllocateIndices(inCommandList, inIndexBuffer, m_NumIndices, inIndexFormat);
+		m_StartIndex		= m_Pool->GetStartIndex(m_IndexAllocation);
 	}
 
 	m_PrimitiveTopology = inPrimitiveTopology;
+
+	SubMesh sub_mesh;
+	sub_mesh.m_LODs.resize(1);
+	sub_mesh.m_LODs[0].m_NumIndices = m_NumIndices;
+	m_SubMeshes.assign(1, sub_mesh);
 }
 
-void Mesh::Release()
+void Mesh::SetSubMeshes(const std::vector<SubMesh>& inSubMeshes)
 {
-	m_VertexBuffer->Release();
-	delete m_VertexBuffer;
+	Assert(!inSubMeshes.empty());
 
-	if (m_IndexBuffer != nullptr)
+	for (const SubMesh& sub_mesh : inSubMeshes)
 	{
-		m_IndexBuffer->Release();
-		delete m_IndexBuffer;
+		Assert(!sub_mesh.m_LODs.empty());
+
+		for (const MeshLOD& lod : sub_mesh.m_LODs)
+			Assert(lod.m_StartIndex + lod.m_NumIndices <= m_NumIndices);
 	}
+
+	m_SubMeshes = inSubMeshes;
 }
 
-void Mesh::SetResourceName(const std::string& inName)
+uint32 Mesh::SelectLOD(uint32 inSubMesh, float inMaxError) const
 {
-	// TODO: Properly handle string and wstrings...
-	const std::wstring wide_str(inName.begin(), inName.end());
+	const std::vector<MeshLOD>& lods = m_SubMeshes[inSubMesh].m_LODs;
 
-	m_VertexBuffer->GetResource()->SetName((wide_str + L"_VertexBuffer").c_str());
+	uint32 selected_lod = 0;
+	for (uint32 i = 1; i < static_cast<uint32>(lods.size()); i++)
+	{
+		if (lods[i].m_Error > inMaxError)
+			break;
 
-	if (m_IndexBuffer != nullptr)
-		m_IndexBuffer->GetResource()->SetName((wide_str + L"_IndexBuffer").c_str());
+		selected_lod = i;
+	}
+
+	return selected_lod;
 }
 
-void Mesh::Set(ID3D12GraphicsCommandList2& inCommandList) const
+void Mesh::Release()
 {
-	inCommandList.IASetPrimitiveTopology(m_PrimitiveTopology);
+	if (m_Pool == nullptr)
+		return;
 
-	m_VertexBuffer->SetVertexBuffer(inCommandList, 0);
+	m_Pool->Free(m_VertexAllocation);
 
-	if (m_IndexBuffer != nullptr)
-		m_IndexBuffer->SetIndexBuffer(inCommandList);
+	if (m_IndexAllocation.IsValid())
+		m_Pool->Free(m_IndexAllocation);
+
+	m_Pool				= nullptr;
+	m_VertexAllocation	= GeometryPool::Allocation();
+	m_IndexAllocation	= GeometryPool::Allocation();
+}
+
+void Mesh::Set(CommandList& inCommandList) const
+{
+	// Meshes sharing pages bind the same views, the state cache drops them
+	m_Pool->SetBuffers(inCommandList, m_PrimitiveTopology, m_VertexAllocation.m_Page, m_IndexAllocation.m_Page);
 }
@@ -1,26 +1,69 @@
 #pragma once
 
-#include "DX12/DX12Resource.h"
+#include "Gfx/GeometryPool.h"
+#include "Math/BoundingVolumes.h"
 
+#include <vector>
+
+// Range of the index buffer to draw for a level of detail
+struct MeshLOD
+{
+	uint32	m_StartIndex	= 0;
+	uint32	m_NumIndices	= 0;
+	float	m_Error			= 0.0f;		// Object space distance to the full resolution mesh
+};
+
+// Handle to the vertices and indices of a mesh in the GeometryPool
 class Mesh final
 {
 public:
+	// Part of the index buffer drawn with a single material. All submeshes share the vertex buffer.
+	// LODs are sorted from the most to the least detailed. Bounds are in object space and cover the full resolution LOD
+	struct SubMesh
+	{
+		std::vector<MeshLOD>	m_LODs;
+		AABB					m_AABB;
+		BoundingSphere			m_BoundingSphere;
+	};
+
+public:
+	~Mesh();
+
 	void Init(
 		ID3D12GraphicsCommandList2& inCommandList,
 		D3D_PRIMITIVE_TOPOLOGY inPrimitiveTopology,
-		void* inVertexBuffer, int32 inVertexBufferSize, int32 inStride,
-		void* inIndexBuffer = nullptr, int32 inIndexBufferSize = 0);
+		const void* inVertexBuffer, int32 inVertexBufferSize, int32 inStride,
+		const void* inIndexBuffer = nullptr, int32 inIndexBufferSize = 0, DXGI_FORMAT inIndexFormat = DXGI_FORMAT_R16_UINT);
 
 	void	Release();
 
-	void	SetResourceName(const std::string& inName);
-
-	void			Set(ID3D12GraphicsCommandList2& inCommandList) const;
+	void			Set(CommandList& inCommandList) const;
 	inline uint32	GetNumIndices() const			{ return m_NumIndices; }
+	// Where the mesh starts in the buffers of the pool. Add to draw call arguments
+	inline uint32	GetBaseVertex() const			{ return m_BaseVertex; }
+	inline uint32	GetStartIndex() const			{ return m_StartIndex; }
+	// Same for meshes in the same vertex and index pages of the pool, they are drawn without rebinding buffers
+	inline uint32	GetGeometryID() const			{ return (m_VertexAllocation.m_Page << 8) | (m_IndexAllocation.m_Page & 0xff); }
+
+	// By default, a single submesh with a single LOD covers the whole index buffer
+	void					SetSubMeshes(const std::vector<SubMesh>& inSubMeshes);
+	inline uint32			GetNumSubMeshes() const								{ return static_cast<uint32>(m_SubMeshes.size()); }
+	inline uint32			GetNumLODs(uint32 inSubMesh) const					{ return static_cast<uint32>(m_SubMeshes[inSubMesh].m_LODs.size()); }
+	inline const MeshLOD&	GetLOD(uint32 inSubMesh, uint32 inLOD) const		{ return m_SubMeshes[inSubMesh].m_LODs[inLOD]; }
+	inline const SubMesh&	GetSubMesh(uint32 inSubMesh) const					{ return m_SubMeshes[inSubMesh]; }
+	// Least detailed LOD of inSubMesh with an error below inMaxError
+	uint32					SelectLOD(uint32 inSubMesh, float inMaxError) const;
+
+	// Smallest index format able to address inNumVertices vertices. 16 bit indices save memory and bandwidth
+	static inline DXGI_FORMAT	GetIndexFormat(uint32 inNumVertices)	{ return (inNumVertices <= (1u << 16)) ? DXGI_FORMAT_R16_UINT : DXGI_FORMAT_R32_UINT; }
 
 private:
-	DX12VertexBuffer*			m_VertexBuffer;
-	DX12IndexBuffer*			m_IndexBuffer;
+	GeometryPool*				m_Pool				= nullptr;
+	GeometryPool::Allocation	m_VertexAllocation;
+	GeometryPool::Allocation	m_IndexAllocation;
+	uint32						m_BaseVertex		= 0;
+	uint32						m_StartIndex		= 0;
 	uint32						m_NumIndices		= 0;
+	std::vector<SubMesh>		m_SubMeshes;
 	D3D_PRIMITIVE_TOPOLOGY		m_PrimitiveTopology = D3D_PRIMITIVE_TOPOLOGY_UNDEFINED;
 };
\ No newline at end of file
@@ -0,0 +1,65 @@
+#include "Engine.h"
+#include "MeshAsset.h"
+
+#include <chrono>
+
+#include "Gfx/BakedMesh.h"
+#include "Gfx/DrawableObject.h"
+#include "Gfx/MeshLoader.h"
+
+#include "Utils/AssetCache.h"
+
+MeshAsset::MeshAsset() = default;
+
+MeshAsset::~MeshAsset()
+{
+	for (DrawableObject* d : m_DrawableObjects)
+		delete d;
+}
+
+bool MeshAsset::Load(const AssetFile&)
+{
+	const auto start_time = std::chrono::high_resolution_clock::now();
+
+	const MeshImportSettings import_settings;
+
+	// Fails when the OBJ file or one of its material libraries is missing
+	AssetCacheKey cache_key("BakedMesh", BakedMeshFormat::Version);
+	if (!BakedMesh::AddToCacheKey(GetPath(), import_settings, cache_key))
+		return false;
+
+	m_BakedMesh = std::make_unique<BakedMesh>();
+	const bool baked_mesh_loaded = m_BakedMesh->LoadFromFile(g_AssetCache.GetPath(cache_key, ".amesh"));
+	if (!baked_mesh_loaded)
+	{
+		m_BakedMesh.reset();
+
+		m_MeshLoader = std::make_unique<MeshLoader>(import_settings);
+		m_MeshLoader->LoadFromFile(GetPath());
+
+		// The OBJ is loaded already, a read-only or full cache only means it's parsed again next time
+		const bool success = g_AssetCache.Store(cache_key, ".amesh",
+												[this](const std::string& inBakedFile) { return BakedMesh::Bake(*m_MeshLoader, inBakedFile); });
+		if (!success)
+			Trace("MeshAsset: Can't store the baked version of %s", GetPath().c_str());
+	}
+
+	const std::chrono::duration<double> elapsed = std::chrono::high_resolution_clock::now() - start_time;
+	Trace("MeshAsset: %s loaded from %s in %.2f ms", GetPath().c_str(), baked_mesh_loaded ? "baked file" : "OBJ", elapsed.count() * 1000.0);
+
+	return true;
+}
+
+bool MeshAsset::Upload(const AssetUploadContext& inContext)
+{
+	if (m_BakedMesh != nullptr)
+		m_BakedMesh->Finalize(*inContext.m_CommandList, *inContext.m_ShaderObjects, m_DrawableObjects);
+	else
+		m_MeshLoader->Finalize(*inContext.m_CommandList, *inContext.m_ShaderObjects, m_DrawableObjects);
+
+	// Everything has been copied to the geometry pool upload buffers
+	m_BakedMesh.reset();
+	m_MeshLoader.reset();
+
+	return true;
+}
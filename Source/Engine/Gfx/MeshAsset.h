@@ -0,0 +1,36 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "Gfx/AssetManager.h"
+
+class BakedMesh;
+class DrawableObject;
+class MeshLoader;
+
+// OBJ file loaded through the AssetManager. The baked version is used when the AssetCache has it,
+// otherwise the OBJ file is parsed and baked for the next run
+class MeshAsset final : public Asset
+{
+public:
+	static constexpr const char* TypeName = "Mesh";
+
+	MeshAsset();
+	~MeshAsset() override;
+
+	// One DrawableObject per submesh, owned by the asset
+	inline const std::vector<DrawableObject*>&	GetDrawableObjects() const	{ return m_DrawableObjects; }
+
+protected:
+	// Maps the baked file or the OBJ itself, the OBJ also needs its material libraries
+	bool	Load(const AssetFile& inFile) override;
+	bool	Upload(const AssetUploadContext& inContext) override;
+
+private:
+	// Only one of them is loaded, until Upload
+	std::unique_ptr<BakedMesh>	m_BakedMesh;
+	std::unique_ptr<MeshLoader>	m_MeshLoader;
+
+	std::vector<DrawableObject*>	m_DrawableObjects;
+};
@@ -0,0 +1,180 @@
+#include "Engine.h"
+
+#include "DX12/DX12Resource.h"
+
+#include "Gfx/BakedMesh.h"
+#include "Gfx/DrawableObject.h"
+#include "Gfx/MeshLoader.h"
+#include "Gfx/ShaderObject.h"
+
+// Upload of loaded and baked meshes, and creation of their DrawableObjects.
+// Apart from the loaders so the tools can load, process and bake meshes without the renderer
+
+// Final step of loading OBJ files
+// Create materials, create meshes, create Drawable objects
+void MeshLoader::Finalize(ID3D12GraphicsCommandList2& inCommandList,
+						  const std::map<std::string, ShaderObject*>& inShaderObjects, std::vector<DrawableObject*>& ioDrawableObjects)
+{
+	Assert(m_VertexData.size() > 0);
+
+	size_t num_meshes		= 0;
+	size_t num_drawables	= 0;
+
+	for (size_t i = 0; i <= m_CurrentMeshInfo; i++)
+	{
+		MeshInfo* mesh_info = m_MeshInfos[i];
+
+		const Range vertex_range	= mesh_info->m_VertexBuffeRange;
+		const Range index_range		= mesh_info->m_IndexBufferRange;
+
+		const uint32 num_vertices	= static_cast<uint32>(vertex_range.m_End	- vertex_range.m_Start);
+		const uint32 num_indices	= static_cast<uint32>(index_range.m_End		- index_range.m_Start);
+
+		// Objects without any triangle have nothing to draw
+		if (num_indices == 0)
+		{
+			delete mesh_info;
+			continue;
+		}
+
+		const DXGI_FORMAT index_format = Mesh::GetIndexFormat(num_vertices);
+
+		// One index buffer for the whole object: full resolution indices of all submeshes, then LODs of each submesh
+		std::vector<uint32> indices(m_IndexData.begin() + index_range.m_Start, m_IndexData.begin() + index_range.m_End);
+		std::vector<Mesh::SubMesh> sub_meshes(mesh_info->m_SubMeshes.size());
+
+		for (size_t s = 0; s < mesh_info->m_SubMeshes.size(); s++)
+		{
+			const SubMeshInfo& sub_mesh_info = mesh_info->m_SubMeshes[s];
+
+			sub_meshes[s].m_AABB			= sub_mesh_info.m_AABB;
+			sub_meshes[s].m_BoundingSphere	= sub_mesh_info.m_BoundingSphere;
+
+			MeshLOD lod;
+			lod.m_StartIndex	= static_cast<uint32>(sub_mesh_info.m_IndexBufferRange.m_Start - index_range.m_Start);
+			lod.m_NumIndices	= static_cast<uint32>(sub_mesh_info.m_IndexBufferRange.m_End - sub_mesh_info.m_IndexBufferRange.m_Start);
+			sub_meshes[s].m_LODs.push_back(lod);
+
+			for (const LODInfo& lod_info : sub_mesh_info.m_LODs)
+			{
+				lod.m_StartIndex	= static_cast<uint32>(indices.size());
+				lod.m_NumIndices	= static_cast<uint32>(lod_info.m_IndexBufferRange.m_End - lod_info.m_IndexBufferRange.m_Start);
+				lod.m_Error			= lod_info.m_Error;
+				sub_meshes[s].m_LODs.push_back(lod);
+
+				indices.insert(indices.end(),
+							   m_LODIndexData.begin() + lod_info.m_IndexBufferRange.m_Start,
+							   m_LODIndexData.begin() + lod_info.m_IndexBufferRange.m_End);
+			}
+		}
+
+		uint32 vertex_size			= num_vertices * sizeof(VertexPosUVNormal);
+		uint32 index_size			= static_cast<uint32>(indices.size()) * DX12IndexBuffer::GetIndexSize(index_format);
+		const void* index_data		= indices.data();
+
+		// Indices are stored as 32 bits. Narrow them down if the mesh is small enough
+		std::vector<uint16> index_data_16;
+		if (index_format == DXGI_FORMAT_R16_UINT)
+		{
+			index_data_16.assign(indices.begin(), indices.end());
+			index_data = index_data_16.data();
+		}
+
+		std::shared_ptr<Mesh> mesh = std::make_shared<Mesh>();
+		mesh->Init(inCommandList,
+				   D3D_PRIMITIVE_TOPOLOGY::D3D10_PRIMITIVE_TOPOLOGY_TRIANGLELIST,
+				   m_VertexData.data() + vertex_range.m_Start, vertex_size, sizeof(VertexPosUVNormal),
+				   index_data, index_size, index_format);
+		mesh->SetSubMeshes(sub_meshes);
+
+		// One DrawableObject per submesh, drawn with the shader of its material
+		for (size_t s = 0; s < mesh_info->m_SubMeshes.size(); s++)
+		{
+			const SubMeshInfo& sub_mesh_info = mesh_info->m_SubMeshes[s];
+			if (sub_meshes[s].m_LODs[0].m_NumIndices == 0)
+				continue;
+
+			bool is_transparent = IsMaterialTransparent(sub_mesh_info.m_MaterialName);
+			const ShaderObject* shader_object = is_transparent ? inShaderObjects.at("Transparent") : inShaderObjects.at("OpaqueGeometry");
+			DrawableObject* drawable = new DrawableObject(mesh, static_cast<uint32>(s), shader_object);
+			ioDrawableObjects.emplace_back(drawable);
+			num_drawables++;
+		}
+
+		num_meshes++;
+		delete mesh_info;
+	}
+	m_MeshInfos.clear();
+
+	Trace("MeshLoader: Created %zu meshes for %zu drawable objects", num_meshes, num_drawables);
+}
+
+using namespace BakedMeshFormat;
+
+// Create meshes straight from the mapped file. There is no intermediate copy
+void BakedMesh::Finalize(ID3D12GraphicsCommandList2& inCommandList,
+						 const std::map<std::string, ShaderObject*>& inShaderObjects, std::vector<DrawableObject*>& ioDrawableObjects)
+{
+	Assert(m_File.IsOpen());
+
+	const Header& header			= GetHeader();
+	const Object* objects			= GetObjects();
+	const SubMesh* sub_meshes		= GetSubMeshes();
+	const LOD* lods					= GetLODs();
+	const Byte* vertex_data			= GetSection(header.m_VertexDataOffset);
+	const Byte* index_data			= GetSection(header.m_IndexDataOffset);
+
+	for (uint32 i = 0; i < header.m_NumObjects; i++)
+	{
+		const Object& object				= objects[i];
+		const DXGI_FORMAT index_format		= static_cast<DXGI_FORMAT>(object.m_IndexFormat);
+
+		uint32 vertex_size	= object.m_NumVertices * header.m_VertexStride;
+		uint32 index_size	= object.m_NumIndices * DX12IndexBuffer::GetIndexSize(index_format);
+
+		std::shared_ptr<Mesh> mesh = std::make_shared<Mesh>();
+		mesh->Init(inCommandList,
+				   D3D_PRIMITIVE_TOPOLOGY::D3D10_PRIMITIVE_TOPOLOGY_TRIANGLELIST,
+				   vertex_data + object.m_VertexOffset, vertex_size, header.m_VertexStride,
+				   index_data + object.m_IndexOffset, index_size, index_format);
+
+		std::vector<Mesh::SubMesh> mesh_sub_meshes(object.m_NumSubMeshes);
+		for (uint32 s = 0; s < object.m_NumSubMeshes; s++)
+		{
+			const SubMesh& sub_mesh = sub_meshes[object.m_FirstSubMesh + s];
+
+			mesh_sub_meshes[s].m_LODs.resize(sub_mesh.m_NumLODs);
+			for (uint32 l = 0; l < sub_mesh.m_NumLODs; l++)
+			{
+				const LOD& lod = lods[sub_mesh.m_FirstLOD + l];
+				mesh_sub_meshes[s].m_LODs[l].m_StartIndex	= lod.m_StartIndex;
+				mesh_sub_meshes[s].m_LODs[l].m_NumIndices	= lod.m_NumIndices;
+				mesh_sub_meshes[s].m_LODs[l].m_Error		= lod.m_Error;
+			}
+
+			AABB& aabb				= mesh_sub_meshes[s].m_AABB;
+			BoundingSphere& sphere	= mesh_sub_meshes[s].m_BoundingSphere;
+			aabb.m_Min				= Vec3(sub_mesh.m_AABBMin[0], sub_mesh.m_AABBMin[1], sub_mesh.m_AABBMin[2]);
+			aabb.m_Max				= Vec3(sub_mesh.m_AABBMax[0], sub_mesh.m_AABBMax[1], sub_mesh.m_AABBMax[2]);
+			sphere.m_Center			= Vec3(sub_mesh.m_SphereCenter[0], sub_mesh.m_SphereCenter[1], sub_mesh.m_SphereCenter[2]);
+			sphere.m_Radius			= sub_mesh.m_SphereRadius;
+		}
+		mesh->SetSubMeshes(mesh_sub_meshes);
+
+		// One DrawableObject per submesh, drawn with the shader of its material
+		for (uint32 s = 0; s < object.m_NumSubMeshes; s++)
+		{
+			const SubMesh& sub_mesh = sub_meshes[object.m_FirstSubMesh + s];
+			if (mesh_sub_meshes[s].m_LODs[0].m_NumIndices == 0)
+				continue;
+
+			bool is_transparent = (sub_mesh.m_Flags & SubMeshFlags::Transparent) != 0;
+			const ShaderObject* shader_object = is_transparent ? inShaderObjects.at("Transparent") : inShaderObjects.at("OpaqueGeometry");
+			DrawableObject* drawable = new DrawableObject(mesh, s, shader_object);
+			ioDrawableObjects.emplace_back(drawable);
+		}
+	}
+
+	// Data has been copied to upload buffers, the file isn't needed anymore
+	m_File.Close();
+}
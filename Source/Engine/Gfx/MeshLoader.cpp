@@ -2,36 +2,78 @@
 #include "MeshLoader.h"
 
 #include "Utils/FileReader.h"
+#include "Utils/JobSystem.h"
 #include "Utils/String.h"
 
-#include "Gfx/DrawableObject.h"
-#include "Gfx/ShaderObject.h"
+#include "Gfx/MeshOptimizer.h"
 
-#include <sstream>
+#include <chrono>
 
-std::map<std::string, OBJKeyword> MeshLoader::s_OBJKeywords;
+static inline bool IsSpace(char inChar)
+{
+	return inChar == ' ' || inChar == '\t';
+}
+
+static inline void SkipSpaces(const char*& ioCursor, const char* inEnd)
+{
+	while (ioCursor < inEnd && IsSpace(*ioCursor))
+		ioCursor++;
+}
+
+// Returns the next space separated token and moves the cursor past it.
+// Returns an empty string_view when the end of the line is reached.
+static std::string_view NextToken(const char*& ioCursor, const char* inEnd)
+{
+	SkipSpaces(ioCursor, inEnd);
+
+	const char* token_start = ioCursor;
+	while (ioCursor < inEnd && !IsSpace(*ioCursor))
+		ioCursor++;
+
+	return std::string_view(token_start, ioCursor - token_start);
+}
 
-const char* obj_keywords_strings[] =
+// Parse the next space separated float and move the cursor past it
+static float NextFloat(const char*& ioCursor, const char* inEnd)
 {
-	"v",			//VertexPosition
-	"vn",			// VertexNormal
-	"vt",			// VertexUV
+	SkipSpaces(ioCursor, inEnd);
 
-	"mtllib",		// MaterialLibrary
-	"usemtl",		// MaterialName
+	float value = 0.0f;
+	const char* parse_end = String::ParseFloat(ioCursor, inEnd, value);
+	Assert(parse_end != ioCursor && (parse_end == inEnd || IsSpace(*parse_end)));
 
-	"p",			// Point
-	"l",			// Line
-	"f",			// Polygon
+	ioCursor = parse_end;
+	return value;
+}
 
-	"o",			// ObjectName,
-	"g",			// GroupName,
-	"s",			// SmoothingGroup
+// Parse the next "p/t/n" face element and move the cursor past it
+static OBJVertexIndices NextFaceElement(const char*& ioCursor, const char* inEnd)
+{
+	SkipSpaces(ioCursor, inEnd);
 
-	"#",			// Comment
-	"Invalid"		// Invalid
- };
-static_assert(_countof(obj_keywords_strings) == static_cast<int>(OBJKeyword::NumKeywords));
+	// Only support Position/UV/Normal for now
+	OBJVertexIndices indices;
+	const char* cursor = String::ParseInt(ioCursor, inEnd, indices.m_Position);
+	Assert(cursor != ioCursor && cursor < inEnd && *cursor == '/');
+
+	const char* uv_begin = cursor + 1;
+	cursor = String::ParseInt(uv_begin, inEnd, indices.m_UV);
+	Assert(cursor != uv_begin && cursor < inEnd && *cursor == '/');
+
+	const char* normal_begin = cursor + 1;
+	cursor = String::ParseInt(normal_begin, inEnd, indices.m_Normal);
+	Assert(cursor != normal_begin && (cursor == inEnd || IsSpace(*cursor)));
+
+	ioCursor = cursor;
+
+	// OBJ index starts at 1. Relative (negative) indices are not supported
+	indices.m_Position	-= 1;
+	indices.m_UV		-= 1;
+	indices.m_Normal	-= 1;
+	Assert(indices.m_Position >= 0 && indices.m_UV >= 0 && indices.m_Normal >= 0);
+
+	return indices;
+}
 
 // Crude test to check if material should be transparent
 // http://paulbourke.net/dataformats/mtl/
@@ -67,213 +109,744 @@ void MeshLoader::ReverseWinding()
 	}
 }
 
+// Bounding box and sphere of every submesh, from the vertices its indices reference
+void MeshLoader::ComputeBounds()
+{
+	const auto start_time = std::chrono::high_resolution_clock::now();
+
+	const size_t num_mesh_infos = m_CurrentMeshInfo + 1;
+
+	g_JobSystem.ParallelFor(num_mesh_infos, [&](size_t i)
+	{
+		MeshInfo& mesh_info			= *m_MeshInfos[i];
+		const float* positions		= &(m_VertexData.data() + mesh_info.m_VertexBuffeRange.m_Start)->Position.x;
+
+		for (SubMeshInfo& sub_mesh_info : mesh_info.m_SubMeshes)
+		{
+			const Range index_range		= sub_mesh_info.m_IndexBufferRange;
+			const uint32* indices		= m_IndexData.data() + index_range.m_Start;
+			const size_t num_indices	= static_cast<size_t>(index_range.m_End - index_range.m_Start);
+
+			sub_mesh_info.m_AABB			= BoundingVolumes::ComputeAABB(indices, num_indices, positions, sizeof(VertexPosUVNormal));
+			sub_mesh_info.m_BoundingSphere	= BoundingVolumes::ComputeSphere(indices, num_indices, positions, sizeof(VertexPosUVNormal), sub_mesh_info.m_AABB);
+		}
+	});
+
+	AABB scene_aabb;
+	size_t num_sub_meshes = 0;
+	for (size_t i = 0; i < num_mesh_infos; i++)
+	{
+		for (const SubMeshInfo& sub_mesh_info : m_MeshInfos[i]->m_SubMeshes)
+		{
+			scene_aabb.Merge(sub_mesh_info.m_AABB);
+			num_sub_meshes++;
+		}
+	}
+
+	const std::chrono::duration<double> elapsed = std::chrono::high_resolution_clock::now() - start_time;
+	Trace("MeshLoader: Computed bounds of %zu submeshes in %.2f ms (%u workers). Scene AABB (%f, %f, %f) (%f, %f, %f)",
+		  num_sub_meshes, elapsed.count() * 1000.0, g_JobSystem.GetNumWorkers(),
+		  scene_aabb.m_Min.x, scene_aabb.m_Min.y, scene_aabb.m_Min.z, scene_aabb.m_Max.x, scene_aabb.m_Max.y, scene_aabb.m_Max.z);
+}
+
+// Run the vertex cache, overdraw and vertex fetch optimizations on every MeshInfo.
+// MeshInfos own disjoint vertex and index ranges so they are processed in parallel
+void MeshLoader::OptimizeMeshes()
+{
+	const auto start_time = std::chrono::high_resolution_clock::now();
+
+	const size_t num_mesh_infos = m_CurrentMeshInfo + 1;
+
+	std::vector<MeshOptimizer::VertexCacheStatistics>	cache_statistics_before(num_mesh_infos);
+	std::vector<MeshOptimizer::VertexCacheStatistics>	cache_statistics_after(num_mesh_infos);
+	std::vector<MeshOptimizer::OverdrawStatistics>		overdraw_statistics_before(num_mesh_infos);
+	std::vector<MeshOptimizer::OverdrawStatistics>		overdraw_statistics_after(num_mesh_infos);
+
+	g_JobSystem.ParallelFor(num_mesh_infos, [&](size_t i)
+	{
+		const MeshInfo& mesh_info	= *m_MeshInfos[i];
+		const Range vertex_range	= mesh_info.m_VertexBuffeRange;
+		const Range index_range		= mesh_info.m_IndexBufferRange;
+
+		VertexPosUVNormal* vertices	= m_VertexData.data() + vertex_range.m_Start;
+		uint32* indices				= m_IndexData.data() + index_range.m_Start;
+		const size_t num_vertices	= static_cast<size_t>(vertex_range.m_End - vertex_range.m_Start);
+		const size_t num_indices	= static_cast<size_t>(index_range.m_End - index_range.m_Start);
+		const float* positions		= &vertices->Position.x;
+
+		cache_statistics_before[i] = MeshOptimizer::AnalyzeVertexCache(indices, num_indices, num_vertices);
+
+		// Triangles never move from a submesh to another. Each one is drawn separately
+		for (const SubMeshInfo& sub_mesh_info : mesh_info.m_SubMeshes)
+		{
+			uint32* sub_mesh_indices		= m_IndexData.data() + sub_mesh_info.m_IndexBufferRange.m_Start;
+			const size_t num_sub_mesh_indices	= static_cast<size_t>(sub_mesh_info.m_IndexBufferRange.m_End - sub_mesh_info.m_IndexBufferRange.m_Start);
+
+			// Overdraw doesn't matter for transparent meshes, they are sorted back to front
+			const bool is_transparent		= IsMaterialTransparent(sub_mesh_info.m_MaterialName);
+			const bool optimize_overdraw	= m_Settings.m_OptimizeOverdraw && !is_transparent;
+			const bool analyze_overdraw		= optimize_overdraw && m_Settings.m_AnalyzeOverdraw;
+
+			if (analyze_overdraw)
+				overdraw_statistics_before[i].Accumulate(MeshOptimizer::AnalyzeOverdraw(sub_mesh_indices, num_sub_mesh_indices, positions, num_vertices, sizeof(VertexPosUVNormal)));
+
+			MeshOptimizer::OptimizeVertexCache(sub_mesh_indices, num_sub_mesh_indices, num_vertices);
+
+			if (optimize_overdraw)
+				MeshOptimizer::OptimizeOverdraw(sub_mesh_indices, num_sub_mesh_indices, positions, num_vertices, sizeof(VertexPosUVNormal), m_Settings.m_OverdrawACMRThreshold);
+
+			if (analyze_overdraw)
+				overdraw_statistics_after[i].Accumulate(MeshOptimizer::AnalyzeOverdraw(sub_mesh_indices, num_sub_mesh_indices, positions, num_vertices, sizeof(VertexPosUVNormal)));
+		}
+
+		// Last, vertex order depends on the final triangle order of all submeshes
+		MeshOptimizer::OptimizeVertexFetch(vertices, num_vertices, sizeof(VertexPosUVNormal), indices, num_indices);
+
+		cache_statistics_after[i] = MeshOptimizer::AnalyzeVertexCache(indices, num_indices, num_vertices);
+	});
+
+	MeshOptimizer::VertexCacheStatistics	total_cache_before;
+	MeshOptimizer::VertexCacheStatistics	total_cache_after;
+	MeshOptimizer::OverdrawStatistics		total_overdraw_before;
+	MeshOptimizer::OverdrawStatistics		total_overdraw_after;
+	for (size_t i = 0; i < num_mesh_infos; i++)
+	{
+		total_cache_before.Accumulate(cache_statistics_before[i]);
+		total_cache_after.Accumulate(cache_statistics_after[i]);
+		total_overdraw_before.Accumulate(overdraw_statistics_before[i]);
+		total_overdraw_after.Accumulate(overdraw_statistics_after[i]);
+	}
+
+	const std::chrono::duration<double> elapsed = std::chrono::high_resolution_clock::now() - start_time;
+	Trace("MeshLoader: Optimized %zu meshes in %.2f ms (%u workers). ACMR %.3f -> %.3f, ATVR %.3f -> %.3f",
+		  num_mesh_infos, elapsed.count() * 1000.0, g_JobSystem.GetNumWorkers(),
+		  total_cache_before.GetACMR(), total_cache_after.GetACMR(), total_cache_before.GetATVR(), total_cache_after.GetATVR());
+
+	if (m_Settings.m_AnalyzeOverdraw)
+		Trace("MeshLoader: Overdraw %.3f -> %.3f", total_overdraw_before.GetOverdraw(), total_overdraw_after.GetOverdraw());
+}
+
+// Build a chain of simplified index buffers for every submesh. Each LOD is simplified from the previous one
+void MeshLoader::GenerateLODs()
+{
+	// Not worth keeping a LOD that removes less than this ratio of the triangles of the previous one
+	constexpr float min_reduction = 0.1f;
+
+	const auto start_time = std::chrono::high_resolution_clock::now();
+
+	const size_t num_mesh_infos = m_CurrentMeshInfo + 1;
+
+	// LOD indices of each MeshInfo, ranges are relative to these until they get appended to m_LODIndexData
+	std::vector<std::vector<uint32>> lod_index_data(num_mesh_infos);
+
+	g_JobSystem.ParallelFor(num_mesh_infos, [&](size_t i)
+	{
+		MeshInfo& mesh_info			= *m_MeshInfos[i];
+		const Range vertex_range	= mesh_info.m_VertexBuffeRange;
+
+		const VertexPosUVNormal* vertices	= m_VertexData.data() + vertex_range.m_Start;
+		const size_t num_vertices			= static_cast<size_t>(vertex_range.m_End - vertex_range.m_Start);
+		const float* positions				= &vertices->Position.x;
+
+		if (num_vertices == 0)
+			return;
+
+		// Error is relative to the size of the object so the same settings work for any scale
+		Vec3 min_position = vertices[0].Position;
+		Vec3 max_position = vertices[0].Position;
+		for (size_t v = 1; v < num_vertices; v++)
+		{
+			for (int32 k = 0; k < 3; k++)
+			{
+				min_position[k] = Math::Min(min_position[k], vertices[v].Position[k]);
+				max_position[k] = Math::Max(max_position[k], vertices[v].Position[k]);
+			}
+		}
+
+		const float max_error = m_Settings.m_LODMaxError * (max_position - min_position).Length() * 0.5f;
+
+		// Submeshes are simplified on their own. Vertices on material boundaries must stay in all of them or the LODs crack apart
+		std::vector<bool> locked_vertices(num_vertices, false);
+		if (mesh_info.m_SubMeshes.size() > 1)
+		{
+			constexpr uint32 no_sub_mesh = ~0u;
+			std::vector<uint32> first_sub_mesh(num_vertices, no_sub_mesh);
+
+			for (uint32 sub_mesh = 0; sub_mesh < mesh_info.m_SubMeshes.size(); sub_mesh++)
+			{
+				const Range index_range = mesh_info.m_SubMeshes[sub_mesh].m_IndexBufferRange;
+				for (int index = index_range.m_Start; index < index_range.m_End; index++)
+				{
+					const uint32 vertex = m_IndexData[index];
+					if (first_sub_mesh[vertex] == no_sub_mesh)
+						first_sub_mesh[vertex] = sub_mesh;
+					else if (first_sub_mesh[vertex] != sub_mesh)
+						locked_vertices[vertex] = true;
+				}
+			}
+		}
+
+		for (SubMeshInfo& sub_mesh_info : mesh_info.m_SubMeshes)
+		{
+			const Range index_range = sub_mesh_info.m_IndexBufferRange;
+
+			std::vector<uint32> previous_lod(m_IndexData.begin() + index_range.m_Start, m_IndexData.begin() + index_range.m_End);
+			std::vector<uint32> lod(previous_lod.size());
+			float previous_error = 0.0f;
+
+			for (uint32 l = 0; l < m_Settings.m_NumLODs && !previous_lod.empty(); l++)
+			{
+				const size_t target_num_indices = static_cast<size_t>(previous_lod.size() / 3 * m_Settings.m_LODTriangleRatio) * 3;
+
+				// Errors add up since every LOD is simplified from the previous one
+				float error = 0.0f;
+				const size_t num_indices = MeshOptimizer::SimplifyMesh(lod.data(), previous_lod.data(), previous_lod.size(),
+																	   positions, num_vertices, sizeof(VertexPosUVNormal),
+																	   target_num_indices, max_error - previous_error, error, &locked_vertices);
+
+				if (num_indices == 0 || num_indices > previous_lod.size() * (1.0f - min_reduction))
+					break;
+
+				MeshOptimizer::OptimizeVertexCache(lod.data(), num_indices, num_vertices);
+
+				LODInfo lod_info;
+				lod_info.m_IndexBufferRange	= { static_cast<int>(lod_index_data[i].size()), static_cast<int>(lod_index_data[i].size() + num_indices) };
+				lod_info.m_Error			= previous_error + error;
+				sub_mesh_info.m_LODs.push_back(lod_info);
+
+				lod_index_data[i].insert(lod_index_data[i].end(), lod.begin(), lod.begin() + num_indices);
+
+				previous_lod.assign(lod.begin(), lod.begin() + num_indices);
+				previous_error = lod_info.m_Error;
+			}
+		}
+	});
+
+	// Per LOD level totals for the report
+	std::vector<size_t> num_triangles(m_Settings.m_NumLODs + 1, 0);
+	std::vector<float> max_errors(m_Settings.m_NumLODs + 1, 0.0f);
+
+	for (size_t i = 0; i < num_mesh_infos; i++)
+	{
+		MeshInfo& mesh_info = *m_MeshInfos[i];
+		const int offset = static_cast<int>(m_LODIndexData.size());
+
+		m_LODIndexData.insert(m_LODIndexData.end(), lod_index_data[i].begin(), lod_index_data[i].end());
+
+		for (SubMeshInfo& sub_mesh_info : mesh_info.m_SubMeshes)
+		{
+			num_triangles[0] += (sub_mesh_info.m_IndexBufferRange.m_End - sub_mesh_info.m_IndexBufferRange.m_Start) / 3;
+
+			for (size_t l = 0; l < sub_mesh_info.m_LODs.size(); l++)
+			{
+				LODInfo& lod_info = sub_mesh_info.m_LODs[l];
+				lod_info.m_IndexBufferRange.m_Start	+= offset;
+				lod_info.m_IndexBufferRange.m_End	+= offset;
+
+				num_triangles[l + 1]	+= (lod_info.m_IndexBufferRange.m_End - lod_info.m_IndexBufferRange.m_Start) / 3;
+				max_errors[l + 1]		= Math::Max(max_errors[l + 1], lod_info.m_Error);
+			}
+		}
+	}
+
+	const std::chrono::duration<double> elapsed = std::chrono::high_resolution_clock::now() - start_time;
+	Trace("MeshLoader: Generated LODs for %zu meshes in %.2f ms (%u workers)", num_mesh_infos, elapsed.count() * 1000.0, g_JobSystem.GetNumWorkers());
+
+	for (size_t l = 0; l < num_triangles.size() && num_triangles[l] > 0; l++)
+		Trace("MeshLoader:   LOD%zu: %zu triangles, max error %f", l, num_triangles[l], max_errors[l]);
+}
+
+// Split the full resolution mesh of every submesh into meshlets and check that they cover it
+void MeshLoader::BuildMeshlets()
+{
+	const auto start_time = std::chrono::high_resolution_clock::now();
+
+	const size_t num_mesh_infos = m_CurrentMeshInfo + 1;
+
+	// Meshlets of each MeshInfo, offsets are relative to these until they get appended to m_MeshletData
+	std::vector<MeshletData> meshlet_data(num_mesh_infos);
+
+	g_JobSystem.ParallelFor(num_mesh_infos, [&](size_t i)
+	{
+		MeshInfo& mesh_info			= *m_MeshInfos[i];
+		const Range vertex_range	= mesh_info.m_VertexBuffeRange;
+
+		const size_t num_vertices	= static_cast<size_t>(vertex_range.m_End - vertex_range.m_Start);
+		// Pointer arithmetic: an empty trailing object starts at size(), which can't be indexed
+		const float* positions		= &(m_VertexData.data() + vertex_range.m_Start)->Position.x;
+
+		// Meshlets never span submeshes, they are culled with the material of their submesh
+		for (SubMeshInfo& sub_mesh_info : mesh_info.m_SubMeshes)
+		{
+			const Range index_range		= sub_mesh_info.m_IndexBufferRange;
+			const uint32* indices		= m_IndexData.data() + index_range.m_Start;
+			const size_t num_indices	= static_cast<size_t>(index_range.m_End - index_range.m_Start);
+
+			const size_t first_meshlet = meshlet_data[i].m_Meshlets.size();
+
+			Meshlets::Build(indices, num_indices, positions, num_vertices, sizeof(VertexPosUVNormal), meshlet_data[i]);
+
+			const size_t num_meshlets = meshlet_data[i].m_Meshlets.size() - first_meshlet;
+			sub_mesh_info.m_MeshletRange = { static_cast<int>(first_meshlet), static_cast<int>(first_meshlet + num_meshlets) };
+
+			const bool is_valid = Meshlets::Validate(meshlet_data[i], first_meshlet, num_meshlets, indices, num_indices,
+													 positions, sizeof(VertexPosUVNormal));
+			Assert(is_valid);
+		}
+	});
+
+	size_t num_triangles		= 0;
+	size_t num_vertices			= 0;
+	size_t num_cones			= 0;
+	double total_tightness		= 0.0;
+
+	for (size_t i = 0; i < num_mesh_infos; i++)
+	{
+		MeshInfo& mesh_info			= *m_MeshInfos[i];
+		const MeshletData& data		= meshlet_data[i];
+
+		const uint32 vertex_offset		= static_cast<uint32>(m_MeshletData.m_VertexIndices.size());
+		const uint32 triangle_offset	= static_cast<uint32>(m_MeshletData.m_TriangleIndices.size());
+
+		const int meshlet_offset		= static_cast<int>(m_MeshletData.m_Meshlets.size());
+
+		for (SubMeshInfo& sub_mesh_info : mesh_info.m_SubMeshes)
+		{
+			sub_mesh_info.m_MeshletRange.m_Start	+= meshlet_offset;
+			sub_mesh_info.m_MeshletRange.m_End		+= meshlet_offset;
+		}
+
+		for (size_t m = 0; m < data.m_Meshlets.size(); m++)
+		{
+			Meshlet meshlet				= data.m_Meshlets[m];
+			const MeshletBounds& bounds	= data.m_Bounds[m];
+
+			meshlet.m_VertexOffset		+= vertex_offset;
+			meshlet.m_TriangleOffset	+= triangle_offset;
+			m_MeshletData.m_Meshlets.push_back(meshlet);
+
+			num_triangles	+= meshlet.m_NumTriangles;
+			num_vertices	+= meshlet.m_NumVertices;
+			num_cones		+= (bounds.m_ConeCutoff < 1.0f) ? 1 : 0;
+
+			// Ratio between the sphere and the sphere around the AABB. Lower is tighter
+			const float aabb_radius = (bounds.m_AABBMax - bounds.m_AABBMin).Length() * 0.5f;
+			total_tightness += (aabb_radius > 0.0f) ? bounds.m_SphereRadius / aabb_radius : 1.0f;
+		}
+
+		m_MeshletData.m_Bounds.insert(m_MeshletData.m_Bounds.end(), data.m_Bounds.begin(), data.m_Bounds.end());
+		m_MeshletData.m_VertexIndices.insert(m_MeshletData.m_VertexIndices.end(), data.m_VertexIndices.begin(), data.m_VertexIndices.end());
+		m_MeshletData.m_TriangleIndices.insert(m_MeshletData.m_TriangleIndices.end(), data.m_TriangleIndices.begin(), data.m_TriangleIndices.end());
+	}
+
+	// Every triangle ends up in exactly one meshlet
+	Assert(num_triangles * 3 == m_IndexData.size());
+
+	const size_t num_meshlets = Math::Max<size_t>(1, m_MeshletData.m_Meshlets.size());
+
+	const std::chrono::duration<double> elapsed = std::chrono::high_resolution_clock::now() - start_time;
+	Trace("MeshLoader: Built %zu meshlets in %.2f ms (%u workers). %.1f vertices, %.1f triangles per meshlet. %.1f%% with a backface cone. Sphere/AABB radius %.3f",
+		  m_MeshletData.m_Meshlets.size(), elapsed.count() * 1000.0, g_JobSystem.GetNumWorkers(),
+		  num_vertices / static_cast<double>(num_meshlets), num_triangles / static_cast<double>(num_meshlets),
+		  100.0 * num_cones / num_meshlets, total_tightness / num_meshlets);
+}
+
+// Encode the vertices of every MeshInfo with the compressed format selected in the settings.
+// Vertices keep the same order so index buffers are shared with the uncompressed version
+void MeshLoader::CompressVertices(const std::string& inFile)
+{
+	const auto start_time = std::chrono::high_resolution_clock::now();
+
+	const bool is_quantized = (m_Settings.m_VertexCompression == VertexCompressionMode::Quantized);
+
+	if (is_quantized)
+		m_QuantizedVertexData.resize(m_VertexData.size());
+	else
+		m_PackedVertexData.resize(m_VertexData.size());
+
+	VertexCompression::EncodingError error;
+
+	for (size_t i = 0; i <= m_CurrentMeshInfo; i++)
+	{
+		MeshInfo& mesh_info			= *m_MeshInfos[i];
+		const Range vertex_range	= mesh_info.m_VertexBuffeRange;
+
+		const VertexPosUVNormal* vertices	= m_VertexData.data() + vertex_range.m_Start;
+		const size_t num_vertices			= static_cast<size_t>(vertex_range.m_End - vertex_range.m_Start);
+
+		if (is_quantized)
+		{
+			mesh_info.m_QuantizationBounds = VertexCompression::ComputeQuantizationBounds(vertices, num_vertices);
+
+			VertexPosUVNormalQuantized* encoded_vertices = m_QuantizedVertexData.data() + vertex_range.m_Start;
+			VertexCompression::Encode(vertices, num_vertices, mesh_info.m_QuantizationBounds, encoded_vertices);
+			error.Accumulate(VertexCompression::ComputeError(vertices, encoded_vertices, num_vertices, mesh_info.m_QuantizationBounds));
+		}
+		else
+		{
+			VertexPosUVNormalPacked* encoded_vertices = m_PackedVertexData.data() + vertex_range.m_Start;
+			VertexCompression::Encode(vertices, num_vertices, encoded_vertices);
+			error.Accumulate(VertexCompression::ComputeError(vertices, encoded_vertices, num_vertices));
+		}
+	}
+
+	const std::chrono::duration<double> elapsed = std::chrono::high_resolution_clock::now() - start_time;
+	const size_t encoded_vertex_size	= is_quantized ? sizeof(VertexPosUVNormalQuantized) : sizeof(VertexPosUVNormalPacked);
+	const double size_in_mb				= m_VertexData.size() * sizeof(VertexPosUVNormal) / (1024.0 * 1024.0);
+	const double encoded_size_in_mb		= m_VertexData.size() * encoded_vertex_size / (1024.0 * 1024.0);
+	Trace("MeshLoader: Compressed vertices of %s in %.2f ms. %.2f MB -> %.2f MB (-%.1f%%). Max error: Position %f, UV %f, Normal %.3f deg",
+		  inFile.c_str(), elapsed.count() * 1000.0, size_in_mb, encoded_size_in_mb, 100.0 * (1.0 - encoded_size_in_mb / size_in_mb),
+		  error.m_MaxPositionError, error.m_MaxUVError, error.m_MaxNormalError);
+}
+
+// TODO: Hack: Find a nice way to read from the same directory as obj file?
+// Material libraries are next to the OBJ file
+std::string MeshLoader::GetMaterialLibraryPath(const std::string& inFile, std::string_view inName)
+{
+	const size_t separator = inFile.find_last_of("/\\");
+	if (separator == std::string::npos)
+		return std::string(inName);
+
+	return inFile.substr(0, separator + 1) + std::string(inName);
+}
+
+bool MeshLoader::GetSourceFiles(const std::string& inFile, std::vector<std::string>& outFiles)
+{
+	FileReader file_reader;
+	if (!file_reader.ReadFile(inFile, FileReadMode::Map))
+		return false;
+
+	outFiles.push_back(inFile);
+
+	// Only mtllib statements matter, look for them without parsing the whole file
+	const std::string_view content(file_reader.GetContentAsString(), file_reader.GetContentSize());
+	for (size_t position = content.find("mtllib"); position != std::string_view::npos; position = content.find("mtllib", position + 1))
+	{
+		const bool is_line_start = (position == 0 || content[position - 1] == '\n' || content[position - 1] == '\r');
+		if (!is_line_start)
+			continue;
+
+		const char* cursor		= content.data() + position + 6;
+		const char* next_line	= nullptr;
+		const char* line_end	= String::FindLineEnd(cursor, content.data() + content.size(), next_line);
+
+		// "mtllibx" isn't a keyword
+		if (cursor == line_end || !IsSpace(*cursor))
+			continue;
+
+		std::string_view name = NextToken(cursor, line_end);
+		if (!name.empty())
+			outFiles.push_back(GetMaterialLibraryPath(inFile, name));
+	}
+
+	return true;
+}
+
 void MeshLoader::ProcessMaterialLibraryFile(const std::string& inFile)
 {
 	FileReader file_reader;
-	// TODO: Hack: Find a nice way to read from the same directory as obj file?
-	bool success = file_reader.ReadFile("Data\\" + inFile);
+	bool success = file_reader.ReadFile(GetMaterialLibraryPath(m_File, inFile));
 	Assert(success);
 
-	std::istringstream stream(file_reader.GetContentAsString());
-	std::string line;
+	const char* content = file_reader.GetContentAsString();
 
 	MaterialInfo* current_material = nullptr;
 
-	// Process a single line
-	while (String::GetLine(stream, line))
+	for (std::string_view line : String::Lines(content, content + file_reader.GetContentSize()))
 	{
-		// TODO: Those spaces right there is a hack.
-		const std::string newmtl("newmtl ");
-		const std::string illum("illum ");
-
 		// TODO: It's tricky to list all MTL keywords. Let's just detect the Illumination Model (illum) for transparency for now
+		String::Range<String::TokenIterator> tokens = String::Tokens(line);
+		String::TokenIterator token = tokens.begin();
+
+		// Don't process empty lines
+		if (token == tokens.end())
+			continue;
+
+		const std::string_view keyword = *token++;
+		const std::string_view value = (token != tokens.end()) ? *token : std::string_view();
 
 		// Keyword to create a new material
-		if (line.substr(0, newmtl.size()) == newmtl)
+		if (keyword == "newmtl")
 		{
-			std::string material_name = line.substr(newmtl.size());
-			Assert(m_MaterialInfos.find(material_name) == m_MaterialInfos.end());
+			std::string material_name(value);
+			Assert(!material_name.empty() && m_MaterialInfos.find(material_name) == m_MaterialInfos.end());
 
-			m_MaterialInfos[material_name] = MaterialInfo();
-
-			current_material = &(*m_MaterialInfos.find(material_name)).second;
+			current_material = &m_MaterialInfos[material_name];
 		}
 		// Check Illumination
-		else if (line.substr(0, illum.size()) == illum)
+		else if (keyword == "illum")
 		{
 			Assert(current_material != nullptr);
 
-			std::string value_str = line.substr(illum.size());
-			int illumination_model = String::ToInt(value_str);
+			int illumination_model = String::ToInt(value);
 			current_material->m_IsTransparent = IsIlluminationModelTransparent(illumination_model);
 		}
 	}
 }
 
-void MeshLoader::Init()
+// Doesn't insert unknown materials so it can be called from multiple threads
+bool MeshLoader::IsMaterialTransparent(const std::string& inMaterialName) const
+{
+	auto material_search = m_MaterialInfos.find(inMaterialName);
+	return material_search != m_MaterialInfos.end() && material_search->second.m_IsTransparent;
+}
+
+// Split the buffer into chunks of roughly equal size. Chunks always start at the beginning of a line
+static std::vector<const char*> SplitIntoChunks(const char* inBegin, const char* inEnd, uint32 inNumChunks)
+{
+	std::vector<const char*> boundaries;
+	boundaries.push_back(inBegin);
+
+	const size_t chunk_size = (inEnd - inBegin) / inNumChunks;
+
+	for (uint32 i = 1; i < inNumChunks; i++)
+	{
+		const char* target		= Math::Max(inBegin + i * chunk_size, boundaries.back());
+		const char* new_line	= static_cast<const char*>(::memchr(target, '\n', inEnd - target));
+
+		if (new_line == nullptr || new_line + 1 >= inEnd)
+			break;
+
+		boundaries.push_back(new_line + 1);
+	}
+
+	boundaries.push_back(inEnd);
+	return boundaries;
+}
+
+// Parse a range of whole lines.
+// This doesn't touch the loader state so multiple chunks can be parsed at the same time
+void MeshLoader::ParseChunk(const char* inBegin, const char* inEnd, OBJChunk& outChunk)
+{
+	// Count elements ahead of time so the attribute arrays never need to grow while parsing
+	{
+		size_t num_positions	= 0;
+		size_t num_normals		= 0;
+		size_t num_uvs			= 0;
+		size_t num_faces		= 0;
+
+		for (std::string_view line : String::Lines(inBegin, inEnd))
+		{
+			if (line.size() >= 2)
+			{
+				if (line[0] == 'v')
+				{
+					num_positions	+= IsSpace(line[1]);
+					num_normals		+= (line[1] == 'n');
+					num_uvs			+= (line[1] == 't');
+				}
+				else if (line[0] == 'f')
+				{
+					num_faces		+= IsSpace(line[1]);
+				}
+			}
+		}
+
+		outChunk.m_Positions.reserve(num_positions);
+		outChunk.m_Normals.reserve(num_normals);
+		outChunk.m_UVCoords.reserve(num_uvs);
+		outChunk.m_Faces.reserve(num_faces);
+	}
+
+	for (std::string_view line : String::Lines(inBegin, inEnd))
+		ParseLine(line, outChunk);
+}
+
+// Append the attributes of all chunks then replay faces and events in file order.
+// The result is the same whatever the number of chunks
+void MeshLoader::MergeChunks(const std::vector<OBJChunk>& inChunks)
 {
-	for (size_t i = 0; i < static_cast<size_t>(OBJKeyword::NumKeywords); i++)
+	size_t num_positions	= m_AllPositions.size();
+	size_t num_normals		= m_AllNormals.size();
+	size_t num_uvs			= m_AllUVCoords.size();
+	size_t num_faces		= 0;
+
+	for (const OBJChunk& chunk : inChunks)
 	{
-		OBJKeyword keyword = static_cast<OBJKeyword>(i);
-		const char* keyword_string = obj_keywords_strings[i];
-		s_OBJKeywords[keyword_string] = keyword;
+		num_positions	+= chunk.m_Positions.size();
+		num_normals		+= chunk.m_Normals.size();
+		num_uvs			+= chunk.m_UVCoords.size();
+		num_faces		+= chunk.m_Faces.size();
+	}
+
+	m_AllPositions.reserve(num_positions);
+	m_AllNormals.reserve(num_normals);
+	m_AllUVCoords.reserve(num_uvs);
+	m_IndexData.reserve(m_IndexData.size() + num_faces * 3);
+
+	// A closed triangle mesh has about half as many vertices as faces, seams add some on top of that
+	m_IndexMap.Reserve(num_faces);
+
+	// OBJ indices are global to the file. Concatenating attributes in order keeps them valid
+	for (const OBJChunk& chunk : inChunks)
+	{
+		m_AllPositions.insert(m_AllPositions.end(),	chunk.m_Positions.begin(),	chunk.m_Positions.end());
+		m_AllNormals.insert(m_AllNormals.end(),		chunk.m_Normals.begin(),	chunk.m_Normals.end());
+		m_AllUVCoords.insert(m_AllUVCoords.end(),	chunk.m_UVCoords.begin(),	chunk.m_UVCoords.end());
+	}
+
+	for (const OBJChunk& chunk : inChunks)
+	{
+		size_t next_event = 0;
+
+		for (size_t face_index = 0; face_index < chunk.m_Faces.size(); face_index++)
+		{
+			while (next_event < chunk.m_Events.size() && chunk.m_Events[next_event].m_FaceIndex == face_index)
+				ProcessEvent(chunk.m_Events[next_event++]);
+
+			ProcessTriangle(chunk.m_Faces[face_index]);
+		}
+
+		// Events after the last face of the chunk
+		while (next_event < chunk.m_Events.size())
+			ProcessEvent(chunk.m_Events[next_event++]);
 	}
 }
 
-void MeshLoader::LoadFromFile(const std::string& inFile)
+MeshLoader::MeshLoader(const MeshImportSettings& inSettings/* = MeshImportSettings()*/) :
+	m_Settings(inSettings)
+{
+}
+
+MeshLoader::~MeshLoader()
+{
+	// Left over when Finalize isn't called
+	for (MeshInfo* mesh_info : m_MeshInfos)
+		delete mesh_info;
+}
+
+void MeshLoader::LoadFromFile(const std::string& inFile, uint32 inNumChunks/* = 0*/)
 {
-	Assert(s_OBJKeywords.size() > 0);
+	// Small chunks aren't worth a job
+	constexpr size_t min_chunk_size = 512 * 1024;
+
+	const auto start_time = std::chrono::high_resolution_clock::now();
+
+	m_File = inFile;
 
 	FileReader file_reader;
-	bool success = file_reader.ReadFile(inFile);
+	// Mapped, chunks are parsed straight from the page cache. Saves a copy of the whole file
+	bool success = file_reader.ReadFile(inFile, FileReadMode::Map);
 	Assert(success);
 
-	std::istringstream stream(file_reader.GetContentAsString());
-	std::string line;
-	while (String::GetLine(stream, line))
+	// Walk the file buffer in place. Lines are never copied
+	const char* content_begin	= file_reader.GetContentAsString();
+	const char* content_end		= content_begin + file_reader.GetContentSize();
+
+	uint32 num_chunks = inNumChunks;
+	if (num_chunks == 0)
 	{
-		ProcessLine(line);
+		const size_t max_chunks	= Math::Max<size_t>(1, file_reader.GetContentSize() / min_chunk_size);
+		num_chunks				= static_cast<uint32>(Math::Min<size_t>(g_JobSystem.GetNumWorkers(), max_chunks));
 	}
 
+	const std::vector<const char*> boundaries = SplitIntoChunks(content_begin, content_end, num_chunks);
+	num_chunks = static_cast<uint32>(boundaries.size() - 1);
+
+	// Parse all chunks in parallel
+	std::vector<OBJChunk> chunks(num_chunks);
+	g_JobSystem.ParallelFor(num_chunks, [&](size_t i)
+	{
+		ParseChunk(boundaries[i], boundaries[i + 1], chunks[i]);
+	});
+
+	// Chunks reference the file content. Merge before the FileReader goes out of scope
+	const auto merge_start_time	= std::chrono::high_resolution_clock::now();
+	const uint64 num_lookups	= m_IndexMap.GetNumLookups();
+
+	MergeChunks(chunks);
+
+	const std::chrono::duration<double> merge_elapsed = std::chrono::high_resolution_clock::now() - merge_start_time;
+	const double lookups_per_second = (m_IndexMap.GetNumLookups() - num_lookups) / merge_elapsed.count();
+
 	// Close range on the last MeshInfo
 	MeshInfo& last_mesh_info = *m_MeshInfos[m_CurrentMeshInfo];
 	last_mesh_info.EndRange((int) m_VertexData.size(), (int) m_IndexData.size());
 
 	// Blender exports meshes in Right Hand Coordinates. DX12 uses Left Hand. We need to flip the winding order
 	ReverseWinding();
-}
-
-// Final step of loading OBJ files
-// Create materials, create meshes, create Drawable objects
-void MeshLoader::Finalize(ID3D12GraphicsCommandList2& inCommandList,
-						  const std::map<std::string, ShaderObject*>& inShaderObjects, RenderBuckets& ioBuckets)
-{
-	Assert(m_VertexData.size() > 0);
-
-	for (size_t i = 0; i <= m_CurrentMeshInfo; i++)
-	{
-		MeshInfo* mesh_info = m_MeshInfos[i];
 
-		const Range vertex_range	= mesh_info->m_VertexBuffeRange;
-		const Range index_range		= mesh_info->m_IndexBufferRange;
+	// Positions are final from here, later stages only reorder vertices and triangles
+	ComputeBounds();
 
-		uint32 vertex_size	= static_cast<uint32>(vertex_range.m_End	- vertex_range.m_Start) * sizeof(VertexPosUVNormal);
-		uint32 index_size	= static_cast<uint32>(index_range.m_End		- index_range.m_Start) * sizeof(uint16);
+	if (m_Settings.m_OptimizeVertexCache)
+		OptimizeMeshes();
 
-		Mesh* mesh = new Mesh();
-		mesh->Init(inCommandList,
-				   D3D_PRIMITIVE_TOPOLOGY::D3D10_PRIMITIVE_TOPOLOGY_TRIANGLELIST,
-				   m_VertexData.data()	+ vertex_range.m_Start,	vertex_size, sizeof(VertexPosUVNormal),
-				   m_IndexData.data()	+ index_range.m_Start,	index_size);
+	// LODs use the final vertex order
+	if (m_Settings.m_NumLODs > 0)
+		GenerateLODs();
 
-		// Set Mesh debug name
-		const std::string mesh_name = mesh_info->m_ObjectName + "_" + mesh_info->m_MaterialName;
-		mesh->SetResourceName(mesh_name);
+	// Meshlets reference the final vertex and index order
+	if (m_Settings.m_BuildMeshlets)
+		BuildMeshlets();
 
-		bool is_transparent = m_MaterialInfos[mesh_info->m_MaterialName].m_IsTransparent;
-		const ShaderObject* shader_object = is_transparent ? inShaderObjects.at("Transparent") : inShaderObjects.at("OpaqueGeometry");
-		DrawableObject* drawable = new DrawableObject(mesh, shader_object);
-		ioBuckets[(uint32) shader_object->GetRenderPass()].emplace_back(drawable);
+	// Last, compressed vertices must be in their final order
+	if (m_Settings.m_VertexCompression != VertexCompressionMode::None)
+		CompressVertices(inFile);
 
-		delete mesh_info;
-	}
+	const std::chrono::duration<double> elapsed = std::chrono::high_resolution_clock::now() - start_time;
+	const double size_in_mb = file_reader.GetContentSize() / (1024.0 * 1024.0);
+	Trace("MeshLoader: Loaded %s (%.2f MB) in %.2f ms (%.2f MB/s, %u chunks, %.2f M vertex lookups/s)",
+		  inFile.c_str(), size_in_mb, elapsed.count() * 1000.0, size_in_mb / elapsed.count(), num_chunks, lookups_per_second * 1e-6);
 }
 
-void MeshLoader::ProcessLine(const std::string& inLine)
+void MeshLoader::ParseLine(std::string_view inLine, OBJChunk& ioChunk)
 {
+	const char* cursor		= inLine.data();
+	const char* line_end	= inLine.data() + inLine.size();
+
+	std::string_view keyword_string = NextToken(cursor, line_end);
+
 	// Don't process empty lines
-	if (inLine.empty())
+	if (keyword_string.empty())
 	{
 		return;
 	}
 
-	// Get all elements from line
-	std::vector<std::string> all_elem = String::Split(inLine, " ");
-	size_t num_elems = all_elem.size();
-	Assert(num_elems > 0);
-
-	const std::string& keyword_string = all_elem[0];
 	OBJKeyword keyword = GetKeywordFromString(keyword_string);
 
-	// Remove first element (keyword)
-	all_elem.erase(all_elem.begin());
-	num_elems = num_elems - 1;
-
 	switch (keyword)
 	{
 	case OBJKeyword::VertexPosition:
 	{
-		Assert(num_elems == 3);
+		float x = NextFloat(cursor, line_end);
+		float y = NextFloat(cursor, line_end);
+		float z = NextFloat(cursor, line_end);
+		Assert(NextToken(cursor, line_end).empty());
 
-		float x = String::ToFloat(all_elem[0]);
-		float y = String::ToFloat(all_elem[1]);
-		float z = String::ToFloat(all_elem[2]);
-
-		m_AllPositions.push_back(Vec3(x, y, z));
+		ioChunk.m_Positions.push_back(Vec3(x, y, z));
 		break;
 	}
 	case OBJKeyword::VertexNormal:
 	{
-		Assert(num_elems == 3);
-
-		float x = String::ToFloat(all_elem[0]);
-		float y = String::ToFloat(all_elem[1]);
-		float z = String::ToFloat(all_elem[2]);
+		float x = NextFloat(cursor, line_end);
+		float y = NextFloat(cursor, line_end);
+		float z = NextFloat(cursor, line_end);
+		Assert(NextToken(cursor, line_end).empty());
 
-		m_AllNormals.push_back(Vec3(x, y, z));
+		ioChunk.m_Normals.push_back(Vec3(x, y, z));
 		break;
 	}
 	case OBJKeyword::VertexUV:
 	{
 		// Only support 2D UV coordinates
-		Assert(num_elems == 2);
-
-		float x = String::ToFloat(all_elem[0]);
-		float y = String::ToFloat(all_elem[1]);
+		float x = NextFloat(cursor, line_end);
+		float y = NextFloat(cursor, line_end);
+		Assert(NextToken(cursor, line_end).empty());
 
-		m_AllUVCoords.push_back(Vec2(x, y));
+		ioChunk.m_UVCoords.push_back(Vec2(x, y));
 		break;
 	}
 	case OBJKeyword::MaterialLibrary:
-		// Should only be one element. The filename
-		Assert(num_elems == 1);
-
-		ProcessMaterialLibraryFile(all_elem[0]);
-		break;
 	case OBJKeyword::MaterialName:
+	case OBJKeyword::ObjectName:
 	{
-		// Special case for different materials within the same mesh.
-		// Recreate a new mesh but still based on the current 
-
-		Assert(m_MeshInfos.size() != 0);
-
-		MeshInfo& current_mesh_info = *m_MeshInfos[m_CurrentMeshInfo];
-
-		// If we haven't processed any vertices yet. Don't create a new MeshInfo. We are processing the first material of a new object
-		if (m_IncrementalIndexValue != 0)
-		{
-			// Deal in the same was as if it was a new object.
-			// TODO: Use the same vertex buffer with different index buffer?
-
-			current_mesh_info.EndRange((int) m_VertexData.size(), (int) m_IndexData.size());
-
-			MeshInfo* new_mesh_info = new MeshInfo(current_mesh_info);
-			new_mesh_info->m_ObjectName = current_mesh_info.m_ObjectName;
-
-			m_MeshInfos.push_back(new_mesh_info);
-
-			m_IndexMap.clear();
-			m_IncrementalIndexValue = 0;
-
-			m_CurrentMeshInfo++;
-		}
-
-		// Actually set the material name for the current or new MeshInfo
-		Assert(m_MeshInfos[m_CurrentMeshInfo]->m_MaterialName.length() == 0);
-		Assert(m_MaterialInfos.find(all_elem[0]) != m_MaterialInfos.end());
-
-		m_MeshInfos[m_CurrentMeshInfo]->m_MaterialName = all_elem[0];
+		// Should only be one element. The file, material or object name
+		std::string_view name = NextToken(cursor, line_end);
+		Assert(!name.empty() && NextToken(cursor, line_end).empty());
 
+		// These depend on the loader state, they are processed when merging chunks
+		ioChunk.m_Events.push_back({ keyword, name, ioChunk.m_Faces.size() });
 		break;
 	}
 	case OBJKeyword::Point:
@@ -284,9 +857,63 @@ void MeshLoader::ProcessLine(const std::string& inLine)
 	}
 	case OBJKeyword::Polygon:
 	{
+		OBJFace face;
+		face[0] = NextFaceElement(cursor, line_end);
+		face[1] = NextFaceElement(cursor, line_end);
+		face[2] = NextFaceElement(cursor, line_end);
+
 		// Only support triangles
-		Assert(num_elems == 3);
-		ProcessTriangle(all_elem);
+		Assert(NextToken(cursor, line_end).empty());
+		ioChunk.m_Faces.push_back(face);
+		break;
+	}
+	case OBJKeyword::GroupName:
+		// Don't do anything for now
+		break;
+	case OBJKeyword::SmoothingGroup:
+	{
+		Assert(!NextToken(cursor, line_end).empty());
+		// Don't do anything for now
+		break;
+	}
+	case OBJKeyword::Comment:
+		// Ignore comments
+		break;
+
+	case OBJKeyword::Invalid:
+	default:
+		Assert(false);
+		break;
+	}
+}
+
+void MeshLoader::ProcessEvent(const OBJChunk::Event& inEvent)
+{
+	switch (inEvent.m_Keyword)
+	{
+	case OBJKeyword::MaterialLibrary:
+		ProcessMaterialLibraryFile(std::string(inEvent.m_Name));
+		break;
+	case OBJKeyword::MaterialName:
+	{
+		// A new material starts a new submesh of the current object.
+		// Vertices are shared between submeshes so the index map is kept as is
+
+		Assert(m_MeshInfos.size() != 0);
+
+		MeshInfo& current_mesh_info = *m_MeshInfos[m_CurrentMeshInfo];
+
+		// If the current submesh doesn't have any triangle yet, it simply takes this material
+		const int index_buffer_end = static_cast<int>(m_IndexData.size());
+		if (current_mesh_info.m_SubMeshes.back().m_IndexBufferRange.m_Start != index_buffer_end)
+			current_mesh_info.StartSubMesh(index_buffer_end);
+
+		// Actually set the material name for the current or new submesh
+		SubMeshInfo& sub_mesh_info = current_mesh_info.m_SubMeshes.back();
+		sub_mesh_info.m_MaterialName = inEvent.m_Name;
+
+		Assert(m_MaterialInfos.find(sub_mesh_info.m_MaterialName) != m_MaterialInfos.end());
+
 		break;
 	}
 	case OBJKeyword::ObjectName:
@@ -306,86 +933,79 @@ void MeshLoader::ProcessLine(const std::string& inLine)
 
 			m_MeshInfos.push_back(new MeshInfo(current_mesh_info));
 
-			m_IndexMap.clear();
+			m_IndexMap.Clear();
 			m_IncrementalIndexValue = 0;
 
 			m_CurrentMeshInfo++;
 		}
 
 		// Actually set the object name for the new MeshInfo
-		m_MeshInfos[m_CurrentMeshInfo]->m_ObjectName = all_elem[0];
+		m_MeshInfos[m_CurrentMeshInfo]->m_ObjectName = inEvent.m_Name;
 
 		break;
 	}
-	case OBJKeyword::GroupName:
-		// Don't do anything for now
-		break;
-	case OBJKeyword::SmoothingGroup:
-	{
-		Assert(num_elems == 1);
-		// Don't do anything for now
-		break;
-	}
-	case OBJKeyword::Comment:
-		// Ignore comments
-		break;
-
-	case OBJKeyword::Invalid:
 	default:
 		Assert(false);
 		break;
 	}
 }
 
-void MeshLoader::ProcessTriangle(const std::vector<std::string>& inFaceElements)
+void MeshLoader::ProcessTriangle(const OBJFace& inFace)
 {
-	// Make sure we are dealing with a triangle
-	Assert(inFaceElements.size() == 3);
-
-	for (size_t i = 0; i < 3; i++)
+	for (const OBJVertexIndices& vertex_indices : inFace)
 	{
-		const std::string& vertex_string = inFaceElements[i];
-
-		auto index_search = m_IndexMap.find(vertex_string);
-		if (index_search == m_IndexMap.end())
+		uint32 index = 0;
+		if (m_IndexMap.FindOrInsert(vertex_indices, m_IncrementalIndexValue, index))
 		{
-			m_IndexMap[vertex_string] = m_IncrementalIndexValue;
-			m_IndexData.push_back(m_IncrementalIndexValue);
 			m_IncrementalIndexValue++;
 
-			std::vector<std::string> all_elem = String::Split(vertex_string, "/");
-			size_t num_elems = all_elem.size();
-
-			// Only support Position/UV/Normal for now
-			Assert(num_elems == 3);
-
-			// OBJ index starts at 1
-			size_t position_index	= String::ToInt(all_elem[0]) - 1;
-			size_t coords_index		= String::ToInt(all_elem[1]) - 1;
-			size_t normal_index		= String::ToInt(all_elem[2]) - 1;
-
 			// TODO: Only one Vertex layout for now
 			VertexPosUVNormal vertex;
-			vertex.Position		= m_AllPositions[position_index];
-			vertex.UV			= m_AllUVCoords[coords_index];
-			vertex.Normal		= m_AllNormals[normal_index];
+			vertex.Position		= m_AllPositions[vertex_indices.m_Position];
+			vertex.UV			= m_AllUVCoords[vertex_indices.m_UV];
+			vertex.Normal		= m_AllNormals[vertex_indices.m_Normal];
 
 			m_VertexData.push_back(vertex);
 		}
-		else
-		{
-			m_IndexData.push_back((*index_search).second);
-		}
+
+		m_IndexData.push_back(index);
 	}
 }
 
-OBJKeyword MeshLoader::GetKeywordFromString(const std::string& inStr)
+OBJKeyword MeshLoader::GetKeywordFromString(std::string_view inStr)
 {
-	auto search = s_OBJKeywords.find(inStr);
-	if (search != s_OBJKeywords.end())
+	Assert(!inStr.empty());
+
+	// Comments don't need a space after the #
+	if (inStr[0] == '#')
 	{
-		return (*search).second;
+		return OBJKeyword::Comment;
+	}
+
+	switch (inStr.size())
+	{
+	case 1:
+		switch (inStr[0])
+		{
+		case 'v':	return OBJKeyword::VertexPosition;
+		case 'p':	return OBJKeyword::Point;
+		case 'l':	return OBJKeyword::Line;
+		case 'f':	return OBJKeyword::Polygon;
+		case 'o':	return OBJKeyword::ObjectName;
+		case 'g':	return OBJKeyword::GroupName;
+		case 's':	return OBJKeyword::SmoothingGroup;
+		}
+		break;
+	case 2:
+		if (inStr == "vn")	return OBJKeyword::VertexNormal;
+		if (inStr == "vt")	return OBJKeyword::VertexUV;
+		break;
+	case 6:
+		if (inStr == "mtllib")	return OBJKeyword::MaterialLibrary;
+		if (inStr == "usemtl")	return OBJKeyword::MaterialName;
+		break;
 	}
+
 	return OBJKeyword::Invalid;
 }
 
@@ -393,16 +1013,122 @@ MeshInfo::MeshInfo()
 {
 	m_VertexBuffeRange = { 0, -1 };
 	m_IndexBufferRange = { 0, -1 };
+
+	StartSubMesh(0);
 }
 
 MeshInfo::MeshInfo(const MeshInfo& inPreviousMeshInfo)
 {
 	m_VertexBuffeRange = { inPreviousMeshInfo.m_VertexBuffeRange.m_End, -1 };
 	m_IndexBufferRange = { inPreviousMeshInfo.m_IndexBufferRange.m_End, -1 };
+
+	StartSubMesh(m_IndexBufferRange.m_Start);
+}
+
+void MeshInfo::StartSubMesh(int inIndexBufferStart)
+{
+	// Close the previous submesh, the new one starts right after it
+	if (!m_SubMeshes.empty())
+		m_SubMeshes.back().m_IndexBufferRange.m_End = inIndexBufferStart;
+
+	SubMeshInfo sub_mesh_info;
+	sub_mesh_info.m_IndexBufferRange = { inIndexBufferStart, -1 };
+	m_SubMeshes.push_back(sub_mesh_info);
 }
 
 void MeshInfo::EndRange(int inVertexBufferEnd, int inIndexBufferEnd)
 {
 	m_VertexBuffeRange.m_End = inVertexBufferEnd;
 	m_IndexBufferRange.m_End = inIndexBufferEnd;
-}
\ No newline at end of file
+
+	m_SubMeshes.back().m_IndexBufferRange.m_End = inIndexBufferEnd;
+}
+
+void VertexIndexMap::Reserve(size_t inNumElements)
+{
+	// Keep the load factor under 50%
+	size_t capacity = 16;
+	while (capacity < inNumElements * 2)
+		capacity *= 2;
+
+	if (capacity > m_Entries.size())
+		Grow(capacity);
+}
+
+void VertexIndexMap::Clear()
+{
+	// Entries from previous generations are considered empty
+	m_Generation++;
+	m_NumElements = 0;
+}
+
+bool VertexIndexMap::FindOrInsert(const OBJVertexIndices& inKey, uint32 inNewIndex, uint32& outIndex)
+{
+	if ((m_NumElements + 1) * 2 > m_Entries.size())
+		Grow(Math::Max<size_t>(16, m_Entries.size() * 2));
+
+	m_NumLookups++;
+
+	// Linear probing. Capacity is always a power of two
+	const size_t mask = m_Entries.size() - 1;
+	for (size_t slot = Hash(inKey) & mask; ; slot = (slot + 1) & mask)
+	{
+		Entry& entry = m_Entries[slot];
+
+		if (entry.m_Generation != m_Generation)
+		{
+			entry.m_Key			= inKey;
+			entry.m_Index		= inNewIndex;
+			entry.m_Generation	= m_Generation;
+			m_NumElements++;
+
+			outIndex = inNewIndex;
+			return true;
+		}
+
+		if (entry.m_Key == inKey)
+		{
+			outIndex = entry.m_Index;
+			return false;
+		}
+	}
+}
+
+void VertexIndexMap::Grow(size_t inNewCapacity)
+{
+	Assert((inNewCapacity & (inNewCapacity - 1)) == 0);
+
+	std::vector<Entry> old_entries;
+	old_entries.swap(m_Entries);
+	m_Entries.resize(inNewCapacity);
+
+	// Only re-insert entries of the current generation
+	const size_t mask = m_Entries.size() - 1;
+	for (const Entry& old_entry : old_entries)
+	{
+		if (old_entry.m_Generation != m_Generation)
+			continue;
+
+		size_t slot = Hash(old_entry.m_Key) & mask;
+		while (m_Entries[slot].m_Generation == m_Generation)
+			slot = (slot + 1) & mask;
+
+		m_Entries[slot] = old_entry;
+	}
+}
+
+uint32 VertexIndexMap::Hash(const OBJVertexIndices& inKey)
+{
+	// Mix the 3 indices then finalize like MurmurHash3
+	uint32 hash = static_cast<uint32>(inKey.m_Position) * 0x9E3779B1u;
+	hash ^= static_cast<uint32>(inKey.m_UV)		* 0x85EBCA77u;
+	hash ^= static_cast<uint32>(inKey.m_Normal)	* 0xC2B2AE3Du;
+
+	hash ^= hash >> 16;
+	hash *= 0x85EBCA6Bu;
+	hash ^= hash >> 13;
+	hash *= 0xC2B2AE35u;
+	hash ^= hash >> 16;
+
+	return hash;
+}
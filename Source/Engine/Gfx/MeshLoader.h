@@ -1,15 +1,21 @@
 #pragma once
 
+#include <array>
 #include <map>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include "Gfx/Mesh.h"
+#include "Gfx/Meshlet.h"
 #include "Gfx/RenderPass.h"
+#include "Gfx/VertexCompression.h"
+#include "Math/BoundingVolumes.h"
 
 #include "Shaders/Include/VertexLayouts.h"
 using namespace VertexFormats;
 
+class DrawableObject;
 class ShaderObject;
 
 enum class OBJKeyword
@@ -46,17 +52,48 @@ struct Range
 	int m_End	= -1;
 };
 
+struct LODInfo
+{
+	Range			m_IndexBufferRange;		// In MeshLoader::m_LODIndexData
+	float			m_Error		= 0.0f;		// Object space distance to the full resolution mesh
+};
+
+// Part of an object drawn with a single material
+struct SubMeshInfo
+{
+	Range					m_IndexBufferRange;
+
+	std::string				m_MaterialName;
+
+	// Simplified versions of the submesh, from the most to the least detailed
+	std::vector<LODInfo>	m_LODs;
+
+	// Meshlets of the full resolution submesh, in MeshLoader::m_MeshletData
+	Range					m_MeshletRange;
+
+	// Object space bounds of the full resolution submesh
+	AABB					m_AABB;
+	BoundingSphere			m_BoundingSphere;
+};
+
+// An OBJ object. Submeshes share the vertices of the object and their indices are relative to m_VertexBuffeRange
 struct MeshInfo
 {
 	Range			m_VertexBuffeRange;
-	Range			m_IndexBufferRange;
+	Range			m_IndexBufferRange;		// Indices of all submeshes, in order
 
 	std::string		m_ObjectName;
-	std::string		m_MaterialName;
+
+	// Only set with VertexCompressionMode::Quantized
+	VertexCompression::QuantizationBounds	m_QuantizationBounds;
+
+	// Always at least one. Submeshes are contiguous in the index buffer
+	std::vector<SubMeshInfo>				m_SubMeshes;
 
 	MeshInfo();
 	MeshInfo(const MeshInfo& inPreviousMeshInfo);
 
+	void StartSubMesh(int inIndexBufferStart);
 	void EndRange(int inVertexBufferEnd, int inIndexBufferEnd);
 };
 
@@ -65,36 +102,161 @@ struct MaterialInfo
 	bool m_IsTransparent = false;
 };
 
+// Position/UV/Normal indices of a face element. 0 based
+struct OBJVertexIndices
+{
+	int32	m_Position	= 0;
+	int32	m_UV		= 0;
+	int32	m_Normal	= 0;
+
+	inline bool operator==(const OBJVertexIndices& inOther) const
+	{
+		return m_Position == inOther.m_Position && m_UV == inOther.m_UV && m_Normal == inOther.m_Normal;
+	}
+};
+
+using OBJFace = std::array<OBJVertexIndices, 3>;
+
+// Open addressing hash table used to deduplicate vertices.
+// Clearing is O(1): entries are tagged with a generation so the table can be reused across MeshInfos
+class VertexIndexMap final
+{
+public:
+	void	Reserve(size_t inNumElements);
+	void	Clear();
+
+	// Returns true if inKey was inserted with inNewIndex. Otherwise outIndex is the index already associated with inKey
+	bool	FindOrInsert(const OBJVertexIndices& inKey, uint32 inNewIndex, uint32& outIndex);
+
+	inline uint64	GetNumLookups() const		{ return m_NumLookups; }
+
+private:
+	void	Grow(size_t inNewCapacity);
+
+	static uint32	Hash(const OBJVertexIndices& inKey);
+
+private:
+	struct Entry
+	{
+		OBJVertexIndices	m_Key;
+		uint32				m_Index			= 0;
+		uint32				m_Generation	= 0;
+	};
+
+	std::vector<Entry>	m_Entries;
+	uint32				m_Generation	= 1;
+	size_t				m_NumElements	= 0;
+	uint64				m_NumLookups	= 0;
+};
+
+// Result of parsing a slice of an OBJ file.
+// Chunks are parsed independently (and in parallel) then merged back in file order.
+struct OBJChunk
+{
+	// Statements that change the loader state (o, usemtl, mtllib). Replayed in order while merging
+	struct Event
+	{
+		OBJKeyword			m_Keyword;
+		std::string_view	m_Name;
+		size_t				m_FaceIndex;	// Number of faces of the chunk that come before this event
+	};
+
+	std::vector<Vec3>							m_Positions;
+	std::vector<Vec3>							m_Normals;
+	std::vector<Vec2>							m_UVCoords;
+	std::vector<OBJFace>						m_Faces;
+	std::vector<Event>							m_Events;
+};
+
+enum class VertexCompressionMode
+{
+	None,
+	Packed,		// VertexPosUVNormalPacked
+	Quantized	// VertexPosUVNormalQuantized
+};
+
+// Optional processing stages applied once an OBJ file is loaded.
+// New settings must also be added to the cache key, in BakedMesh::AddToCacheKey
+struct MeshImportSettings
+{
+	// Reorder triangles for the post-transform vertex cache, then vertices for fetch locality
+	bool	m_OptimizeVertexCache	= true;
+	// Sort triangle clusters of opaque meshes to reduce overdraw. Requires m_OptimizeVertexCache
+	bool	m_OptimizeOverdraw		= true;
+	// How much the ACMR is allowed to degrade when splitting clusters for overdraw
+	float	m_OverdrawACMRThreshold	= 1.05f;
+	// Rasterize opaque meshes before and after the overdraw optimization and trace the result. Slow, for tuning only.
+	// Doesn't change the mesh so it isn't part of the cache key
+	bool	m_AnalyzeOverdraw		= false;
+	// Number of simplified LODs generated on top of the full resolution mesh
+	uint32	m_NumLODs				= 0;
+	// Each LOD targets this ratio of the triangles of the previous one
+	float	m_LODTriangleRatio		= 0.5f;
+	// Max simplification error, relative to the radius of the mesh
+	float	m_LODMaxError			= 0.02f;
+	// Split the full resolution submeshes into meshlets with culling bounds, baked with the mesh
+	bool	m_BuildMeshlets			= false;
+	// Encode a compressed copy of the vertices and report the round-trip error. Baked next to the full precision vertices,
+	// which the renderer still draws with
+	VertexCompressionMode	m_VertexCompression	= VertexCompressionMode::None;
+};
+
 class MeshLoader final
 {
+	friend class BakedMesh;
+
 public:
-	void	LoadFromFile(const std::string& inFile);
+	// Bump when the loader produces different meshes from the same OBJ file and settings. Invalidates cached bakes
+	static constexpr uint32 ImporterVersion = 3;
+
+	explicit MeshLoader(const MeshImportSettings& inSettings = MeshImportSettings());
+	~MeshLoader();
+
+	// The file is split into inNumChunks parsed in parallel by the job system, 0 for one per worker
+	void	LoadFromFile(const std::string& inFile, uint32 inNumChunks = 0);
+	// In MeshFinalize.cpp, with the rest of the renderer dependencies
 	void	Finalize(ID3D12GraphicsCommandList2& inCommandList,
-					 const std::map<std::string, ShaderObject*>& inShaderObjects, RenderBuckets& ioBuckets);
+					 const std::map<std::string, ShaderObject*>& inShaderObjects, std::vector<DrawableObject*>& ioDrawableObjects);
+
+	// Files read by LoadFromFile: the OBJ file then the material libraries it references
+	static bool	GetSourceFiles(const std::string& inFile, std::vector<std::string>& outFiles);
 
 private:
-	void	ProcessLine(const std::string& inLine);
-	void	ProcessTriangle(const std::vector<std::string>& inFaceElements);
+	void	MergeChunks(const std::vector<OBJChunk>& inChunks);
+	void	ProcessEvent(const OBJChunk::Event& inEvent);
+	void	ProcessTriangle(const OBJFace& inFace);
 	void	ReverseWinding();
+	void	ComputeBounds();
+	void	OptimizeMeshes();
+	void	GenerateLODs();
+	void	BuildMeshlets();
+	void	CompressVertices(const std::string& inFile);
 	void	ProcessMaterialLibraryFile(const std::string& inFile);
+	bool	IsMaterialTransparent(const std::string& inMaterialName) const;
 
 private:
-	static std::map<std::string, OBJKeyword> s_OBJKeywords;
-
-	static OBJKeyword GetKeywordFromString(const std::string& inStr);
-public:
-	static void Init();
+	static std::string	GetMaterialLibraryPath(const std::string& inFile, std::string_view inName);
+	static void			ParseChunk(const char* inBegin, const char* inEnd, OBJChunk& outChunk);
+	static void			ParseLine(std::string_view inLine, OBJChunk& ioChunk);
+	static OBJKeyword	GetKeywordFromString(std::string_view inStr);
 
 private:
+	MeshImportSettings				m_Settings;
+	std::string						m_File;		// OBJ file being loaded
+
 	// TODO: Hardcoded VertexFormat
 	std::vector<Vec3>				m_AllPositions;
 	std::vector<Vec3>				m_AllNormals;
 	std::vector<Vec2>				m_AllUVCoords;
 	std::vector<VertexPosUVNormal>	m_VertexData;
-	std::vector<uint16>				m_IndexData;
-	std::map<std::string, uint16>	m_IndexMap;
+	std::vector<uint32>				m_IndexData;
+	std::vector<uint32>				m_LODIndexData;
+	std::vector<VertexPosUVNormalPacked>	m_PackedVertexData;
+	std::vector<VertexPosUVNormalQuantized>	m_QuantizedVertexData;
+	MeshletData						m_MeshletData;
+	VertexIndexMap					m_IndexMap;
 
-	uint16							m_IncrementalIndexValue	= 0;
+	uint32							m_IncrementalIndexValue	= 0;
 
 	std::vector<MeshInfo*>			m_MeshInfos;
 	size_t							m_CurrentMeshInfo		= 0;
@@ -0,0 +1,935 @@
+#include "Engine.h"
+#include "MeshOptimizer.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <numeric>
+#include <unordered_map>
+
+namespace MeshOptimizer
+{
+	void VertexCacheStatistics::Accumulate(const VertexCacheStatistics& inOther)
+	{
+		m_NumTransforms		+= inOther.m_NumTransforms;
+		m_NumTriangles		+= inOther.m_NumTriangles;
+		m_NumVertices		+= inOther.m_NumVertices;
+	}
+
+	void OverdrawStatistics::Accumulate(const OverdrawStatistics& inOther)
+	{
+		m_NumPixelsCovered	+= inOther.m_NumPixelsCovered;
+		m_NumPixelsShaded	+= inOther.m_NumPixelsShaded;
+	}
+
+	VertexCacheStatistics AnalyzeVertexCache(const uint32* inIndices, size_t inNumIndices, size_t inNumVertices, uint32 inCacheSize/* = 16*/)
+	{
+		Assert((inNumIndices % 3) == 0);
+		Assert(inCacheSize > 0);
+
+		VertexCacheStatistics statistics;
+		statistics.m_NumTriangles = inNumIndices / 3;
+
+		// Timestamp at which each vertex entered the cache. A vertex is in the cache if it entered less than inCacheSize misses ago
+		std::vector<uint64> cache_timestamps(inNumVertices, 0);
+		std::vector<bool> is_referenced(inNumVertices, false);
+		uint64 timestamp = inCacheSize + 1;
+
+		for (size_t i = 0; i < inNumIndices; i++)
+		{
+			const uint32 index = inIndices[i];
+			Assert(index < inNumVertices);
+
+			if (timestamp - cache_timestamps[index] > inCacheSize)
+			{
+				cache_timestamps[index] = timestamp++;
+				statistics.m_NumTransforms++;
+			}
+
+			if (!is_referenced[index])
+			{
+				is_referenced[index] = true;
+				statistics.m_NumVertices++;
+			}
+		}
+
+		return statistics;
+	}
+
+	// Forsyth's scoring constants. See https://tomforsyth1000.github.io/papers/fast_vert_cache_opt.html
+	constexpr uint32	s_CacheSize				= 32;
+	constexpr float		s_CacheDecayPower		= 1.5f;
+	constexpr float		s_LastTriangleScore		= 0.75f;
+	constexpr float		s_ValenceBoostScale		= 2.0f;
+	constexpr float		s_ValenceBoostPower		= 0.5f;
+
+	static float ComputeVertexScore(int32 inCachePosition, uint32 inRemainingTriangles)
+	{
+		// Vertex isn't used by any remaining triangle
+		if (inRemainingTriangles == 0)
+			return -1.0f;
+
+		float score = 0.0f;
+		if (inCachePosition >= 0)
+		{
+			if (inCachePosition < 3)
+			{
+				// Vertices of the last triangle get a fixed score so the same triangle isn't favored in every direction
+				score = s_LastTriangleScore;
+			}
+			else
+			{
+				Assert(inCachePosition < (int32) s_CacheSize);
+				const float scaler = 1.0f / (s_CacheSize - 3);
+				score = ::powf(1.0f - (inCachePosition - 3) * scaler, s_CacheDecayPower);
+			}
+		}
+
+		// Boost vertices with few triangles left so they get finished off instead of leaving lonely triangles behind
+		score += s_ValenceBoostScale * ::powf(static_cast<float>(inRemainingTriangles), -s_ValenceBoostPower);
+
+		return score;
+	}
+
+	void OptimizeVertexCache(uint32* ioIndices, size_t inNumIndices, size_t inNumVertices)
+	{
+		Assert((inNumIndices % 3) == 0);
+
+		const size_t num_triangles = inNumIndices / 3;
+		if (num_triangles == 0)
+			return;
+
+		// Build vertex to triangle adjacency
+		std::vector<uint32> triangle_counts(inNumVertices, 0);
+		for (size_t i = 0; i < inNumIndices; i++)
+		{
+			Assert(ioIndices[i] < inNumVertices);
+			triangle_counts[ioIndices[i]]++;
+		}
+
+		std::vector<uint32> adjacency_offsets(inNumVertices + 1, 0);
+		for (size_t v = 0; v < inNumVertices; v++)
+			adjacency_offsets[v + 1] = adjacency_offsets[v] + triangle_counts[v];
+
+		std::vector<uint32> adjacency(inNumIndices);
+		{
+			std::vector<uint32> fill_offsets(adjacency_offsets.begin(), adjacency_offsets.end() - 1);
+			for (size_t i = 0; i < inNumIndices; i++)
+				adjacency[fill_offsets[ioIndices[i]]++] = static_cast<uint32>(i / 3);
+		}
+
+		// Remaining triangles per vertex. Adjacency lists are kept compact by swapping emitted triangles at the end
+		std::vector<uint32>& remaining_triangles = triangle_counts;
+
+		std::vector<int32> cache_positions(inNumVertices, -1);
+		std::vector<float> vertex_scores(inNumVertices);
+		for (size_t v = 0; v < inNumVertices; v++)
+			vertex_scores[v] = ComputeVertexScore(-1, remaining_triangles[v]);
+
+		std::vector<bool>	is_triangle_emitted(num_triangles, false);
+		std::vector<uint32>	output_indices;
+		output_indices.reserve(inNumIndices);
+
+		// LRU cache. Holds up to 3 extra entries while the newest triangle is being pushed
+		uint32 cache[s_CacheSize + 3];
+		uint32 cache_count = 0;
+
+		size_t next_unemitted_triangle = 0;
+		int64 best_triangle = 0;
+
+		for (size_t emitted = 0; emitted < num_triangles; emitted++)
+		{
+			// Nothing good in the cache. Fallback to the next triangle in input order
+			if (best_triangle < 0)
+			{
+				while (is_triangle_emitted[next_unemitted_triangle])
+					next_unemitted_triangle++;
+
+				best_triangle = static_cast<int64>(next_unemitted_triangle);
+			}
+
+			const uint32* triangle = &ioIndices[best_triangle * 3];
+			output_indices.insert(output_indices.end(), triangle, triangle + 3);
+			is_triangle_emitted[best_triangle] = true;
+
+			// Remove the triangle from the adjacency of its vertices
+			for (uint32 k = 0; k < 3; k++)
+			{
+				const uint32 vertex = triangle[k];
+				uint32* begin	= &adjacency[adjacency_offsets[vertex]];
+				uint32* end		= begin + remaining_triangles[vertex];
+
+				for (uint32* it = begin; it != end; ++it)
+				{
+					if (*it == static_cast<uint32>(best_triangle))
+					{
+						std::swap(*it, *(end - 1));
+						break;
+					}
+				}
+
+				remaining_triangles[vertex]--;
+			}
+
+			// Push the triangle's vertices at the front of the LRU cache
+			uint32 new_cache[s_CacheSize + 3];
+			uint32 new_cache_count = 0;
+			for (uint32 k = 0; k < 3; k++)
+				new_cache[new_cache_count++] = triangle[k];
+
+			for (uint32 c = 0; c < cache_count; c++)
+			{
+				const uint32 vertex = cache[c];
+				if (vertex != triangle[0] && vertex != triangle[1] && vertex != triangle[2])
+					new_cache[new_cache_count++] = vertex;
+			}
+
+			// Vertices pushed out of the cache lose their cache score
+			for (uint32 c = s_CacheSize; c < new_cache_count; c++)
+			{
+				const uint32 vertex = new_cache[c];
+				cache_positions[vertex]	= -1;
+				vertex_scores[vertex]	= ComputeVertexScore(-1, remaining_triangles[vertex]);
+			}
+
+			cache_count = Math::Min(new_cache_count, s_CacheSize);
+			::memcpy(cache, new_cache, cache_count * sizeof(uint32));
+
+			// Update scores of vertices in the cache and of their remaining triangles
+			for (uint32 c = 0; c < cache_count; c++)
+			{
+				const uint32 vertex = cache[c];
+				cache_positions[vertex]	= static_cast<int32>(c);
+				vertex_scores[vertex]	= ComputeVertexScore(static_cast<int32>(c), remaining_triangles[vertex]);
+			}
+
+			best_triangle = -1;
+			float best_score = -1.0f;
+
+			for (uint32 c = 0; c < cache_count; c++)
+			{
+				const uint32 vertex = cache[c];
+				const uint32* begin	= &adjacency[adjacency_offsets[vertex]];
+				const uint32* end	= begin + remaining_triangles[vertex];
+
+				for (const uint32* it = begin; it != end; ++it)
+				{
+					const uint32 t = *it;
+					const float score = vertex_scores[ioIndices[t * 3 + 0]] + vertex_scores[ioIndices[t * 3 + 1]] + vertex_scores[ioIndices[t * 3 + 2]];
+
+					if (score > best_score)
+					{
+						best_score		= score;
+						best_triangle	= t;
+					}
+				}
+			}
+		}
+
+		::memcpy(ioIndices, output_indices.data(), inNumIndices * sizeof(uint32));
+	}
+
+	void OptimizeVertexFetch(void* ioVertices, size_t inNumVertices, size_t inVertexSize, uint32* ioIndices, size_t inNumIndices)
+	{
+		constexpr uint32 unassigned = ~0u;
+
+		// Assign new indices in order of first use
+		std::vector<uint32> remap(inNumVertices, unassigned);
+		uint32 next_index = 0;
+
+		for (size_t i = 0; i < inNumIndices; i++)
+		{
+			const uint32 index = ioIndices[i];
+			Assert(index < inNumVertices);
+
+			if (remap[index] == unassigned)
+				remap[index] = next_index++;
+
+			ioIndices[i] = remap[index];
+		}
+
+		// Keep unreferenced vertices at the end so the vertex count doesn't change
+		for (size_t v = 0; v < inNumVertices; v++)
+		{
+			if (remap[v] == unassigned)
+				remap[v] = next_index++;
+		}
+
+		Byte* vertices = static_cast<Byte*>(ioVertices);
+		std::vector<Byte> original_vertices(vertices, vertices + inNumVertices * inVertexSize);
+
+		for (size_t v = 0; v < inNumVertices; v++)
+			::memcpy(vertices + remap[v] * inVertexSize, original_vertices.data() + v * inVertexSize, inVertexSize);
+	}
+
+	static inline Vec3 GetPosition(const float* inPositions, size_t inVertexStride, uint32 inIndex)
+	{
+		const float* position = reinterpret_cast<const float*>(reinterpret_cast<const Byte*>(inPositions) + inIndex * inVertexStride);
+		return Vec3(position[0], position[1], position[2]);
+	}
+
+	// Rasterize triangles seen along inViewDirection with an orthographic projection.
+	// Front faces are clockwise as seen by the viewer, like D3D12 with FrontCounterClockwise = false
+	static void RasterizeView(const uint32* inIndices, size_t inNumIndices, const float* inPositions, size_t inVertexStride,
+							  const Vec3& inCenter, float inRadius, const Vec3& inViewDirection,
+							  std::vector<float>& ioDepthBuffer, OverdrawStatistics& ioStatistics)
+	{
+		constexpr int32 resolution = 256;
+
+		// Any vector not parallel to the view direction will do to build the basis
+		const Vec3 up_hint	= Math::Abs(inViewDirection.y) < 0.9f ? Vec3(0.0f, 1.0f, 0.0f) : Vec3(1.0f, 0.0f, 0.0f);
+		const Vec3 right	= Vec3::CrossProduct(up_hint, inViewDirection).Normalized();
+		const Vec3 up		= Vec3::CrossProduct(inViewDirection, right);
+
+		// Map the bounding sphere to the whole viewport
+		const float scale = resolution / (2.0f * inRadius);
+
+		std::fill(ioDepthBuffer.begin(), ioDepthBuffer.end(), std::numeric_limits<float>::max());
+		std::vector<bool> is_covered(ioDepthBuffer.size(), false);
+
+		for (size_t i = 0; i < inNumIndices; i += 3)
+		{
+			float x[3], y[3], z[3];
+			for (uint32 k = 0; k < 3; k++)
+			{
+				const Vec3 position = GetPosition(inPositions, inVertexStride, inIndices[i + k]) - inCenter;
+				x[k] = (Vec3::DotProduct(position, right) + inRadius) * scale;
+				y[k] = (Vec3::DotProduct(position, up) + inRadius) * scale;
+				z[k] = Vec3::DotProduct(position, inViewDirection);
+			}
+
+			// Counter clockwise in a Y up viewport means back facing
+			const float area = (x[1] - x[0]) * (y[2] - y[0]) - (x[2] - x[0]) * (y[1] - y[0]);
+			if (area >= 0.0f)
+				continue;
+
+			const int32 min_x = Math::Max(0,				static_cast<int32>(::floorf(Math::Min(x[0], Math::Min(x[1], x[2])))));
+			const int32 max_x = Math::Min(resolution - 1,	static_cast<int32>(::ceilf(Math::Max(x[0], Math::Max(x[1], x[2])))));
+			const int32 min_y = Math::Max(0,				static_cast<int32>(::floorf(Math::Min(y[0], Math::Min(y[1], y[2])))));
+			const int32 max_y = Math::Min(resolution - 1,	static_cast<int32>(::ceilf(Math::Max(y[0], Math::Max(y[1], y[2])))));
+
+			const float inv_area = 1.0f / area;
+
+			for (int32 py = min_y; py <= max_y; py++)
+			{
+				for (int32 px = min_x; px <= max_x; px++)
+				{
+					const float sample_x = px + 0.5f;
+					const float sample_y = py + 0.5f;
+
+					// Barycentric coordinates. All of them are positive inside the triangle
+					const float w0 = ((x[2] - x[1]) * (sample_y - y[1]) - (y[2] - y[1]) * (sample_x - x[1])) * inv_area;
+					const float w1 = ((x[0] - x[2]) * (sample_y - y[2]) - (y[0] - y[2]) * (sample_x - x[2])) * inv_area;
+					const float w2 = 1.0f - w0 - w1;
+
+					if (w0 <= 0.0f || w1 <= 0.0f || w2 <= 0.0f)
+						continue;
+
+					const float depth		= w0 * z[0] + w1 * z[1] + w2 * z[2];
+					const size_t pixel		= static_cast<size_t>(py) * resolution + px;
+
+					if (depth < ioDepthBuffer[pixel])
+					{
+						ioDepthBuffer[pixel] = depth;
+						ioStatistics.m_NumPixelsShaded++;
+
+						if (!is_covered[pixel])
+						{
+							is_covered[pixel] = true;
+							ioStatistics.m_NumPixelsCovered++;
+						}
+					}
+				}
+			}
+		}
+	}
+
+	OverdrawStatistics AnalyzeOverdraw(const uint32* inIndices, size_t inNumIndices,
+									   const float* inPositions, size_t inNumVertices, size_t inVertexStride)
+	{
+		Assert((inNumIndices % 3) == 0);
+
+		OverdrawStatistics statistics;
+		if (inNumIndices == 0 || inNumVertices == 0)
+			return statistics;
+
+		// Bounding sphere from the AABB is good enough to frame the mesh
+		Vec3 min_position = GetPosition(inPositions, inVertexStride, 0);
+		Vec3 max_position = min_position;
+		for (uint32 v = 1; v < inNumVertices; v++)
+		{
+			const Vec3 position = GetPosition(inPositions, inVertexStride, v);
+			for (int32 k = 0; k < 3; k++)
+			{
+				min_position[k] = Math::Min(min_position[k], position[k]);
+				max_position[k] = Math::Max(max_position[k], position[k]);
+			}
+		}
+
+		const Vec3 center	= (min_position + max_position) * 0.5f;
+		const float radius	= Math::Max((max_position - center).Length(), 1e-6f);
+
+		// Both ways along the 3 axes and the 4 cube diagonals
+		const Vec3 view_directions[] =
+		{
+			Vec3( 1.0f,  0.0f,  0.0f),	Vec3(-1.0f,  0.0f,  0.0f),
+			Vec3( 0.0f,  1.0f,  0.0f),	Vec3( 0.0f, -1.0f,  0.0f),
+			Vec3( 0.0f,  0.0f,  1.0f),	Vec3( 0.0f,  0.0f, -1.0f),
+			Vec3( 1.0f,  1.0f,  1.0f),	Vec3(-1.0f, -1.0f, -1.0f),
+			Vec3(-1.0f,  1.0f,  1.0f),	Vec3( 1.0f, -1.0f, -1.0f),
+			Vec3( 1.0f, -1.0f,  1.0f),	Vec3(-1.0f,  1.0f, -1.0f),
+			Vec3( 1.0f,  1.0f, -1.0f),	Vec3(-1.0f, -1.0f,  1.0f),
+		};
+
+		std::vector<float> depth_buffer(256 * 256);
+		for (const Vec3& view_direction : view_directions)
+			RasterizeView(inIndices, inNumIndices, inPositions, inVertexStride, center, radius, view_direction.Normalized(), depth_buffer, statistics);
+
+		return statistics;
+	}
+
+	// Number of FIFO cache misses of each triangle in [inBegin, inEnd) when drawn in order
+	static void SimulateCacheMisses(const uint32* inIndices, size_t inBegin, size_t inEnd, uint32 inCacheSize,
+									std::vector<uint64>& ioCacheTimestamps, uint64& ioTimestamp, std::vector<uint32>& outMisses)
+	{
+		for (size_t t = inBegin; t < inEnd; t++)
+		{
+			uint32 misses = 0;
+			for (uint32 k = 0; k < 3; k++)
+			{
+				const uint32 index = inIndices[t * 3 + k];
+				if (ioTimestamp - ioCacheTimestamps[index] > inCacheSize)
+				{
+					ioCacheTimestamps[index] = ioTimestamp++;
+					misses++;
+				}
+			}
+
+			outMisses[t] = misses;
+		}
+	}
+
+	// Reorder clusters of triangles, cluster c being [inClusterBoundaries[c], inClusterBoundaries[c + 1]), keeping the order
+	// of the triangles within each cluster
+	static void SortClusters(const uint32* inIndices, const std::vector<size_t>& inClusterBoundaries,
+							 const float* inPositions, size_t inVertexStride, std::vector<uint32>& outIndices)
+	{
+		const size_t num_clusters = inClusterBoundaries.size() - 1;
+
+		// Area weighted centroid of the mesh
+		Vec3 mesh_centroid(0.0f, 0.0f, 0.0f);
+		float mesh_area = 0.0f;
+
+		// Per cluster: sum of the area weighted normals, sum of dot(triangle centroid, area weighted normal) and area
+		std::vector<Vec3> cluster_normals(num_clusters, Vec3(0.0f, 0.0f, 0.0f));
+		std::vector<float> cluster_dots(num_clusters, 0.0f);
+		std::vector<float> cluster_areas(num_clusters, 0.0f);
+
+		for (size_t c = 0; c < num_clusters; c++)
+		{
+			for (size_t t = inClusterBoundaries[c]; t < inClusterBoundaries[c + 1]; t++)
+			{
+				const Vec3 p0 = GetPosition(inPositions, inVertexStride, inIndices[t * 3 + 0]);
+				const Vec3 p1 = GetPosition(inPositions, inVertexStride, inIndices[t * 3 + 1]);
+				const Vec3 p2 = GetPosition(inPositions, inVertexStride, inIndices[t * 3 + 2]);
+
+				// Clockwise front faces: this normal points outward
+				const Vec3 normal		= Vec3::CrossProduct(p1 - p0, p2 - p0);
+				const float area		= normal.Length();
+				const Vec3 centroid		= (p0 + p1 + p2) * (1.0f / 3.0f);
+
+				cluster_normals[c]		+= normal;
+				cluster_dots[c]			+= Vec3::DotProduct(centroid, normal);
+				cluster_areas[c]		+= area;
+				mesh_centroid			+= centroid * area;
+			}
+
+			mesh_area += cluster_areas[c];
+		}
+
+		if (mesh_area > 0.0f)
+			mesh_centroid = mesh_centroid * (1.0f / mesh_area);
+
+		// Clusters facing away from the center of the mesh are likely to occlude others. Draw them first.
+		// The key is the area weighted average over the triangles of dot(centroid - mesh centroid, normal) rather than the
+		// same with the averages of the cluster: a closed cluster, a whole object, has no average normal to sort by
+		std::vector<float> cluster_keys(num_clusters);
+		for (size_t c = 0; c < num_clusters; c++)
+		{
+			const float dot = cluster_dots[c] - Vec3::DotProduct(mesh_centroid, cluster_normals[c]);
+			cluster_keys[c] = cluster_areas[c] > 0.0f ? dot / cluster_areas[c] : 0.0f;
+		}
+
+		std::vector<size_t> cluster_order(num_clusters);
+		std::iota(cluster_order.begin(), cluster_order.end(), 0);
+		std::stable_sort(cluster_order.begin(), cluster_order.end(), [&cluster_keys](size_t inA, size_t inB)
+		{
+			return cluster_keys[inA] > cluster_keys[inB];
+		});
+
+		outIndices.clear();
+		for (size_t c : cluster_order)
+			outIndices.insert(outIndices.end(), inIndices + inClusterBoundaries[c] * 3, inIndices + inClusterBoundaries[c + 1] * 3);
+	}
+
+	void OptimizeOverdraw(uint32* ioIndices, size_t inNumIndices,
+						  const float* inPositions, size_t inNumVertices, size_t inVertexStride,
+						  float inACMRThreshold/* = 1.05f*/)
+	{
+		Assert((inNumIndices % 3) == 0);
+		Assert(inACMRThreshold >= 1.0f);
+
+		constexpr uint32 cache_size = 16;
+
+		const size_t num_triangles = inNumIndices / 3;
+		if (num_triangles == 0)
+			return;
+
+		std::vector<uint64> cache_timestamps(inNumVertices, 0);
+		std::vector<uint32> misses(num_triangles);
+		uint64 timestamp = cache_size + 1;
+
+		SimulateCacheMisses(ioIndices, 0, num_triangles, cache_size, cache_timestamps, timestamp, misses);
+
+		// Hard boundaries: triangles with 3 misses start from a cold cache so cutting there is free
+		std::vector<size_t> hard_boundaries;
+		for (size_t t = 0; t < num_triangles; t++)
+		{
+			if (t == 0 || misses[t] == 3)
+				hard_boundaries.push_back(t);
+		}
+		hard_boundaries.push_back(num_triangles);
+
+		// Soft boundaries: split hard clusters further as long as the ACMR stays within the threshold
+		std::vector<size_t> cluster_boundaries;
+		std::vector<uint32> cold_misses(num_triangles);
+		for (size_t h = 0; h + 1 < hard_boundaries.size(); h++)
+		{
+			const size_t begin	= hard_boundaries[h];
+			const size_t end	= hard_boundaries[h + 1];
+
+			uint32 cluster_misses = 0;
+			for (size_t t = begin; t < end; t++)
+				cluster_misses += misses[t];
+
+			const float cluster_threshold = inACMRThreshold * float(cluster_misses) / float(end - begin);
+
+			// Every sub cluster restarts from a cold cache
+			timestamp += cache_size + 1;
+
+			cluster_boundaries.push_back(begin);
+
+			uint32 running_misses		= 0;
+			uint32 running_triangles	= 0;
+			for (size_t t = begin; t < end; t++)
+			{
+				SimulateCacheMisses(ioIndices, t, t + 1, cache_size, cache_timestamps, timestamp, cold_misses);
+
+				running_misses += cold_misses[t];
+				running_triangles++;
+
+				if (t + 1 < end && float(running_misses) / float(running_triangles) <= cluster_threshold)
+				{
+					cluster_boundaries.push_back(t + 1);
+
+					timestamp			+= cache_size + 1;
+					running_misses		= 0;
+					running_triangles	= 0;
+				}
+			}
+		}
+		cluster_boundaries.push_back(num_triangles);
+
+		// Sub clusters are measured on their own from a cold cache. Once reordered, clusters also lose the vertices the previous
+		// ones left in the cache, so the result can still go past the threshold. Check it, and fall back to the hard clusters
+		// only, then to the input order
+		const double max_num_transforms = inACMRThreshold * double(AnalyzeVertexCache(ioIndices, inNumIndices, inNumVertices, cache_size).m_NumTransforms);
+
+		std::vector<uint32> output_indices;
+		output_indices.reserve(inNumIndices);
+
+		for (const std::vector<size_t>* boundaries : { &cluster_boundaries, &hard_boundaries })
+		{
+			SortClusters(ioIndices, *boundaries, inPositions, inVertexStride, output_indices);
+
+			if (double(AnalyzeVertexCache(output_indices.data(), inNumIndices, inNumVertices, cache_size).m_NumTransforms) <= max_num_transforms)
+			{
+				::memcpy(ioIndices, output_indices.data(), inNumIndices * sizeof(uint32));
+				return;
+			}
+		}
+	}
+
+	// Sum of squared distances to a set of planes: p'Ap + 2b'p + c, weighted by area
+	struct Quadric
+	{
+		double	m_A00 = 0.0, m_A11 = 0.0, m_A22 = 0.0;
+		double	m_A01 = 0.0, m_A02 = 0.0, m_A12 = 0.0;
+		double	m_B0 = 0.0, m_B1 = 0.0, m_B2 = 0.0;
+		double	m_C = 0.0;
+		double	m_Weight = 0.0;
+
+		// Plane of unit normal inNormal going through inPoint
+		static Quadric FromPlane(const Vec3& inNormal, const Vec3& inPoint, double inWeight)
+		{
+			const double nx = inNormal.x, ny = inNormal.y, nz = inNormal.z;
+			const double d = -(nx * inPoint.x + ny * inPoint.y + nz * inPoint.z);
+
+			Quadric quadric;
+			quadric.m_A00		= inWeight * nx * nx;
+			quadric.m_A11		= inWeight * ny * ny;
+			quadric.m_A22		= inWeight * nz * nz;
+			quadric.m_A01		= inWeight * nx * ny;
+			quadric.m_A02		= inWeight * nx * nz;
+			quadric.m_A12		= inWeight * ny * nz;
+			quadric.m_B0		= inWeight * nx * d;
+			quadric.m_B1		= inWeight * ny * d;
+			quadric.m_B2		= inWeight * nz * d;
+			quadric.m_C			= inWeight * d * d;
+			quadric.m_Weight	= inWeight;
+
+			return quadric;
+		}
+
+		void Add(const Quadric& inOther)
+		{
+			m_A00 += inOther.m_A00;	m_A11 += inOther.m_A11;	m_A22 += inOther.m_A22;
+			m_A01 += inOther.m_A01;	m_A02 += inOther.m_A02;	m_A12 += inOther.m_A12;
+			m_B0 += inOther.m_B0;	m_B1 += inOther.m_B1;	m_B2 += inOther.m_B2;
+			m_C += inOther.m_C;
+			m_Weight += inOther.m_Weight;
+		}
+
+		// Weighted average of the squared distances to the planes
+		double GetError(const Vec3& inPoint) const
+		{
+			const double x = inPoint.x, y = inPoint.y, z = inPoint.z;
+
+			const double error =
+				m_A00 * x * x + m_A11 * y * y + m_A22 * z * z +
+				2.0 * (m_A01 * x * y + m_A02 * x * z + m_A12 * y * z) +
+				2.0 * (m_B0 * x + m_B1 * y + m_B2 * z) + m_C;
+
+			return m_Weight > 0.0 ? Math::Max(error, 0.0) / m_Weight : 0.0;
+		}
+	};
+
+	enum class VertexKind : uint8
+	{
+		Manifold,	// Can collapse anywhere
+		Border,		// Can only collapse along a border edge, onto another border vertex
+		Locked		// Seams and vertices locked by the caller. Never collapse, never lose their last triangle
+	};
+
+	struct Collapse
+	{
+		uint32	m_From;
+		uint32	m_To;
+		double	m_Error;
+	};
+
+	static inline uint64 GetEdgeKey(uint32 inFrom, uint32 inTo)
+	{
+		return (static_cast<uint64>(inFrom) << 32) | inTo;
+	}
+
+	// Sorted list of the directed edges of a triangle list
+	static std::vector<uint64> BuildDirectedEdges(const std::vector<uint32>& inIndices)
+	{
+		std::vector<uint64> edges;
+		edges.reserve(inIndices.size());
+
+		for (size_t i = 0; i < inIndices.size(); i += 3)
+		{
+			for (uint32 k = 0; k < 3; k++)
+				edges.push_back(GetEdgeKey(inIndices[i + k], inIndices[i + (k + 1) % 3]));
+		}
+
+		std::sort(edges.begin(), edges.end());
+		return edges;
+	}
+
+	static inline bool HasEdge(const std::vector<uint64>& inEdges, uint32 inFrom, uint32 inTo)
+	{
+		return std::binary_search(inEdges.begin(), inEdges.end(), GetEdgeKey(inFrom, inTo));
+	}
+
+	size_t SimplifyMesh(uint32* outIndices, const uint32* inIndices, size_t inNumIndices,
+						const float* inPositions, size_t inNumVertices, size_t inVertexStride,
+						size_t inTargetNumIndices, float inMaxError, float& outError,
+						const std::vector<bool>* inLockedVertices/* = nullptr*/)
+	{
+		Assert((inNumIndices % 3) == 0);
+
+		outError = 0.0f;
+
+		std::vector<uint32> indices(inIndices, inIndices + inNumIndices);
+		std::vector<Vec3> positions(inNumVertices);
+		for (uint32 v = 0; v < inNumVertices; v++)
+			positions[v] = GetPosition(inPositions, inVertexStride, v);
+
+		// Vertices sharing a position with another one are on a UV or normal seam
+		std::vector<VertexKind> vertex_kinds(inNumVertices, VertexKind::Manifold);
+		{
+			struct PositionHash
+			{
+				size_t operator()(const Vec3& inPosition) const
+				{
+					uint32 bits[3];
+					::memcpy(bits, &inPosition.x, sizeof(bits));
+					return (bits[0] * 73856093u) ^ (bits[1] * 19349663u) ^ (bits[2] * 83492791u);
+				}
+			};
+
+			std::unordered_map<Vec3, uint32, PositionHash> first_vertex;
+			first_vertex.reserve(inNumVertices);
+
+			for (uint32 v = 0; v < inNumVertices; v++)
+			{
+				if (inLockedVertices != nullptr && (*inLockedVertices)[v])
+					vertex_kinds[v] = VertexKind::Locked;
+
+				auto result = first_vertex.emplace(positions[v], v);
+				if (!result.second)
+				{
+					vertex_kinds[v]						= VertexKind::Locked;
+					vertex_kinds[result.first->second]	= VertexKind::Locked;
+				}
+			}
+		}
+
+		// Edges without their opposite are on the border of the mesh. Material boundaries end up there too
+		std::vector<Quadric> quadrics(inNumVertices);
+		{
+			const std::vector<uint64> edges = BuildDirectedEdges(indices);
+
+			for (size_t i = 0; i < indices.size(); i += 3)
+			{
+				const Vec3& p0 = positions[indices[i + 0]];
+				const Vec3& p1 = positions[indices[i + 1]];
+				const Vec3& p2 = positions[indices[i + 2]];
+
+				const Vec3 normal		= Vec3::CrossProduct(p1 - p0, p2 - p0);
+				const float length		= normal.Length();
+				if (length <= 0.0f)
+					continue;
+
+				const Vec3 unit_normal	= normal * (1.0f / length);
+				const Quadric quadric	= Quadric::FromPlane(unit_normal, p0, 0.5 * length);
+
+				for (uint32 k = 0; k < 3; k++)
+					quadrics[indices[i + k]].Add(quadric);
+
+				for (uint32 k = 0; k < 3; k++)
+				{
+					const uint32 from	= indices[i + k];
+					const uint32 to		= indices[i + (k + 1) % 3];
+					if (HasEdge(edges, to, from))
+						continue;
+
+					if (vertex_kinds[from] == VertexKind::Manifold)
+						vertex_kinds[from] = VertexKind::Border;
+					if (vertex_kinds[to] == VertexKind::Manifold)
+						vertex_kinds[to] = VertexKind::Border;
+
+					// Plane perpendicular to the triangle through the border edge keeps the outline in place
+					const Vec3 edge				= positions[to] - positions[from];
+					const float edge_length		= edge.Length();
+					if (edge_length <= 0.0f)
+						continue;
+
+					constexpr double border_weight = 10.0;
+					const Vec3 border_normal	= Vec3::CrossProduct(edge * (1.0f / edge_length), unit_normal);
+					const Quadric border		= Quadric::FromPlane(border_normal, positions[from], border_weight * edge_length * edge_length);
+
+					quadrics[from].Add(border);
+					quadrics[to].Add(border);
+				}
+			}
+		}
+
+		const double max_error = static_cast<double>(inMaxError) * inMaxError;
+		double result_error = 0.0;
+
+		std::vector<uint32>					remap(inNumVertices);
+		std::vector<bool>					is_collapse_locked(inNumVertices);
+		std::vector<Collapse>				collapses;
+		std::vector<uint32>					adjacency_offsets(inNumVertices + 1);
+		std::vector<uint32>					adjacency;
+		std::vector<uint32>					num_vertex_triangles(inNumVertices);
+		std::vector<uint32>					removed_triangles;
+
+		// Last passes only collapse a handful of edges each. Stop once close enough to the target
+		const size_t num_indices_tolerance = inTargetNumIndices / 100;
+
+		while (indices.size() > inTargetNumIndices + num_indices_tolerance)
+		{
+			const std::vector<uint64> edges = BuildDirectedEdges(indices);
+
+			// Gather candidates from every edge, in both directions
+			collapses.clear();
+			for (size_t i = 0; i < indices.size(); i += 3)
+			{
+				for (uint32 k = 0; k < 3; k++)
+				{
+					const uint32 v0 = indices[i + k];
+					const uint32 v1 = indices[i + (k + 1) % 3];
+
+					const bool is_border_edge = !HasEdge(edges, v1, v0);
+
+					const uint32 pairs[2][2] = { { v0, v1 }, { v1, v0 } };
+					for (const auto& pair : pairs)
+					{
+						const uint32 from	= pair[0];
+						const uint32 to		= pair[1];
+
+						const VertexKind kind = vertex_kinds[from];
+						if (kind == VertexKind::Locked)
+							continue;
+						if (kind == VertexKind::Border && (!is_border_edge || vertex_kinds[to] == VertexKind::Manifold))
+							continue;
+
+						Quadric quadric = quadrics[from];
+						quadric.Add(quadrics[to]);
+
+						const double error = quadric.GetError(positions[to]);
+						if (error <= max_error)
+							collapses.push_back({ from, to, error });
+					}
+				}
+			}
+
+			if (collapses.empty())
+				break;
+
+			std::sort(collapses.begin(), collapses.end(), [](const Collapse& inA, const Collapse& inB)
+			{
+				return inA.m_Error < inB.m_Error;
+			});
+
+			// Vertex to triangle adjacency, used to reject collapses that flip triangles
+			std::fill(adjacency_offsets.begin(), adjacency_offsets.end(), 0);
+			for (uint32 index : indices)
+				adjacency_offsets[index + 1]++;
+			for (size_t v = 0; v < inNumVertices; v++)
+				adjacency_offsets[v + 1] += adjacency_offsets[v];
+
+			adjacency.resize(indices.size());
+			{
+				std::vector<uint32> fill_offsets(adjacency_offsets.begin(), adjacency_offsets.end() - 1);
+				for (size_t i = 0; i < indices.size(); i++)
+					adjacency[fill_offsets[indices[i]]++] = static_cast<uint32>(i / 3);
+			}
+
+			std::iota(remap.begin(), remap.end(), 0);
+			std::fill(is_collapse_locked.begin(), is_collapse_locked.end(), false);
+
+			for (size_t v = 0; v < inNumVertices; v++)
+				num_vertex_triangles[v] = adjacency_offsets[v + 1] - adjacency_offsets[v];
+
+			// Each collapse removes about 2 triangles. Don't overshoot the target too much
+			const size_t num_triangles		= indices.size() / 3;
+			const size_t target_triangles	= inTargetNumIndices / 3;
+			const size_t max_collapses		= Math::Max<size_t>(1, (num_triangles - target_triangles) / 2);
+			size_t num_collapses			= 0;
+
+			for (const Collapse& collapse : collapses)
+			{
+				if (num_collapses >= max_collapses)
+					break;
+
+				const uint32 from	= collapse.m_From;
+				const uint32 to		= collapse.m_To;
+				if (is_collapse_locked[from] || is_collapse_locked[to])
+					continue;
+
+				// Moving from onto to must not flip any remaining triangle, nor remove the last triangle of a locked vertex
+				bool is_flipping = false;
+				removed_triangles.clear();
+				for (uint32 a = adjacency_offsets[from]; a < adjacency_offsets[from + 1] && !is_flipping; a++)
+				{
+					const uint32* triangle = &indices[adjacency[a] * 3];
+					const uint32 t0 = remap[triangle[0]], t1 = remap[triangle[1]], t2 = remap[triangle[2]];
+
+					// Already removed by a collapse of this pass
+					if (t0 == t1 || t1 == t2 || t0 == t2)
+						continue;
+
+					// Triangles using both vertices get removed
+					if (t0 == to || t1 == to || t2 == to)
+					{
+						removed_triangles.push_back(adjacency[a]);
+						continue;
+					}
+
+					const Vec3 p0 = positions[t0], p1 = positions[t1], p2 = positions[t2];
+					const Vec3 normal_before = Vec3::CrossProduct(p1 - p0, p2 - p0);
+
+					const Vec3 q0 = positions[t0 == from ? to : t0];
+					const Vec3 q1 = positions[t1 == from ? to : t1];
+					const Vec3 q2 = positions[t2 == from ? to : t2];
+					const Vec3 normal_after = Vec3::CrossProduct(q1 - q0, q2 - q0);
+
+					is_flipping = Vec3::DotProduct(normal_before, normal_after) <= 0.0f;
+				}
+
+				if (is_flipping)
+					continue;
+
+				// Third vertex of every removed triangle, then to, which gets the remaining triangles of from
+				bool is_orphaning = false;
+				for (uint32 triangle : removed_triangles)
+				{
+					const uint32 other = remap[indices[triangle * 3]] ^ remap[indices[triangle * 3 + 1]] ^ remap[indices[triangle * 3 + 2]] ^ from ^ to;
+					is_orphaning |= vertex_kinds[other] == VertexKind::Locked && num_vertex_triangles[other] == 1;
+				}
+
+				const uint32 num_removed = static_cast<uint32>(removed_triangles.size());
+				is_orphaning |= vertex_kinds[to] == VertexKind::Locked && num_vertex_triangles[to] + num_vertex_triangles[from] == 2 * num_removed;
+
+				if (is_orphaning)
+					continue;
+
+				for (uint32 triangle : removed_triangles)
+					num_vertex_triangles[remap[indices[triangle * 3]] ^ remap[indices[triangle * 3 + 1]] ^ remap[indices[triangle * 3 + 2]] ^ from ^ to]--;
+				num_vertex_triangles[to]	+= num_vertex_triangles[from] - 2 * num_removed;
+				num_vertex_triangles[from]	= 0;
+
+				remap[from] = to;
+				quadrics[to].Add(quadrics[from]);
+
+				is_collapse_locked[from]	= true;
+				is_collapse_locked[to]		= true;
+
+				result_error = Math::Max(result_error, collapse.m_Error);
+				num_collapses++;
+			}
+
+			if (num_collapses == 0)
+				break;
+
+			// Apply collapses and drop degenerate triangles
+			size_t write = 0;
+			for (size_t i = 0; i < indices.size(); i += 3)
+			{
+				const uint32 t0 = remap[indices[i + 0]];
+				const uint32 t1 = remap[indices[i + 1]];
+				const uint32 t2 = remap[indices[i + 2]];
+
+				if (t0 == t1 || t1 == t2 || t0 == t2)
+					continue;
+
+				indices[write++] = t0;
+				indices[write++] = t1;
+				indices[write++] = t2;
+			}
+
+			indices.resize(write);
+		}
+
+		::memcpy(outIndices, indices.data(), indices.size() * sizeof(uint32));
+		outError = static_cast<float>(::sqrt(result_error));
+
+		return indices.size();
+	}
+}
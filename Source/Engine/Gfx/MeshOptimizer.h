@@ -0,0 +1,69 @@
+#pragma once
+
+#include <vector>
+
+// Mesh processing algorithms working on raw triangle lists.
+// Nothing in here depends on D3D so it can be used by offline tools and tested on any platform.
+namespace MeshOptimizer
+{
+	// Result of a post-transform vertex cache simulation
+	struct VertexCacheStatistics
+	{
+		uint64	m_NumTransforms		= 0;	// Vertex shader invocations
+		uint64	m_NumTriangles		= 0;
+		uint64	m_NumVertices		= 0;	// Unique vertices referenced by the index buffer
+
+		// Average Cache Miss Ratio: Transforms per triangle. 0.5 is the best possible value, 3 the worst
+		inline float GetACMR() const	{ return m_NumTriangles > 0 ? float(m_NumTransforms) / float(m_NumTriangles) : 0.0f; }
+		// Average Transform to Vertex Ratio: Transforms per vertex. 1 is the best possible value
+		inline float GetATVR() const	{ return m_NumVertices > 0 ? float(m_NumTransforms) / float(m_NumVertices) : 0.0f; }
+
+		void Accumulate(const VertexCacheStatistics& inOther);
+	};
+
+	// Result of a CPU rasterization from several view directions
+	struct OverdrawStatistics
+	{
+		uint64	m_NumPixelsCovered	= 0;	// Pixels with at least one fragment passing the depth test
+		uint64	m_NumPixelsShaded	= 0;	// Fragments passing the depth test
+
+		// Pixel shader invocations per covered pixel. 1 is the best possible value
+		inline float GetOverdraw() const	{ return m_NumPixelsCovered > 0 ? float(m_NumPixelsShaded) / float(m_NumPixelsCovered) : 0.0f; }
+
+		void Accumulate(const OverdrawStatistics& inOther);
+	};
+
+	// Simulate a FIFO post-transform cache of inCacheSize entries
+	VertexCacheStatistics	AnalyzeVertexCache(const uint32* inIndices, size_t inNumIndices, size_t inNumVertices, uint32 inCacheSize = 16);
+
+	// Reorder triangles to maximize post-transform cache hits.
+	// Implementation of "Linear-Speed Vertex Cache Optimisation" by Tom Forsyth
+	void					OptimizeVertexCache(uint32* ioIndices, size_t inNumIndices, size_t inNumVertices);
+
+	// Estimate overdraw by rasterizing the mesh with back face culling and depth LESS, like RenderPass::OpaqueGeometry.
+	// Positions are read as 3 floats every inVertexStride bytes
+	OverdrawStatistics		AnalyzeOverdraw(const uint32* inIndices, size_t inNumIndices,
+											const float* inPositions, size_t inNumVertices, size_t inVertexStride);
+
+	// Split a vertex cache optimized index buffer into clusters and sort them so outer facing clusters are drawn first.
+	// Clusters are only split where it keeps the ACMR below inACMRThreshold times the ACMR of the input. The result is checked
+	// against that bound, the input order is kept when no clustering meets it.
+	// See "Fast Triangle Reordering for Vertex Locality and Reduced Overdraw" by Sander et al.
+	void					OptimizeOverdraw(uint32* ioIndices, size_t inNumIndices,
+											 const float* inPositions, size_t inNumVertices, size_t inVertexStride,
+											 float inACMRThreshold = 1.05f);
+
+	// Quadric error edge collapse simplification. Vertices are collapsed onto existing ones so the result uses the same vertex buffer.
+	// Vertices on seams (duplicated positions) and the ones set in inLockedVertices, if any, are locked: they stay in the result.
+	// Vertices on borders only slide along the border.
+	// Stops when the index count is within 1% of inTargetNumIndices or when the error would exceed inMaxError (object space distance).
+	// Returns the number of indices written to outIndices, which must be able to hold inNumIndices
+	size_t					SimplifyMesh(uint32* outIndices, const uint32* inIndices, size_t inNumIndices,
+										 const float* inPositions, size_t inNumVertices, size_t inVertexStride,
+										 size_t inTargetNumIndices, float inMaxError, float& outError,
+										 const std::vector<bool>* inLockedVertices = nullptr);
+
+	// Reorder vertices in the order they are first referenced by the index buffer to improve fetch locality.
+	// Indices are remapped accordingly. Unreferenced vertices are moved to the end of the buffer
+	void					OptimizeVertexFetch(void* ioVertices, size_t inNumVertices, size_t inVertexSize, uint32* ioIndices, size_t inNumIndices);
+}
@@ -0,0 +1,245 @@
+#include "Engine.h"
+#include "Meshlet.h"
+
+#include "Math/BoundingVolumes.h"
+
+namespace Meshlets
+{
+	static inline Vec3 GetPosition(const float* inPositions, size_t inVertexStride, uint32 inIndex)
+	{
+		const float* position = reinterpret_cast<const float*>(reinterpret_cast<const Byte*>(inPositions) + inIndex * inVertexStride);
+		return Vec3(position[0], position[1], position[2]);
+	}
+
+	static MeshletBounds ComputeBounds(const MeshletData& inData, const Meshlet& inMeshlet, const float* inPositions, size_t inVertexStride)
+	{
+		MeshletBounds bounds;
+
+		const uint32* vertex_indices	= &inData.m_VertexIndices[inMeshlet.m_VertexOffset];
+		const AABB aabb					= BoundingVolumes::ComputeAABB(vertex_indices, inMeshlet.m_NumVertices, inPositions, inVertexStride);
+		const BoundingSphere sphere		= BoundingVolumes::ComputeSphere(vertex_indices, inMeshlet.m_NumVertices, inPositions, inVertexStride, aabb);
+
+		bounds.m_AABBMin		= aabb.m_Min;
+		bounds.m_AABBMax		= aabb.m_Max;
+		bounds.m_SphereCenter	= sphere.m_Center;
+		bounds.m_SphereRadius	= sphere.m_Radius;
+
+		std::vector<Vec3> positions(inMeshlet.m_NumVertices);
+		for (uint32 v = 0; v < inMeshlet.m_NumVertices; v++)
+			positions[v] = GetPosition(inPositions, inVertexStride, inData.m_VertexIndices[inMeshlet.m_VertexOffset + v]);
+
+		// Normal cone. Front faces are clockwise in a left-handed space so the outward normal is (p1 - p0) x (p2 - p0)
+		std::vector<Vec3> normals;
+		normals.reserve(inMeshlet.m_NumTriangles);
+
+		Vec3 axis(0.0f, 0.0f, 0.0f);
+		for (uint32 t = 0; t < inMeshlet.m_NumTriangles; t++)
+		{
+			const uint8* triangle	= &inData.m_TriangleIndices[inMeshlet.m_TriangleOffset + t * 3];
+			const Vec3& p0			= positions[triangle[0]];
+			const Vec3& p1			= positions[triangle[1]];
+			const Vec3& p2			= positions[triangle[2]];
+
+			const Vec3 normal	= Vec3::CrossProduct(p1 - p0, p2 - p0);
+			const float length	= normal.Length();
+			if (length <= 0.0f)
+				continue;
+
+			normals.push_back(normal * (1.0f / length));
+			axis += normals.back();
+		}
+
+		// Meshlets that can't be backface culled get a cone that never passes the test
+		bounds.m_ConeApex	= bounds.m_SphereCenter;
+		bounds.m_ConeAxis	= Vec3(0.0f, 0.0f, 0.0f);
+		bounds.m_ConeCutoff	= 1.0f;
+
+		const float axis_length = axis.Length();
+		if (normals.empty() || axis_length <= 0.0f)
+			return bounds;
+
+		axis = axis * (1.0f / axis_length);
+
+		float min_dot = 1.0f;
+		for (const Vec3& normal : normals)
+			min_dot = Math::Min(min_dot, Vec3::DotProduct(axis, normal));
+
+		// Cone is too wide to be worth it
+		if (min_dot <= 0.1f)
+			return bounds;
+
+		// Move the apex back so the cone contains every triangle plane
+		float max_t = 0.0f;
+		for (uint32 t = 0, n = 0; t < inMeshlet.m_NumTriangles; t++)
+		{
+			const uint8* triangle	= &inData.m_TriangleIndices[inMeshlet.m_TriangleOffset + t * 3];
+			const Vec3& p0			= positions[triangle[0]];
+			const Vec3& p1			= positions[triangle[1]];
+			const Vec3& p2			= positions[triangle[2]];
+
+			if (Vec3::CrossProduct(p1 - p0, p2 - p0).Length() <= 0.0f)
+				continue;
+
+			const Vec3& normal = normals[n++];
+			const float t_plane = Vec3::DotProduct(bounds.m_SphereCenter - p0, normal) / Vec3::DotProduct(axis, normal);
+			max_t = Math::Max(max_t, t_plane);
+		}
+
+		bounds.m_ConeApex	= bounds.m_SphereCenter - axis * max_t;
+		bounds.m_ConeAxis	= axis;
+		bounds.m_ConeCutoff	= ::sqrtf(1.0f - min_dot * min_dot);
+
+		return bounds;
+	}
+
+	void Build(const uint32* inIndices, size_t inNumIndices,
+			   const float* inPositions, size_t inNumVertices, size_t inVertexStride, MeshletData& ioData)
+	{
+		Assert((inNumIndices % 3) == 0);
+
+		constexpr uint8 unassigned = 0xFF;
+		static_assert(MaxVertices < unassigned, "Local vertex indices must fit in 8 bits");
+
+		// Local index of each vertex in the current meshlet
+		std::vector<uint8> local_indices(inNumVertices, unassigned);
+
+		Meshlet meshlet = {};
+		meshlet.m_VertexOffset		= static_cast<uint32>(ioData.m_VertexIndices.size());
+		meshlet.m_TriangleOffset	= static_cast<uint32>(ioData.m_TriangleIndices.size());
+
+		const size_t first_meshlet = ioData.m_Meshlets.size();
+
+		auto flush_meshlet = [&]()
+		{
+			for (uint32 v = 0; v < meshlet.m_NumVertices; v++)
+				local_indices[ioData.m_VertexIndices[meshlet.m_VertexOffset + v]] = unassigned;
+
+			ioData.m_Meshlets.push_back(meshlet);
+
+			meshlet.m_VertexOffset		= static_cast<uint32>(ioData.m_VertexIndices.size());
+			meshlet.m_TriangleOffset	= static_cast<uint32>(ioData.m_TriangleIndices.size());
+			meshlet.m_NumVertices		= 0;
+			meshlet.m_NumTriangles		= 0;
+		};
+
+		for (size_t i = 0; i < inNumIndices; i += 3)
+		{
+			uint32 num_new_vertices = 0;
+			for (uint32 k = 0; k < 3; k++)
+			{
+				Assert(inIndices[i + k] < inNumVertices);
+				num_new_vertices += (local_indices[inIndices[i + k]] == unassigned) ? 1 : 0;
+			}
+
+			if (meshlet.m_NumVertices + num_new_vertices > MaxVertices || meshlet.m_NumTriangles + 1 > MaxTriangles)
+				flush_meshlet();
+
+			for (uint32 k = 0; k < 3; k++)
+			{
+				const uint32 index = inIndices[i + k];
+				if (local_indices[index] == unassigned)
+				{
+					local_indices[index] = static_cast<uint8>(meshlet.m_NumVertices++);
+					ioData.m_VertexIndices.push_back(index);
+				}
+
+				ioData.m_TriangleIndices.push_back(local_indices[index]);
+			}
+
+			meshlet.m_NumTriangles++;
+		}
+
+		if (meshlet.m_NumTriangles > 0)
+			flush_meshlet();
+
+		for (size_t m = first_meshlet; m < ioData.m_Meshlets.size(); m++)
+			ioData.m_Bounds.push_back(ComputeBounds(ioData, ioData.m_Meshlets[m], inPositions, inVertexStride));
+	}
+
+	bool Validate(const MeshletData& inData, size_t inFirstMeshlet, size_t inNumMeshlets, const uint32* inIndices, size_t inNumIndices,
+				  const float* inPositions, size_t inVertexStride)
+	{
+		constexpr float epsilon = 1e-4f;
+
+		size_t index = 0;
+		for (size_t m = inFirstMeshlet; m < inFirstMeshlet + inNumMeshlets; m++)
+		{
+			const Meshlet& meshlet			= inData.m_Meshlets[m];
+			const MeshletBounds& bounds		= inData.m_Bounds[m];
+
+			if (meshlet.m_NumVertices > MaxVertices || meshlet.m_NumTriangles > MaxTriangles)
+				return false;
+
+			const float tolerance = epsilon * Math::Max(1.0f, bounds.m_SphereRadius);
+
+			for (uint32 t = 0; t < meshlet.m_NumTriangles * 3; t++)
+			{
+				const uint8 local_index = inData.m_TriangleIndices[meshlet.m_TriangleOffset + t];
+				if (local_index >= meshlet.m_NumVertices || index >= inNumIndices)
+					return false;
+
+				const uint32 vertex = inData.m_VertexIndices[meshlet.m_VertexOffset + local_index];
+				if (vertex != inIndices[index++])
+					return false;
+
+				const Vec3 position = GetPosition(inPositions, inVertexStride, vertex);
+				if ((position - bounds.m_SphereCenter).Length() > bounds.m_SphereRadius + tolerance)
+					return false;
+
+				for (int32 k = 0; k < 3; k++)
+				{
+					if (position[k] < bounds.m_AABBMin[k] || position[k] > bounds.m_AABBMax[k])
+						return false;
+				}
+			}
+		}
+
+		return index == inNumIndices;
+	}
+
+	void ExtractFrustumPlanes(const Mat4x4& inViewProjection, Vec4 outPlanes[6])
+	{
+		// Gribb and Hartmann. With column vectors, planes are combinations of the rows of the matrix
+		const Mat4x4& m = inViewProjection;
+		for (int32 i = 0; i < 3; i++)
+		{
+			outPlanes[i * 2 + 0] = Vec4(m(3, 0) + m(i, 0), m(3, 1) + m(i, 1), m(3, 2) + m(i, 2), m(3, 3) + m(i, 3));
+			outPlanes[i * 2 + 1] = Vec4(m(3, 0) - m(i, 0), m(3, 1) - m(i, 1), m(3, 2) - m(i, 2), m(3, 3) - m(i, 3));
+		}
+
+		for (int32 i = 0; i < 6; i++)
+		{
+			const float length = Vec3(outPlanes[i].x, outPlanes[i].y, outPlanes[i].z).Length();
+			if (length > 0.0f)
+				outPlanes[i] = outPlanes[i] * (1.0f / length);
+		}
+	}
+
+	bool IsVisible(const MeshletBounds& inBounds, const Vec3& inCameraPosition, const Vec4 inFrustumPlanes[6])
+	{
+		for (int32 i = 0; i < 6; i++)
+		{
+			const Vec4& plane = inFrustumPlanes[i];
+			const float distance = Vec3::DotProduct(Vec3(plane.x, plane.y, plane.z), inBounds.m_SphereCenter) + plane.w;
+			if (distance < -inBounds.m_SphereRadius)
+				return false;
+		}
+
+		const Vec3 view = inBounds.m_ConeApex - inCameraPosition;
+		const float view_length = view.Length();
+		if (view_length > 0.0f && Vec3::DotProduct(view, inBounds.m_ConeAxis) >= inBounds.m_ConeCutoff * view_length)
+			return false;
+
+		return true;
+	}
+
+	void Cull(const MeshletData& inData, size_t inFirstMeshlet, size_t inNumMeshlets,
+			  const Vec3& inCameraPosition, const Vec4 inFrustumPlanes[6], std::vector<uint32>& outVisibleMeshlets)
+	{
+		for (size_t m = inFirstMeshlet; m < inFirstMeshlet + inNumMeshlets; m++)
+		{
+			if (IsVisible(inData.m_Bounds[m], inCameraPosition, inFrustumPlanes))
+				outVisibleMeshlets.push_back(static_cast<uint32>(m));
+		}
+	}
+}
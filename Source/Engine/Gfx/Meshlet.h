@@ -0,0 +1,61 @@
+#pragma once
+
+#include <vector>
+
+// Small clusters of triangles that can be culled individually.
+// The layout is contiguous so the same data can be walked by the CPU or uploaded for mesh shaders
+struct Meshlet
+{
+	uint32	m_VertexOffset;		// In MeshletData::m_VertexIndices
+	uint32	m_TriangleOffset;	// In MeshletData::m_TriangleIndices. 3 indices per triangle
+	uint32	m_NumVertices;
+	uint32	m_NumTriangles;
+};
+
+struct MeshletBounds
+{
+	Vec3	m_SphereCenter;
+	float	m_SphereRadius;
+	Vec3	m_AABBMin;
+	Vec3	m_AABBMax;
+
+	// Backface cone. All triangles face away from cameras where dot(normalize(m_ConeApex - camera), m_ConeAxis) >= m_ConeCutoff
+	Vec3	m_ConeApex;
+	Vec3	m_ConeAxis;
+	float	m_ConeCutoff;
+};
+
+struct MeshletData
+{
+	std::vector<Meshlet>		m_Meshlets;
+	std::vector<MeshletBounds>	m_Bounds;			// One per meshlet
+	std::vector<uint32>			m_VertexIndices;	// Indices in the vertex buffer of the mesh
+	std::vector<uint8>			m_TriangleIndices;	// Indices in the vertices of the meshlet
+};
+
+namespace Meshlets
+{
+	// Usual limits for mesh shaders
+	constexpr uint32 MaxVertices	= 64;
+	constexpr uint32 MaxTriangles	= 124;
+
+	// Split a triangle list into meshlets, in order, and append them to ioData.
+	// Works best on vertex cache optimized index buffers
+	void	Build(const uint32* inIndices, size_t inNumIndices,
+				  const float* inPositions, size_t inNumVertices, size_t inVertexStride, MeshletData& ioData);
+
+	// Check that meshlets [inFirstMeshlet, inFirstMeshlet + inNumMeshlets[ cover the triangle list exactly and that their bounds contain their vertices
+	bool	Validate(const MeshletData& inData, size_t inFirstMeshlet, size_t inNumMeshlets, const uint32* inIndices, size_t inNumIndices,
+					 const float* inPositions, size_t inVertexStride);
+
+	// Normalized planes pointing inside the frustum.
+	// inViewProjection uses mathfu conventions, e.g. m_ProjectionMatrix * m_ViewMatrix * m_ModelMatrix for object space planes
+	void	ExtractFrustumPlanes(const Mat4x4& inViewProjection, Vec4 outPlanes[6]);
+
+	// Bounds, camera position and planes must be in the same space
+	bool	IsVisible(const MeshletBounds& inBounds, const Vec3& inCameraPosition, const Vec4 inFrustumPlanes[6]);
+
+	// Append the index of visible meshlets in [inFirstMeshlet, inFirstMeshlet + inNumMeshlets[ to outVisibleMeshlets
+	void	Cull(const MeshletData& inData, size_t inFirstMeshlet, size_t inNumMeshlets,
+				 const Vec3& inCameraPosition, const Vec4 inFrustumPlanes[6], std::vector<uint32>& outVisibleMeshlets);
+}
@@ -0,0 +1,401 @@
+#include "Engine.h"
+#include "RecordingCommandList.h"
+
+void RecordingCommandList::Reset()
+{
+	m_Stream.clear();
+	m_Statistics			= RecordingStatistics();
+
+	m_DescriptorHeap		= nullptr;
+	m_RootSignature			= nullptr;
+	m_PipelineState			= nullptr;
+	m_Topology				= D3D_PRIMITIVE_TOPOLOGY_UNDEFINED;
+	m_VertexBuffer			= {};
+	m_IndexBuffer			= {};
+	m_NumRenderTargets		= 0;
+	m_HasDepthStencil		= false;
+	m_HasViewport			= false;
+	m_HasScissorRect		= false;
+	m_RootParameters		= {};
+	m_BoundRootParameters	= 0;
+	m_NextDescriptor		= 1;
+}
+
+void RecordingCommandList::WriteCommand(RecordedCommand inCommand)
+{
+	Write(inCommand);
+	m_Statistics.m_NumCommands++;
+}
+
+void RecordingCommandList::WriteBarrier(const D3D12_RESOURCE_BARRIER& inBarrier)
+{
+	Write(static_cast<uint8>(inBarrier.Type));
+	Write(static_cast<uint8>(inBarrier.Flags));
+
+	switch (inBarrier.Type)
+	{
+	case D3D12_RESOURCE_BARRIER_TYPE_TRANSITION:
+		Write(reinterpret_cast<uint64>(inBarrier.Transition.pResource));
+		Write(static_cast<uint32>(inBarrier.Transition.Subresource));
+		Write(static_cast<uint32>(inBarrier.Transition.StateBefore));
+		Write(static_cast<uint32>(inBarrier.Transition.StateAfter));
+		break;
+	case D3D12_RESOURCE_BARRIER_TYPE_ALIASING:
+		Write(reinterpret_cast<uint64>(inBarrier.Aliasing.pResourceBefore));
+		Write(reinterpret_cast<uint64>(inBarrier.Aliasing.pResourceAfter));
+		break;
+	case D3D12_RESOURCE_BARRIER_TYPE_UAV:
+		Write(reinterpret_cast<uint64>(inBarrier.UAV.pResource));
+		break;
+	}
+}
+
+void RecordingCommandList::Error(const char* inMessage)
+{
+	m_Statistics.m_NumErrors++;
+	Trace("RecordingCommandList: %s (command %llu)", inMessage, m_Statistics.m_NumCommands);
+}
+
+bool RecordingCommandList::SetRootParameter(uint32 inRootParameterIndex, uint64 inValue)
+{
+	if (m_RootSignature == nullptr)
+		Error("Root parameter set without a root signature");
+
+	if (inRootParameterIndex >= MaxRootParameters)
+		return false;
+
+	const uint32 bit		= 1u << inRootParameterIndex;
+	const bool redundant	= (m_BoundRootParameters & bit) != 0 && m_RootParameters[inRootParameterIndex] == inValue;
+
+	m_RootParameters[inRootParameterIndex]	= inValue;
+	m_BoundRootParameters					|= bit;
+
+	return redundant;
+}
+
+void RecordingCommandList::ValidateDraw(bool inIndexed)
+{
+	if (m_RootSignature == nullptr)
+		Error("Draw without a root signature");
+	if (m_PipelineState == nullptr)
+		Error("Draw without a pipeline state");
+	if (m_Topology == D3D_PRIMITIVE_TOPOLOGY_UNDEFINED)
+		Error("Draw without a primitive topology");
+	if (m_VertexBuffer.BufferLocation == 0)
+		Error("Draw without a vertex buffer");
+	if (inIndexed && m_IndexBuffer.BufferLocation == 0)
+		Error("Indexed draw without an index buffer");
+	if (m_NumRenderTargets == 0 && !m_HasDepthStencil)
+		Error("Draw without a render target");
+	if (!m_HasViewport || !m_HasScissorRect)
+		Error("Draw without a viewport or a scissor rect");
+}
+
+void RecordingCommandList::ResourceBarrier(uint32 inNumBarriers, const D3D12_RESOURCE_BARRIER* inBarriers)
+{
+	WriteCommand(RecordedCommand::ResourceBarrier);
+	Write(inNumBarriers);
+
+	for (uint32 i = 0; i < inNumBarriers; i++)
+	{
+		const D3D12_RESOURCE_BARRIER& barrier = inBarriers[i];
+		WriteBarrier(barrier);
+
+		if (barrier.Type != D3D12_RESOURCE_BARRIER_TYPE_TRANSITION)
+			continue;
+
+		const D3D12_RESOURCE_TRANSITION_BARRIER& transition = barrier.Transition;
+		if (transition.StateBefore == transition.StateAfter)
+			Error("Transition to the state the resource is already in");
+
+		// The first transition of a resource tells its state, the next ones must start from there
+		auto it = m_ResourceStates.find(transition.pResource);
+		if (it != m_ResourceStates.end() && it->second != transition.StateBefore)
+			Error("Transition from a state the resource isn't in");
+
+		m_ResourceStates[transition.pResource] = transition.StateAfter;
+	}
+
+	m_Statistics.m_NumBarriers += inNumBarriers;
+}
+
+void RecordingCommandList::SetDescriptorHeaps(uint32 inNumHeaps, ID3D12DescriptorHeap* const* inHeaps)
+{
+	WriteCommand(RecordedCommand::SetDescriptorHeaps);
+	Write(inNumHeaps);
+	for (uint32 i = 0; i < inNumHeaps; i++)
+		Write(reinterpret_cast<uint64>(inHeaps[i]));
+
+	// Only the shader visible CBV/SRV/UAV heap is used
+	if (inNumHeaps == 1 && inHeaps[0] == m_DescriptorHeap)
+		m_Statistics.m_NumRedundantCommands++;
+
+	m_DescriptorHeap = inNumHeaps > 0 ? inHeaps[0] : nullptr;
+}
+
+void RecordingCommandList::SetGraphicsRootSignature(ID3D12RootSignature* inRootSignature)
+{
+	WriteCommand(RecordedCommand::SetGraphicsRootSignature);
+	Write(reinterpret_cast<uint64>(inRootSignature));
+
+	if (inRootSignature == nullptr)
+		Error("Null root signature");
+
+	if (inRootSignature == m_RootSignature)
+	{
+		m_Statistics.m_NumRedundantCommands++;
+		return;
+	}
+
+	// Changing the root signature unbinds all root parameters
+	m_RootSignature			= inRootSignature;
+	m_BoundRootParameters	= 0;
+	m_Statistics.m_NumRootSignatureSwitches++;
+}
+
+void RecordingCommandList::SetPipelineState(ID3D12PipelineState* inPipelineState)
+{
+	WriteCommand(RecordedCommand::SetPipelineState);
+	Write(reinterpret_cast<uint64>(inPipelineState));
+
+	if (inPipelineState == nullptr)
+		Error("Null pipeline state");
+
+	if (inPipelineState == m_PipelineState)
+	{
+		m_Statistics.m_NumRedundantCommands++;
+		return;
+	}
+
+	m_PipelineState = inPipelineState;
+	m_Statistics.m_NumPipelineStateSwitches++;
+}
+
+void RecordingCommandList::SetGraphicsRootDescriptorTable(uint32 inRootParameterIndex, D3D12_GPU_DESCRIPTOR_HANDLE inBaseDescriptor)
+{
+	WriteCommand(RecordedCommand::SetGraphicsRootDescriptorTable);
+	Write(inRootParameterIndex);
+	Write(static_cast<uint64>(inBaseDescriptor.ptr));
+
+	if (m_DescriptorHeap == nullptr)
+		Error("Descriptor table set without a descriptor heap");
+
+	if (SetRootParameter(inRootParameterIndex, inBaseDescriptor.ptr))
+		m_Statistics.m_NumRedundantCommands++;
+}
+
+void RecordingCommandList::SetGraphicsRootConstantBufferView(uint32 inRootParameterIndex, D3D12_GPU_VIRTUAL_ADDRESS inBufferLocation)
+{
+	WriteCommand(RecordedCommand::SetGraphicsRootConstantBufferView);
+	Write(inRootParameterIndex);
+	Write(static_cast<uint64>(inBufferLocation));
+
+	if (inBufferLocation == 0)
+		Error("Null constant buffer address");
+
+	if (SetRootParameter(inRootParameterIndex, inBufferLocation))
+		m_Statistics.m_NumRedundantCommands++;
+}
+
+void RecordingCommandList::IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY inTopology)
+{
+	WriteCommand(RecordedCommand::IASetPrimitiveTopology);
+	Write(static_cast<uint8>(inTopology));
+
+	if (inTopology == m_Topology)
+		m_Statistics.m_NumRedundantCommands++;
+
+	m_Topology = inTopology;
+}
+
+void RecordingCommandList::IASetVertexBuffers(uint32 inStartSlot, uint32 inNumViews, const D3D12_VERTEX_BUFFER_VIEW* inViews)
+{
+	WriteCommand(RecordedCommand::IASetVertexBuffers);
+	Write(inStartSlot);
+	Write(inNumViews);
+	for (uint32 i = 0; i < inNumViews; i++)
+	{
+		Write(static_cast<uint64>(inViews[i].BufferLocation));
+		Write(static_cast<uint32>(inViews[i].SizeInBytes));
+		Write(static_cast<uint32>(inViews[i].StrideInBytes));
+	}
+
+	// Only slot 0 is used
+	if (inStartSlot != 0 || inNumViews == 0)
+		return;
+
+	const D3D12_VERTEX_BUFFER_VIEW& view = inViews[0];
+	if (view.BufferLocation == m_VertexBuffer.BufferLocation && view.SizeInBytes == m_VertexBuffer.SizeInBytes && view.StrideInBytes == m_VertexBuffer.StrideInBytes)
+		m_Statistics.m_NumRedundantCommands++;
+
+	m_VertexBuffer = view;
+}
+
+void RecordingCommandList::IASetIndexBuffer(const D3D12_INDEX_BUFFER_VIEW* inView)
+{
+	WriteCommand(RecordedCommand::IASetIndexBuffer);
+
+	const D3D12_INDEX_BUFFER_VIEW view = inView != nullptr ? *inView : D3D12_INDEX_BUFFER_VIEW {};
+	Write(static_cast<uint64>(view.BufferLocation));
+	Write(static_cast<uint32>(view.SizeInBytes));
+	Write(static_cast<uint8>(view.Format));
+
+	if (view.BufferLocation != 0 && view.Format != DXGI_FORMAT_R16_UINT && view.Format != DXGI_FORMAT_R32_UINT)
+		Error("Index buffer format isn't R16_UINT or R32_UINT");
+
+	if (view.BufferLocation == m_IndexBuffer.BufferLocation && view.SizeInBytes == m_IndexBuffer.SizeInBytes && view.Format == m_IndexBuffer.Format)
+		m_Statistics.m_NumRedundantCommands++;
+
+	m_IndexBuffer = view;
+}
+
+void RecordingCommandList::RSSetViewports(uint32 inNumViewports, const D3D12_VIEWPORT* inViewports)
+{
+	WriteCommand(RecordedCommand::RSSetViewports);
+	Write(inNumViewports);
+	for (uint32 i = 0; i < inNumViewports; i++)
+	{
+		const D3D12_VIEWPORT& viewport = inViewports[i];
+		Write(viewport.TopLeftX);
+		Write(viewport.TopLeftY);
+		Write(viewport.Width);
+		Write(viewport.Height);
+		Write(viewport.MinDepth);
+		Write(viewport.MaxDepth);
+
+		if (viewport.Width <= 0.0f || viewport.Height <= 0.0f)
+			Error("Empty viewport");
+	}
+
+	m_HasViewport = inNumViewports > 0;
+}
+
+void RecordingCommandList::RSSetScissorRects(uint32 inNumRects, const D3D12_RECT* inRects)
+{
+	WriteCommand(RecordedCommand::RSSetScissorRects);
+	Write(inNumRects);
+	for (uint32 i = 0; i < inNumRects; i++)
+	{
+		Write(static_cast<int32>(inRects[i].left));
+		Write(static_cast<int32>(inRects[i].top));
+		Write(static_cast<int32>(inRects[i].right));
+		Write(static_cast<int32>(inRects[i].bottom));
+	}
+
+	m_HasScissorRect = inNumRects > 0;
+}
+
+void RecordingCommandList::OMSetRenderTargets(uint32 inNumRenderTargets, const D3D12_CPU_DESCRIPTOR_HANDLE* inRenderTargets,
+											  bool inSingleHandleToDescriptorRange, const D3D12_CPU_DESCRIPTOR_HANDLE* inDepthStencil)
+{
+	WriteCommand(RecordedCommand::OMSetRenderTargets);
+	Write(inNumRenderTargets);
+	Write(static_cast<uint8>(inSingleHandleToDescriptorRange));
+
+	// A single handle covers all the render targets when they are a range
+	const uint32 num_handles = inSingleHandleToDescriptorRange ? Math::Min<uint32>(inNumRenderTargets, 1) : inNumRenderTargets;
+	for (uint32 i = 0; i < num_handles; i++)
+		Write(static_cast<uint64>(inRenderTargets[i].ptr));
+	Write(static_cast<uint64>(inDepthStencil != nullptr ? inDepthStencil->ptr : 0));
+
+	if (inNumRenderTargets > D3D12_SIMULTANEOUS_RENDER_TARGET_COUNT)
+		Error("Too many render targets");
+
+	m_NumRenderTargets	= inNumRenderTargets;
+	m_HasDepthStencil	= inDepthStencil != nullptr;
+}
+
+void RecordingCommandList::ClearRenderTargetView(D3D12_CPU_DESCRIPTOR_HANDLE inRenderTarget, const float inColor[4])
+{
+	WriteCommand(RecordedCommand::ClearRenderTargetView);
+	Write(static_cast<uint64>(inRenderTarget.ptr));
+	for (uint32 i = 0; i < 4; i++)
+		Write(inColor[i]);
+}
+
+void RecordingCommandList::ClearDepthStencilView(D3D12_CPU_DESCRIPTOR_HANDLE inDepthStencil, D3D12_CLEAR_FLAGS inFlags, float inDepth, uint8 inStencil)
+{
+	WriteCommand(RecordedCommand::ClearDepthStencilView);
+	Write(static_cast<uint64>(inDepthStencil.ptr));
+	Write(static_cast<uint8>(inFlags));
+	Write(inDepth);
+	Write(inStencil);
+
+	if ((inFlags & (D3D12_CLEAR_FLAG_DEPTH | D3D12_CLEAR_FLAG_STENCIL)) == 0)
+		Error("Depth stencil clear that clears nothing");
+}
+
+void RecordingCommandList::DrawInstanced(uint32 inVertexCountPerInstance, uint32 inInstanceCount, uint32 inStartVertex, uint32 inStartInstance)
+{
+	WriteCommand(RecordedCommand::DrawInstanced);
+	Write(inVertexCountPerInstance);
+	Write(inInstanceCount);
+	Write(inStartVertex);
+	Write(inStartInstance);
+
+	ValidateDraw(false);
+
+	m_Statistics.m_NumDraws++;
+	m_Statistics.m_NumVertices += static_cast<uint64>(inVertexCountPerInstance) * inInstanceCount;
+}
+
+void RecordingCommandList::DrawIndexedInstanced(uint32 inIndexCountPerInstance, uint32 inInstanceCount, uint32 inStartIndex, int32 inBaseVertex, uint32 inStartInstance)
+{
+	WriteCommand(RecordedCommand::DrawIndexedInstanced);
+	Write(inIndexCountPerInstance);
+	Write(inInstanceCount);
+	Write(inStartIndex);
+	Write(inBaseVertex);
+	Write(inStartInstance);
+
+	ValidateDraw(true);
+
+	// The index buffer view must hold every index read by the draw
+	const uint32 index_size = m_IndexBuffer.Format == DXGI_FORMAT_R32_UINT ? sizeof(uint32) : sizeof(uint16);
+	if (m_IndexBuffer.BufferLocation != 0 && (static_cast<uint64>(inStartIndex) + inIndexCountPerInstance) * index_size > m_IndexBuffer.SizeInBytes)
+		Error("Draw reads past the end of the index buffer");
+
+	m_Statistics.m_NumDraws++;
+	m_Statistics.m_NumVertices += static_cast<uint64>(inIndexCountPerInstance) * inInstanceCount;
+}
+
+D3D12_GPU_DESCRIPTOR_HANDLE RecordingCommandList::CopyDescriptor(D3D12_CPU_DESCRIPTOR_HANDLE inDescriptor)
+{
+	WriteCommand(RecordedCommand::CopyDescriptor);
+	Write(static_cast<uint64>(inDescriptor.ptr));
+
+	if (inDescriptor.ptr == 0)
+		Error("Copy of a null descriptor");
+
+	m_Statistics.m_NumDescriptorAllocations++;
+
+	D3D12_GPU_DESCRIPTOR_HANDLE handle;
+	handle.ptr = m_NextDescriptor++;
+	return handle;
+}
+
+D3D12_GPU_DESCRIPTOR_HANDLE RecordingCommandList::CreateShaderResourceView(ID3D12Resource* inResource)
+{
+	WriteCommand(RecordedCommand::CreateShaderResourceView);
+	Write(reinterpret_cast<uint64>(inResource));
+
+	if (inResource == nullptr)
+		Error("Shader resource view of a null resource");
+
+	m_Statistics.m_NumDescriptorAllocations++;
+
+	D3D12_GPU_DESCRIPTOR_HANDLE handle;
+	handle.ptr = m_NextDescriptor++;
+	return handle;
+}
+
+void RecordingCommandList::TraceStatistics() const
+{
+	const RecordingStatistics& statistics = m_Statistics;
+
+	Trace("RecordingCommandList: %llu commands in %zu bytes, %llu draws (%llu vertices), %llu PSO switches, %llu root signature switches, "
+		  "%llu barriers, %llu descriptors, %llu redundant commands, %llu errors",
+		  statistics.m_NumCommands, m_Stream.size(), statistics.m_NumDraws, statistics.m_NumVertices,
+		  statistics.m_NumPipelineStateSwitches, statistics.m_NumRootSignatureSwitches, statistics.m_NumBarriers,
+		  statistics.m_NumDescriptorAllocations, statistics.m_NumRedundantCommands, statistics.m_NumErrors);
+}
@@ -0,0 +1,129 @@
+#pragma once
+
+#include "Gfx/CommandList.h"
+
+#include <array>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+// Commands of a recorded stream. Each one is this opcode followed by its arguments, packed without padding
+enum class RecordedCommand : uint8
+{
+	ResourceBarrier,
+	SetDescriptorHeaps,
+	SetGraphicsRootSignature,
+	SetPipelineState,
+	SetGraphicsRootDescriptorTable,
+	SetGraphicsRootConstantBufferView,
+	IASetPrimitiveTopology,
+	IASetVertexBuffers,
+	IASetIndexBuffer,
+	RSSetViewports,
+	RSSetScissorRects,
+	OMSetRenderTargets,
+	ClearRenderTargetView,
+	ClearDepthStencilView,
+	DrawInstanced,
+	DrawIndexedInstanced,
+	CopyDescriptor,
+	CreateShaderResourceView
+};
+
+struct RecordingStatistics
+{
+	uint64	m_NumCommands				= 0;
+	uint64	m_NumDraws					= 0;
+	uint64	m_NumVertices				= 0;	// Vertices or indices drawn, instances included
+	uint64	m_NumPipelineStateSwitches	= 0;	// Changes of pipeline state, redundant ones excluded
+	uint64	m_NumRootSignatureSwitches	= 0;
+	uint64	m_NumBarriers				= 0;	// Barriers, not calls
+	uint64	m_NumDescriptorAllocations	= 0;
+	uint64	m_NumRedundantCommands		= 0;	// Set something that was already bound
+	uint64	m_NumErrors					= 0;
+};
+
+// Checks frame commands and stores them in a compact stream instead of sending them to a GPU.
+// No device is needed, frames can be built headless to measure and test their CPU side.
+// Invalid commands are traced and counted in the statistics, they are recorded anyway
+class RecordingCommandList final : public CommandList
+{
+public:
+	// Root parameters tracked to find redundant bindings. D3D12 allows 64 DWORDs, this engine uses a handful
+	static constexpr uint32 MaxRootParameters = 16;
+
+	// Start a new frame: clears the stream, the bindings and the statistics.
+	// Resource states are kept, they carry over from one frame to the next like on a GPU queue
+	void	Reset();
+
+	void	ResourceBarrier(uint32 inNumBarriers, const D3D12_RESOURCE_BARRIER* inBarriers) override;
+
+	void	SetDescriptorHeaps(uint32 inNumHeaps, ID3D12DescriptorHeap* const* inHeaps) override;
+	void	SetGraphicsRootSignature(ID3D12RootSignature* inRootSignature) override;
+	void	SetPipelineState(ID3D12PipelineState* inPipelineState) override;
+	void	SetGraphicsRootDescriptorTable(uint32 inRootParameterIndex, D3D12_GPU_DESCRIPTOR_HANDLE inBaseDescriptor) override;
+	void	SetGraphicsRootConstantBufferView(uint32 inRootParameterIndex, D3D12_GPU_VIRTUAL_ADDRESS inBufferLocation) override;
+
+	void	IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY inTopology) override;
+	void	IASetVertexBuffers(uint32 inStartSlot, uint32 inNumViews, const D3D12_VERTEX_BUFFER_VIEW* inViews) override;
+	void	IASetIndexBuffer(const D3D12_INDEX_BUFFER_VIEW* inView) override;
+
+	void	RSSetViewports(uint32 inNumViewports, const D3D12_VIEWPORT* inViewports) override;
+	void	RSSetScissorRects(uint32 inNumRects, const D3D12_RECT* inRects) override;
+	void	OMSetRenderTargets(uint32 inNumRenderTargets, const D3D12_CPU_DESCRIPTOR_HANDLE* inRenderTargets,
+							   bool inSingleHandleToDescriptorRange, const D3D12_CPU_DESCRIPTOR_HANDLE* inDepthStencil) override;
+
+	void	ClearRenderTargetView(D3D12_CPU_DESCRIPTOR_HANDLE inRenderTarget, const float inColor[4]) override;
+	void	ClearDepthStencilView(D3D12_CPU_DESCRIPTOR_HANDLE inDepthStencil, D3D12_CLEAR_FLAGS inFlags, float inDepth, uint8 inStencil) override;
+
+	void	DrawInstanced(uint32 inVertexCountPerInstance, uint32 inInstanceCount, uint32 inStartVertex, uint32 inStartInstance) override;
+	void	DrawIndexedInstanced(uint32 inIndexCountPerInstance, uint32 inInstanceCount, uint32 inStartIndex, int32 inBaseVertex, uint32 inStartInstance) override;
+
+	// Handles are made up, they only identify the allocation in the stream
+	D3D12_GPU_DESCRIPTOR_HANDLE	CopyDescriptor(D3D12_CPU_DESCRIPTOR_HANDLE inDescriptor) override;
+	D3D12_GPU_DESCRIPTOR_HANDLE	CreateShaderResourceView(ID3D12Resource* inResource) override;
+
+	inline const std::vector<Byte>&		GetStream() const		{ return m_Stream; }
+	inline const RecordingStatistics&	GetStatistics() const	{ return m_Statistics; }
+	void	TraceStatistics() const;
+
+private:
+	template <typename T>
+	void	Write(const T& inValue)
+	{
+		static_assert(std::is_trivially_copyable_v<T>, "Only plain values go in the stream");
+		const size_t offset = m_Stream.size();
+		m_Stream.resize(offset + sizeof(T));
+		::memcpy(&m_Stream[offset], &inValue, sizeof(T));
+	}
+
+	void	WriteCommand(RecordedCommand inCommand);
+	void	WriteBarrier(const D3D12_RESOURCE_BARRIER& inBarrier);
+	void	Error(const char* inMessage);
+	void	ValidateDraw(bool inIndexed);
+	// Returns true when the root parameter already had inValue
+	bool	SetRootParameter(uint32 inRootParameterIndex, uint64 inValue);
+
+	std::vector<Byte>			m_Stream;
+	RecordingStatistics			m_Statistics;
+
+	// Bound state, to check draws and count redundant commands
+	ID3D12DescriptorHeap*		m_DescriptorHeap		= nullptr;
+	ID3D12RootSignature*		m_RootSignature			= nullptr;
+	ID3D12PipelineState*		m_PipelineState			= nullptr;
+	D3D_PRIMITIVE_TOPOLOGY		m_Topology				= D3D_PRIMITIVE_TOPOLOGY_UNDEFINED;
+	D3D12_VERTEX_BUFFER_VIEW	m_VertexBuffer			= {};
+	D3D12_INDEX_BUFFER_VIEW		m_IndexBuffer			= {};
+	uint32						m_NumRenderTargets		= 0;
+	bool						m_HasDepthStencil		= false;
+	bool						m_HasViewport			= false;
+	bool						m_HasScissorRect		= false;
+
+	// Descriptor table or constant buffer address of each root parameter, cleared by root signature changes
+	std::array<uint64, MaxRootParameters>	m_RootParameters	= {};
+	uint32						m_BoundRootParameters	= 0;	// Bit mask
+
+	uint64						m_NextDescriptor		= 1;
+
+	std::unordered_map<ID3D12Resource*, D3D12_RESOURCE_STATES>	m_ResourceStates;
+};
@@ -2,8 +2,6 @@
 
 #include "DX12/DX12Includes.h"
 
-class DrawableObject;
-
 enum RenderPass : uint32
 {
 	OpaqueGeometry = 0,
@@ -11,9 +9,6 @@ enum RenderPass : uint32
 	Count
 };
 
-using RenderBucket	= std::vector<DrawableObject*>;
-using RenderBuckets	= RenderBucket[RenderPass::Count];
-
 class RenderPassDesc
 {
 public:
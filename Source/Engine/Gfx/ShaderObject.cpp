@@ -2,12 +2,16 @@
 #include "ShaderObject.h"
 
 #include "DX12/DX12Device.h"
+#include "Gfx/CommandList.h"
 
 #include "Shaders/Include/Shaders.h"
 #include "Shaders/Include/VertexLayouts.h"
 
+uint32 ShaderObject::s_NextID = 0;
+
 ShaderObject::ShaderObject(RenderPass inRenderPass, const D3D12_SHADER_BYTECODE inVSBytecode, const D3D12_SHADER_BYTECODE inPSBytecode) :
-	m_RenderPass(inRenderPass)
+	m_RenderPass(inRenderPass),
+	m_ID(s_NextID++)
 {
 	CreateRootSignature();
 	CreatePSO(inVSBytecode, inPSBytecode);
@@ -19,7 +23,7 @@ ShaderObject::~ShaderObject()
 	m_RootSignature->Release();
 }
 
-void ShaderObject::Set(ID3D12GraphicsCommandList2& inCommandList) const
+void ShaderObject::Set(CommandList& inCommandList) const
 {
 	// TODO: Deal with actual shader bindings (textures, constant buffers, ...)
 	inCommandList.SetGraphicsRootSignature(m_RootSignature);
@@ -2,6 +2,8 @@
 
 #include "Gfx/RenderPass.h"
 
+class CommandList;
+
 // A ShaderObject actually regroups multiple shaders. (e.g Pixel+Vertex shader)
 // In this case, shaders a grouped into a single PSO
 class ShaderObject final
@@ -12,8 +14,10 @@ public:
 
 	inline const std::string&	GetName() const			{ return m_Name; }
 	inline RenderPass			GetRenderPass() const	{ return m_RenderPass; }
+	// Unique to each ShaderObject, identifies its pipeline state in draw sort keys
+	inline uint32				GetID() const			{ return m_ID; }
 
-	void Set(ID3D12GraphicsCommandList2& inCommandList) const;
+	void Set(CommandList& inCommandList) const;
 
 private:
 	void CreatePSO(const D3D12_SHADER_BYTECODE inVSBytecode, const D3D12_SHADER_BYTECODE inPSBytecode);
@@ -23,6 +27,9 @@ private:
 	ID3D12PipelineState*	m_PipelineState	= nullptr;
 	ID3D12RootSignature*	m_RootSignature = nullptr;
 	RenderPass				m_RenderPass;
+	uint32					m_ID;
 
 	std::string				m_Name;
+
+	static uint32			s_NextID;
 };
\ No newline at end of file
@@ -0,0 +1,208 @@
+#include "Engine.h"
+#include "StateCacheCommandList.h"
+
+StateCacheCommandList::StateCacheCommandList(CommandList& inCommandList) :
+	m_CommandList(inCommandList)
+{
+}
+
+void StateCacheCommandList::Reset()
+{
+	m_Statistics			= StateCacheStatistics();
+
+	m_DescriptorHeap		= nullptr;
+	m_RootSignature			= nullptr;
+	m_PipelineState			= nullptr;
+	m_Topology				= D3D_PRIMITIVE_TOPOLOGY_UNDEFINED;
+	m_VertexBuffer			= {};
+	m_IndexBuffer			= {};
+	m_HasDescriptorHeap		= false;
+	m_HasVertexBuffer		= false;
+	m_HasIndexBuffer		= false;
+	m_RootParameters		= {};
+	m_BoundRootParameters	= 0;
+}
+
+bool StateCacheCommandList::Issue(bool inIsRedundant)
+{
+	if (inIsRedundant)
+	{
+		m_Statistics.m_NumElided++;
+		return false;
+	}
+
+	m_Statistics.m_NumIssued++;
+	return true;
+}
+
+bool StateCacheCommandList::SetRootParameter(uint32 inRootParameterIndex, uint64 inValue)
+{
+	// Untracked parameters are always set
+	if (inRootParameterIndex >= MaxRootParameters)
+		return Issue(false);
+
+	const uint32 bit = 1u << inRootParameterIndex;
+	if (!Issue((m_BoundRootParameters & bit) != 0 && m_RootParameters[inRootParameterIndex] == inValue))
+		return false;
+
+	m_RootParameters[inRootParameterIndex]	= inValue;
+	m_BoundRootParameters					|= bit;
+	return true;
+}
+
+void StateCacheCommandList::ResourceBarrier(uint32 inNumBarriers, const D3D12_RESOURCE_BARRIER* inBarriers)
+{
+	m_CommandList.ResourceBarrier(inNumBarriers, inBarriers);
+}
+
+void StateCacheCommandList::SetDescriptorHeaps(uint32 inNumHeaps, ID3D12DescriptorHeap* const* inHeaps)
+{
+	// Only the shader visible CBV/SRV/UAV heap is used, other combinations are forwarded and forgotten
+	const bool is_single_heap = inNumHeaps == 1;
+	if (!Issue(is_single_heap && m_HasDescriptorHeap && inHeaps[0] == m_DescriptorHeap))
+		return;
+
+	m_CommandList.SetDescriptorHeaps(inNumHeaps, inHeaps);
+
+	// Descriptor tables pointing in the previous heap aren't valid anymore
+	m_DescriptorHeap		= is_single_heap ? inHeaps[0] : nullptr;
+	m_HasDescriptorHeap		= is_single_heap;
+	m_BoundRootParameters	= 0;
+}
+
+void StateCacheCommandList::SetGraphicsRootSignature(ID3D12RootSignature* inRootSignature)
+{
+	if (!Issue(inRootSignature != nullptr && inRootSignature == m_RootSignature))
+		return;
+
+	m_CommandList.SetGraphicsRootSignature(inRootSignature);
+
+	// Changing the root signature unbinds all root parameters
+	m_RootSignature			= inRootSignature;
+	m_BoundRootParameters	= 0;
+}
+
+void StateCacheCommandList::SetPipelineState(ID3D12PipelineState* inPipelineState)
+{
+	if (!Issue(inPipelineState != nullptr && inPipelineState == m_PipelineState))
+		return;
+
+	m_CommandList.SetPipelineState(inPipelineState);
+	m_PipelineState = inPipelineState;
+}
+
+void StateCacheCommandList::SetGraphicsRootDescriptorTable(uint32 inRootParameterIndex, D3D12_GPU_DESCRIPTOR_HANDLE inBaseDescriptor)
+{
+	if (SetRootParameter(inRootParameterIndex, inBaseDescriptor.ptr))
+		m_CommandList.SetGraphicsRootDescriptorTable(inRootParameterIndex, inBaseDescriptor);
+}
+
+void StateCacheCommandList::SetGraphicsRootConstantBufferView(uint32 inRootParameterIndex, D3D12_GPU_VIRTUAL_ADDRESS inBufferLocation)
+{
+	if (SetRootParameter(inRootParameterIndex, inBufferLocation))
+		m_CommandList.SetGraphicsRootConstantBufferView(inRootParameterIndex, inBufferLocation);
+}
+
+void StateCacheCommandList::IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY inTopology)
+{
+	if (!Issue(inTopology != D3D_PRIMITIVE_TOPOLOGY_UNDEFINED && inTopology == m_Topology))
+		return;
+
+	m_CommandList.IASetPrimitiveTopology(inTopology);
+	m_Topology = inTopology;
+}
+
+void StateCacheCommandList::IASetVertexBuffers(uint32 inStartSlot, uint32 inNumViews, const D3D12_VERTEX_BUFFER_VIEW* inViews)
+{
+	// Only slot 0 is used, other slots are forwarded and make slot 0 unknown if they cover it
+	const bool is_slot_0 = inStartSlot == 0 && inNumViews == 1;
+	const bool is_redundant = is_slot_0 && m_HasVertexBuffer &&
+							  inViews[0].BufferLocation == m_VertexBuffer.BufferLocation &&
+							  inViews[0].SizeInBytes == m_VertexBuffer.SizeInBytes &&
+							  inViews[0].StrideInBytes == m_VertexBuffer.StrideInBytes;
+	if (!Issue(is_redundant))
+		return;
+
+	m_CommandList.IASetVertexBuffers(inStartSlot, inNumViews, inViews);
+
+	if (is_slot_0)
+	{
+		m_VertexBuffer		= inViews[0];
+		m_HasVertexBuffer	= true;
+	}
+	else if (inStartSlot == 0)
+	{
+		m_HasVertexBuffer	= false;
+	}
+}
+
+void StateCacheCommandList::IASetIndexBuffer(const D3D12_INDEX_BUFFER_VIEW* inView)
+{
+	const D3D12_INDEX_BUFFER_VIEW view = inView != nullptr ? *inView : D3D12_INDEX_BUFFER_VIEW {};
+	const bool is_redundant = m_HasIndexBuffer &&
+							  view.BufferLocation == m_IndexBuffer.BufferLocation &&
+							  view.SizeInBytes == m_IndexBuffer.SizeInBytes &&
+							  view.Format == m_IndexBuffer.Format;
+	if (!Issue(is_redundant))
+		return;
+
+	m_CommandList.IASetIndexBuffer(inView);
+
+	m_IndexBuffer		= view;
+	m_HasIndexBuffer	= true;
+}
+
+void StateCacheCommandList::RSSetViewports(uint32 inNumViewports, const D3D12_VIEWPORT* inViewports)
+{
+	m_CommandList.RSSetViewports(inNumViewports, inViewports);
+}
+
+void StateCacheCommandList::RSSetScissorRects(uint32 inNumRects, const D3D12_RECT* inRects)
+{
+	m_CommandList.RSSetScissorRects(inNumRects, inRects);
+}
+
+void StateCacheCommandList::OMSetRenderTargets(uint32 inNumRenderTargets, const D3D12_CPU_DESCRIPTOR_HANDLE* inRenderTargets,
+											   bool inSingleHandleToDescriptorRange, const D3D12_CPU_DESCRIPTOR_HANDLE* inDepthStencil)
+{
+	m_CommandList.OMSetRenderTargets(inNumRenderTargets, inRenderTargets, inSingleHandleToDescriptorRange, inDepthStencil);
+}
+
+void StateCacheCommandList::ClearRenderTargetView(D3D12_CPU_DESCRIPTOR_HANDLE inRenderTarget, const float inColor[4])
+{
+	m_CommandList.ClearRenderTargetView(inRenderTarget, inColor);
+}
+
+void StateCacheCommandList::ClearDepthStencilView(D3D12_CPU_DESCRIPTOR_HANDLE inDepthStencil, D3D12_CLEAR_FLAGS inFlags, float inDepth, uint8 inStencil)
+{
+	m_CommandList.ClearDepthStencilView(inDepthStencil, inFlags, inDepth, inStencil);
+}
+
+void StateCacheCommandList::DrawInstanced(uint32 inVertexCountPerInstance, uint32 inInstanceCount, uint32 inStartVertex, uint32 inStartInstance)
+{
+	m_CommandList.DrawInstanced(inVertexCountPerInstance, inInstanceCount, inStartVertex, inStartInstance);
+}
+
+void StateCacheCommandList::DrawIndexedInstanced(uint32 inIndexCountPerInstance, uint32 inInstanceCount, uint32 inStartIndex, int32 inBaseVertex, uint32 inStartInstance)
+{
+	m_CommandList.DrawIndexedInstanced(inIndexCountPerInstance, inInstanceCount, inStartIndex, inBaseVertex, inStartInstance);
+}
+
+D3D12_GPU_DESCRIPTOR_HANDLE StateCacheCommandList::CopyDescriptor(D3D12_CPU_DESCRIPTOR_HANDLE inDescriptor)
+{
+	return m_CommandList.CopyDescriptor(inDescriptor);
+}
+
+D3D12_GPU_DESCRIPTOR_HANDLE StateCacheCommandList::CreateShaderResourceView(ID3D12Resource* inResource)
+{
+	return m_CommandList.CreateShaderResourceView(inResource);
+}
+
+void StateCacheCommandList::TraceStatistics() const
+{
+	const uint64 num_calls = m_Statistics.m_NumIssued + m_Statistics.m_NumElided;
+
+	Trace("StateCacheCommandList: %llu state calls issued, %llu elided (%.1f%%)",
+		  m_Statistics.m_NumIssued, m_Statistics.m_NumElided,
+		  num_calls > 0 ? 100.0 * m_Statistics.m_NumElided / num_calls : 0.0);
+}
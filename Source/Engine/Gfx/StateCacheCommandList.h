@@ -0,0 +1,81 @@
+#pragma once
+
+#include "Gfx/CommandList.h"
+
+#include <array>
+
+// Calls that bind state, whether they were forwarded or dropped. Other commands aren't counted
+struct StateCacheStatistics
+{
+	uint64	m_NumIssued	= 0;
+	uint64	m_NumElided	= 0;
+};
+
+// Forwards commands to another CommandList, minus the ones binding what's already bound: descriptor heap,
+// root signature, pipeline state, topology, vertex and index buffers, root descriptor tables and root CBVs.
+// Draw code can set everything it needs for every draw and leave the filtering to this.
+// Bindings don't survive a command list reset, Reset must be called whenever the target starts a new one
+class StateCacheCommandList final : public CommandList
+{
+public:
+	// Root parameters that are tracked, the ones above are always forwarded
+	static constexpr uint32 MaxRootParameters = 16;
+
+	explicit StateCacheCommandList(CommandList& inCommandList);
+
+	// Forget the bindings and the statistics
+	void	Reset();
+
+	void	ResourceBarrier(uint32 inNumBarriers, const D3D12_RESOURCE_BARRIER* inBarriers) override;
+
+	void	SetDescriptorHeaps(uint32 inNumHeaps, ID3D12DescriptorHeap* const* inHeaps) override;
+	void	SetGraphicsRootSignature(ID3D12RootSignature* inRootSignature) override;
+	void	SetPipelineState(ID3D12PipelineState* inPipelineState) override;
+	void	SetGraphicsRootDescriptorTable(uint32 inRootParameterIndex, D3D12_GPU_DESCRIPTOR_HANDLE inBaseDescriptor) override;
+	void	SetGraphicsRootConstantBufferView(uint32 inRootParameterIndex, D3D12_GPU_VIRTUAL_ADDRESS inBufferLocation) override;
+
+	void	IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY inTopology) override;
+	void	IASetVertexBuffers(uint32 inStartSlot, uint32 inNumViews, const D3D12_VERTEX_BUFFER_VIEW* inViews) override;
+	void	IASetIndexBuffer(const D3D12_INDEX_BUFFER_VIEW* inView) override;
+
+	void	RSSetViewports(uint32 inNumViewports, const D3D12_VIEWPORT* inViewports) override;
+	void	RSSetScissorRects(uint32 inNumRects, const D3D12_RECT* inRects) override;
+	void	OMSetRenderTargets(uint32 inNumRenderTargets, const D3D12_CPU_DESCRIPTOR_HANDLE* inRenderTargets,
+							   bool inSingleHandleToDescriptorRange, const D3D12_CPU_DESCRIPTOR_HANDLE* inDepthStencil) override;
+
+	void	ClearRenderTargetView(D3D12_CPU_DESCRIPTOR_HANDLE inRenderTarget, const float inColor[4]) override;
+	void	ClearDepthStencilView(D3D12_CPU_DESCRIPTOR_HANDLE inDepthStencil, D3D12_CLEAR_FLAGS inFlags, float inDepth, uint8 inStencil) override;
+
+	void	DrawInstanced(uint32 inVertexCountPerInstance, uint32 inInstanceCount, uint32 inStartVertex, uint32 inStartInstance) override;
+	void	DrawIndexedInstanced(uint32 inIndexCountPerInstance, uint32 inInstanceCount, uint32 inStartIndex, int32 inBaseVertex, uint32 inStartInstance) override;
+
+	D3D12_GPU_DESCRIPTOR_HANDLE	CopyDescriptor(D3D12_CPU_DESCRIPTOR_HANDLE inDescriptor) override;
+	D3D12_GPU_DESCRIPTOR_HANDLE	CreateShaderResourceView(ID3D12Resource* inResource) override;
+
+	inline const StateCacheStatistics&	GetStatistics() const	{ return m_Statistics; }
+	void	TraceStatistics() const;
+
+private:
+	// Count the call, returns true when it must be forwarded
+	bool	Issue(bool inIsRedundant);
+	// Returns true when the root parameter must be set, and remembers inValue
+	bool	SetRootParameter(uint32 inRootParameterIndex, uint64 inValue);
+
+	CommandList&				m_CommandList;
+	StateCacheStatistics		m_Statistics;
+
+	// What the target has bound. The flags tell whether the values are known
+	ID3D12DescriptorHeap*		m_DescriptorHeap		= nullptr;
+	ID3D12RootSignature*		m_RootSignature			= nullptr;
+	ID3D12PipelineState*		m_PipelineState			= nullptr;
+	D3D_PRIMITIVE_TOPOLOGY		m_Topology				= D3D_PRIMITIVE_TOPOLOGY_UNDEFINED;
+	D3D12_VERTEX_BUFFER_VIEW	m_VertexBuffer			= {};
+	D3D12_INDEX_BUFFER_VIEW		m_IndexBuffer			= {};
+	bool						m_HasDescriptorHeap		= false;
+	bool						m_HasVertexBuffer		= false;
+	bool						m_HasIndexBuffer		= false;
+
+	// Descriptor table or constant buffer address of each root parameter, forgotten when the root signature changes
+	std::array<uint64, MaxRootParameters>	m_RootParameters	= {};
+	uint32						m_BoundRootParameters	= 0;	// Bit mask
+};
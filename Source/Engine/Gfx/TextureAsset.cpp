@@ -0,0 +1,38 @@
+#include "Engine.h"
+#include "TextureAsset.h"
+
+#include "DX12/DX12Texture.h"
+
+#include "Gfx/TextureLoader.h"
+
+TextureAsset::TextureAsset() = default;
+
+TextureAsset::~TextureAsset()
+{
+	if (m_Texture != nullptr)
+	{
+		m_Texture->Release();
+		delete m_Texture;
+	}
+}
+
+bool TextureAsset::Load(const AssetFile& inFile)
+{
+	// Workers don't initialize COM, they use the multithreaded apartment created by TextureLoader::Init
+	m_TextureLoader = std::make_unique<TextureLoader>();
+	if (!m_TextureLoader->LoadFromMemory(inFile.m_Data, static_cast<size_t>(inFile.m_Size)))
+	{
+		m_TextureLoader.reset();
+		return false;
+	}
+
+	return true;
+}
+
+bool TextureAsset::Upload(const AssetUploadContext& inContext)
+{
+	m_Texture = m_TextureLoader->CreateTexture(*inContext.m_CommandList);
+	m_TextureLoader.reset();
+
+	return true;
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <memory>
+
+#include "Gfx/AssetManager.h"
+
+class DX12Texture;
+class TextureLoader;
+
+// Image file loaded through the AssetManager. Read by AsyncIO and decoded on a job, the texture is created by Upload
+class TextureAsset final : public Asset
+{
+public:
+	static constexpr const char* TypeName = "Texture";
+
+	TextureAsset();
+	~TextureAsset() override;
+
+	inline DX12Texture*		GetTexture() const	{ return m_Texture; }
+
+protected:
+	bool	ReadsWholeFile() const override	{ return true; }
+	bool	Load(const AssetFile& inFile) override;
+	bool	Upload(const AssetUploadContext& inContext) override;
+
+private:
+	// Decoded image, until Upload
+	std::unique_ptr<TextureLoader>	m_TextureLoader;
+	DX12Texture*					m_Texture	= nullptr;
+};
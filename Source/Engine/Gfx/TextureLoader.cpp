@@ -3,23 +3,67 @@
 
 #include "DX12/DX12Texture.h"
 
+#include "Utils/AssetCache.h"
 #include "Utils/FileReader.h"
 
-void TextureLoader::LoadFromFile(const std::string& inFile)
+#include <filesystem>
+
+bool TextureLoader::LoadFromFile(const std::string& inFile)
 {
 	FileReader file_reader;
-	bool success = file_reader.ReadFile(inFile);
-	Assert(success);
+	if (!file_reader.ReadFile(inFile))
+		return false;
+
+	return LoadFromMemory(file_reader.GetContentAsBinary(), file_reader.GetContentSize());
+}
+
+bool TextureLoader::LoadFromMemory(const void* inData, size_t inSize)
+{
+	HRESULT result = E_FAIL;
+
+	const bool use_cache = g_AssetCache.IsInitialized();
+	AssetCacheKey cache_key("Texture", ImporterVersion);
+	cache_key.AddData(inData, inSize);
+
+	// DDS files are the decoded image as is, no need to decompress the PNG again
+	const std::filesystem::path cached_file = use_cache ? g_AssetCache.GetPath(cache_key, ".dds") : std::string();
+	if (use_cache && g_AssetCache.Contains(cache_key, ".dds"))
+		result = DirectX::LoadFromDDSFile(cached_file.c_str(), DirectX::DDS_FLAGS_NONE, nullptr, m_ScratchImage);
+
+	if (FAILED(result))
+	{
+		// Runs on jobs, a bad image fails the load instead of throwing
+		result = DirectX::LoadFromWICMemory(inData, inSize, DirectX::WIC_FLAGS_NONE, nullptr, m_ScratchImage);
+		if (FAILED(result))
+		{
+			Trace("TextureLoader: Can't decode image (HRESULT 0x%08X)", static_cast<uint32>(result));
+			return false;
+		}
+
+		if (use_cache)
+		{
+			bool success = g_AssetCache.Store(cache_key, ".dds", [this](const std::string& inCachedFile)
+			{
+				const HRESULT save_result = DirectX::SaveToDDSFile(m_ScratchImage.GetImages(), m_ScratchImage.GetImageCount(), m_ScratchImage.GetMetadata(),
+																   DirectX::DDS_FLAGS_NONE, std::filesystem::path(inCachedFile).c_str());
+				return SUCCEEDED(save_result);
+			});
 
-	HRESULT result = DirectX::LoadFromWICMemory(
-		file_reader.GetContentAsBinary(), file_reader.GetContentSize(),
-		DirectX::WIC_FLAGS_NONE, nullptr, m_ScratchImage);
+			// The image is decoded already, it's only decoded again next time
+			if (!success)
+				Trace("TextureLoader: Can't store the decoded image in the AssetCache");
+		}
+	}
 
-	ThrowIfFailed(result);
+	const DirectX::TexMetadata metadata = m_ScratchImage.GetMetadata();
+	if (!Math::IsPowerOfTwo(static_cast<int>(metadata.width)) || !Math::IsPowerOfTwo(static_cast<int>(metadata.height)))
+	{
+		Trace("TextureLoader: %zux%zu image isn't supported, sizes must be powers of two", metadata.width, metadata.height);
+		m_ScratchImage.Release();
+		return false;
+	}
 
-	DirectX::TexMetadata metadata = m_ScratchImage.GetMetadata();
-	Assert(Math::IsPowerOfTwo(static_cast<int>(metadata.width)));
-	Assert(Math::IsPowerOfTwo(static_cast<int>(metadata.height)));
+	return true;
 }
 
 DX12Texture* TextureLoader::CreateTexture(ID3D12GraphicsCommandList2& inCommandList)
@@ -9,7 +9,14 @@ class DX12Texture;
 class TextureLoader final
 {
 public:
-	void			LoadFromFile(const std::string& inFile);
+	// Bump when decoding produces a different image from the same file. Invalidates cached textures
+	static constexpr uint32 ImporterVersion = 1;
+
+	// False when the file can't be read or decoded
+	bool			LoadFromFile(const std::string& inFile);
+	// Content of an image file, e.g. read with AsyncIO. False when the image is corrupt or unsupported.
+	// Decoded images are kept as DDS in the AssetCache when it's initialized, and loaded from there next time
+	bool			LoadFromMemory(const void* inData, size_t inSize);
 	DX12Texture*	CreateTexture(ID3D12GraphicsCommandList2& inCommandList);
 
 public:
@@ -0,0 +1,446 @@
+#include "Engine.h"
+#include "VertexCompression.h"
+
+#include <cstring>
+
+#if defined(_M_X64) || defined(__SSE2__)
+	#define VERTEX_COMPRESSION_SSE2
+	#include <emmintrin.h>
+#endif
+
+// The SSE2 path loads a vertex as 2 registers: [Position.xyz, UV.x] and [UV.y, Normal.xyz]
+static_assert(sizeof(VertexPosUVNormal) == 8 * sizeof(float), "Unexpected VertexPosUVNormal layout");
+static_assert(sizeof(VertexPosUVNormalPacked) == 20, "Unexpected VertexPosUVNormalPacked layout");
+static_assert(sizeof(VertexPosUVNormalQuantized) == 16, "Unexpected VertexPosUVNormalQuantized layout");
+
+namespace VertexCompression
+{
+	static inline uint32 FloatAsUint(float inValue)
+	{
+		uint32 value;
+		::memcpy(&value, &inValue, sizeof(value));
+		return value;
+	}
+
+	static inline float UintAsFloat(uint32 inValue)
+	{
+		float value;
+		::memcpy(&value, &inValue, sizeof(value));
+		return value;
+	}
+
+	static inline int16 FloatToSnorm16(float inValue)
+	{
+		return static_cast<int16>(::lrintf(Math::Clamp(inValue, -1.0f, 1.0f) * 32767.0f));
+	}
+
+	static inline float Snorm16ToFloat(int16 inValue)
+	{
+		// -32768 and -32767 both map to -1
+		return Math::Max(inValue / 32767.0f, -1.0f);
+	}
+
+	// Degenerate axes are all encoded as 0
+	static inline Vec3 GetInverseExtents(const QuantizationBounds& inBounds)
+	{
+		return Vec3(inBounds.m_Extents.x > 0.0f ? 1.0f / inBounds.m_Extents.x : 0.0f,
+					inBounds.m_Extents.y > 0.0f ? 1.0f / inBounds.m_Extents.y : 0.0f,
+					inBounds.m_Extents.z > 0.0f ? 1.0f / inBounds.m_Extents.z : 0.0f);
+	}
+
+	void EncodingError::Accumulate(const EncodingError& inOther)
+	{
+		m_MaxPositionError	= Math::Max(m_MaxPositionError,	inOther.m_MaxPositionError);
+		m_MaxUVError		= Math::Max(m_MaxUVError,		inOther.m_MaxUVError);
+		m_MaxNormalError	= Math::Max(m_MaxNormalError,	inOther.m_MaxNormalError);
+	}
+
+	// Round to nearest even. Based on "float_to_half_fast3_rtne" by Fabian Giesen
+	uint16 FloatToHalf(float inValue)
+	{
+		constexpr uint32 f32_infinity	= 255 << 23;
+		constexpr uint32 f16_max		= (127 + 16) << 23;
+		constexpr uint32 f16_min_normal	= (127 - 14) << 23;
+		constexpr uint32 denorm_magic	= ((127 - 15) + (23 - 10) + 1) << 23;
+
+		uint32 value		= FloatAsUint(inValue);
+		const uint32 sign	= value & 0x80000000u;
+		value ^= sign;
+
+		uint32 result;
+		if (value >= f16_max)
+		{
+			// Infinity or NaN
+			result = (value > f32_infinity) ? 0x7E00 : 0x7C00;
+		}
+		else if (value < f16_min_normal)
+		{
+			// Let the FPU do the rounding of denormals
+			result = FloatAsUint(UintAsFloat(value) + UintAsFloat(denorm_magic)) - denorm_magic;
+		}
+		else
+		{
+			const uint32 mantissa_odd = (value >> 13) & 1;
+			value += ((15u - 127u) << 23) + 0xFFF;
+			value += mantissa_odd;
+			result = value >> 13;
+		}
+
+		return static_cast<uint16>(result | (sign >> 16));
+	}
+
+	float HalfToFloat(uint16 inValue)
+	{
+		constexpr uint32 shifted_exponent = 0x7C00 << 13;
+
+		uint32 result			= (inValue & 0x7FFF) << 13;
+		const uint32 exponent	= result & shifted_exponent;
+		result += (127 - 15) << 23;
+
+		if (exponent == shifted_exponent)
+		{
+			// Infinity or NaN
+			result += (128 - 16) << 23;
+		}
+		else if (exponent == 0)
+		{
+			// Denormal, renormalize
+			result += 1 << 23;
+			result = FloatAsUint(UintAsFloat(result) - UintAsFloat(113 << 23));
+		}
+
+		return UintAsFloat(result | ((inValue & 0x8000) << 16));
+	}
+
+	// See "A Survey of Efficient Representations for Independent Unit Vectors" by Cigolle et al.
+	Vec2 EncodeOctahedral(const Vec3& inNormal)
+	{
+		// Zero length normals end up as (0, 0, 1)
+		const float length_l1	= Math::Max(Math::Abs(inNormal.x) + Math::Abs(inNormal.y) + Math::Abs(inNormal.z), 1e-20f);
+		const float inv_length	= 1.0f / length_l1;
+
+		const float x = inNormal.x * inv_length;
+		const float y = inNormal.y * inv_length;
+
+		// Fold the lower hemisphere over the diagonals
+		if (inNormal.z < 0.0f)
+			return Vec2((1.0f - Math::Abs(y)) * Math::Sign(x), (1.0f - Math::Abs(x)) * Math::Sign(y));
+
+		return Vec2(x, y);
+	}
+
+	Vec3 DecodeOctahedral(const Vec2& inEncoded)
+	{
+		Vec3 normal(inEncoded.x, inEncoded.y, 1.0f - Math::Abs(inEncoded.x) - Math::Abs(inEncoded.y));
+
+		if (normal.z < 0.0f)
+		{
+			const float x = normal.x;
+			normal.x = (1.0f - Math::Abs(normal.y)) * Math::Sign(x);
+			normal.y = (1.0f - Math::Abs(x)) * Math::Sign(normal.y);
+		}
+
+		return normal.Normalized();
+	}
+
+	QuantizationBounds ComputeQuantizationBounds(const VertexPosUVNormal* inVertices, size_t inNumVertices)
+	{
+		QuantizationBounds bounds;
+		bounds.m_Center		= Vec3(0.0f, 0.0f, 0.0f);
+		bounds.m_Extents	= Vec3(0.0f, 0.0f, 0.0f);
+
+		if (inNumVertices == 0)
+			return bounds;
+
+		Vec3 min_position = inVertices[0].Position;
+		Vec3 max_position = inVertices[0].Position;
+
+		for (size_t i = 1; i < inNumVertices; i++)
+		{
+			for (int32 k = 0; k < 3; k++)
+			{
+				min_position[k] = Math::Min(min_position[k], inVertices[i].Position[k]);
+				max_position[k] = Math::Max(max_position[k], inVertices[i].Position[k]);
+			}
+		}
+
+		bounds.m_Center		= (min_position + max_position) * 0.5f;
+		bounds.m_Extents	= (max_position - min_position) * 0.5f;
+
+		return bounds;
+	}
+
+	static inline uint32 PackUVs(const VertexPosUVNormal& inVertex)
+	{
+		return FloatToHalf(inVertex.UV.x) | (FloatToHalf(inVertex.UV.y) << 16);
+	}
+
+	static inline uint32 PackNormal(const VertexPosUVNormal& inVertex)
+	{
+		const Vec2 encoded = EncodeOctahedral(inVertex.Normal);
+		return static_cast<uint16>(FloatToSnorm16(encoded.x)) | (static_cast<uint16>(FloatToSnorm16(encoded.y)) << 16);
+	}
+
+	static void EncodeVertex(const VertexPosUVNormal& inVertex, VertexPosUVNormalPacked& outVertex)
+	{
+		const uint32 uvs	= PackUVs(inVertex);
+		const uint32 normal	= PackNormal(inVertex);
+
+		outVertex.Position = inVertex.Position;
+		::memcpy(outVertex.UV,		&uvs,		sizeof(uvs));
+		::memcpy(outVertex.Normal,	&normal,	sizeof(normal));
+	}
+
+	static void EncodeVertex(const VertexPosUVNormal& inVertex, const Vec3& inCenter, const Vec3& inInverseExtents, VertexPosUVNormalQuantized& outVertex)
+	{
+		const uint32 uvs	= PackUVs(inVertex);
+		const uint32 normal	= PackNormal(inVertex);
+
+		for (int32 k = 0; k < 3; k++)
+			outVertex.Position[k] = FloatToSnorm16((inVertex.Position[k] - inCenter[k]) * inInverseExtents[k]);
+		outVertex.Position[3] = 0;
+
+		::memcpy(outVertex.UV,		&uvs,		sizeof(uvs));
+		::memcpy(outVertex.Normal,	&normal,	sizeof(normal));
+	}
+
+#if defined(VERTEX_COMPRESSION_SSE2)
+	// 4 wide version of FloatToHalf. Returns the half in the low 16 bits of each lane
+	static inline __m128i FloatToHalf4(__m128 inValues)
+	{
+		const __m128i f16_max			= _mm_set1_epi32((127 + 16) << 23);
+		const __m128i f16_min_normal	= _mm_set1_epi32((127 - 14) << 23);
+		const __m128i denorm_magic		= _mm_set1_epi32(((127 - 15) + (23 - 10) + 1) << 23);
+		const __m128i normal_bias		= _mm_set1_epi32(static_cast<int32>(((15u - 127u) << 23) + 0xFFF));
+		const __m128i nan_bit			= _mm_set1_epi32(0x0200);
+		const __m128i infinity			= _mm_set1_epi32(0x7C00);
+
+		const __m128 sign			= _mm_and_ps(inValues, _mm_set1_ps(-0.0f));
+		const __m128 abs_values		= _mm_xor_ps(inValues, sign);
+		const __m128i abs_bits		= _mm_castps_si128(abs_values);
+
+		// Infinity or NaN
+		const __m128i is_nan		= _mm_castps_si128(_mm_cmpunord_ps(abs_values, abs_values));
+		const __m128i special		= _mm_or_si128(infinity, _mm_and_si128(is_nan, nan_bit));
+		const __m128i is_regular	= _mm_cmpgt_epi32(f16_max, abs_bits);
+
+		// Denormals
+		const __m128i is_denormal	= _mm_cmpgt_epi32(f16_min_normal, abs_bits);
+		const __m128i denormal		= _mm_sub_epi32(_mm_castps_si128(_mm_add_ps(abs_values, _mm_castsi128_ps(denorm_magic))), denorm_magic);
+
+		// Normals
+		const __m128i mantissa_odd	= _mm_and_si128(_mm_srli_epi32(abs_bits, 13), _mm_set1_epi32(1));
+		const __m128i normal		= _mm_srli_epi32(_mm_add_epi32(_mm_add_epi32(abs_bits, normal_bias), mantissa_odd), 13);
+
+		const __m128i finite		= _mm_or_si128(_mm_and_si128(is_denormal, denormal), _mm_andnot_si128(is_denormal, normal));
+		const __m128i result		= _mm_or_si128(_mm_and_si128(is_regular, finite), _mm_andnot_si128(is_regular, special));
+
+		return _mm_or_si128(result, _mm_srli_epi32(_mm_castps_si128(sign), 16));
+	}
+
+	// 4 wide version of FloatToSnorm16. Returns the value in the low 16 bits of each lane
+	static inline __m128i FloatToSnorm16x4(__m128 inValues)
+	{
+		const __m128 clamped = _mm_max_ps(_mm_set1_ps(-1.0f), _mm_min_ps(_mm_set1_ps(1.0f), inValues));
+		return _mm_and_si128(_mm_cvtps_epi32(_mm_mul_ps(clamped, _mm_set1_ps(32767.0f))), _mm_set1_epi32(0xFFFF));
+	}
+
+	static inline __m128 Sign4(__m128 inValues)
+	{
+		const __m128 is_negative = _mm_cmplt_ps(inValues, _mm_setzero_ps());
+		return _mm_or_ps(_mm_and_ps(is_negative, _mm_set1_ps(-1.0f)), _mm_andnot_ps(is_negative, _mm_set1_ps(1.0f)));
+	}
+
+	static inline __m128 Abs4(__m128 inValues)
+	{
+		return _mm_andnot_ps(_mm_set1_ps(-0.0f), inValues);
+	}
+
+	// Structure of arrays for 4 vertices
+	struct VertexBlock
+	{
+		__m128 m_PositionX, m_PositionY, m_PositionZ;
+		__m128 m_U, m_V;
+		__m128 m_NormalX, m_NormalY, m_NormalZ;
+	};
+
+	static inline VertexBlock LoadVertexBlock(const VertexPosUVNormal* inVertices)
+	{
+		const float* data = &inVertices->Position.x;
+
+		__m128 low0		= _mm_loadu_ps(data + 0);
+		__m128 high0	= _mm_loadu_ps(data + 4);
+		__m128 low1		= _mm_loadu_ps(data + 8);
+		__m128 high1	= _mm_loadu_ps(data + 12);
+		__m128 low2		= _mm_loadu_ps(data + 16);
+		__m128 high2	= _mm_loadu_ps(data + 20);
+		__m128 low3		= _mm_loadu_ps(data + 24);
+		__m128 high3	= _mm_loadu_ps(data + 28);
+
+		_MM_TRANSPOSE4_PS(low0, low1, low2, low3);
+		_MM_TRANSPOSE4_PS(high0, high1, high2, high3);
+
+		VertexBlock block;
+		block.m_PositionX	= low0;
+		block.m_PositionY	= low1;
+		block.m_PositionZ	= low2;
+		block.m_U			= low3;
+		block.m_V			= high0;
+		block.m_NormalX		= high1;
+		block.m_NormalY		= high2;
+		block.m_NormalZ		= high3;
+
+		return block;
+	}
+
+	static inline __m128i PackUVs4(const VertexBlock& inBlock)
+	{
+		return _mm_or_si128(FloatToHalf4(inBlock.m_U), _mm_slli_epi32(FloatToHalf4(inBlock.m_V), 16));
+	}
+
+	static inline __m128i PackNormals4(const VertexBlock& inBlock)
+	{
+		const __m128 length_l1	= _mm_max_ps(_mm_add_ps(_mm_add_ps(Abs4(inBlock.m_NormalX), Abs4(inBlock.m_NormalY)), Abs4(inBlock.m_NormalZ)), _mm_set1_ps(1e-20f));
+		const __m128 inv_length	= _mm_div_ps(_mm_set1_ps(1.0f), length_l1);
+
+		const __m128 x = _mm_mul_ps(inBlock.m_NormalX, inv_length);
+		const __m128 y = _mm_mul_ps(inBlock.m_NormalY, inv_length);
+
+		const __m128 folded_x = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(1.0f), Abs4(y)), Sign4(x));
+		const __m128 folded_y = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(1.0f), Abs4(x)), Sign4(y));
+
+		const __m128 is_lower = _mm_cmplt_ps(inBlock.m_NormalZ, _mm_setzero_ps());
+		const __m128 encoded_x = _mm_or_ps(_mm_and_ps(is_lower, folded_x), _mm_andnot_ps(is_lower, x));
+		const __m128 encoded_y = _mm_or_ps(_mm_and_ps(is_lower, folded_y), _mm_andnot_ps(is_lower, y));
+
+		return _mm_or_si128(FloatToSnorm16x4(encoded_x), _mm_slli_epi32(FloatToSnorm16x4(encoded_y), 16));
+	}
+#endif
+
+	void Encode(const VertexPosUVNormal* inVertices, size_t inNumVertices, VertexPosUVNormalPacked* outVertices)
+	{
+		size_t i = 0;
+
+#if defined(VERTEX_COMPRESSION_SSE2)
+		for (; i + 4 <= inNumVertices; i += 4)
+		{
+			const VertexBlock block = LoadVertexBlock(inVertices + i);
+
+			alignas(16) uint32 uvs[4];
+			alignas(16) uint32 normals[4];
+			_mm_store_si128(reinterpret_cast<__m128i*>(uvs),		PackUVs4(block));
+			_mm_store_si128(reinterpret_cast<__m128i*>(normals),	PackNormals4(block));
+
+			for (size_t k = 0; k < 4; k++)
+			{
+				VertexPosUVNormalPacked& vertex = outVertices[i + k];
+				vertex.Position = inVertices[i + k].Position;
+				::memcpy(vertex.UV,		&uvs[k],		sizeof(uint32));
+				::memcpy(vertex.Normal,	&normals[k],	sizeof(uint32));
+			}
+		}
+#endif
+
+		for (; i < inNumVertices; i++)
+			EncodeVertex(inVertices[i], outVertices[i]);
+	}
+
+	void Encode(const VertexPosUVNormal* inVertices, size_t inNumVertices, const QuantizationBounds& inBounds, VertexPosUVNormalQuantized* outVertices)
+	{
+		const Vec3 inv_extents = GetInverseExtents(inBounds);
+
+		size_t i = 0;
+
+#if defined(VERTEX_COMPRESSION_SSE2)
+		const __m128 center_x		= _mm_set1_ps(inBounds.m_Center.x);
+		const __m128 center_y		= _mm_set1_ps(inBounds.m_Center.y);
+		const __m128 center_z		= _mm_set1_ps(inBounds.m_Center.z);
+		const __m128 inv_extents_x	= _mm_set1_ps(inv_extents.x);
+		const __m128 inv_extents_y	= _mm_set1_ps(inv_extents.y);
+		const __m128 inv_extents_z	= _mm_set1_ps(inv_extents.z);
+
+		for (; i + 4 <= inNumVertices; i += 4)
+		{
+			const VertexBlock block = LoadVertexBlock(inVertices + i);
+
+			const __m128i x = FloatToSnorm16x4(_mm_mul_ps(_mm_sub_ps(block.m_PositionX, center_x), inv_extents_x));
+			const __m128i y = FloatToSnorm16x4(_mm_mul_ps(_mm_sub_ps(block.m_PositionY, center_y), inv_extents_y));
+			const __m128i z = FloatToSnorm16x4(_mm_mul_ps(_mm_sub_ps(block.m_PositionZ, center_z), inv_extents_z));
+
+			// Each lane holds one vertex, transpose back to one vertex per register
+			__m128 position_xy	= _mm_castsi128_ps(_mm_or_si128(x, _mm_slli_epi32(y, 16)));
+			__m128 position_zw	= _mm_castsi128_ps(z);
+			__m128 uvs			= _mm_castsi128_ps(PackUVs4(block));
+			__m128 normals		= _mm_castsi128_ps(PackNormals4(block));
+
+			_MM_TRANSPOSE4_PS(position_xy, position_zw, uvs, normals);
+
+			_mm_storeu_ps(reinterpret_cast<float*>(outVertices + i + 0), position_xy);
+			_mm_storeu_ps(reinterpret_cast<float*>(outVertices + i + 1), position_zw);
+			_mm_storeu_ps(reinterpret_cast<float*>(outVertices + i + 2), uvs);
+			_mm_storeu_ps(reinterpret_cast<float*>(outVertices + i + 3), normals);
+		}
+#endif
+
+		for (; i < inNumVertices; i++)
+			EncodeVertex(inVertices[i], inBounds.m_Center, inv_extents, outVertices[i]);
+	}
+
+	VertexPosUVNormal Decode(const VertexPosUVNormalPacked& inVertex)
+	{
+		VertexPosUVNormal vertex;
+		vertex.Position	= inVertex.Position;
+		vertex.UV		= Vec2(HalfToFloat(static_cast<uint16>(inVertex.UV[0])), HalfToFloat(static_cast<uint16>(inVertex.UV[1])));
+		vertex.Normal	= DecodeOctahedral(Vec2(Snorm16ToFloat(inVertex.Normal[0]), Snorm16ToFloat(inVertex.Normal[1])));
+
+		return vertex;
+	}
+
+	VertexPosUVNormal Decode(const VertexPosUVNormalQuantized& inVertex, const QuantizationBounds& inBounds)
+	{
+		VertexPosUVNormal vertex;
+		for (int32 k = 0; k < 3; k++)
+			vertex.Position[k] = inBounds.m_Center[k] + Snorm16ToFloat(inVertex.Position[k]) * inBounds.m_Extents[k];
+		vertex.UV		= Vec2(HalfToFloat(static_cast<uint16>(inVertex.UV[0])), HalfToFloat(static_cast<uint16>(inVertex.UV[1])));
+		vertex.Normal	= DecodeOctahedral(Vec2(Snorm16ToFloat(inVertex.Normal[0]), Snorm16ToFloat(inVertex.Normal[1])));
+
+		return vertex;
+	}
+
+	static EncodingError ComputeVertexError(const VertexPosUVNormal& inOriginal, const VertexPosUVNormal& inDecoded)
+	{
+		EncodingError error;
+		error.m_MaxPositionError	= (inDecoded.Position - inOriginal.Position).Length();
+		error.m_MaxUVError			= Math::Max(Math::Abs(inDecoded.UV.x - inOriginal.UV.x), Math::Abs(inDecoded.UV.y - inOriginal.UV.y));
+
+		// Zero length normals can't be compared
+		const float length = inOriginal.Normal.Length();
+		if (length > 0.0f)
+		{
+			// acos of the dot product can't resolve angles below a few hundredths of a degree in float precision
+			const Vec3 normal		= inOriginal.Normal * (1.0f / length);
+			error.m_MaxNormalError	= Math::ToDegrees(::atan2f(Vec3::CrossProduct(normal, inDecoded.Normal).Length(), Vec3::DotProduct(normal, inDecoded.Normal)));
+		}
+
+		return error;
+	}
+
+	EncodingError ComputeError(const VertexPosUVNormal* inVertices, const VertexPosUVNormalPacked* inEncodedVertices, size_t inNumVertices)
+	{
+		EncodingError error;
+		for (size_t i = 0; i < inNumVertices; i++)
+			error.Accumulate(ComputeVertexError(inVertices[i], Decode(inEncodedVertices[i])));
+
+		return error;
+	}
+
+	EncodingError ComputeError(const VertexPosUVNormal* inVertices, const VertexPosUVNormalQuantized* inEncodedVertices, size_t inNumVertices,
+							   const QuantizationBounds& inBounds)
+	{
+		EncodingError error;
+		for (size_t i = 0; i < inNumVertices; i++)
+			error.Accumulate(ComputeVertexError(inVertices[i], Decode(inEncodedVertices[i], inBounds)));
+
+		return error;
+	}
+}
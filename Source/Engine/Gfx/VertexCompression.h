@@ -0,0 +1,47 @@
+#pragma once
+
+#include "DX12/DX12Includes.h"
+#include "Shaders/Include/VertexLayouts.h"
+using namespace VertexFormats;
+
+// Encoding of VertexPosUVNormal into VertexPosUVNormalPacked (20 bytes) and VertexPosUVNormalQuantized (16 bytes).
+// UVs are stored as half floats, normals are octahedral encoded in 2 snorm16.
+// Quantized positions are snorm16 relative to the bounding box of the vertices
+namespace VertexCompression
+{
+	// Decoded position = m_Center + Position * m_Extents
+	struct QuantizationBounds
+	{
+		Vec3	m_Center;
+		Vec3	m_Extents;
+	};
+
+	// Round-trip error of an encoding
+	struct EncodingError
+	{
+		float	m_MaxPositionError	= 0.0f;		// In object space units
+		float	m_MaxUVError		= 0.0f;
+		float	m_MaxNormalError	= 0.0f;		// In degrees
+
+		void Accumulate(const EncodingError& inOther);
+	};
+
+	uint16	FloatToHalf(float inValue);
+	float	HalfToFloat(uint16 inValue);
+
+	Vec2	EncodeOctahedral(const Vec3& inNormal);
+	Vec3	DecodeOctahedral(const Vec2& inEncoded);
+
+	QuantizationBounds	ComputeQuantizationBounds(const VertexPosUVNormal* inVertices, size_t inNumVertices);
+
+	// Encoding uses SSE2 when available, 4 vertices at a time
+	void	Encode(const VertexPosUVNormal* inVertices, size_t inNumVertices, VertexPosUVNormalPacked* outVertices);
+	void	Encode(const VertexPosUVNormal* inVertices, size_t inNumVertices, const QuantizationBounds& inBounds, VertexPosUVNormalQuantized* outVertices);
+
+	VertexPosUVNormal	Decode(const VertexPosUVNormalPacked& inVertex);
+	VertexPosUVNormal	Decode(const VertexPosUVNormalQuantized& inVertex, const QuantizationBounds& inBounds);
+
+	EncodingError		ComputeError(const VertexPosUVNormal* inVertices, const VertexPosUVNormalPacked* inEncodedVertices, size_t inNumVertices);
+	EncodingError		ComputeError(const VertexPosUVNormal* inVertices, const VertexPosUVNormalQuantized* inEncodedVertices, size_t inNumVertices,
+									 const QuantizationBounds& inBounds);
+}
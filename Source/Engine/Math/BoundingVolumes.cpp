@@ -0,0 +1,290 @@
+#include "Engine.h"
+#include "BoundingVolumes.h"
+
+#if defined(_M_X64) || defined(__SSE2__)
+	#define BOUNDING_VOLUMES_SSE2
+	#include <emmintrin.h>
+#endif
+
+void AABB::Merge(const AABB& inOther)
+{
+	for (int32 k = 0; k < 3; k++)
+	{
+		m_Min[k] = Math::Min(m_Min[k], inOther.m_Min[k]);
+		m_Max[k] = Math::Max(m_Max[k], inOther.m_Max[k]);
+	}
+}
+
+bool AABB::Contains(const Vec3& inPoint, float inEpsilon/* = 0.0f*/) const
+{
+	for (int32 k = 0; k < 3; k++)
+	{
+		if (inPoint[k] < m_Min[k] - inEpsilon || inPoint[k] > m_Max[k] + inEpsilon)
+			return false;
+	}
+	return true;
+}
+
+bool BoundingSphere::Contains(const Vec3& inPoint, float inEpsilon/* = 0.0f*/) const
+{
+	return (inPoint - m_Center).Length() <= m_Radius + inEpsilon;
+}
+
+namespace BoundingVolumes
+{
+	static inline const float* GetPosition(const float* inPositions, size_t inVertexStride, uint32 inIndex)
+	{
+		return reinterpret_cast<const float*>(reinterpret_cast<const Byte*>(inPositions) + inIndex * inVertexStride);
+	}
+
+	static inline Vec3 LoadPosition(const float* inPositions, size_t inVertexStride, uint32 inIndex)
+	{
+		const float* position = GetPosition(inPositions, inVertexStride, inIndex);
+		return Vec3(position[0], position[1], position[2]);
+	}
+
+#if defined(BOUNDING_VOLUMES_SSE2)
+	// Exactly 3 floats, x and y in one 8 byte load. Never reads past the position, whatever the stride
+	static inline __m128 LoadPosition3(const float* inPosition)
+	{
+		const __m128 xy	= _mm_castsi128_ps(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(inPosition)));
+		const __m128 z	= _mm_load_ss(inPosition + 2);
+		return _mm_movelh_ps(xy, z);
+	}
+
+	static inline __m128 LoadVec3(const Vec3& inVector)
+	{
+		return _mm_set_ps(0.0f, inVector.z, inVector.y, inVector.x);
+	}
+
+	static inline Vec3 StoreVec3(__m128 inVector)
+	{
+		float values[4];
+		_mm_storeu_ps(values, inVector);
+		return Vec3(values[0], values[1], values[2]);
+	}
+
+	// Upper 3 rows of a column of inMatrix
+	static inline __m128 LoadColumn(const Mat4x4& inMatrix, int32 inColumn)
+	{
+		return _mm_set_ps(0.0f, inMatrix(2, inColumn), inMatrix(1, inColumn), inMatrix(0, inColumn));
+	}
+
+	// inColumns[0] * x + inColumns[1] * y + inColumns[2] * z
+	static inline __m128 Rotate(const __m128 inColumns[3], __m128 inVector)
+	{
+		const __m128 x = _mm_shuffle_ps(inVector, inVector, _MM_SHUFFLE(0, 0, 0, 0));
+		const __m128 y = _mm_shuffle_ps(inVector, inVector, _MM_SHUFFLE(1, 1, 1, 1));
+		const __m128 z = _mm_shuffle_ps(inVector, inVector, _MM_SHUFFLE(2, 2, 2, 2));
+		return _mm_add_ps(_mm_add_ps(_mm_mul_ps(inColumns[0], x), _mm_mul_ps(inColumns[1], y)), _mm_mul_ps(inColumns[2], z));
+	}
+#endif
+
+	AABB ComputeAABB(const uint32* inIndices, size_t inNumIndices, const float* inPositions, size_t inVertexStride)
+	{
+		AABB aabb;
+		size_t i = 0;
+
+#if defined(BOUNDING_VOLUMES_SSE2)
+		if (inNumIndices >= 2)
+		{
+			// Two sets of accumulators to hide the latency of min/max
+			__m128 min0 = LoadPosition3(GetPosition(inPositions, inVertexStride, inIndices[0]));
+			__m128 max0 = min0;
+			__m128 min1 = min0;
+			__m128 max1 = min0;
+
+			for (; i + 2 <= inNumIndices; i += 2)
+			{
+				const __m128 p0 = LoadPosition3(GetPosition(inPositions, inVertexStride, inIndices[i]));
+				const __m128 p1 = LoadPosition3(GetPosition(inPositions, inVertexStride, inIndices[i + 1]));
+				min0 = _mm_min_ps(min0, p0);
+				max0 = _mm_max_ps(max0, p0);
+				min1 = _mm_min_ps(min1, p1);
+				max1 = _mm_max_ps(max1, p1);
+			}
+
+			aabb.m_Min = StoreVec3(_mm_min_ps(min0, min1));
+			aabb.m_Max = StoreVec3(_mm_max_ps(max0, max1));
+		}
+#endif
+
+		// Remaining vertices, or all of them without SSE2
+		for (; i < inNumIndices; i++)
+		{
+			const float* position = GetPosition(inPositions, inVertexStride, inIndices[i]);
+			for (int32 k = 0; k < 3; k++)
+			{
+				aabb.m_Min[k] = Math::Min(aabb.m_Min[k], position[k]);
+				aabb.m_Max[k] = Math::Max(aabb.m_Max[k], position[k]);
+			}
+		}
+
+		return aabb;
+	}
+
+	BoundingSphere ComputeSphere(const uint32* inIndices, size_t inNumIndices, const float* inPositions, size_t inVertexStride,
+								 const AABB& inAABB)
+	{
+		BoundingSphere sphere;
+		if (inNumIndices == 0)
+			return sphere;
+
+		// Ritter's bounding sphere. Not optimal but within a few percent.
+		// Start from the most distant pair of extreme points along the axes
+		uint32 min_points[3] = { inIndices[0], inIndices[0], inIndices[0] };
+		uint32 max_points[3] = { inIndices[0], inIndices[0], inIndices[0] };
+
+		for (size_t i = 0; i < inNumIndices; i++)
+		{
+			const float* position = GetPosition(inPositions, inVertexStride, inIndices[i]);
+			for (int32 k = 0; k < 3; k++)
+			{
+				if (position[k] < GetPosition(inPositions, inVertexStride, min_points[k])[k])
+					min_points[k] = inIndices[i];
+				if (position[k] > GetPosition(inPositions, inVertexStride, max_points[k])[k])
+					max_points[k] = inIndices[i];
+			}
+		}
+
+		int32 best_axis = 0;
+		float best_distance = -1.0f;
+		for (int32 k = 0; k < 3; k++)
+		{
+			const Vec3 min_point = LoadPosition(inPositions, inVertexStride, min_points[k]);
+			const Vec3 max_point = LoadPosition(inPositions, inVertexStride, max_points[k]);
+
+			const float distance = (max_point - min_point).LengthSquared();
+			if (distance > best_distance)
+			{
+				best_distance	= distance;
+				best_axis		= k;
+			}
+		}
+
+		Vec3 center		= (LoadPosition(inPositions, inVertexStride, min_points[best_axis]) + LoadPosition(inPositions, inVertexStride, max_points[best_axis])) * 0.5f;
+		float radius	= Math::Sqrt(best_distance) * 0.5f;
+
+		// Grow the sphere to include points outside of it
+		for (size_t i = 0; i < inNumIndices; i++)
+		{
+			const Vec3 point = LoadPosition(inPositions, inVertexStride, inIndices[i]);
+
+			const float distance = (point - center).Length();
+			if (distance > radius)
+			{
+				const float new_radius = (radius + distance) * 0.5f;
+				center += (point - center) * ((new_radius - radius) / distance);
+				radius = new_radius;
+			}
+		}
+
+		// Ritter's sphere can end up larger than the one centered on the AABB. Keep the tightest
+		const Vec3 aabb_center	= inAABB.GetCenter();
+		float aabb_radius		= 0.0f;
+		for (size_t i = 0; i < inNumIndices; i++)
+			aabb_radius = Math::Max(aabb_radius, (LoadPosition(inPositions, inVertexStride, inIndices[i]) - aabb_center).LengthSquared());
+		aabb_radius = Math::Sqrt(aabb_radius);
+
+		sphere.m_Center = (aabb_radius < radius) ? aabb_center : center;
+		sphere.m_Radius = (aabb_radius < radius) ? aabb_radius : radius;
+
+		return sphere;
+	}
+
+	void Transform(const AABB* inAABBs, size_t inCount, const Mat4x4& inMatrix, AABB* outAABBs)
+	{
+#if defined(BOUNDING_VOLUMES_SSE2)
+		// Arvo's method: transform the center, extents go through the absolute value of the rotation
+		const __m128 sign_mask		= _mm_set1_ps(-0.0f);
+		const __m128 columns[3]		= { LoadColumn(inMatrix, 0), LoadColumn(inMatrix, 1), LoadColumn(inMatrix, 2) };
+		const __m128 abs_columns[3]	= { _mm_andnot_ps(sign_mask, columns[0]), _mm_andnot_ps(sign_mask, columns[1]), _mm_andnot_ps(sign_mask, columns[2]) };
+		const __m128 translation	= LoadColumn(inMatrix, 3);
+		const __m128 half			= _mm_set1_ps(0.5f);
+
+		for (size_t i = 0; i < inCount; i++)
+		{
+			if (inAABBs[i].IsEmpty())
+			{
+				outAABBs[i] = inAABBs[i];
+				continue;
+			}
+
+			const __m128 min_point	= LoadVec3(inAABBs[i].m_Min);
+			const __m128 max_point	= LoadVec3(inAABBs[i].m_Max);
+			const __m128 center		= _mm_mul_ps(_mm_add_ps(min_point, max_point), half);
+			const __m128 extents	= _mm_mul_ps(_mm_sub_ps(max_point, min_point), half);
+
+			const __m128 new_center		= _mm_add_ps(Rotate(columns, center), translation);
+			const __m128 new_extents	= Rotate(abs_columns, extents);
+
+			outAABBs[i].m_Min = StoreVec3(_mm_sub_ps(new_center, new_extents));
+			outAABBs[i].m_Max = StoreVec3(_mm_add_ps(new_center, new_extents));
+		}
+#else
+		for (size_t i = 0; i < inCount; i++)
+		{
+			if (inAABBs[i].IsEmpty())
+			{
+				outAABBs[i] = inAABBs[i];
+				continue;
+			}
+
+			const Vec3 center	= inAABBs[i].GetCenter();
+			const Vec3 extents	= inAABBs[i].GetHalfExtents();
+
+			Vec3 new_center, new_extents;
+			for (int32 r = 0; r < 3; r++)
+			{
+				new_center[r]	= inMatrix(r, 3);
+				new_extents[r]	= 0.0f;
+				for (int32 c = 0; c < 3; c++)
+				{
+					new_center[r]	+= inMatrix(r, c) * center[c];
+					new_extents[r]	+= Math::Abs(inMatrix(r, c)) * extents[c];
+				}
+			}
+
+			outAABBs[i].m_Min = new_center - new_extents;
+			outAABBs[i].m_Max = new_center + new_extents;
+		}
+#endif
+	}
+
+	void Transform(const BoundingSphere* inSpheres, size_t inCount, const Mat4x4& inMatrix, BoundingSphere* outSpheres)
+	{
+		// Non uniform scales stretch the sphere, use the largest one
+		float max_scale = 0.0f;
+		for (int32 c = 0; c < 3; c++)
+		{
+			const Vec3 column(inMatrix(0, c), inMatrix(1, c), inMatrix(2, c));
+			max_scale = Math::Max(max_scale, column.LengthSquared());
+		}
+		max_scale = Math::Sqrt(max_scale);
+
+#if defined(BOUNDING_VOLUMES_SSE2)
+		const __m128 columns[3]		= { LoadColumn(inMatrix, 0), LoadColumn(inMatrix, 1), LoadColumn(inMatrix, 2) };
+		const __m128 translation	= LoadColumn(inMatrix, 3);
+#endif
+
+		for (size_t i = 0; i < inCount; i++)
+		{
+			if (inSpheres[i].IsEmpty())
+			{
+				outSpheres[i] = inSpheres[i];
+				continue;
+			}
+
+#if defined(BOUNDING_VOLUMES_SSE2)
+			outSpheres[i].m_Center = StoreVec3(_mm_add_ps(Rotate(columns, LoadVec3(inSpheres[i].m_Center)), translation));
+#else
+			const Vec3 center = inSpheres[i].m_Center;
+			Vec3 new_center;
+			for (int32 r = 0; r < 3; r++)
+				new_center[r] = inMatrix(r, 0) * center.x + inMatrix(r, 1) * center.y + inMatrix(r, 2) * center.z + inMatrix(r, 3);
+			outSpheres[i].m_Center = new_center;
+#endif
+			outSpheres[i].m_Radius = inSpheres[i].m_Radius * max_scale;
+		}
+	}
+}
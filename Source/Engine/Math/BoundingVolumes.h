@@ -0,0 +1,41 @@
+#pragma once
+
+#include <limits>
+
+// Axis aligned bounding box. Default constructed boxes are empty and grow with Merge
+struct AABB
+{
+	Vec3	m_Min	= Vec3(std::numeric_limits<float>::max());
+	Vec3	m_Max	= Vec3(-std::numeric_limits<float>::max());
+
+	inline bool	IsEmpty() const			{ return m_Min.x > m_Max.x || m_Min.y > m_Max.y || m_Min.z > m_Max.z; }
+	inline Vec3	GetCenter() const		{ return (m_Min + m_Max) * 0.5f; }
+	inline Vec3	GetHalfExtents() const	{ return (m_Max - m_Min) * 0.5f; }
+
+	void		Merge(const AABB& inOther);
+	bool		Contains(const Vec3& inPoint, float inEpsilon = 0.0f) const;
+};
+
+struct BoundingSphere
+{
+	Vec3	m_Center	= Vec3(0.0f);
+	float	m_Radius	= -1.0f;		// Negative when empty
+
+	inline bool	IsEmpty() const			{ return m_Radius < 0.0f; }
+
+	bool		Contains(const Vec3& inPoint, float inEpsilon = 0.0f) const;
+};
+
+// Bounds of vertices referenced by an index list. Positions are 3 floats at the start of each vertex
+namespace BoundingVolumes
+{
+	AABB			ComputeAABB(const uint32* inIndices, size_t inNumIndices, const float* inPositions, size_t inVertexStride);
+	// Ritter's sphere or the sphere centered on inAABB, whichever is the tightest. inAABB must bound the same vertices
+	BoundingSphere	ComputeSphere(const uint32* inIndices, size_t inNumIndices, const float* inPositions, size_t inVertexStride,
+								  const AABB& inAABB);
+
+	// Object to world space. inMatrix must be affine. outAABBs and outSpheres may alias the inputs.
+	// Transformed boxes enclose the transformed box, they are not the bounds of the transformed vertices
+	void			Transform(const AABB* inAABBs, size_t inCount, const Mat4x4& inMatrix, AABB* outAABBs);
+	void			Transform(const BoundingSphere* inSpheres, size_t inCount, const Mat4x4& inMatrix, BoundingSphere* outSpheres);
+}
@@ -1,6 +1,6 @@
 #pragma once
 
-#include <Math.h>
+#include <math.h>
 #include <cmath>
 
 #include <mathfu/quaternion.h>
@@ -124,4 +124,11 @@ namespace Math
 	{
 		return (::ceil(::log2(n)) == ::floor(::log2(n)));
 	}
+
+	// Round x up to the next multiple of alignment. alignment doesn't need to be a power of two
+	template<typename T>
+	inline T AlignUp(T x, T alignment)
+	{
+		return ((x + alignment - 1) / alignment) * alignment;
+	}
 }
@@ -12,3 +12,20 @@ struct VertexPosUVNormal
 	float2 UV		: TEXCOORD;
 	float3 Normal	: NORMAL;
 };
+
+// Compressed variants of VertexPosUVNormal. Encoded by Gfx/VertexCompression.h
+// UV is a half float, Normal is octahedral encoded
+struct VertexPosUVNormalPacked
+{
+	float3		Position	: POSITION;
+	half2		UV			: TEXCOORD;
+	snorm half2	Normal		: NORMAL;
+};
+
+// Position is relative to the bounding box of the mesh, remapped to [-1, 1]. W is unused
+struct VertexPosUVNormalQuantized
+{
+	snorm half4	Position	: POSITION;
+	half2		UV			: TEXCOORD;
+	snorm half2	Normal		: NORMAL;
+};
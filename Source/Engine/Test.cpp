@@ -9,6 +9,7 @@
 
 #include "Math/Math.h"
 
+#include "DX12/DX12CommandList.h"
 #include "DX12/DX12CommandQueue.h"
 #include "DX12/DX12Device.h"
 #include "DX12/DX12DescriptorHeap.h"
@@ -17,33 +18,53 @@
 #include "DX12/DX12SwapChain.h"
 #include "DX12/DX12Texture.h"
 
+#include "Gfx/AssetManager.h"
 #include "Gfx/DrawableObject.h"
+#include "Gfx/DrawQueue.h"
 #include "Gfx/DrawUtils.h"
 #include "Gfx/GBuffer.h"
+#include "Gfx/GeometryPool.h"
 #include "Gfx/Mesh.h"
-#include "Gfx/MeshLoader.h"
+#include "Gfx/MeshAsset.h"
 #include "Gfx/ShaderObject.h"
+#include "Gfx/StateCacheCommandList.h"
+#include "Gfx/TextureAsset.h"
 #include "Gfx/TextureLoader.h"
 
+#include "Utils/AssetCache.h"
+#include "Utils/AsyncIO.h"
+#include "Utils/JobSystem.h"
 #include "Utils/Mouse.h"
+#include "Utils/PackFile.h"
 
 #include "Shaders/Include/ConstantBuffers.h"
 #include "Shaders/Include/Shaders.h"
 
-// Constant Buffer for the vertex shader
-DX12ConstantBuffer* m_ConstantBuffer = nullptr;
+// Constant buffers of the frames in flight, the vertex shader constants get a new range every frame
+DX12UploadRing* m_UploadRing = nullptr;
 
 GBuffer* m_GBuffer = nullptr;
 
-DX12Texture* m_DummyTexture = nullptr;
-
 std::map<std::string, ShaderObject*> m_AllShaderObjects;
-RenderBuckets m_RenderBuckets;
+
+// Streamed in by the AssetManager, drawn once they are ready
+AssetHandle<TextureAsset>			m_DummyTexture;
+std::vector<AssetHandle<MeshAsset>>	m_Meshes;
+
+// Draws of the current frame, rebuilt every frame
+DrawQueue m_DrawQueue;
+
+// State calls of the last frame that went to the GPU or were dropped as redundant
+StateCacheStatistics m_FrameStateStatistics;
+
+// Last frame that recorded geometry uploads. The upload buffers of the pool are released once it's done, 0 when they are
+uint64 m_GeometryUploadFenceValue = 0;
 
 float	m_FOV;
 Mat4x4	m_ModelMatrix;
 Mat4x4	m_ViewMatrix;
 Mat4x4	m_ProjectionMatrix;
+Vec3	m_EyePosition;
 
 Vec3	m_SavedPosition;
 
@@ -70,9 +91,21 @@ bool LoadContent(uint32 inWidth, uint32 inHeight)
 		m_SavedPosition		= eye_position.Normalized() * eye_distance;
 	}
 
-	MeshLoader::Init();
 	TextureLoader::Init();
 
+	// Shipped data is packed with the AssetPacker tool. Loose files are used when there is no pack
+	PackFile::Mount("Data.apak");
+	g_JobSystem.Init();
+	// Reads the files of assets such as textures, their decoding then runs on jobs
+	g_AsyncIO.Init();
+	// Baked meshes and textures. Only rebuilt when their sources, importer or settings change
+	g_AssetCache.Init("Output\\AssetCache");
+
+	// Loaded by jobs while the first frames render, uploaded by OnRender
+	m_Meshes.push_back(g_AssetManager.Load<MeshAsset>("Data\\Cornell_fake_box.obj"));
+	m_Meshes.push_back(g_AssetManager.Load<MeshAsset>("Data\\LightBulb.obj"));
+	m_DummyTexture = g_AssetManager.Load<TextureAsset>("Data\\render_1024.png");
+
 	auto& command_queue	= g_RenderingDevice.GetCommandQueue(D3D12_COMMAND_LIST_TYPE_DIRECT); // Don't use COPY for this.
 	auto& command_list	= command_queue.GetCommandList();
 
@@ -89,26 +122,8 @@ bool LoadContent(uint32 inWidth, uint32 inHeight)
 
 	DrawUtils::Init(command_list);
 
-	// Create drawable objects
-	{
-		MeshLoader mesh_loader;
-		mesh_loader.LoadFromFile("Data\\Cornell_fake_box.obj");
-		mesh_loader.Finalize(command_list, m_AllShaderObjects, m_RenderBuckets);
-	}
-	{
-		MeshLoader mesh_loader;
-		mesh_loader.LoadFromFile("Data\\LightBulb.obj");
-		mesh_loader.Finalize(command_list, m_AllShaderObjects, m_RenderBuckets);
-	}
-
-	// Load texture
-	TextureLoader texture_loader;
-	texture_loader.LoadFromFile("Data\\render_1024.png");
-	m_DummyTexture = texture_loader.CreateTexture(command_list);
-
-	// Create Constant Buffer View
-	m_ConstantBuffer = new DX12ConstantBuffer();
-	m_ConstantBuffer->InitAsConstantBuffer(sizeof(ConstantBuffers::DefaultConstantBuffer));
+	m_UploadRing = new DX12UploadRing();
+	m_UploadRing->InitAsUploadRing(1024 * 1024);
 
 	auto fence_value = command_queue.ExecuteCommandList(command_list);
 	command_queue.WaitForFenceValue(fence_value);
@@ -123,15 +138,11 @@ void UnloadContent()
 	// Make sure the command queue has finished all commands before closing.
 	g_RenderingDevice.Flush();
 
-	// Delete all drawable objects
-	for (RenderBucket& bucket : m_RenderBuckets)
-	{
-		for (DrawableObject* d : bucket)
-		{
-			delete d;
-		}
-		bucket.clear();
-	}
+	// Delete all assets, with their drawable objects and textures
+	m_DrawQueue.Reset();
+	m_Meshes.clear();
+	m_DummyTexture.Reset();
+	g_AssetManager.Shutdown();
 
 	// Delete all materials
 	for (auto pair : m_AllShaderObjects)
@@ -141,14 +152,18 @@ void UnloadContent()
 
 	DrawUtils::Destroy();
 
-	m_ConstantBuffer->Release();
-	delete m_ConstantBuffer;
+	// After every Mesh has been released
+	g_GeometryPool.Release();
+
+	m_UploadRing->Release();
+	delete m_UploadRing;
 
 	m_GBuffer->ReleaseResources();
 	delete m_GBuffer;
 
-	m_DummyTexture->Release();
-	delete m_DummyTexture;
+	g_AsyncIO.Shutdown();
+	g_JobSystem.Shutdown();
+	PackFile::UnmountAll();
 
 	m_ContentLoaded = false;
 }
@@ -208,6 +223,7 @@ void OnUpdate(uint32 inWidth, uint32 inHeight, float inDeltaT)
 
 	// Update the view matrix.
 	m_ViewMatrix = Mat4x4::LookAt(focus_point, eye_position, up_direction);
+	m_EyePosition = eye_position;
 
 	// Release middle click means we need to save the new position
 	if (mouse.WasJustReleased(MouseButton::Middle))
@@ -224,58 +240,55 @@ void OnUpdate(uint32 inWidth, uint32 inHeight, float inDeltaT)
 	m_ProjectionMatrix = Mat4x4::Perspective(Math::ToRadians(m_FOV), aspect_ratio, 0.1f, 100.0f, handedness);
 }
 
-void SetupBindings(ID3D12GraphicsCommandList2& inCommandList)
-{
-	// TODO: This is whack
-	auto& descriptor_heap = g_RenderingDevice.GetCommandQueue(D3D12_COMMAND_LIST_TYPE_DIRECT).GetDescriptorHeap();
-	uint32 descriptor_index = descriptor_heap.Allocate();
-	g_RenderingDevice.GetD3DDevice().CopyDescriptorsSimple(1, descriptor_heap.GetCPUHandle(descriptor_index), m_DummyTexture->GetCPUHandle(), D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
-
-	// Set slot 0 of our root signature to point to our descriptor heap with the texture SRV
-	inCommandList.SetGraphicsRootDescriptorTable(0, descriptor_heap.GetGPUHandle(descriptor_index));
-}
-
-void RenderGeometry(ID3D12GraphicsCommandList2& inCommandList)
+D3D12_GPU_VIRTUAL_ADDRESS UploadConstantBuffer()
 {
 	ConstantBuffers::DefaultConstantBuffer constant_buffer;
 	// We absolutely need to transpose from Row Major (mathfu) to Colum Major (HLSL)
 	constant_buffer.MVP = (m_ProjectionMatrix*m_ViewMatrix*m_ModelMatrix).Transpose();
 
-	for (DrawableObject* d : m_RenderBuckets[(int) RenderPass::OpaqueGeometry])
-	{
-		d->SetupBindings(inCommandList);
+	// Every upload gets its own range, frames still on the GPU keep reading theirs
+	return m_UploadRing->Upload(constant_buffer);
+}
 
-		SetupBindings(inCommandList);
+// Every draw of the frame, sorted by state for opaque draws and back to front for transparent ones
+void BuildDrawQueue()
+{
+	m_DrawQueue.Reset();
 
-		// Upload Constant Buffer to GPU
-		m_ConstantBuffer->UpdateBufferResource(inCommandList, sizeof(ConstantBuffers::DefaultConstantBuffer), &constant_buffer);
-		m_ConstantBuffer->SetConstantBuffer(inCommandList, 1);
+	for (const AssetHandle<MeshAsset>& mesh : m_Meshes)
+	{
+		if (!mesh.IsReady())
+			continue;
 
-		d->Render(inCommandList);
+		for (const DrawableObject* d : mesh->GetDrawableObjects())
+		{
+			const Vec3 center = m_ModelMatrix * d->GetBoundingSphere().m_Center;
+			m_DrawQueue.Add(*d, (center - m_EyePosition).Length());
+		}
 	}
+
+	m_DrawQueue.Sort();
 }
 
-void RenderTransparent(ID3D12GraphicsCommandList2& inCommandList)
+void RenderDrawQueue(CommandList& inCommandList)
 {
-	// TODO: Just figured out that updating constant buffers this way does not work. Only the last map/unmap is taken into account for the whole pass...
-	//ConstantBuffers::DefaultConstantBuffer constant_buffer;
-	//constant_buffer.MVP = (m_ProjectionMatrix*m_ViewMatrix*m_ModelMatrix).Transpose();
-
-	for (DrawableObject* d : m_RenderBuckets[(int) RenderPass::Transparent])
-	{
-		d->SetupBindings(inCommandList);
+	// Every draw uses the same texture, it's copied to the frame's descriptors once
+	const D3D12_GPU_DESCRIPTOR_HANDLE texture_table = inCommandList.CopyDescriptor(m_DummyTexture->GetTexture()->GetCPUHandle());
 
-		SetupBindings(inCommandList);
+	// All objects share the model matrix, one upload serves every draw. Per draw data would be uploaded in the lambda
+	const D3D12_GPU_VIRTUAL_ADDRESS constant_buffer = UploadConstantBuffer();
 
-		// Upload Constant Buffer to GPU
-		//m_ConstantBuffer->UpdateBufferResource(inCommandList, sizeof(ConstantBuffers::DefaultConstantBuffer), &constant_buffer);
-		//m_ConstantBuffer->SetConstantBuffer(inCommandList, 1);
+	// Everything is bound for every draw, the state cache drops what's already bound
+	m_DrawQueue.Submit(inCommandList, [texture_table, constant_buffer](CommandList& ioCommandList, const DrawPacket&)
+	{
+		// Set slot 0 of our root signature to point to our descriptor heap with the texture SRV
+		ioCommandList.SetGraphicsRootDescriptorTable(0, texture_table);
 
-		d->Render(inCommandList);
-	}
+		ioCommandList.SetGraphicsRootConstantBufferView(1, constant_buffer);
+	});
 }
 
-void CopyToBackBuffer(ID3D12GraphicsCommandList2& inCommandList)
+void CopyToBackBuffer(CommandList& inCommandList)
 {
 	auto& swap_chain = g_RenderingDevice.GetSwapChain();
 
@@ -292,21 +305,59 @@ void OnRender()
 	auto& command_queue		= g_RenderingDevice.GetCommandQueue(D3D12_COMMAND_LIST_TYPE_DIRECT);
 	auto& command_list		= command_queue.GetCommandList();
 
+	// Ranges of the upload ring used by frames the GPU is done with
+	m_UploadRing->Reclaim(command_queue.GetCompletedFenceValue());
+
+	// Geometry uploaded by earlier frames is in the pool once they are done, before this frame records more
+	if (m_GeometryUploadFenceValue != 0 && command_queue.IsFenceComplete(m_GeometryUploadFenceValue))
+	{
+		g_GeometryPool.ReleaseUploadBuffers();
+		g_GeometryPool.TraceStatistics();
+		g_AssetManager.TraceStatistics();
+		g_JobSystem.TraceStatistics();
+		m_UploadRing->TraceStatistics();
+		Trace("Last frame: %llu state calls issued, %llu elided", m_FrameStateStatistics.m_NumIssued, m_FrameStateStatistics.m_NumElided);
+		m_GeometryUploadFenceValue = 0;
+	}
+
+	AssetUploadContext upload_context;
+	upload_context.m_CommandList	= &command_list;
+	upload_context.m_ShaderObjects	= &m_AllShaderObjects;
+	const uint32 num_uploaded_assets = g_AssetManager.Update(upload_context);
+
+	// The frame itself goes through the CommandList interface, uploads above use the D3D12 command list.
+	// New command list, nothing is bound yet: the state cache starts empty
+	DX12CommandList d3d_commands(command_list, command_queue.GetDescriptorHeap());
+	StateCacheCommandList frame_commands(d3d_commands);
+
 	// Set the descriptor heap containing all textures
 	ID3D12DescriptorHeap* heaps[] = { &command_queue.GetDescriptorHeap().GetD3DDescriptorHeap() };
-	command_list.SetDescriptorHeaps(1, heaps);
+	frame_commands.SetDescriptorHeaps(1, heaps);
 
 	// Clear the GBuffer targets.
-	m_GBuffer->ClearDepthBuffer(command_list);
-	m_GBuffer->ClearRenderTargets(command_list);
+	m_GBuffer->ClearDepthBuffer(frame_commands);
+	m_GBuffer->ClearRenderTargets(frame_commands);
 
-	m_GBuffer->Set(command_list);
+	m_GBuffer->Set(frame_commands);
 
-	RenderGeometry(command_list);
-	RenderTransparent(command_list);
+	// Everything uses the texture, nothing is drawn until it's ready
+	if (m_DummyTexture.IsReady())
+	{
+		BuildDrawQueue();
+		RenderDrawQueue(frame_commands);
+	}
+
+	CopyToBackBuffer(frame_commands);
 
-	CopyToBackBuffer(command_list);
+	m_FrameStateStatistics = frame_commands.GetStatistics();
 
 	// Present
 	g_RenderingDevice.Present(command_list);
+
+	// Signaled after the frame, once it's complete its uploads are in the pool and its constants can be overwritten
+	const uint64 frame_fence_value = command_queue.Signal();
+	m_UploadRing->EndFrame(frame_fence_value);
+
+	if (num_uploaded_assets > 0)
+		m_GeometryUploadFenceValue = frame_fence_value;
 }
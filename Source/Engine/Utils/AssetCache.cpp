@@ -0,0 +1,106 @@
+#include "Engine.h"
+#include "AssetCache.h"
+
+#include "Utils/FileReader.h"
+#include "Utils/Hash.h"
+
+#include <atomic>
+#include <cstdio>
+#include <filesystem>
+#include <random>
+#include <thread>
+
+AssetCache g_AssetCache;
+
+AssetCacheKey::AssetCacheKey(std::string_view inImporter, uint32 inVersion)
+{
+	AddString(inImporter);
+	AddValue(inVersion);
+}
+
+void AssetCacheKey::AddData(const void* inData, uint64 inSize)
+{
+	// Chaining through the seed makes the order of the inputs matter
+	m_Hash = Hash::Hash64(inData, inSize, m_Hash);
+}
+
+void AssetCacheKey::AddString(std::string_view inString)
+{
+	// The size separates consecutive strings, "ab" + "c" isn't "a" + "bc"
+	AddValue(static_cast<uint64>(inString.size()));
+	AddData(inString.data(), inString.size());
+}
+
+bool AssetCacheKey::AddFile(const std::string& inFile)
+{
+	FileReader file_reader;
+	if (!file_reader.ReadFile(inFile, FileReadMode::Map))
+		return false;
+
+	AddValue(file_reader.GetContentSize());
+	AddData(file_reader.GetContentAsBinary(), file_reader.GetContentSize());
+	return true;
+}
+
+void AssetCache::Init(const std::string& inDirectory)
+{
+	std::error_code error_code;
+	std::filesystem::create_directories(inDirectory, error_code);
+	Assert(!error_code, "Can't create the asset cache directory");
+
+	m_Directory = inDirectory;
+}
+
+std::string AssetCache::GetPath(const AssetCacheKey& inKey, std::string_view inExtension) const
+{
+	Assert(IsInitialized());
+
+	char name[17];
+	snprintf(name, sizeof(name), "%016llx", static_cast<unsigned long long>(inKey.GetHash()));
+
+	return (std::filesystem::path(m_Directory) / name).string().append(inExtension);
+}
+
+bool AssetCache::Contains(const AssetCacheKey& inKey, std::string_view inExtension) const
+{
+	std::error_code error_code;
+	return std::filesystem::exists(GetPath(inKey, inExtension), error_code);
+}
+
+bool AssetCache::Store(const AssetCacheKey& inKey, std::string_view inExtension,
+					   const std::function<bool(const std::string&)>& inWriteFile)
+{
+	const std::string path = GetPath(inKey, inExtension);
+
+	// Unique between threads of this process, and between processes thanks to the random part
+	static const uint64 process_id = (static_cast<uint64>(std::random_device()()) << 32) | std::random_device()();
+	static std::atomic<uint64> temp_file_counter = 0;
+
+	char suffix[64];
+	snprintf(suffix, sizeof(suffix), ".%016llx.%llu.tmp", static_cast<unsigned long long>(process_id),
+			 static_cast<unsigned long long>(temp_file_counter++));
+	const std::string temp_path = path + suffix;
+
+	std::error_code error_code;
+	if (!inWriteFile(temp_path))
+	{
+		std::filesystem::remove(temp_path, error_code);
+		return false;
+	}
+
+	// Replacing the file is atomic, readers see either the old or the new file, never a partial one
+	std::filesystem::rename(temp_path, path, error_code);
+	if (error_code)
+	{
+		std::filesystem::remove(temp_path, error_code);
+
+		// Windows can't replace a file that is open. Another baker got there first with the same content
+		if (!std::filesystem::exists(path, error_code))
+		{
+			Trace("AssetCache: Failed to store %s", path.c_str());
+			return false;
+		}
+	}
+
+	return true;
+}
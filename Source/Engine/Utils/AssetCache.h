@@ -0,0 +1,58 @@
+#pragma once
+
+#include <functional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+// Identifies a baked asset by hashing everything the bake depends on:
+// the importer and its version, the import settings and the content of every source file
+class AssetCacheKey final
+{
+public:
+	// Bump inVersion whenever the importer produces a different output for the same input
+	AssetCacheKey(std::string_view inImporter, uint32 inVersion);
+
+	void	AddData(const void* inData, uint64 inSize);
+	void	AddString(std::string_view inString);
+	// Content of the file, its name and date don't matter. Returns false if it can't be read
+	bool	AddFile(const std::string& inFile);
+
+	// Add settings one member at a time, the padding of a struct isn't deterministic
+	template <typename T>
+	void	AddValue(const T& inValue)
+	{
+		static_assert(std::is_arithmetic_v<T> || std::is_enum_v<T>, "Only scalars can be hashed as is");
+		AddData(&inValue, sizeof(T));
+	}
+
+	inline uint64	GetHash() const		{ return m_Hash; }
+
+private:
+	uint64	m_Hash	= 0;
+};
+
+// Baked assets stored by AssetCacheKey. An asset is only baked again when its sources, importer or settings change.
+// Entries are written to a temporary file then renamed, they are never modified once in place.
+// Any number of threads or processes can bake into the same cache
+class AssetCache final
+{
+public:
+	void			Init(const std::string& inDirectory);
+
+	// Where the baked file of inKey is, whether it was baked or not
+	std::string		GetPath(const AssetCacheKey& inKey, std::string_view inExtension) const;
+	bool			Contains(const AssetCacheKey& inKey, std::string_view inExtension) const;
+
+	// inWriteFile writes the baked asset to the path it receives and returns false on failure.
+	// When another baker stores the same key first, its file is kept
+	bool			Store(const AssetCacheKey& inKey, std::string_view inExtension,
+						  const std::function<bool(const std::string&)>& inWriteFile);
+
+	inline bool		IsInitialized() const	{ return !m_Directory.empty(); }
+
+private:
+	std::string		m_Directory;
+};
+
+extern AssetCache g_AssetCache;
@@ -0,0 +1,655 @@
+#include "Engine.h"
+#include "AsyncIO.h"
+
+#include "Utils/PackFile.h"
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+#define ASYNC_IO_URING
+#include <cstring>
+#include <linux/io_uring.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#endif
+
+AsyncIO g_AsyncIO;
+
+namespace
+{
+	// Bigger reads are split. ReadFile takes 32 bit sizes, and Linux stops a single read just under 2GB anyway
+	constexpr uint64 MaxReadSize = 1ull << 30;
+
+#if defined(_WIN32)
+	using NativeFile = HANDLE;
+	const NativeFile InvalidFile = INVALID_HANDLE_VALUE;
+
+	bool OpenNativeFile(const std::string& inFilename, NativeFile& outFile, uint64& outSize)
+	{
+		outFile = ::CreateFileA(inFilename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (outFile == InvalidFile)
+			return false;
+
+		LARGE_INTEGER file_size;
+		if (!::GetFileSizeEx(outFile, &file_size))
+			return false;
+
+		outSize = static_cast<uint64>(file_size.QuadPart);
+		return true;
+	}
+
+	void CloseNativeFile(NativeFile inFile)
+	{
+		::CloseHandle(inFile);
+	}
+
+	// Positioned read, the file pointer isn't used so threads can share a file. Returns the bytes read, 0 at the end of the file or -1
+	int64 ReadNativeFile(NativeFile inFile, void* outBuffer, uint64 inSize, uint64 inOffset)
+	{
+		OVERLAPPED overlapped	= {};
+		overlapped.Offset		= static_cast<DWORD>(inOffset);
+		overlapped.OffsetHigh	= static_cast<DWORD>(inOffset >> 32);
+
+		DWORD bytes_read = 0;
+		if (!::ReadFile(inFile, outBuffer, static_cast<DWORD>(Math::Min(inSize, MaxReadSize)), &bytes_read, &overlapped))
+			return (::GetLastError() == ERROR_HANDLE_EOF) ? 0 : -1;
+
+		return bytes_read;
+	}
+#else
+	using NativeFile = int;
+	constexpr NativeFile InvalidFile = -1;
+
+	bool OpenNativeFile(const std::string& inFilename, NativeFile& outFile, uint64& outSize)
+	{
+		outFile = ::open(inFilename.c_str(), O_RDONLY | O_CLOEXEC);
+		if (outFile == InvalidFile)
+			return false;
+
+		struct stat file_stat;
+		if (::fstat(outFile, &file_stat) != 0)
+			return false;
+
+		outSize = static_cast<uint64>(file_stat.st_size);
+		return true;
+	}
+
+	void CloseNativeFile(NativeFile inFile)
+	{
+		::close(inFile);
+	}
+
+	int64 ReadNativeFile(NativeFile inFile, void* outBuffer, uint64 inSize, uint64 inOffset)
+	{
+		ssize_t bytes_read;
+		do
+		{
+			bytes_read = ::pread(inFile, outBuffer, static_cast<size_t>(Math::Min(inSize, MaxReadSize)), static_cast<off_t>(inOffset));
+		} while (bytes_read < 0 && errno == EINTR);
+
+		return bytes_read;
+	}
+#endif
+}
+
+struct AsyncIO::PendingRead
+{
+	AsyncReadRequest				m_Request;
+	AsyncReadResult					m_Result;
+	std::promise<AsyncReadResult>	m_Promise;
+
+	NativeFile						m_File	= InvalidFile;
+	uint64							m_Size	= 0;		// Bytes to read, m_Result.m_Size is what has been read so far
+
+#if defined(ASYNC_IO_URING)
+	iovec							m_IOVec;
+#endif
+};
+
+#if defined(ASYNC_IO_URING)
+
+// Raw io_uring, liburing isn't needed for a single reader thread.
+// Only READV and POLL_ADD are used, they are both available since Linux 5.1
+struct AsyncIO::IOUring
+{
+	static constexpr uint64 WakeUpUserData = 0;
+
+	bool			Init(uint32 inNumEntries);
+	void			Release();
+
+	// The entry is zeroed. It is only seen by the kernel once committed
+	io_uring_sqe*	GetSQE();
+	void			CommitSQE();
+
+	// Submit the committed entries and wait for inMinCompletions
+	void			Enter(uint32 inMinCompletions);
+
+	void			WakeUp();
+
+	int				m_RingFD		= -1;
+	int				m_WakeUpFD		= -1;	// eventfd, signaled when requests are queued. Always polled by the ring
+
+	void*			m_SQRing		= nullptr;
+	void*			m_CQRing		= nullptr;
+	size_t			m_SQRingSize	= 0;
+	size_t			m_CQRingSize	= 0;
+	io_uring_sqe*	m_SQEs			= nullptr;
+	size_t			m_SQEsSize		= 0;
+
+	uint32*			m_SQHead		= nullptr;
+	uint32*			m_SQTail		= nullptr;
+	uint32*			m_SQArray		= nullptr;
+	uint32			m_SQMask		= 0;
+	uint32			m_SQEntries		= 0;
+	uint32			m_NumToSubmit	= 0;
+
+	uint32*			m_CQHead		= nullptr;
+	uint32*			m_CQTail		= nullptr;
+	io_uring_cqe*	m_CQEs			= nullptr;
+	uint32			m_CQMask		= 0;
+};
+
+bool AsyncIO::IOUring::Init(uint32 inNumEntries)
+{
+	io_uring_params params;
+	::memset(&params, 0, sizeof(params));
+
+	// Fails without io_uring support, or when it is disabled or filtered out
+	m_RingFD = static_cast<int>(::syscall(__NR_io_uring_setup, inNumEntries, &params));
+	if (m_RingFD < 0)
+		return false;
+
+	m_SQRingSize = params.sq_off.array + params.sq_entries * sizeof(uint32);
+	m_CQRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+
+	// Both rings can share the same mapping
+	const bool single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+	if (single_mmap)
+		m_SQRingSize = m_CQRingSize = Math::Max(m_SQRingSize, m_CQRingSize);
+
+	m_SQRing = ::mmap(nullptr, m_SQRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_RingFD, IORING_OFF_SQ_RING);
+	if (m_SQRing == MAP_FAILED)
+	{
+		m_SQRing = nullptr;
+		Release();
+		return false;
+	}
+
+	m_CQRing = single_mmap ? m_SQRing : ::mmap(nullptr, m_CQRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_RingFD, IORING_OFF_CQ_RING);
+	if (m_CQRing == MAP_FAILED)
+	{
+		m_CQRing = nullptr;
+		Release();
+		return false;
+	}
+
+	m_SQEsSize	= params.sq_entries * sizeof(io_uring_sqe);
+	void* sqes	= ::mmap(nullptr, m_SQEsSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_RingFD, IORING_OFF_SQES);
+	if (sqes == MAP_FAILED)
+	{
+		Release();
+		return false;
+	}
+	m_SQEs = static_cast<io_uring_sqe*>(sqes);
+
+	m_WakeUpFD = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+	if (m_WakeUpFD < 0)
+	{
+		Release();
+		return false;
+	}
+
+	Byte* sq_ring	= static_cast<Byte*>(m_SQRing);
+	m_SQHead		= reinterpret_cast<uint32*>(sq_ring + params.sq_off.head);
+	m_SQTail		= reinterpret_cast<uint32*>(sq_ring + params.sq_off.tail);
+	m_SQArray		= reinterpret_cast<uint32*>(sq_ring + params.sq_off.array);
+	m_SQMask		= *reinterpret_cast<uint32*>(sq_ring + params.sq_off.ring_mask);
+	m_SQEntries		= params.sq_entries;
+
+	Byte* cq_ring	= static_cast<Byte*>(m_CQRing);
+	m_CQHead		= reinterpret_cast<uint32*>(cq_ring + params.cq_off.head);
+	m_CQTail		= reinterpret_cast<uint32*>(cq_ring + params.cq_off.tail);
+	m_CQEs			= reinterpret_cast<io_uring_cqe*>(cq_ring + params.cq_off.cqes);
+	m_CQMask		= *reinterpret_cast<uint32*>(cq_ring + params.cq_off.ring_mask);
+
+	return true;
+}
+
+void AsyncIO::IOUring::Release()
+{
+	if (m_SQEs != nullptr)
+		::munmap(m_SQEs, m_SQEsSize);
+
+	if (m_CQRing != nullptr && m_CQRing != m_SQRing)
+		::munmap(m_CQRing, m_CQRingSize);
+
+	if (m_SQRing != nullptr)
+		::munmap(m_SQRing, m_SQRingSize);
+
+	if (m_WakeUpFD >= 0)
+		::close(m_WakeUpFD);
+
+	if (m_RingFD >= 0)
+		::close(m_RingFD);
+
+	*this = IOUring();
+}
+
+io_uring_sqe* AsyncIO::IOUring::GetSQE()
+{
+	// Only this thread writes the tail
+	const uint32 tail = *m_SQTail;
+	Assert(tail - __atomic_load_n(m_SQHead, __ATOMIC_ACQUIRE) < m_SQEntries, "Submission queue is full");
+
+	const uint32 index	= tail & m_SQMask;
+	io_uring_sqe* sqe	= &m_SQEs[index];
+	::memset(sqe, 0, sizeof(*sqe));
+	m_SQArray[index]	= index;
+
+	return sqe;
+}
+
+void AsyncIO::IOUring::CommitSQE()
+{
+	__atomic_store_n(m_SQTail, *m_SQTail + 1, __ATOMIC_RELEASE);
+	m_NumToSubmit++;
+}
+
+void AsyncIO::IOUring::Enter(uint32 inMinCompletions)
+{
+	while (true)
+	{
+		const int result = static_cast<int>(::syscall(__NR_io_uring_enter, m_RingFD, m_NumToSubmit, inMinCompletions, IORING_ENTER_GETEVENTS, nullptr, 0));
+		if (result >= 0)
+		{
+			m_NumToSubmit -= static_cast<uint32>(result);
+			return;
+		}
+
+		// Out of kernel resources: return, completions are reaped and the submission is retried
+		if (errno != EINTR)
+		{
+			Assert(errno == EAGAIN || errno == EBUSY, "io_uring_enter failed");
+			return;
+		}
+	}
+}
+
+void AsyncIO::IOUring::WakeUp()
+{
+	const uint64 value = 1;
+	const ssize_t written = ::write(m_WakeUpFD, &value, sizeof(value));
+	(void) written;
+}
+
+#else
+
+// Never created, only needed to destroy the unique_ptr
+struct AsyncIO::IOUring
+{
+};
+
+#endif
+
+AsyncIO::~AsyncIO()
+{
+	Shutdown();
+}
+
+void AsyncIO::Init(uint32 inNumThreads/* = 0*/)
+{
+	Assert(!IsInitialized());
+
+	m_Stop = false;
+
+#if defined(ASYNC_IO_URING)
+	// Reads beyond the queue depth wait in user space, unopened.
+	// Kept low on purpose: open() gets much slower in a multithreaded process once more than 64 files are open
+	constexpr uint32 queue_depth = 32;
+
+	m_IOUring = std::make_unique<IOUring>();
+	if (m_IOUring->Init(queue_depth))
+	{
+		m_Threads.emplace_back(&AsyncIO::IOUringLoop, this);
+		Trace("AsyncIO: io_uring, %u entries", m_IOUring->m_SQEntries);
+		return;
+	}
+
+	m_IOUring.reset();
+#endif
+
+	const uint32 num_threads = (inNumThreads != 0) ? inNumThreads : Math::Max(1u, std::thread::hardware_concurrency());
+	for (uint32 i = 0; i < num_threads; i++)
+		m_Threads.emplace_back(&AsyncIO::ThreadPoolLoop, this);
+
+	Trace("AsyncIO: thread pool, %u threads", num_threads);
+}
+
+void AsyncIO::Shutdown()
+{
+	if (!IsInitialized())
+		return;
+
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_Stop = true;
+	}
+
+	m_QueueCondition.notify_all();
+
+#if defined(ASYNC_IO_URING)
+	if (m_IOUring)
+		m_IOUring->WakeUp();
+#endif
+
+	for (std::thread& thread : m_Threads)
+		thread.join();
+	m_Threads.clear();
+
+#if defined(ASYNC_IO_URING)
+	if (m_IOUring)
+		m_IOUring->Release();
+#endif
+	m_IOUring.reset();
+}
+
+std::vector<std::future<AsyncReadResult>> AsyncIO::Submit(std::vector<AsyncReadRequest>&& inRequests)
+{
+	Assert(IsInitialized(), "AsyncIO::Init must be called before submitting reads");
+
+	std::vector<std::future<AsyncReadResult>> futures;
+	futures.reserve(inRequests.size());
+
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+
+		for (AsyncReadRequest& request : inRequests)
+		{
+			PendingRead* read	= new PendingRead;
+			read->m_Request		= std::move(request);
+			futures.push_back(read->m_Promise.get_future());
+			m_Queue.push_back(read);
+		}
+
+		m_NumPendingReads += inRequests.size();
+	}
+
+	m_QueueCondition.notify_all();
+
+#if defined(ASYNC_IO_URING)
+	if (m_IOUring)
+		m_IOUring->WakeUp();
+#endif
+
+	return futures;
+}
+
+std::future<AsyncReadResult> AsyncIO::Submit(AsyncReadRequest&& inRequest)
+{
+	std::vector<AsyncReadRequest> requests;
+	requests.push_back(std::move(inRequest));
+	return std::move(Submit(std::move(requests))[0]);
+}
+
+void AsyncIO::WaitIdle()
+{
+	std::unique_lock<std::mutex> lock(m_Mutex);
+	m_IdleCondition.wait(lock, [this]() { return m_NumPendingReads == 0; });
+}
+
+bool AsyncIO::BeginRead(PendingRead& ioRead)
+{
+	const AsyncReadRequest& request = ioRead.m_Request;
+
+	const PackFileFormat::Entry* entry	= nullptr;
+	const PackFile* pack_file			= PackFile::FindMounted(request.m_Filename, entry);
+
+	uint64 file_size	= 0;
+	bool is_open		= (pack_file != nullptr);
+	if (is_open)
+		file_size = entry->m_Size;
+	else
+		is_open = OpenNativeFile(request.m_Filename, ioRead.m_File, file_size);
+
+	if (!is_open || request.m_Offset > file_size)
+	{
+		CompleteRead(&ioRead, false);
+		return false;
+	}
+
+	if (request.m_Size == AsyncReadRequest::WholeFile)
+	{
+		// From the offset to the end of the file
+		ioRead.m_Size = file_size - request.m_Offset;
+
+		// Need to add 1 for \0
+		ioRead.m_Result.m_FileContent.reset(new Byte[ioRead.m_Size + 1]);
+		ioRead.m_Result.m_FileContent[ioRead.m_Size] = '\0';
+		ioRead.m_Result.m_Data = ioRead.m_Result.m_FileContent.get();
+	}
+	else
+	{
+		Assert(request.m_Buffer != nullptr || request.m_Size == 0, "Range reads need a buffer");
+
+		if (request.m_Offset + request.m_Size > file_size)
+		{
+			CompleteRead(&ioRead, false);
+			return false;
+		}
+
+		ioRead.m_Size			= request.m_Size;
+		ioRead.m_Result.m_Data	= request.m_Buffer;
+	}
+
+	if (ioRead.m_Size == 0)
+	{
+		CompleteRead(&ioRead, true);
+		return false;
+	}
+
+	// Packed files are decompressed from the mapped pack right away, there is nothing to wait for
+	if (pack_file != nullptr)
+	{
+		const bool success = pack_file->Read(*entry, request.m_Offset, ioRead.m_Size, ioRead.m_Result.m_Data);
+		ioRead.m_Result.m_Size = success ? ioRead.m_Size : 0;
+
+		CompleteRead(&ioRead, success);
+		return false;
+	}
+
+	return true;
+}
+
+void AsyncIO::CompleteRead(PendingRead* inRead, bool inSuccess)
+{
+	if (inRead->m_File != InvalidFile)
+		CloseNativeFile(inRead->m_File);
+
+	inRead->m_Result.m_Success = inSuccess;
+
+	if (inRead->m_Request.m_Callback)
+		inRead->m_Request.m_Callback(inRead->m_Result);
+
+	inRead->m_Promise.set_value(std::move(inRead->m_Result));
+	delete inRead;
+
+	bool is_idle = false;
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		is_idle = (--m_NumPendingReads == 0);
+	}
+
+	if (is_idle)
+		m_IdleCondition.notify_all();
+}
+
+void AsyncIO::ThreadPoolLoop()
+{
+	while (true)
+	{
+		PendingRead* read = nullptr;
+		{
+			std::unique_lock<std::mutex> lock(m_Mutex);
+			m_QueueCondition.wait(lock, [this]() { return m_Stop || !m_Queue.empty(); });
+
+			// Stopping, but only once the queue has been drained
+			if (m_Queue.empty())
+				return;
+
+			read = m_Queue.front();
+			m_Queue.pop_front();
+		}
+
+		if (!BeginRead(*read))
+			continue;
+
+		Byte* data		= static_cast<Byte*>(read->m_Result.m_Data);
+		uint64& offset	= read->m_Result.m_Size;
+
+		bool success = true;
+		while (success && offset < read->m_Size)
+		{
+			const int64 bytes_read = ReadNativeFile(read->m_File, data + offset, read->m_Size - offset, read->m_Request.m_Offset + offset);
+			if (bytes_read > 0)
+				offset += static_cast<uint64>(bytes_read);
+			else
+				success = false;
+		}
+
+		CompleteRead(read, success);
+	}
+}
+
+void AsyncIO::IOUringLoop()
+{
+#if defined(ASYNC_IO_URING)
+	IOUring& ring = *m_IOUring;
+
+	// One entry is kept for the wake up poll
+	const uint32 max_reads_in_flight = ring.m_SQEntries - 1;
+
+	// Files are only opened once there is room in the ring, so few are open at the same time
+	std::deque<PendingRead*> waiting_reads;
+	// Opened reads to submit again after a short read
+	std::deque<PendingRead*> ready_reads;
+
+	uint32	num_reads_in_flight	= 0;
+	bool	is_wake_up_polled	= false;
+
+	while (true)
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+
+			while (!m_Queue.empty())
+			{
+				waiting_reads.push_back(m_Queue.front());
+				m_Queue.pop_front();
+			}
+
+			if (m_Stop && waiting_reads.empty() && ready_reads.empty() && num_reads_in_flight == 0)
+				break;
+		}
+
+		if (!is_wake_up_polled)
+		{
+			io_uring_sqe* sqe	= ring.GetSQE();
+			sqe->opcode			= IORING_OP_POLL_ADD;
+			sqe->fd				= ring.m_WakeUpFD;
+			sqe->poll32_events	= POLLIN;
+			sqe->user_data		= IOUring::WakeUpUserData;
+			ring.CommitSQE();
+
+			is_wake_up_polled = true;
+		}
+
+		while (num_reads_in_flight < max_reads_in_flight && (!ready_reads.empty() || !waiting_reads.empty()))
+		{
+			PendingRead* read = nullptr;
+			if (!ready_reads.empty())
+			{
+				read = ready_reads.front();
+				ready_reads.pop_front();
+			}
+			else
+			{
+				read = waiting_reads.front();
+				waiting_reads.pop_front();
+
+				// Opening isn't asynchronous, it is cheap compared to reading
+				if (!BeginRead(*read))
+					continue;
+			}
+
+			const uint64 offset		= read->m_Result.m_Size;
+			read->m_IOVec.iov_base	= static_cast<Byte*>(read->m_Result.m_Data) + offset;
+			read->m_IOVec.iov_len	= static_cast<size_t>(Math::Min(read->m_Size - offset, MaxReadSize));
+
+			io_uring_sqe* sqe	= ring.GetSQE();
+			sqe->opcode			= IORING_OP_READV;
+			sqe->fd				= read->m_File;
+			sqe->addr			= reinterpret_cast<uint64>(&read->m_IOVec);
+			sqe->len			= 1;
+			sqe->off			= read->m_Request.m_Offset + offset;
+			sqe->user_data		= reinterpret_cast<uint64>(read);
+			ring.CommitSQE();
+
+			num_reads_in_flight++;
+		}
+
+		// Wait for at least one completion. New requests complete the wake up poll
+		ring.Enter(1);
+
+		uint32 head			= *ring.m_CQHead;
+		const uint32 tail	= __atomic_load_n(ring.m_CQTail, __ATOMIC_ACQUIRE);
+		for (; head != tail; head++)
+		{
+			const io_uring_cqe& cqe = ring.m_CQEs[head & ring.m_CQMask];
+
+			if (cqe.user_data == IOUring::WakeUpUserData)
+			{
+				// Reset the event, it is polled again on the next iteration
+				uint64 value;
+				const ssize_t bytes_read = ::read(ring.m_WakeUpFD, &value, sizeof(value));
+				(void) bytes_read;
+
+				is_wake_up_polled = false;
+				continue;
+			}
+
+			PendingRead* read = reinterpret_cast<PendingRead*>(cqe.user_data);
+			num_reads_in_flight--;
+
+			if (cqe.res > 0)
+			{
+				read->m_Result.m_Size += static_cast<uint64>(cqe.res);
+				if (read->m_Result.m_Size == read->m_Size)
+					CompleteRead(read, true);
+				else
+					ready_reads.push_front(read);		// Short read, continue where it stopped
+			}
+			else if (cqe.res == -EINTR || cqe.res == -EAGAIN)
+			{
+				ready_reads.push_front(read);
+			}
+			else
+			{
+				// Error, or the file got shorter since it was opened
+				CompleteRead(read, false);
+			}
+		}
+
+		__atomic_store_n(ring.m_CQHead, head, __ATOMIC_RELEASE);
+	}
+#endif
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct AsyncReadResult
+{
+	bool					m_Success	= false;
+	uint64					m_Size		= 0;		// Bytes read
+	void*					m_Data		= nullptr;	// Caller buffer, or m_FileContent for whole file reads
+	std::unique_ptr<Byte[]>	m_FileContent;			// Whole file reads only. Null terminated like FileReader
+};
+
+// Runs on an I/O thread, before the future is ready. Keep it short, it holds up other reads.
+// It may take m_FileContent, the future then gets a null buffer
+using AsyncReadCallback = std::function<void(AsyncReadResult&)>;
+
+struct AsyncReadRequest
+{
+	static constexpr uint64 WholeFile = ~0ull;
+
+	std::string			m_Filename;
+	uint64				m_Offset	= 0;
+	uint64				m_Size		= WholeFile;	// Reading past the end of the file fails
+	void*				m_Buffer	= nullptr;		// Caller owned, at least m_Size bytes. Unused for whole file reads
+	AsyncReadCallback	m_Callback;
+};
+
+// Reads files in the background. Requests are submitted in batches and complete in any order.
+// Linux uses io_uring. Other platforms, or kernels without io_uring, use a pool of threads doing positioned reads.
+// Files in mounted packs are decompressed from there instead
+class AsyncIO final
+{
+public:
+	AsyncIO() = default;
+	~AsyncIO();
+
+	AsyncIO(const AsyncIO&) = delete;
+	AsyncIO& operator=(const AsyncIO&) = delete;
+
+	// inNumThreads is the size of the thread pool, 0 for one per core. The io_uring backend only needs one thread
+	void			Init(uint32 inNumThreads = 0);
+	// Finishes the pending reads first
+	void			Shutdown();
+
+	// One future per request, in the same order
+	std::vector<std::future<AsyncReadResult>>	Submit(std::vector<AsyncReadRequest>&& inRequests);
+	std::future<AsyncReadResult>				Submit(AsyncReadRequest&& inRequest);
+
+	// Block until every submitted read has completed
+	void			WaitIdle();
+
+	inline bool		IsInitialized() const	{ return !m_Threads.empty(); }
+	inline bool		IsUsingIOUring() const	{ return m_IOUring != nullptr; }
+
+private:
+	struct PendingRead;
+	struct IOUring;
+
+	void			ThreadPoolLoop();
+	void			IOUringLoop();
+
+	// Open the file and allocate the whole file buffer. False when the read already completed (failed, empty or packed)
+	bool			BeginRead(PendingRead& ioRead);
+	void			CompleteRead(PendingRead* inRead, bool inSuccess);
+
+	std::mutex								m_Mutex;
+	std::condition_variable					m_QueueCondition;
+	std::condition_variable					m_IdleCondition;
+	std::deque<PendingRead*>				m_Queue;
+	uint64									m_NumPendingReads	= 0;		// Queued or in flight
+	bool									m_Stop				= false;
+
+	std::vector<std::thread>				m_Threads;
+	std::unique_ptr<IOUring>				m_IOUring;
+};
+
+extern AsyncIO g_AsyncIO;
@@ -0,0 +1,224 @@
+#include "Engine.h"
+#include "Compression.h"
+
+#include <cstring>
+#include <vector>
+
+namespace Compression
+{
+	// A sequence is a run of literals followed by a match copied from earlier output:
+	// token (4 bits literal length, 4 bits match length - MinMatch), extra literal length bytes, literals,
+	// 16 bits little endian offset, extra match length bytes. The last sequence only has literals
+	constexpr uint32 MinMatch			= 4;
+	constexpr uint32 MaxOffset			= 65535;
+	constexpr uint32 RunMask			= 15;
+	// The format requires the last 5 bytes to be literals and the last match to start 12 bytes before the end
+	constexpr uint32 LastLiterals		= 5;
+	constexpr uint32 MatchFindLimit		= 12;
+
+	constexpr uint32 HashLog			= 14;
+	// Skip faster through data that doesn't compress
+	constexpr uint32 SkipTrigger		= 6;
+
+	static inline uint32 Read32(const Byte* inData)
+	{
+		uint32 value;
+		::memcpy(&value, inData, sizeof(value));
+		return value;
+	}
+
+	static inline uint32 HashSequence(uint32 inSequence)
+	{
+		return (inSequence * 2654435761u) >> (32 - HashLog);
+	}
+
+	// Lengths past the 4 bits of the token continue in bytes of 255
+	static inline Byte* WriteLength(Byte* outData, uint64 inLength)
+	{
+		for (; inLength >= 255; inLength -= 255)
+			*outData++ = 255;
+		*outData++ = static_cast<Byte>(inLength);
+		return outData;
+	}
+
+	// Returns nullptr when the sequence doesn't fit
+	static Byte* WriteSequence(Byte* outData, const Byte* inDataEnd, const Byte* inLiterals, uint64 inNumLiterals, uint32 inOffset, uint64 inMatchLength)
+	{
+		const bool is_last = (inOffset == 0);
+
+		// Token, literals and their length, offset, then the match length
+		const uint64 worst_size = 1 + (inNumLiterals / 255 + 1) + inNumLiterals + (is_last ? 0 : 2 + inMatchLength / 255 + 1);
+		if (worst_size > static_cast<uint64>(inDataEnd - outData))
+			return nullptr;
+
+		const uint64 match_length = is_last ? 0 : inMatchLength - MinMatch;
+
+		Byte* token = outData++;
+		*token = static_cast<Byte>((Math::Min<uint64>(inNumLiterals, RunMask) << 4) | Math::Min<uint64>(match_length, RunMask));
+
+		if (inNumLiterals >= RunMask)
+			outData = WriteLength(outData, inNumLiterals - RunMask);
+
+		::memcpy(outData, inLiterals, static_cast<size_t>(inNumLiterals));
+		outData += inNumLiterals;
+
+		if (is_last)
+			return outData;
+
+		*outData++ = static_cast<Byte>(inOffset);
+		*outData++ = static_cast<Byte>(inOffset >> 8);
+
+		if (match_length >= RunMask)
+			outData = WriteLength(outData, match_length - RunMask);
+
+		return outData;
+	}
+
+	uint64 GetMaxCompressedSize(uint64 inSize)
+	{
+		return inSize + inSize / 255 + 16;
+	}
+
+	uint64 Compress(const void* inData, uint64 inSize, void* outData, uint64 inCapacity)
+	{
+		const Byte* source		= static_cast<const Byte*>(inData);
+		const Byte* source_end	= source + inSize;
+		const Byte* anchor		= source;		// Start of the pending literals
+
+		Byte* output			= static_cast<Byte*>(outData);
+		Byte* output_end		= output + inCapacity;
+
+		// Positions in the hash table are 32 bits
+		Assert(inSize <= 0xFFFFFFFFull, "Compress blocks smaller than 4GB");
+
+		if (inSize >= MatchFindLimit + 1)
+		{
+			// Last position of each hashed 4 bytes sequence, relative to source
+			std::vector<uint32> hash_table(1u << HashLog, 0);
+
+			const Byte* match_limit		= source_end - LastLiterals;
+			const Byte* find_limit		= source_end - MatchFindLimit;
+			const Byte* cursor			= source + 1;
+
+			while (cursor < find_limit)
+			{
+				const uint32 sequence	= Read32(cursor);
+				const uint32 hash		= HashSequence(sequence);
+				const Byte* candidate	= source + hash_table[hash];
+				hash_table[hash]		= static_cast<uint32>(cursor - source);
+
+				if (candidate >= cursor || cursor - candidate > MaxOffset || Read32(candidate) != sequence)
+				{
+					cursor += 1 + ((cursor - anchor) >> SkipTrigger);
+					continue;
+				}
+
+				// Grow the match backward over pending literals, then forward
+				while (cursor > anchor && candidate > source && cursor[-1] == candidate[-1])
+				{
+					cursor--;
+					candidate--;
+				}
+
+				uint64 match_length = MinMatch;
+				while (cursor + match_length < match_limit && cursor[match_length] == candidate[match_length])
+					match_length++;
+
+				output = WriteSequence(output, output_end, anchor, cursor - anchor, static_cast<uint32>(cursor - candidate), match_length);
+				if (output == nullptr)
+					return 0;
+
+				cursor += match_length;
+				anchor = cursor;
+
+				// Positions inside the match aren't hashed, only the one just before its end
+				if (cursor - 2 > source)
+					hash_table[HashSequence(Read32(cursor - 2))] = static_cast<uint32>(cursor - 2 - source);
+			}
+		}
+
+		output = WriteSequence(output, output_end, anchor, source_end - anchor, 0, 0);
+		if (output == nullptr)
+			return 0;
+
+		return output - static_cast<Byte*>(outData);
+	}
+
+	// Returns false when the length runs past the end of the input
+	static inline bool ReadLength(const Byte*& ioData, const Byte* inDataEnd, uint64& ioLength)
+	{
+		Byte value;
+		do
+		{
+			if (ioData >= inDataEnd)
+				return false;
+
+			value = *ioData++;
+			ioLength += value;
+		} while (value == 255);
+
+		return true;
+	}
+
+	bool Decompress(const void* inData, uint64 inSize, void* outData, uint64 inDecompressedSize)
+	{
+		const Byte* input		= static_cast<const Byte*>(inData);
+		const Byte* input_end	= input + inSize;
+
+		Byte* output_begin		= static_cast<Byte*>(outData);
+		Byte* output			= output_begin;
+		Byte* output_end		= output + inDecompressedSize;
+
+		while (input < input_end)
+		{
+			const Byte token = *input++;
+
+			uint64 num_literals = token >> 4;
+			if (num_literals == RunMask && !ReadLength(input, input_end, num_literals))
+				return false;
+
+			if (num_literals > static_cast<uint64>(input_end - input) || num_literals > static_cast<uint64>(output_end - output))
+				return false;
+
+			::memcpy(output, input, static_cast<size_t>(num_literals));
+			input	+= num_literals;
+			output	+= num_literals;
+
+			// The last sequence has no match
+			if (input == input_end)
+				break;
+
+			if (input_end - input < 2)
+				return false;
+
+			const uint32 offset = input[0] | (input[1] << 8);
+			input += 2;
+
+			if (offset == 0 || offset > static_cast<uint64>(output - output_begin))
+				return false;
+
+			uint64 match_length = token & RunMask;
+			if (match_length == RunMask && !ReadLength(input, input_end, match_length))
+				return false;
+			match_length += MinMatch;
+
+			if (match_length > static_cast<uint64>(output_end - output))
+				return false;
+
+			// Matches can overlap the bytes they produce, offset 1 repeats the last byte
+			const Byte* match = output - offset;
+			if (offset >= match_length)
+			{
+				::memcpy(output, match, static_cast<size_t>(match_length));
+				output += match_length;
+			}
+			else
+			{
+				for (uint64 i = 0; i < match_length; i++)
+					*output++ = *match++;
+			}
+		}
+
+		return output == output_end;
+	}
+}
@@ -0,0 +1,16 @@
+#pragma once
+
+// Fast LZ77 compression using the LZ4 block format, so blocks can be inspected with the reference lz4 tools.
+// Favors decompression speed over ratio. Blocks are independent, there is no frame or checksum
+namespace Compression
+{
+	// Worst case size of the compressed data, for incompressible input
+	uint64	GetMaxCompressedSize(uint64 inSize);
+
+	// Returns the compressed size, or 0 when it doesn't fit in inCapacity.
+	// Passing inSize - 1 as capacity only keeps blocks that actually got smaller
+	uint64	Compress(const void* inData, uint64 inSize, void* outData, uint64 inCapacity);
+
+	// inDecompressedSize must be exact. Returns false on corrupted data, it never reads or writes out of bounds
+	bool	Decompress(const void* inData, uint64 inSize, void* outData, uint64 inDecompressedSize);
+}
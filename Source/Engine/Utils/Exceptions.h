@@ -1,6 +1,12 @@
 #pragma once
 
 void ThrowIfFailed(uint32 inResult);
+
+#if !defined(_WIN32)
+// MSVC intrinsic. Tools and tests also build with GCC and Clang
+#define __debugbreak() __builtin_trap()
+#endif
+
 #define Assert(expression, ...) do { if (!(expression) && HandleAssert(__FILE__, __LINE__, #expression, ##__VA_ARGS__)) __debugbreak(); } while (0);
 
 bool HandleAssert(const char* inFileName, int inLineNumber, const char* inExpression, const char* inMessage = nullptr);
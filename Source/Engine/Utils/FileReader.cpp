@@ -1,17 +1,60 @@
 #include "Engine.h"
 #include "FileReader.h"
 
+#include "Utils/PackFile.h"
+
 #include <fstream>
 
 FileReader::~FileReader()
 {
+	// The prefetch thread reads the mapping, stop it before unmapping
+	StopPrefetch();
+
 	if (m_FileContent)
 	{
 		delete[] m_FileContent;
 	}
 }
 
-bool FileReader::ReadFile(const std::string& inFilename)
+bool FileReader::ReadFile(const std::string& inFilename, FileReadMode inMode/* = FileReadMode::Copy*/)
+{
+	Assert(m_FileContent == nullptr && !m_MappedFile.IsOpen(), "FileReader can only read one file");
+
+	if (ReadFromPack(inFilename))
+		return true;
+
+	if (inMode != FileReadMode::Copy && MapToMemory(inFilename, inMode == FileReadMode::MapWithPrefetch))
+		return true;
+
+	return ReadToBuffer(inFilename);
+}
+
+bool FileReader::ReadFromPack(const std::string& inFilename)
+{
+	const PackFileFormat::Entry* entry = nullptr;
+	const PackFile* pack_file = PackFile::FindMounted(inFilename, entry);
+	if (pack_file == nullptr)
+		return false;
+
+	// Need to add 1 for \0
+	m_FileContent = new char[entry->m_Size + 1];
+
+	if (!pack_file->Read(*entry, 0, entry->m_Size, m_FileContent))
+	{
+		// Corrupted pack
+		Assert(false);
+		delete[] m_FileContent;
+		m_FileContent = nullptr;
+		return false;
+	}
+
+	m_FileContent[entry->m_Size]	= '\0';
+	m_ContentSize					= entry->m_Size;
+
+	return true;
+}
+
+bool FileReader::ReadToBuffer(const std::string& inFilename)
 {
 	// Seek to the end of stream immediately after open
 	std::ifstream stream(inFilename, std::ios::binary | std::ios::ate);
@@ -43,15 +86,56 @@ bool FileReader::ReadFile(const std::string& inFilename)
 	return true;
 }
 
+bool FileReader::MapToMemory(const std::string& inFilename, bool inPrefetch)
+{
+	// Files are mostly parsed front to back, and always entirely
+	if (!m_MappedFile.Open(inFilename, MappedFile::AccessHints::Sequential | MappedFile::AccessHints::WillNeed))
+		return false;
+
+	// The end of the last page is zero filled, which gives the null terminator for free.
+	// There is none when the file ends exactly on a page boundary, copy it instead
+	const uint64 page_size = MappedFile::GetPageSize();
+	if (m_MappedFile.GetSize() % page_size == 0)
+	{
+		m_MappedFile.Close();
+		return false;
+	}
+
+	m_ContentSize = m_MappedFile.GetSize();
+
+	if (inPrefetch)
+	{
+		const char* data = static_cast<const char*>(m_MappedFile.GetData());
+		m_PrefetchThread = std::thread([this, data, page_size]()
+		{
+			// Reading one byte is enough to fault a page in
+			volatile char sink = 0;
+			for (uint64 offset = 0; offset < m_ContentSize && !m_StopPrefetch.load(std::memory_order_relaxed); offset += page_size)
+				sink = data[offset];
+			(void) sink;
+		});
+	}
+
+	return true;
+}
+
+void FileReader::StopPrefetch()
+{
+	if (m_PrefetchThread.joinable())
+	{
+		m_StopPrefetch = true;
+		m_PrefetchThread.join();
+	}
+}
 
 const char* FileReader::GetContentAsString() const
 {
-	return (char*) m_FileContent;
+	return IsMapped() ? static_cast<const char*>(m_MappedFile.GetData()) : m_FileContent;
 }
 
 const void* FileReader::GetContentAsBinary() const
 {
-	return (void*) m_FileContent;
+	return GetContentAsString();
 }
 
 uint64 FileReader::GetContentSize() const
@@ -1,19 +1,43 @@
 #pragma once
 
+#include "Utils/MappedFile.h"
+
+#include <atomic>
 #include <string>
+#include <thread>
+
+enum class FileReadMode
+{
+	Copy,				// Read the whole file into a heap buffer
+	Map,				// Map the file in memory. Nothing is copied, pages are loaded from the page cache when touched
+	MapWithPrefetch,	// Map, and touch every page on a background thread so the reader rarely waits on the disk
+};
 
+// Files in mounted packs are read from there first, whatever the mode.
+// Content is always null terminated, the terminator is not part of the size
 class FileReader final
 {
 public:
 	~FileReader();
 
-	bool			ReadFile(const std::string& inFilename);
+	bool			ReadFile(const std::string& inFilename, FileReadMode inMode = FileReadMode::Copy);
 
 	const char*		GetContentAsString() const;
 	const void*		GetContentAsBinary() const;
 	uint64			GetContentSize() const;
 
+	inline bool		IsMapped() const	{ return m_MappedFile.IsOpen(); }
+
 protected:
-	char*	m_FileContent = nullptr;
-	uint64	m_ContentSize;
-};
\ No newline at end of file
+	bool			ReadFromPack(const std::string& inFilename);
+	bool			ReadToBuffer(const std::string& inFilename);
+	bool			MapToMemory(const std::string& inFilename, bool inPrefetch);
+	void			StopPrefetch();
+
+	char*				m_FileContent = nullptr;
+	uint64				m_ContentSize = 0;
+
+	MappedFile			m_MappedFile;
+	std::thread			m_PrefetchThread;
+	std::atomic<bool>	m_StopPrefetch { false };
+};
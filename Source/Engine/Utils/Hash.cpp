@@ -0,0 +1,113 @@
+#include "Engine.h"
+#include "Hash.h"
+
+#include <cstring>
+
+namespace Hash
+{
+	constexpr uint64 Prime1 = 0x9E3779B185EBCA87ull;
+	constexpr uint64 Prime2 = 0xC2B2AE3D27D4EB4Full;
+	constexpr uint64 Prime3 = 0x165667B19E3779F9ull;
+	constexpr uint64 Prime4 = 0x85EBCA77C2B2AE63ull;
+	constexpr uint64 Prime5 = 0x27D4EB2F165667C5ull;
+
+	static inline uint64 RotateLeft(uint64 inValue, uint32 inBits)
+	{
+		return (inValue << inBits) | (inValue >> (64 - inBits));
+	}
+
+	static inline uint64 Read64(const Byte* inData)
+	{
+		uint64 value;
+		::memcpy(&value, inData, sizeof(value));
+		return value;
+	}
+
+	static inline uint32 Read32(const Byte* inData)
+	{
+		uint32 value;
+		::memcpy(&value, inData, sizeof(value));
+		return value;
+	}
+
+	static inline uint64 Round(uint64 inAccumulator, uint64 inInput)
+	{
+		inAccumulator += inInput * Prime2;
+		inAccumulator = RotateLeft(inAccumulator, 31);
+		return inAccumulator * Prime1;
+	}
+
+	static inline uint64 MergeRound(uint64 inAccumulator, uint64 inValue)
+	{
+		inAccumulator ^= Round(0, inValue);
+		return inAccumulator * Prime1 + Prime4;
+	}
+
+	uint64 Hash64(const void* inData, uint64 inSize, uint64 inSeed)
+	{
+		const Byte* data	= static_cast<const Byte*>(inData);
+		const Byte* end		= data + inSize;
+
+		uint64 hash;
+
+		if (inSize >= 32)
+		{
+			// 4 independent lanes of 8 bytes, so consecutive rounds don't wait on each other
+			uint64 lane_0 = inSeed + Prime1 + Prime2;
+			uint64 lane_1 = inSeed + Prime2;
+			uint64 lane_2 = inSeed;
+			uint64 lane_3 = inSeed - Prime1;
+
+			const Byte* stripes_end = end - 32;
+			do
+			{
+				lane_0 = Round(lane_0, Read64(data));
+				lane_1 = Round(lane_1, Read64(data + 8));
+				lane_2 = Round(lane_2, Read64(data + 16));
+				lane_3 = Round(lane_3, Read64(data + 24));
+				data += 32;
+			} while (data <= stripes_end);
+
+			hash = RotateLeft(lane_0, 1) + RotateLeft(lane_1, 7) + RotateLeft(lane_2, 12) + RotateLeft(lane_3, 18);
+			hash = MergeRound(hash, lane_0);
+			hash = MergeRound(hash, lane_1);
+			hash = MergeRound(hash, lane_2);
+			hash = MergeRound(hash, lane_3);
+		}
+		else
+		{
+			hash = inSeed + Prime5;
+		}
+
+		hash += inSize;
+
+		// Remaining bytes
+		for (; data + 8 <= end; data += 8)
+		{
+			hash ^= Round(0, Read64(data));
+			hash = RotateLeft(hash, 27) * Prime1 + Prime4;
+		}
+
+		if (data + 4 <= end)
+		{
+			hash ^= Read32(data) * Prime1;
+			hash = RotateLeft(hash, 23) * Prime2 + Prime3;
+			data += 4;
+		}
+
+		for (; data < end; data++)
+		{
+			hash ^= *data * Prime5;
+			hash = RotateLeft(hash, 11) * Prime1;
+		}
+
+		// Avalanche
+		hash ^= hash >> 33;
+		hash *= Prime2;
+		hash ^= hash >> 29;
+		hash *= Prime3;
+		hash ^= hash >> 32;
+
+		return hash;
+	}
+}
@@ -0,0 +1,8 @@
+#pragma once
+
+// Fast non cryptographic hashing of byte buffers, for content hashes and lookups.
+// Same algorithm and output as XXH64, so results can be checked against the reference xxhsum
+namespace Hash
+{
+	uint64	Hash64(const void* inData, uint64 inSize, uint64 inSeed = 0);
+}
@@ -0,0 +1,508 @@
+#include "Engine.h"
+#include "JobSystem.h"
+
+#include <chrono>
+
+#if defined(_M_X64) || defined(__SSE2__)
+	#include <emmintrin.h>
+	#define JOB_SYSTEM_PAUSE()	_mm_pause()
+#else
+	#define JOB_SYSTEM_PAUSE()	std::this_thread::yield()
+#endif
+
+JobSystem g_JobSystem;
+
+struct Job
+{
+	JobFunction		m_Function;
+	JobCounter*		m_Counter	= nullptr;
+};
+
+namespace
+{
+	// Jobs pushed to a full deque run right away instead
+	constexpr int64 DequeCapacity		= 4096;
+	// Rounds of looking for work before sleeping, or yielding while waiting
+	constexpr uint32 NumSpinsBeforeSleep	= 64;
+
+	inline int64 GetTime()
+	{
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+
+	// Chase-Lev deque of fixed capacity, as in "Correct and Efficient Work-Stealing for Weak Memory Models" (Le et al. 2013).
+	// Only the owner pushes and pops, at the bottom. Any thread can steal from the top
+	class JobDeque final
+	{
+	public:
+		bool Push(Job* inJob)
+		{
+			const int64 bottom	= m_Bottom.load(std::memory_order_relaxed);
+			const int64 top		= m_Top.load(std::memory_order_acquire);
+			if (bottom - top >= DequeCapacity)
+				return false;
+
+			// Release: a thief that sees the new bottom sees the job
+			m_Jobs[bottom & (DequeCapacity - 1)].store(inJob, std::memory_order_relaxed);
+			m_Bottom.store(bottom + 1, std::memory_order_release);
+			return true;
+		}
+
+		Job* Pop()
+		{
+			const int64 bottom = m_Bottom.load(std::memory_order_relaxed) - 1;
+			m_Bottom.store(bottom, std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			int64 top = m_Top.load(std::memory_order_relaxed);
+
+			if (top > bottom)
+			{
+				// Empty
+				m_Bottom.store(bottom + 1, std::memory_order_relaxed);
+				return nullptr;
+			}
+
+			Job* job = m_Jobs[bottom & (DequeCapacity - 1)].load(std::memory_order_relaxed);
+			if (top == bottom)
+			{
+				// Last job, race thieves for it
+				if (!m_Top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+					job = nullptr;
+				m_Bottom.store(bottom + 1, std::memory_order_relaxed);
+			}
+			return job;
+		}
+
+		// Can fail when racing other thieves or the owner, even if the deque isn't empty
+		Job* Steal()
+		{
+			int64 top = m_Top.load(std::memory_order_acquire);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			const int64 bottom = m_Bottom.load(std::memory_order_acquire);
+
+			if (top >= bottom)
+				return nullptr;
+
+			Job* job = m_Jobs[top & (DequeCapacity - 1)].load(std::memory_order_relaxed);
+			if (!m_Top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+				return nullptr;
+
+			return job;
+		}
+
+		inline bool IsEmpty() const
+		{
+			return m_Bottom.load(std::memory_order_relaxed) <= m_Top.load(std::memory_order_relaxed);
+		}
+
+	private:
+		// On their own cache lines, thieves only write m_Top
+		alignas(64) std::atomic<int64>	m_Top		= 0;
+		alignas(64) std::atomic<int64>	m_Bottom	= 0;
+		alignas(64) std::atomic<Job*>	m_Jobs[DequeCapacity] = {};
+	};
+}
+
+struct JobWorker
+{
+	JobDeque				m_Deque;
+
+	uint32					m_Index			= 0;
+	// Xorshift state to pick victims
+	uint32					m_RandomState	= 1;
+
+	// Only written by the worker, read by GetStatistics
+	std::atomic<uint64>		m_NumJobs		= 0;
+	std::atomic<uint64>		m_NumStolenJobs	= 0;
+	std::atomic<uint64>		m_IdleTime		= 0;
+};
+
+// Worker running on this thread, nullptr for threads that aren't workers
+static thread_local JobWorker* g_CurrentWorker = nullptr;
+
+JobCounter::~JobCounter()
+{
+	// The last job to complete may still hold the mutex after m_Value reached zero
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	Assert(m_Value == 0 && m_WaitingJobs.empty(), "JobCounter destroyed while jobs are in flight");
+}
+
+JobSystem::~JobSystem()
+{
+	Shutdown();
+}
+
+void JobSystem::Init(uint32 inNumWorkers/* = 0*/)
+{
+	Assert(!IsInitialized());
+
+	const uint32 num_workers = (inNumWorkers != 0) ? inNumWorkers : Math::Max(1u, std::thread::hardware_concurrency());
+
+	m_Stop = false;
+
+	for (uint32 i = 0; i < num_workers; i++)
+	{
+		m_Workers.push_back(std::make_unique<JobWorker>());
+		m_Workers[i]->m_Index		= i;
+		m_Workers[i]->m_RandomState	= 0x9E3779B9u * (i + 1);
+	}
+
+	g_CurrentWorker = m_Workers[0].get();
+	ResetStatistics();
+
+	for (uint32 i = 1; i < num_workers; i++)
+		m_Threads.emplace_back(&JobSystem::WorkerLoop, this, i);
+
+	Trace("JobSystem: %u workers", num_workers);
+}
+
+void JobSystem::Shutdown()
+{
+	if (!IsInitialized())
+		return;
+
+	Assert(g_CurrentWorker == m_Workers[0].get(), "Shutdown from the thread that called Init");
+	Assert(!HasWork(), "Jobs are still pending");
+
+	{
+		std::lock_guard<std::mutex> lock(m_SleepMutex);
+		m_Stop = true;
+	}
+
+	m_SleepCondition.notify_all();
+
+	for (std::thread& thread : m_Threads)
+		thread.join();
+	m_Threads.clear();
+
+	g_CurrentWorker = nullptr;
+	m_Workers.clear();
+}
+
+void JobSystem::Schedule(JobFunction&& inFunction, JobCounter* ioCounter/* = nullptr*/, JobCounter* inDependency/* = nullptr*/)
+{
+	if (ioCounter != nullptr)
+		ioCounter->m_Value.fetch_add(1, std::memory_order_relaxed);
+
+	Job* job = new Job { std::move(inFunction), ioCounter };
+
+	if (inDependency != nullptr)
+	{
+		// Checked under the lock, the last job of the dependency takes the waiting jobs under the same lock
+		std::lock_guard<std::mutex> lock(inDependency->m_Mutex);
+		if (!inDependency->IsDone())
+		{
+			inDependency->m_WaitingJobs.push_back(job);
+			return;
+		}
+	}
+
+	Push(job);
+}
+
+void JobSystem::Wait(const JobCounter& inCounter)
+{
+	JobWorker* worker	= g_CurrentWorker;
+	int64 idle_start	= 0;
+	uint32 num_spins	= 0;
+
+	while (!inCounter.IsDone())
+	{
+		Job* job = IsInitialized() ? FindJob(worker) : nullptr;
+		if (job != nullptr)
+		{
+			if (idle_start != 0 && worker != nullptr)
+				worker->m_IdleTime.fetch_add(GetTime() - idle_start, std::memory_order_relaxed);
+
+			idle_start	= 0;
+			num_spins	= 0;
+
+			Execute(job);
+			continue;
+		}
+
+		if (idle_start == 0)
+			idle_start = GetTime();
+
+		// The remaining jobs run on other workers. Don't take their core if there aren't enough
+		if (num_spins++ < NumSpinsBeforeSleep)
+			JOB_SYSTEM_PAUSE();
+		else
+			std::this_thread::yield();
+	}
+
+	if (idle_start != 0 && worker != nullptr)
+		worker->m_IdleTime.fetch_add(GetTime() - idle_start, std::memory_order_relaxed);
+}
+
+void JobSystem::ParallelFor(size_t inCount, const std::function<void(size_t)>& inFunction, size_t inMinBatchSize/* = 1*/)
+{
+	ParallelForBatches(inCount, [&inFunction](size_t inBegin, size_t inEnd)
+	{
+		for (size_t i = inBegin; i < inEnd; i++)
+			inFunction(i);
+	}, inMinBatchSize);
+}
+
+void JobSystem::ParallelForBatches(size_t inCount, const std::function<void(size_t, size_t)>& inFunction, size_t inMinBatchSize)
+{
+	JobCounter counter;
+	RunRange(0, inCount, inFunction, Math::Max<size_t>(1, inMinBatchSize), counter);
+	Wait(counter);
+}
+
+// Lazy binary splitting: run the range one batch at a time, and give half of what's left away whenever the local
+// queue is empty. An empty queue means idle workers stole everything, busy workers keep their whole range
+void JobSystem::RunRange(size_t inBegin, size_t inEnd, const std::function<void(size_t, size_t)>& inFunction, size_t inMinBatchSize, JobCounter& ioCounter)
+{
+	const bool can_split = (GetNumWorkers() > 1);
+
+	while (inEnd - inBegin >= 2 * inMinBatchSize)
+	{
+		const JobWorker* worker = g_CurrentWorker;
+		const bool is_queue_empty = (worker != nullptr) ? worker->m_Deque.IsEmpty() : (m_SharedQueueSize.load(std::memory_order_relaxed) == 0);
+
+		if (can_split && is_queue_empty)
+		{
+			const size_t middle = inBegin + (inEnd - inBegin) / 2;
+			const size_t end	= inEnd;
+
+			Schedule([this, middle, end, &inFunction, inMinBatchSize, &ioCounter]()
+			{
+				RunRange(middle, end, inFunction, inMinBatchSize, ioCounter);
+			}, &ioCounter);
+
+			inEnd = middle;
+			continue;
+		}
+
+		inFunction(inBegin, inBegin + inMinBatchSize);
+		inBegin += inMinBatchSize;
+	}
+
+	if (inBegin < inEnd)
+		inFunction(inBegin, inEnd);
+}
+
+std::vector<JobWorkerStatistics> JobSystem::GetStatistics() const
+{
+	const uint64 elapsed_time = GetTime() - m_StatisticsStartTime.load(std::memory_order_relaxed);
+
+	std::vector<JobWorkerStatistics> statistics(m_Workers.size());
+	for (size_t i = 0; i < m_Workers.size(); i++)
+	{
+		const JobWorker& worker				= *m_Workers[i];
+		statistics[i].m_NumJobs				= worker.m_NumJobs.load(std::memory_order_relaxed);
+		statistics[i].m_NumStolenJobs		= worker.m_NumStolenJobs.load(std::memory_order_relaxed);
+		statistics[i].m_IdleTime			= Math::Min(worker.m_IdleTime.load(std::memory_order_relaxed), elapsed_time);
+		statistics[i].m_ElapsedTime			= elapsed_time;
+	}
+
+	return statistics;
+}
+
+void JobSystem::ResetStatistics()
+{
+	for (const std::unique_ptr<JobWorker>& worker : m_Workers)
+	{
+		worker->m_NumJobs.store(0, std::memory_order_relaxed);
+		worker->m_NumStolenJobs.store(0, std::memory_order_relaxed);
+		worker->m_IdleTime.store(0, std::memory_order_relaxed);
+	}
+
+	m_StatisticsStartTime.store(GetTime(), std::memory_order_relaxed);
+}
+
+void JobSystem::TraceStatistics() const
+{
+	const std::vector<JobWorkerStatistics> statistics = GetStatistics();
+	for (size_t i = 0; i < statistics.size(); i++)
+	{
+		Trace("JobSystem: Worker %zu %.1f%% busy, %llu jobs (%llu stolen)", i, statistics[i].GetUtilization() * 100.0,
+			  static_cast<unsigned long long>(statistics[i].m_NumJobs), static_cast<unsigned long long>(statistics[i].m_NumStolenJobs));
+	}
+}
+
+void JobSystem::WorkerLoop(uint32 inWorkerIndex)
+{
+	JobWorker* worker	= m_Workers[inWorkerIndex].get();
+	g_CurrentWorker		= worker;
+
+	while (true)
+	{
+		Job* job = FindJob(worker);
+		if (job == nullptr)
+		{
+			const int64 idle_start	= GetTime();
+			uint32 num_spins		= 0;
+
+			while (job == nullptr)
+			{
+				if (num_spins++ < NumSpinsBeforeSleep)
+				{
+					JOB_SYSTEM_PAUSE();
+				}
+				else
+				{
+					std::unique_lock<std::mutex> lock(m_SleepMutex);
+					if (m_Stop)
+						return;
+
+					const uint64 wake_epoch = m_WakeEpoch;
+					m_NumSleepingWorkers.fetch_add(1, std::memory_order_relaxed);
+
+					// Pairs with the fence in WakeWorker: either the job pushed last is visible here, or the pusher sees this worker sleeping
+					std::atomic_thread_fence(std::memory_order_seq_cst);
+					if (!HasWork())
+						m_SleepCondition.wait(lock, [this, wake_epoch]() { return m_WakeEpoch != wake_epoch || m_Stop; });
+
+					m_NumSleepingWorkers.fetch_sub(1, std::memory_order_relaxed);
+					num_spins = 0;
+				}
+
+				job = FindJob(worker);
+			}
+
+			worker->m_IdleTime.fetch_add(GetTime() - idle_start, std::memory_order_relaxed);
+		}
+
+		Execute(job);
+	}
+}
+
+void JobSystem::Push(Job* inJob)
+{
+	if (!IsInitialized())
+	{
+		Execute(inJob);
+		return;
+	}
+
+	JobWorker* worker = g_CurrentWorker;
+	if (worker != nullptr)
+	{
+		// Full, there is already plenty of work for everyone
+		if (!worker->m_Deque.Push(inJob))
+		{
+			Execute(inJob);
+			return;
+		}
+	}
+	else
+	{
+		std::lock_guard<std::mutex> lock(m_SharedQueueMutex);
+		m_SharedQueue.push_back(inJob);
+		m_SharedQueueSize.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	WakeWorker();
+}
+
+Job* JobSystem::FindJob(JobWorker* inWorker)
+{
+	if (inWorker != nullptr)
+	{
+		if (Job* job = inWorker->m_Deque.Pop())
+			return job;
+	}
+
+	if (m_SharedQueueSize.load(std::memory_order_relaxed) != 0)
+	{
+		std::lock_guard<std::mutex> lock(m_SharedQueueMutex);
+		if (!m_SharedQueue.empty())
+		{
+			Job* job = m_SharedQueue.front();
+			m_SharedQueue.pop_front();
+			m_SharedQueueSize.fetch_sub(1, std::memory_order_relaxed);
+			return job;
+		}
+	}
+
+	return StealJob(inWorker);
+}
+
+Job* JobSystem::StealJob(JobWorker* inWorker)
+{
+	const uint32 num_workers = static_cast<uint32>(m_Workers.size());
+
+	// Start from a random victim so thieves spread out
+	uint32 first_victim = 0;
+	if (inWorker != nullptr)
+	{
+		uint32& state	= inWorker->m_RandomState;
+		state			^= state << 13;
+		state			^= state >> 17;
+		state			^= state << 5;
+		first_victim	= state % num_workers;
+	}
+
+	for (uint32 i = 0; i < num_workers; i++)
+	{
+		JobWorker* victim = m_Workers[(first_victim + i) % num_workers].get();
+		if (victim == inWorker)
+			continue;
+
+		if (Job* job = victim->m_Deque.Steal())
+		{
+			if (inWorker != nullptr)
+				inWorker->m_NumStolenJobs.fetch_add(1, std::memory_order_relaxed);
+			return job;
+		}
+	}
+
+	return nullptr;
+}
+
+bool JobSystem::HasWork() const
+{
+	if (m_SharedQueueSize.load(std::memory_order_relaxed) != 0)
+		return true;
+
+	for (const std::unique_ptr<JobWorker>& worker : m_Workers)
+	{
+		if (!worker->m_Deque.IsEmpty())
+			return true;
+	}
+
+	return false;
+}
+
+void JobSystem::Execute(Job* inJob)
+{
+	inJob->m_Function();
+
+	JobCounter* counter = inJob->m_Counter;
+	delete inJob;
+
+	if (g_CurrentWorker != nullptr)
+		g_CurrentWorker->m_NumJobs.fetch_add(1, std::memory_order_relaxed);
+
+	if (counter == nullptr)
+		return;
+
+	std::vector<Job*> ready_jobs;
+	{
+		std::lock_guard<std::mutex> lock(counter->m_Mutex);
+		if (counter->m_Value.fetch_sub(1, std::memory_order_acq_rel) == 1)
+			ready_jobs.swap(counter->m_WaitingJobs);
+	}
+
+	// The counter may be destroyed from here
+	for (Job* job : ready_jobs)
+		Push(job);
+}
+
+void JobSystem::WakeWorker()
+{
+	// Pairs with the fence in WorkerLoop
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	if (m_NumSleepingWorkers.load(std::memory_order_relaxed) == 0)
+		return;
+
+	{
+		std::lock_guard<std::mutex> lock(m_SleepMutex);
+		m_WakeEpoch++;
+	}
+
+	m_SleepCondition.notify_one();
+}
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using JobFunction = std::function<void()>;
+
+struct Job;
+struct JobWorker;
+
+// Number of jobs in flight. Scheduling a job with a counter increments it, completing the job decrements it.
+// Wait on a counter with JobSystem::Wait, or use it as the dependency of other jobs
+class JobCounter final
+{
+public:
+	JobCounter() = default;
+	// Waits for the job that completed last to let go of the counter
+	~JobCounter();
+
+	JobCounter(const JobCounter&) = delete;
+	JobCounter& operator=(const JobCounter&) = delete;
+
+	inline bool		IsDone() const	{ return m_Value.load(std::memory_order_acquire) == 0; }
+
+private:
+	friend class JobSystem;
+
+	std::atomic<uint32>		m_Value	= 0;
+	// Jobs that depend on this counter, scheduled once it reaches zero
+	std::mutex				m_Mutex;
+	std::vector<Job*>		m_WaitingJobs;
+};
+
+// Time spent by a worker since the statistics were reset
+struct JobWorkerStatistics
+{
+	uint64	m_NumJobs			= 0;	// Executed by this worker
+	uint64	m_NumStolenJobs		= 0;	// Executed by this worker, taken from another one
+	uint64	m_IdleTime			= 0;	// Nanoseconds spent looking for work or sleeping
+	uint64	m_ElapsedTime		= 0;	// Nanoseconds
+
+	inline double	GetUtilization() const	{ return m_ElapsedTime != 0 ? 1.0 - static_cast<double>(m_IdleTime) / m_ElapsedTime : 0.0; }
+};
+
+// Runs jobs on a worker thread per core. Each worker has its own lock-free deque: it pushes and pops jobs at the bottom
+// while idle workers steal from the top of the others. The thread calling Init is worker 0, it runs jobs while waiting.
+// Other threads can schedule and wait too, their jobs go through a shared queue.
+// Jobs shouldn't block on anything but JobSystem::Wait. Mapping a file or reading a small one from a job is fine,
+// whole asset files are read by AsyncIO before their job is scheduled, see AssetManager.
+// Before Init, or after Shutdown, jobs run right away on the calling thread
+class JobSystem final
+{
+public:
+	JobSystem() = default;
+	~JobSystem();
+
+	JobSystem(const JobSystem&) = delete;
+	JobSystem& operator=(const JobSystem&) = delete;
+
+	// inNumWorkers includes the calling thread, 0 for one per core
+	void			Init(uint32 inNumWorkers = 0);
+	// All jobs must be completed
+	void			Shutdown();
+
+	// ioCounter (optional) is incremented right away and decremented once inFunction returns.
+	// The job doesn't start before inDependency (optional) reaches zero
+	void			Schedule(JobFunction&& inFunction, JobCounter* ioCounter = nullptr, JobCounter* inDependency = nullptr);
+
+	// Run other jobs until inCounter reaches zero. Can be called from a job
+	void			Wait(const JobCounter& inCounter);
+
+	// Call inFunction for every index in [0, inCount[ and wait for all of them. Indices run in batches of at least
+	// inMinBatchSize. Ranges are only split when other workers run out of work, so batches grow when everyone is busy
+	void			ParallelFor(size_t inCount, const std::function<void(size_t)>& inFunction, size_t inMinBatchSize = 1);
+	// Same, inFunction receives [begin, end[ ranges of at least inMinBatchSize indices. Cheaper for tiny items
+	void			ParallelForBatches(size_t inCount, const std::function<void(size_t, size_t)>& inFunction, size_t inMinBatchSize);
+
+	// Workers, the thread that called Init included. 1 when not initialized
+	inline uint32	GetNumWorkers() const	{ return Math::Max<uint32>(1, static_cast<uint32>(m_Workers.size())); }
+	inline bool		IsInitialized() const	{ return !m_Workers.empty(); }
+
+	// Worker 0 is only idle while it waits
+	std::vector<JobWorkerStatistics>	GetStatistics() const;
+	void			ResetStatistics();
+	void			TraceStatistics() const;
+
+private:
+	void			WorkerLoop(uint32 inWorkerIndex);
+
+	void			Push(Job* inJob);
+	// Own deque, then the shared queue, then the other workers. nullptr when there is no work anywhere
+	Job*			FindJob(JobWorker* inWorker);
+	Job*			StealJob(JobWorker* inWorker);
+	bool			HasWork() const;
+	void			Execute(Job* inJob);
+	void			WakeWorker();
+
+	void			RunRange(size_t inBegin, size_t inEnd, const std::function<void(size_t, size_t)>& inFunction, size_t inMinBatchSize, JobCounter& ioCounter);
+
+	std::vector<std::unique_ptr<JobWorker>>	m_Workers;
+	std::vector<std::thread>				m_Threads;
+
+	// Jobs scheduled from threads that aren't workers
+	std::mutex								m_SharedQueueMutex;
+	std::deque<Job*>						m_SharedQueue;
+	std::atomic<uint64>						m_SharedQueueSize		= 0;
+
+	// Idle workers sleep until a job is pushed. The epoch changes on every wake up so none is missed
+	std::mutex								m_SleepMutex;
+	std::condition_variable					m_SleepCondition;
+	std::atomic<uint32>						m_NumSleepingWorkers	= 0;
+	uint64									m_WakeEpoch				= 0;
+	bool									m_Stop					= false;
+
+	std::atomic<int64>						m_StatisticsStartTime	= 0;
+};
+
+extern JobSystem g_JobSystem;
@@ -1,9 +1,11 @@
 #include "Engine.h"
 #include "Utils/Logger.h"
 
-#include <windows.h>
+#include <stdarg.h>
 
-#define vsnprintf _vsnprintf_s
+#if defined(_WIN32)
+#include <windows.h>
+#endif
 
 void Trace(const char* inMessage, /*args*/ ...)
 {
@@ -11,21 +13,37 @@ void Trace(const char* inMessage, /*args*/ ...)
 	va_start(args, inMessage);
 
 	// Length of file after formatting
+#if defined(_WIN32)
 	size_t length	= _vscprintf(inMessage, args) + 1;
+#else
+	va_list length_args;
+	va_copy(length_args, args);
+	size_t length	= vsnprintf(nullptr, 0, inMessage, length_args) + 1;
+	va_end(length_args);
+#endif
 
 	// OutputDebugString has a maximum length of 4KB
 	Assert(length < (4096-1));
 
 	char* buffer	= new char[length+1];
 
-	vsnprintf(buffer, length, length, inMessage, args);
+#if defined(_WIN32)
+	_vsnprintf_s(buffer, length, length, inMessage, args);
+#else
+	vsnprintf(buffer, length, inMessage, args);
+#endif
 	va_end(args);
 
 	// Cause a flush
 	buffer[length-1] = '\n';
 	buffer[length] = '\0';
 
+#if defined(_WIN32)
 	OutputDebugString(buffer);
+#else
+	// Tools and tests built on other platforms, there is no debugger output
+	fputs(buffer, stderr);
+#endif
 
 	delete[] buffer;
 }
\ No newline at end of file
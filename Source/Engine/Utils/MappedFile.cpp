@@ -0,0 +1,152 @@
+#include "Engine.h"
+#include "MappedFile.h"
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::~MappedFile()
+{
+	Close();
+}
+
+#if defined(_WIN32)
+
+bool MappedFile::Open(const std::string& inFilename, uint32 inAccessHints/* = AccessHints::None*/)
+{
+	Assert(!IsOpen());
+
+	const DWORD flags = FILE_ATTRIBUTE_NORMAL | ((inAccessHints & AccessHints::Sequential) ? FILE_FLAG_SEQUENTIAL_SCAN : 0);
+
+	HANDLE file_handle = ::CreateFileA(inFilename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+									   OPEN_EXISTING, flags, nullptr);
+	if (file_handle == INVALID_HANDLE_VALUE)
+		return false;
+
+	LARGE_INTEGER file_size;
+	if (!::GetFileSizeEx(file_handle, &file_size) || file_size.QuadPart == 0)
+	{
+		// Empty files can't be mapped
+		::CloseHandle(file_handle);
+		return false;
+	}
+
+	HANDLE mapping_handle = ::CreateFileMappingA(file_handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (mapping_handle == nullptr)
+	{
+		::CloseHandle(file_handle);
+		return false;
+	}
+
+	const void* data = ::MapViewOfFile(mapping_handle, FILE_MAP_READ, 0, 0, 0);
+	if (data == nullptr)
+	{
+		::CloseHandle(mapping_handle);
+		::CloseHandle(file_handle);
+		return false;
+	}
+
+	m_FileHandle	= file_handle;
+	m_MappingHandle	= mapping_handle;
+	m_Data			= data;
+	m_Size			= static_cast<uint64>(file_size.QuadPart);
+
+	// Queue reads for the whole view. Failing is fine, pages then load on first access
+	if (inAccessHints & AccessHints::WillNeed)
+	{
+		WIN32_MEMORY_RANGE_ENTRY range;
+		range.VirtualAddress	= const_cast<void*>(m_Data);
+		range.NumberOfBytes		= static_cast<SIZE_T>(m_Size);
+		::PrefetchVirtualMemory(::GetCurrentProcess(), 1, &range, 0);
+	}
+
+	return true;
+}
+
+void MappedFile::Close()
+{
+	if (m_Data != nullptr)
+		::UnmapViewOfFile(m_Data);
+
+	if (m_MappingHandle != nullptr)
+		::CloseHandle(m_MappingHandle);
+
+	if (m_FileHandle != nullptr)
+		::CloseHandle(m_FileHandle);
+
+	m_Data			= nullptr;
+	m_Size			= 0;
+	m_FileHandle	= nullptr;
+	m_MappingHandle	= nullptr;
+}
+
+uint64 MappedFile::GetPageSize()
+{
+	SYSTEM_INFO system_info;
+	::GetSystemInfo(&system_info);
+	return system_info.dwPageSize;
+}
+
+#else
+
+bool MappedFile::Open(const std::string& inFilename, uint32 inAccessHints/* = AccessHints::None*/)
+{
+	Assert(!IsOpen());
+
+	int file_descriptor = ::open(inFilename.c_str(), O_RDONLY);
+	if (file_descriptor < 0)
+		return false;
+
+	struct stat file_stat;
+	if (::fstat(file_descriptor, &file_stat) != 0 || file_stat.st_size == 0)
+	{
+		// Empty files can't be mapped
+		::close(file_descriptor);
+		return false;
+	}
+
+	void* data = ::mmap(nullptr, static_cast<size_t>(file_stat.st_size), PROT_READ, MAP_PRIVATE, file_descriptor, 0);
+	if (data == MAP_FAILED)
+	{
+		::close(file_descriptor);
+		return false;
+	}
+
+	m_FileDescriptor	= file_descriptor;
+	m_Data				= data;
+	m_Size				= static_cast<uint64>(file_stat.st_size);
+
+	// Failing is fine, these are only hints
+	if (inAccessHints & AccessHints::Sequential)
+		::madvise(data, static_cast<size_t>(m_Size), MADV_SEQUENTIAL);
+
+	if (inAccessHints & AccessHints::WillNeed)
+		::madvise(data, static_cast<size_t>(m_Size), MADV_WILLNEED);
+
+	return true;
+}
+
+void MappedFile::Close()
+{
+	if (m_Data != nullptr)
+		::munmap(const_cast<void*>(m_Data), static_cast<size_t>(m_Size));
+
+	if (m_FileDescriptor >= 0)
+		::close(m_FileDescriptor);
+
+	m_Data				= nullptr;
+	m_Size				= 0;
+	m_FileDescriptor	= -1;
+}
+
+uint64 MappedFile::GetPageSize()
+{
+	return static_cast<uint64>(::sysconf(_SC_PAGESIZE));
+}
+
+#endif
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <string>
+
+// Read-only memory mapping of a whole file.
+// The content stays valid until Close() is called or the object is destroyed
+class MappedFile final
+{
+public:
+	MappedFile() = default;
+	~MappedFile();
+
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	// How the content is going to be accessed. Hints for the OS page cache, they can be combined
+	enum AccessHints : uint32
+	{
+		None		= 0,
+		Sequential	= 1 << 0,	// Read from start to end, read ahead aggressively
+		WillNeed	= 1 << 1,	// The whole file is needed soon, start loading it right away
+	};
+
+	bool			Open(const std::string& inFilename, uint32 inAccessHints = AccessHints::None);
+	void			Close();
+
+	// Granularity of the mapping. Bytes after the end of the file up to the next page are zeros
+	static uint64	GetPageSize();
+
+	inline const void*	GetData() const			{ return m_Data; }
+	inline uint64		GetSize() const			{ return m_Size; }
+	inline bool			IsOpen() const			{ return m_Data != nullptr; }
+
+private:
+	const void*	m_Data	= nullptr;
+	uint64		m_Size	= 0;
+
+#if defined(_WIN32)
+	void*		m_FileHandle	= nullptr;
+	void*		m_MappingHandle	= nullptr;
+#else
+	int			m_FileDescriptor	= -1;
+#endif
+};
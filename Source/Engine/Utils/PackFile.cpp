@@ -0,0 +1,383 @@
+#include "Engine.h"
+#include "PackFile.h"
+
+#include "Utils/Compression.h"
+#include "Utils/JobSystem.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+
+using namespace PackFileFormat;
+
+namespace PackFileFormat
+{
+	std::string NormalizePath(std::string_view inPath)
+	{
+		std::string path;
+		path.reserve(inPath.size());
+
+		for (char c : inPath)
+			path += (c == '\\') ? '/' : static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+
+		// "./Data/x" is "data/x"
+		while (path.compare(0, 2, "./") == 0)
+			path.erase(0, 2);
+
+		return path;
+	}
+
+	uint64 HashPath(std::string_view inPath)
+	{
+		const std::string path = NormalizePath(inPath);
+
+		uint64 hash = 0xCBF29CE484222325ull;
+		for (char c : path)
+		{
+			hash ^= static_cast<uint8>(c);
+			hash *= 0x100000001B3ull;
+		}
+		return hash;
+	}
+}
+
+static std::vector<std::unique_ptr<PackFile>>& GetMountedPacks()
+{
+	static std::vector<std::unique_ptr<PackFile>> mounted_packs;
+	return mounted_packs;
+}
+
+static void WritePadding(std::ofstream& ioStream, uint64 inAlignedOffset)
+{
+	static const char zeros[Alignment] = {};
+
+	const uint64 current_offset = static_cast<uint64>(ioStream.tellp());
+	Assert(inAlignedOffset >= current_offset && inAlignedOffset - current_offset < Alignment);
+
+	ioStream.write(zeros, static_cast<std::streamsize>(inAlignedOffset - current_offset));
+}
+
+static inline uint64 GetNumBlocks(uint64 inSize, uint64 inBlockSize)
+{
+	return (inSize + inBlockSize - 1) / inBlockSize;
+}
+
+bool PackFile::Open(const std::string& inFile)
+{
+	// Reads jump around the file, no access hint
+	if (!m_File.Open(inFile))
+		return false;
+
+	// Validate the header and every entry before trusting any offset
+	bool is_valid = (m_File.GetSize() >= sizeof(Header));
+	if (is_valid)
+	{
+		const Header& header = GetHeader();
+		is_valid = header.m_Magic == Magic && header.m_Version == Version && header.m_BlockSize > 0 &&
+				   header.m_EntriesOffset + header.m_NumEntries * sizeof(Entry) <= m_File.GetSize() &&
+				   header.m_BlocksOffset + header.m_NumBlocks * sizeof(Block) <= m_File.GetSize() &&
+				   header.m_StringsOffset + header.m_StringsSize <= m_File.GetSize();
+
+		for (uint32 i = 0; is_valid && i < header.m_NumEntries; i++)
+		{
+			const Entry& entry = GetEntries()[i];
+			is_valid = entry.m_FirstBlock + GetNumBlocks(entry.m_Size, header.m_BlockSize) <= header.m_NumBlocks &&
+					   static_cast<uint64>(entry.m_PathOffset) + entry.m_PathLength <= header.m_StringsSize &&
+					   (i == 0 || GetEntries()[i - 1].m_PathHash <= entry.m_PathHash);
+		}
+
+		for (uint64 i = 0; is_valid && i < header.m_NumBlocks; i++)
+		{
+			const Block& block = GetBlocks()[i];
+			is_valid = block.m_Offset + block.m_StoredSize <= m_File.GetSize();
+		}
+	}
+
+	if (!is_valid)
+	{
+		Trace("PackFile: %s is invalid or was packed with another version", inFile.c_str());
+		m_File.Close();
+	}
+
+	return is_valid;
+}
+
+void PackFile::Close()
+{
+	m_File.Close();
+}
+
+const Entry* PackFile::Find(std::string_view inPath) const
+{
+	Assert(IsOpen());
+
+	const std::string path	= NormalizePath(inPath);
+	const uint64 hash		= HashPath(path);
+
+	const Entry* entries_begin	= GetEntries();
+	const Entry* entries_end	= entries_begin + GetHeader().m_NumEntries;
+
+	const Entry* entry = std::lower_bound(entries_begin, entries_end, hash,
+										  [](const Entry& inEntry, uint64 inHash) { return inEntry.m_PathHash < inHash; });
+
+	// Different paths can share a hash
+	const char* strings = reinterpret_cast<const char*>(GetSection(GetHeader().m_StringsOffset));
+	for (; entry != entries_end && entry->m_PathHash == hash; entry++)
+	{
+		if (std::string_view(strings + entry->m_PathOffset, entry->m_PathLength) == path)
+			return entry;
+	}
+
+	return nullptr;
+}
+
+bool PackFile::Read(const Entry& inEntry, uint64 inOffset, uint64 inSize, void* outData) const
+{
+	Assert(IsOpen());
+
+	if (inOffset > inEntry.m_Size || inSize > inEntry.m_Size - inOffset)
+		return false;
+
+	if (inSize == 0)
+		return true;
+
+	const uint64 block_size		= GetHeader().m_BlockSize;
+	const uint64 first_block	= inOffset / block_size;
+	const uint64 num_blocks		= (inOffset + inSize - 1) / block_size - first_block + 1;
+
+	// Blocks [inBegin, inEnd[ relative to first_block
+	auto read_blocks = [&](uint64 inBegin, uint64 inEnd)
+	{
+		for (uint64 i = inBegin; i < inEnd; i++)
+		{
+			const uint64 block_start	= (first_block + i) * block_size;
+			const uint64 block_end		= Math::Min(block_start + block_size, inEntry.m_Size);
+			const uint64 read_start		= Math::Max(block_start, inOffset);
+			const uint64 read_end		= Math::Min(block_end, inOffset + inSize);
+
+			Byte* destination = static_cast<Byte*>(outData) + (read_start - inOffset);
+			if (!ReadBlock(inEntry.m_FirstBlock + first_block + i, block_end - block_start, read_start - block_start, read_end - read_start, destination))
+				return false;
+		}
+		return true;
+	};
+
+	// A few blocks aren't worth a job
+	constexpr uint64 min_blocks_per_job = 8;
+
+	if (num_blocks < 2 * min_blocks_per_job)
+		return read_blocks(0, num_blocks);
+
+	std::atomic<bool> success = true;
+	g_JobSystem.ParallelForBatches(num_blocks, [&](size_t inBegin, size_t inEnd)
+	{
+		if (!read_blocks(inBegin, inEnd))
+			success = false;
+	}, min_blocks_per_job);
+
+	return success;
+}
+
+bool PackFile::ReadBlock(uint64 inBlock, uint64 inBlockSize, uint64 inOffsetInBlock, uint64 inSize, Byte* outData) const
+{
+	const Block& block	= GetBlocks()[inBlock];
+	const Byte* stored	= GetSection(block.m_Offset);
+
+	if ((block.m_Flags & BlockFlags::Compressed) == 0)
+	{
+		if (block.m_StoredSize != inBlockSize)
+			return false;
+
+		::memcpy(outData, stored + inOffsetInBlock, static_cast<size_t>(inSize));
+		return true;
+	}
+
+	// Whole blocks are decompressed in place. Only the first and last block of a range can be partial
+	if (inOffsetInBlock == 0 && inSize == inBlockSize)
+		return Compression::Decompress(stored, block.m_StoredSize, outData, inBlockSize);
+
+	std::unique_ptr<Byte[]> block_data(new Byte[inBlockSize]);
+	if (!Compression::Decompress(stored, block.m_StoredSize, block_data.get(), inBlockSize))
+		return false;
+
+	::memcpy(outData, block_data.get() + inOffsetInBlock, static_cast<size_t>(inSize));
+	return true;
+}
+
+bool PackFile::Write(const std::string& inPackFile, const std::vector<std::string>& inFiles, uint32 inBlockSize/* = PackFileFormat::DefaultBlockSize*/)
+{
+	Assert(inBlockSize > 0);
+
+	struct SourceFile
+	{
+		std::string	m_Path;				// As given, to read it
+		std::string	m_NormalizedPath;
+		Entry		m_Entry;
+	};
+
+	std::vector<SourceFile> files(inFiles.size());
+	for (size_t i = 0; i < inFiles.size(); i++)
+	{
+		std::error_code error_code;
+		const uint64 file_size = std::filesystem::file_size(inFiles[i], error_code);
+		if (error_code)
+		{
+			Trace("PackFile: Can't read %s", inFiles[i].c_str());
+			return false;
+		}
+
+		files[i].m_Path				= inFiles[i];
+		files[i].m_NormalizedPath	= NormalizePath(inFiles[i]);
+		files[i].m_Entry			= {};
+		files[i].m_Entry.m_PathHash	= HashPath(files[i].m_NormalizedPath);
+		files[i].m_Entry.m_Size		= file_size;
+	}
+
+	std::sort(files.begin(), files.end(), [](const SourceFile& inA, const SourceFile& inB)
+	{
+		return (inA.m_Entry.m_PathHash != inB.m_Entry.m_PathHash) ? inA.m_Entry.m_PathHash < inB.m_Entry.m_PathHash : inA.m_NormalizedPath < inB.m_NormalizedPath;
+	});
+
+	std::vector<Entry>	entries;
+	std::string			strings;
+	uint64				num_blocks = 0;
+
+	for (size_t i = 0; i < files.size(); i++)
+	{
+		if (i > 0 && files[i].m_NormalizedPath == files[i - 1].m_NormalizedPath)
+		{
+			Trace("PackFile: %s and %s are the same file once packed", files[i - 1].m_Path.c_str(), files[i].m_Path.c_str());
+			return false;
+		}
+
+		Entry& entry		= files[i].m_Entry;
+		entry.m_FirstBlock	= num_blocks;
+		entry.m_PathOffset	= static_cast<uint32>(strings.size());
+		entry.m_PathLength	= static_cast<uint32>(files[i].m_NormalizedPath.size());
+		strings += files[i].m_NormalizedPath;
+
+		num_blocks += GetNumBlocks(entry.m_Size, inBlockSize);
+		entries.push_back(entry);
+	}
+
+	Header header = {};
+	header.m_Magic			= Magic;
+	header.m_Version		= Version;
+	header.m_BlockSize		= inBlockSize;
+	header.m_NumEntries		= static_cast<uint32>(entries.size());
+	header.m_NumBlocks		= num_blocks;
+
+	header.m_EntriesOffset	= Math::AlignUp<uint64>(sizeof(Header), Alignment);
+	header.m_BlocksOffset	= Math::AlignUp<uint64>(header.m_EntriesOffset + entries.size() * sizeof(Entry), Alignment);
+	header.m_StringsOffset	= Math::AlignUp<uint64>(header.m_BlocksOffset + num_blocks * sizeof(Block), Alignment);
+	header.m_StringsSize	= strings.size();
+
+	std::ofstream stream(inPackFile, std::ios::binary | std::ios::trunc);
+	if (!stream.is_open())
+		return false;
+
+	stream.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+
+	WritePadding(stream, header.m_EntriesOffset);
+	stream.write(reinterpret_cast<const char*>(entries.data()), entries.size() * sizeof(Entry));
+
+	// Block table is written once blocks have been compressed
+	WritePadding(stream, header.m_BlocksOffset);
+	std::vector<Block> blocks(num_blocks);
+	stream.write(reinterpret_cast<const char*>(blocks.data()), blocks.size() * sizeof(Block));
+
+	WritePadding(stream, header.m_StringsOffset);
+	stream.write(strings.data(), header.m_StringsSize);
+
+	std::vector<Byte> compressed_data(inBlockSize);
+	for (const SourceFile& file : files)
+	{
+		std::ifstream source(file.m_Path, std::ios::binary);
+		std::vector<Byte> content(file.m_Entry.m_Size);
+		if (!source.read(reinterpret_cast<char*>(content.data()), content.size()))
+		{
+			Trace("PackFile: Can't read %s", file.m_Path.c_str());
+			return false;
+		}
+
+		for (uint64 offset = 0; offset < content.size(); offset += inBlockSize)
+		{
+			const uint64 size		= Math::Min<uint64>(inBlockSize, content.size() - offset);
+			Block& block			= blocks[file.m_Entry.m_FirstBlock + offset / inBlockSize];
+			block.m_Offset			= static_cast<uint64>(stream.tellp());
+
+			// Only keep the compressed block when it is smaller
+			const uint64 compressed_size = Compression::Compress(content.data() + offset, size, compressed_data.data(), size - 1);
+			if (compressed_size > 0)
+			{
+				block.m_StoredSize	= static_cast<uint32>(compressed_size);
+				block.m_Flags		= BlockFlags::Compressed;
+				stream.write(reinterpret_cast<const char*>(compressed_data.data()), compressed_size);
+			}
+			else
+			{
+				block.m_StoredSize	= static_cast<uint32>(size);
+				block.m_Flags		= 0;
+				stream.write(reinterpret_cast<const char*>(content.data() + offset), size);
+			}
+		}
+	}
+
+	stream.seekp(header.m_BlocksOffset);
+	stream.write(reinterpret_cast<const char*>(blocks.data()), blocks.size() * sizeof(Block));
+
+	return stream.good();
+}
+
+bool PackFile::Mount(const std::string& inFile)
+{
+	std::unique_ptr<PackFile> pack_file = std::make_unique<PackFile>();
+	if (!pack_file->Open(inFile))
+		return false;
+
+	Trace("PackFile: Mounted %s, %u files", inFile.c_str(), pack_file->GetHeader().m_NumEntries);
+	GetMountedPacks().push_back(std::move(pack_file));
+	return true;
+}
+
+void PackFile::UnmountAll()
+{
+	GetMountedPacks().clear();
+}
+
+const PackFile* PackFile::FindMounted(std::string_view inPath, const Entry*& outEntry)
+{
+	for (const std::unique_ptr<PackFile>& pack_file : GetMountedPacks())
+	{
+		outEntry = pack_file->Find(inPath);
+		if (outEntry != nullptr)
+			return pack_file.get();
+	}
+
+	outEntry = nullptr;
+	return nullptr;
+}
+
+const Header& PackFile::GetHeader() const
+{
+	return *reinterpret_cast<const Header*>(m_File.GetData());
+}
+
+const Entry* PackFile::GetEntries() const
+{
+	return reinterpret_cast<const Entry*>(GetSection(GetHeader().m_EntriesOffset));
+}
+
+const Block* PackFile::GetBlocks() const
+{
+	return reinterpret_cast<const Block*>(GetSection(GetHeader().m_BlocksOffset));
+}
+
+const Byte* PackFile::GetSection(uint64 inOffset) const
+{
+	return static_cast<const Byte*>(m_File.GetData()) + inOffset;
+}
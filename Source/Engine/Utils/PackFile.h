@@ -0,0 +1,98 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Utils/MappedFile.h"
+
+// Layout of pack files (.apak), written by the AssetPacker tool.
+// Each file is split into blocks of m_BlockSize bytes compressed independently, so any range of a file
+// is read by decompressing only the blocks it overlaps. Entries are sorted by path hash for binary search.
+// Sections are aligned on PackFileFormat::Alignment bytes from the start of the file.
+namespace PackFileFormat
+{
+	constexpr uint32 Magic				= 0x4B415041; // "APAK"
+	constexpr uint32 Version			= 1;
+	constexpr uint32 Alignment			= 16;
+	constexpr uint32 DefaultBlockSize	= 64 * 1024;
+
+	enum BlockFlags : uint32
+	{
+		Compressed = 1 << 0,		// Stored as is otherwise, compression didn't make it smaller
+	};
+
+	struct Header
+	{
+		uint32	m_Magic;
+		uint32	m_Version;
+		uint32	m_BlockSize;
+		uint32	m_NumEntries;
+		uint64	m_NumBlocks;
+
+		uint64	m_EntriesOffset;
+		uint64	m_BlocksOffset;
+		uint64	m_StringsOffset;
+		uint64	m_StringsSize;
+	};
+
+	struct Entry
+	{
+		uint64	m_PathHash;			// HashPath of the path
+		uint64	m_Size;				// Decompressed
+		uint64	m_FirstBlock;		// The file has (m_Size + m_BlockSize - 1) / m_BlockSize consecutive blocks
+
+		uint32	m_PathOffset;		// Normalized path, to resolve hash collisions
+		uint32	m_PathLength;
+	};
+
+	struct Block
+	{
+		uint64	m_Offset;			// From the start of the pack file
+		uint32	m_StoredSize;
+		uint32	m_Flags;			// BlockFlags
+	};
+
+	// Lower case with '/' separators, like paths are compared on Windows. "Data\\LightBulb.obj" and "data/lightbulb.obj" are the same file
+	std::string		NormalizePath(std::string_view inPath);
+	// FNV-1a of the normalized path
+	uint64			HashPath(std::string_view inPath);
+}
+
+class PackFile final
+{
+public:
+	// Read only: the pack is memory mapped and blocks are decompressed straight from the mapping
+	bool			Open(const std::string& inFile);
+	void			Close();
+
+	const PackFileFormat::Entry*	Find(std::string_view inPath) const;
+
+	// Decompress [inOffset, inOffset + inSize[ of a file. Blocks are decompressed in parallel by the job system for big reads
+	bool			Read(const PackFileFormat::Entry& inEntry, uint64 inOffset, uint64 inSize, void* outData) const;
+
+	inline bool		IsOpen() const	{ return m_File.IsOpen(); }
+
+	// Write a pack containing inFiles, stored with their path as given
+	static bool		Write(const std::string& inPackFile, const std::vector<std::string>& inFiles,
+						  uint32 inBlockSize = PackFileFormat::DefaultBlockSize);
+
+	// Mounted packs are searched by FileReader and AsyncIO before the disk.
+	// Mount and unmount when no file is being read, at load time
+	static bool		Mount(const std::string& inFile);
+	static void		UnmountAll();
+	// First mounted pack containing inPath, or nullptr
+	static const PackFile*	FindMounted(std::string_view inPath, const PackFileFormat::Entry*& outEntry);
+
+private:
+	const PackFileFormat::Header&	GetHeader() const;
+	const PackFileFormat::Entry*	GetEntries() const;
+	const PackFileFormat::Block*	GetBlocks() const;
+	const Byte*						GetSection(uint64 inOffset) const;
+
+	// Decompress one block. outData receives the decompressed block starting at inOffsetInBlock
+	bool			ReadBlock(uint64 inBlock, uint64 inBlockSize, uint64 inOffsetInBlock, uint64 inSize, Byte* outData) const;
+
+private:
+	MappedFile		m_File;
+};
@@ -0,0 +1,138 @@
+#include "Engine.h"
+#include "RadixSort.h"
+
+#include "Utils/JobSystem.h"
+
+#include <array>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+namespace RadixSort
+{
+	// 11 bits: 6 passes instead of 8, and a histogram still fits in L1
+	constexpr uint32 DigitBits	= 11;
+	constexpr uint32 NumBuckets	= 1u << DigitBits;
+	constexpr uint32 NumPasses	= (64 + DigitBits - 1) / DigitBits;
+
+	using Histogram = std::array<uint32, NumBuckets>;
+
+	static inline uint32 GetDigit(uint64 inKey, uint32 inPass)
+	{
+		return static_cast<uint32>(inKey >> (inPass * DigitBits)) & (NumBuckets - 1);
+	}
+
+	// Call inFunction(chunk, begin, end) for every chunk of [0, inCount[. Chunks are the same for every call
+	template <typename Function>
+	static void ForEachChunk(size_t inNumChunks, size_t inCount, const Function& inFunction)
+	{
+		auto run_chunk = [&](size_t inChunk)
+		{
+			inFunction(inChunk, inCount * inChunk / inNumChunks, inCount * (inChunk + 1) / inNumChunks);
+		};
+
+		if (inNumChunks == 1)
+			run_chunk(0);
+		else
+			g_JobSystem.ParallelFor(inNumChunks, run_chunk);
+	}
+
+	void Sort(uint64* ioKeys, uint32* ioValues, size_t inCount, uint64* ioTempKeys, uint32* ioTempValues)
+	{
+		Assert(inCount <= std::numeric_limits<uint32>::max(), "Offsets are 32 bits");
+
+		if (inCount < 2)
+			return;
+
+		const size_t num_chunks = Math::Clamp<size_t>(inCount / MinKeysPerJob, 1, g_JobSystem.GetNumWorkers());
+
+		// Histograms of all digits in a single read. Their totals tell which passes have nothing to sort
+		std::vector<std::array<Histogram, NumPasses>> chunk_digit_histograms(num_chunks);
+		ForEachChunk(num_chunks, inCount, [&](size_t inChunk, size_t inBegin, size_t inEnd)
+		{
+			std::array<Histogram, NumPasses>& histograms = chunk_digit_histograms[inChunk];
+			for (size_t i = inBegin; i < inEnd; i++)
+			{
+				const uint64 key = ioKeys[i];
+				for (uint32 pass = 0; pass < NumPasses; pass++)
+					histograms[pass][GetDigit(key, pass)]++;
+			}
+		});
+
+		uint64* keys			= ioKeys;
+		uint32* values			= ioValues;
+		uint64* temp_keys		= ioTempKeys;
+		uint32* temp_values		= ioTempValues;
+		bool keys_have_moved	= false;
+
+		// Counts of the digit of the current pass in each chunk, then where each chunk writes each bucket
+		std::vector<Histogram> chunk_offsets(num_chunks);
+
+		for (uint32 pass = 0; pass < NumPasses; pass++)
+		{
+			bool is_single_bucket = false;
+			for (uint32 bucket = 0; bucket < NumBuckets && !is_single_bucket; bucket++)
+			{
+				size_t total = 0;
+				for (size_t chunk = 0; chunk < num_chunks; chunk++)
+					total += chunk_digit_histograms[chunk][pass][bucket];
+				is_single_bucket = (total == inCount);
+			}
+
+			if (is_single_bucket)
+				continue;
+
+			// The histograms of the first read only match the chunks until keys move
+			if (!keys_have_moved)
+			{
+				for (size_t chunk = 0; chunk < num_chunks; chunk++)
+					chunk_offsets[chunk] = chunk_digit_histograms[chunk][pass];
+			}
+			else
+			{
+				ForEachChunk(num_chunks, inCount, [&](size_t inChunk, size_t inBegin, size_t inEnd)
+				{
+					Histogram& histogram = chunk_offsets[inChunk];
+					histogram.fill(0);
+					for (size_t i = inBegin; i < inEnd; i++)
+						histogram[GetDigit(keys[i], pass)]++;
+				});
+			}
+
+			// Buckets in order, then chunks in order within a bucket. Keeps the sort stable
+			uint32 offset = 0;
+			for (uint32 bucket = 0; bucket < NumBuckets; bucket++)
+			{
+				for (size_t chunk = 0; chunk < num_chunks; chunk++)
+				{
+					const uint32 count			= chunk_offsets[chunk][bucket];
+					chunk_offsets[chunk][bucket]	= offset;
+					offset						+= count;
+				}
+			}
+
+			ForEachChunk(num_chunks, inCount, [&](size_t inChunk, size_t inBegin, size_t inEnd)
+			{
+				Histogram& offsets = chunk_offsets[inChunk];
+				for (size_t i = inBegin; i < inEnd; i++)
+				{
+					const uint64 key		= keys[i];
+					const uint32 position	= offsets[GetDigit(key, pass)]++;
+					temp_keys[position]		= key;
+					temp_values[position]	= values[i];
+				}
+			});
+
+			std::swap(keys, temp_keys);
+			std::swap(values, temp_values);
+			keys_have_moved = true;
+		}
+
+		// Odd number of passes, the result is in the scratch buffers
+		if (keys != ioKeys)
+		{
+			::memcpy(ioKeys, keys, inCount * sizeof(uint64));
+			::memcpy(ioValues, values, inCount * sizeof(uint32));
+		}
+	}
+}
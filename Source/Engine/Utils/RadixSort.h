@@ -0,0 +1,14 @@
+#pragma once
+
+// Least significant digit radix sort of 64 bit keys carrying a 32 bit value, for sort keys built every frame.
+// Keys and values are separate arrays so the counting passes stream through keys only. Digits that are the
+// same for every key are skipped, keys with few varying bits take few passes
+namespace RadixSort
+{
+	// Keys below this many per job are sorted on the calling thread
+	constexpr size_t MinKeysPerJob = 16384;
+
+	// Ascending and stable. ioTempKeys and ioTempValues are scratch buffers of inCount elements.
+	// Large arrays are split over the workers of g_JobSystem
+	void	Sort(uint64* ioKeys, uint32* ioValues, size_t inCount, uint64* ioTempKeys, uint32* ioTempValues);
+}
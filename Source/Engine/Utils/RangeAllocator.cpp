@@ -0,0 +1,142 @@
+#include "Engine.h"
+#include "RangeAllocator.h"
+
+RangeAllocator::RangeAllocator(uint64 inCapacity)
+{
+	Init(inCapacity);
+}
+
+void RangeAllocator::Init(uint64 inCapacity)
+{
+	m_FreeBlocksByOffset.clear();
+	m_FreeBlocksBySize.clear();
+
+	m_Capacity			= inCapacity;
+	m_UsedSize			= 0;
+	m_NumAllocations	= 0;
+
+	if (inCapacity > 0)
+		AddFreeBlock(0, inCapacity);
+}
+
+uint64 RangeAllocator::Allocate(uint64 inSize, uint64 inAlignment/* = 1*/)
+{
+	Assert(inSize > 0 && inAlignment > 0);
+
+	// Smallest block that fits. Alignment can push the range further in the block so bigger blocks may be needed
+	for (auto it = m_FreeBlocksBySize.lower_bound(inSize); it != m_FreeBlocksBySize.end(); ++it)
+	{
+		const uint64 block_offset	= it->second;
+		const uint64 block_size		= it->first;
+		const uint64 offset			= Math::AlignUp(block_offset, inAlignment);
+
+		if (offset + inSize > block_offset + block_size)
+			continue;
+
+		RemoveFreeBlock(m_FreeBlocksByOffset.find(block_offset));
+
+		// Give back what is left on both sides of the range
+		if (offset > block_offset)
+			AddFreeBlock(block_offset, offset - block_offset);
+
+		if (offset + inSize < block_offset + block_size)
+			AddFreeBlock(offset + inSize, block_offset + block_size - offset - inSize);
+
+		m_UsedSize += inSize;
+		m_NumAllocations++;
+
+		return offset;
+	}
+
+	return InvalidOffset;
+}
+
+void RangeAllocator::Free(uint64 inOffset, uint64 inSize)
+{
+	Assert(inSize > 0 && inOffset + inSize <= m_Capacity);
+	Assert(m_NumAllocations > 0 && m_UsedSize >= inSize);
+	Assert(IsAllocated(inOffset, inSize), "Range freed twice or overlapping a free block");
+
+	uint64 offset	= inOffset;
+	uint64 size		= inSize;
+
+	// Merge with the next free block
+	auto next = m_FreeBlocksByOffset.lower_bound(inOffset);
+	if (next != m_FreeBlocksByOffset.end() && next->first == inOffset + inSize)
+	{
+		size += next->second;
+		RemoveFreeBlock(next);
+	}
+
+	// Merge with the previous free block
+	auto previous = m_FreeBlocksByOffset.lower_bound(inOffset);
+	if (previous != m_FreeBlocksByOffset.begin())
+	{
+		--previous;
+		if (previous->first + previous->second == inOffset)
+		{
+			offset	= previous->first;
+			size	+= previous->second;
+			RemoveFreeBlock(previous);
+		}
+	}
+
+	AddFreeBlock(offset, size);
+
+	m_UsedSize -= inSize;
+	m_NumAllocations--;
+}
+
+bool RangeAllocator::IsAllocated(uint64 inOffset, uint64 inSize) const
+{
+	if (inSize == 0 || inOffset + inSize > m_Capacity)
+		return false;
+
+	// Free blocks never overlap, only the ones right before and after the range can touch it
+	auto next = m_FreeBlocksByOffset.lower_bound(inOffset);
+	if (next != m_FreeBlocksByOffset.end() && next->first < inOffset + inSize)
+		return false;
+
+	if (next != m_FreeBlocksByOffset.begin())
+	{
+		--next;
+		if (next->first + next->second > inOffset)
+			return false;
+	}
+
+	return true;
+}
+
+RangeAllocator::Statistics RangeAllocator::GetStatistics() const
+{
+	Statistics statistics;
+	statistics.m_Capacity			= m_Capacity;
+	statistics.m_UsedSize			= m_UsedSize;
+	statistics.m_LargestFreeBlock	= m_FreeBlocksBySize.empty() ? 0 : m_FreeBlocksBySize.rbegin()->first;
+	statistics.m_NumAllocations		= m_NumAllocations;
+	statistics.m_NumFreeBlocks		= static_cast<uint32>(m_FreeBlocksByOffset.size());
+
+	return statistics;
+}
+
+void RangeAllocator::AddFreeBlock(uint64 inOffset, uint64 inSize)
+{
+	m_FreeBlocksByOffset.emplace(inOffset, inSize);
+	m_FreeBlocksBySize.emplace(inSize, inOffset);
+}
+
+void RangeAllocator::RemoveFreeBlock(std::map<uint64, uint64>::iterator inBlock)
+{
+	// Several blocks can have the same size, find the one at this offset
+	auto range = m_FreeBlocksBySize.equal_range(inBlock->second);
+	for (auto it = range.first; it != range.second; ++it)
+	{
+		if (it->second == inBlock->first)
+		{
+			m_FreeBlocksBySize.erase(it);
+			break;
+		}
+	}
+
+	m_FreeBlocksByOffset.erase(inBlock);
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <map>
+
+// Best fit allocator of ranges in [0, capacity[. It never touches memory, the owner decides what offsets mean.
+// Adjacent free blocks are merged back when ranges are freed
+class RangeAllocator final
+{
+public:
+	static constexpr uint64 InvalidOffset = ~0ull;
+
+	struct Statistics
+	{
+		uint64	m_Capacity			= 0;
+		uint64	m_UsedSize			= 0;
+		uint64	m_LargestFreeBlock	= 0;
+		uint32	m_NumAllocations	= 0;
+		uint32	m_NumFreeBlocks		= 0;
+
+		inline uint64	GetFreeSize() const			{ return m_Capacity - m_UsedSize; }
+		// 0 when all the free space is contiguous, close to 1 when it is scattered in small blocks
+		inline float	GetFragmentation() const	{ return GetFreeSize() > 0 ? 1.0f - m_LargestFreeBlock / static_cast<float>(GetFreeSize()) : 0.0f; }
+	};
+
+public:
+	RangeAllocator() = default;
+	explicit RangeAllocator(uint64 inCapacity);
+
+	void		Init(uint64 inCapacity);
+
+	// Returns InvalidOffset when no free block is large enough. inAlignment doesn't need to be a power of two
+	uint64		Allocate(uint64 inSize, uint64 inAlignment = 1);
+	// inSize must be the size given to Allocate
+	void		Free(uint64 inOffset, uint64 inSize);
+
+	// False when the range overlaps a free block, e.g. it was already freed. Doesn't check it matches a single allocation
+	bool		IsAllocated(uint64 inOffset, uint64 inSize) const;
+
+	inline uint64		GetCapacity() const		{ return m_Capacity; }
+	inline uint64		GetUsedSize() const		{ return m_UsedSize; }
+	inline bool			IsEmpty() const			{ return m_NumAllocations == 0; }
+
+	Statistics			GetStatistics() const;
+
+private:
+	void		AddFreeBlock(uint64 inOffset, uint64 inSize);
+	void		RemoveFreeBlock(std::map<uint64, uint64>::iterator inBlock);
+
+private:
+	// Free blocks indexed by offset (for merging) and by size (for best fit)
+	std::map<uint64, uint64>		m_FreeBlocksByOffset;
+	std::multimap<uint64, uint64>	m_FreeBlocksBySize;
+
+	uint64		m_Capacity			= 0;
+	uint64		m_UsedSize			= 0;
+	uint32		m_NumAllocations	= 0;
+};
@@ -0,0 +1,91 @@
+#include "Engine.h"
+#include "RingAllocator.h"
+
+static inline bool IsPowerOfTwo(uint64 inValue)
+{
+	return inValue != 0 && (inValue & (inValue - 1)) == 0;
+}
+
+// Math::AlignUp divides, powers of two only need a mask
+static inline uint64 AlignUpPowerOfTwo(uint64 inValue, uint64 inAlignment)
+{
+	return (inValue + inAlignment - 1) & ~(inAlignment - 1);
+}
+
+RingAllocator::RingAllocator(uint64 inCapacity)
+{
+	Init(inCapacity);
+}
+
+void RingAllocator::Init(uint64 inCapacity)
+{
+	Assert(IsPowerOfTwo(inCapacity), "Ring capacity must be a power of two");
+
+	m_Head					= 0;
+	m_Tail					= 0;
+	m_NumFailedAllocations	= 0;
+	m_PendingFrames			= {};
+
+	m_Capacity				= inCapacity;
+	m_PeakUsedSize			= 0;
+}
+
+uint64 RingAllocator::Allocate(uint64 inSize, uint64 inAlignment/* = 1*/)
+{
+	Assert(inSize > 0 && inSize <= m_Capacity);
+	Assert(IsPowerOfTwo(inAlignment) && inAlignment <= m_Capacity, "Alignment must be a power of two no larger than the ring");
+
+	const uint64 tail = m_Tail.load(std::memory_order_relaxed);
+
+	uint64 head = m_Head.load(std::memory_order_relaxed);
+	for (;;)
+	{
+		uint64 begin = AlignUpPowerOfTwo(head, inAlignment);
+
+		// Ranges don't wrap around: start over at the beginning of the ring, the end of this lap is wasted
+		if ((begin & (m_Capacity - 1)) + inSize > m_Capacity)
+			begin = AlignUpPowerOfTwo(begin, m_Capacity);
+
+		const uint64 end = begin + inSize;
+		if (end - tail > m_Capacity)
+		{
+			m_NumFailedAllocations.fetch_add(1, std::memory_order_relaxed);
+			return InvalidOffset;
+		}
+
+		// Another thread moved the head, head is reloaded and the range computed again
+		if (m_Head.compare_exchange_weak(head, end, std::memory_order_relaxed))
+			return begin & (m_Capacity - 1);
+	}
+}
+
+void RingAllocator::EndFrame(uint64 inFenceValue)
+{
+	Assert(m_PendingFrames.empty() || m_PendingFrames.back().m_FenceValue <= inFenceValue, "Fence values must not go back");
+
+	const uint64 head = m_Head.load(std::memory_order_relaxed);
+	m_PendingFrames.push({ inFenceValue, head });
+
+	// The tail only moves in Reclaim, the ring is at its fullest here
+	m_PeakUsedSize = Math::Max(m_PeakUsedSize, head - m_Tail.load(std::memory_order_relaxed));
+}
+
+void RingAllocator::Reclaim(uint64 inCompletedFenceValue)
+{
+	while (!m_PendingFrames.empty() && m_PendingFrames.front().m_FenceValue <= inCompletedFenceValue)
+	{
+		m_Tail.store(m_PendingFrames.front().m_End, std::memory_order_relaxed);
+		m_PendingFrames.pop();
+	}
+}
+
+RingAllocator::Statistics RingAllocator::GetStatistics() const
+{
+	Statistics statistics;
+	statistics.m_Capacity				= m_Capacity;
+	statistics.m_UsedSize				= m_Head.load(std::memory_order_relaxed) - m_Tail.load(std::memory_order_relaxed);
+	statistics.m_PeakUsedSize			= m_PeakUsedSize;
+	statistics.m_NumPendingFrames		= static_cast<uint32>(m_PendingFrames.size());
+	statistics.m_NumFailedAllocations	= m_NumFailedAllocations.load(std::memory_order_relaxed);
+	return statistics;
+}
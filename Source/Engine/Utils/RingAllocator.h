@@ -0,0 +1,60 @@
+#pragma once
+
+#include <atomic>
+#include <queue>
+
+// Linear allocator of ranges in a ring of [0, capacity[, for data written once per frame. Like RangeAllocator it
+// never touches memory. Ranges are never freed one by one: EndFrame tags everything allocated so far with the fence
+// value of the frame, Reclaim gives it back once that fence is complete.
+// Allocate is lock free and can be called from several threads. EndFrame and Reclaim must not run at the same time as it
+class RingAllocator final
+{
+public:
+	static constexpr uint64 InvalidOffset = ~0ull;
+
+	struct Statistics
+	{
+		uint64	m_Capacity				= 0;
+		uint64	m_UsedSize				= 0;	// Allocated and not reclaimed yet, padding included
+		uint64	m_PeakUsedSize			= 0;	// Largest used size seen at the end of a frame
+		uint32	m_NumPendingFrames		= 0;	// Ended and waiting for their fence
+		uint32	m_NumFailedAllocations	= 0;
+	};
+
+public:
+	RingAllocator() = default;
+	explicit RingAllocator(uint64 inCapacity);
+
+	// inCapacity must be a power of two. Everything allocated before is forgotten
+	void		Init(uint64 inCapacity);
+
+	// Returns InvalidOffset when the ring is full. inAlignment must be a power of two no larger than the capacity.
+	// A range never wraps around the end of the ring, the end is skipped when it's too small
+	uint64		Allocate(uint64 inSize, uint64 inAlignment = 1);
+
+	// Everything allocated since the last EndFrame is in use until inFenceValue is complete
+	void		EndFrame(uint64 inFenceValue);
+	// Give back the frames whose fence value is at most inCompletedFenceValue
+	void		Reclaim(uint64 inCompletedFenceValue);
+
+	inline uint64		GetCapacity() const		{ return m_Capacity; }
+	Statistics			GetStatistics() const;
+
+private:
+	struct PendingFrame
+	{
+		uint64	m_FenceValue;
+		uint64	m_End;
+	};
+
+	// Positions grow forever, the offset in the ring is the position modulo the capacity.
+	// Everything in [tail, head[ is in use
+	std::atomic<uint64>			m_Head					= 0;
+	std::atomic<uint64>			m_Tail					= 0;
+	std::atomic<uint32>			m_NumFailedAllocations	= 0;
+
+	std::queue<PendingFrame>	m_PendingFrames;
+
+	uint64		m_Capacity			= 0;
+	uint64		m_PeakUsedSize		= 0;
+};
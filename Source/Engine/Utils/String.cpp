@@ -0,0 +1,677 @@
+#include "Engine.h"
+#include "String.h"
+
+#include <charconv>
+#include <cstdlib>
+#include <cstring>
+#include <istream>
+#include <limits>
+
+#if defined(_MSC_VER)
+	#include <intrin.h>
+#endif
+
+namespace String
+{
+	// Powers of 5 from 5^SmallestPowerOfTen to 5^LargestPowerOfTen, normalized to 128 bits.
+	// Any float mantissa of up to 19 digits times a power of ten outside of this range is 0 or infinity
+	static constexpr int32 SmallestPowerOfTen	= -65;
+	static constexpr int32 LargestPowerOfTen	= 38;
+
+	static const uint64 s_PowersOfFive[LargestPowerOfTen - SmallestPowerOfTen + 1][2] =
+	{
+		{ 0x86CCBB52EA94BAEA, 0x98E947129FC2B4E9 },	// 5^-65
+		{ 0xA87FEA27A539E9A5, 0x3F2398D747B36224 },	// 5^-64
+		{ 0xD29FE4B18E88640E, 0x8EEC7F0D19A03AAD },	// 5^-63
+		{ 0x83A3EEEEF9153E89, 0x1953CF68300424AC },	// 5^-62
+		{ 0xA48CEAAAB75A8E2B, 0x5FA8C3423C052DD7 },	// 5^-61
+		{ 0xCDB02555653131B6, 0x3792F412CB06794D },	// 5^-60
+		{ 0x808E17555F3EBF11, 0xE2BBD88BBEE40BD0 },	// 5^-59
+		{ 0xA0B19D2AB70E6ED6, 0x5B6ACEAEAE9D0EC4 },	// 5^-58
+		{ 0xC8DE047564D20A8B, 0xF245825A5A445275 },	// 5^-57
+		{ 0xFB158592BE068D2E, 0xEED6E2F0F0D56712 },	// 5^-56
+		{ 0x9CED737BB6C4183D, 0x55464DD69685606B },	// 5^-55
+		{ 0xC428D05AA4751E4C, 0xAA97E14C3C26B886 },	// 5^-54
+		{ 0xF53304714D9265DF, 0xD53DD99F4B3066A8 },	// 5^-53
+		{ 0x993FE2C6D07B7FAB, 0xE546A8038EFE4029 },	// 5^-52
+		{ 0xBF8FDB78849A5F96, 0xDE98520472BDD033 },	// 5^-51
+		{ 0xEF73D256A5C0F77C, 0x963E66858F6D4440 },	// 5^-50
+		{ 0x95A8637627989AAD, 0xDDE7001379A44AA8 },	// 5^-49
+		{ 0xBB127C53B17EC159, 0x5560C018580D5D52 },	// 5^-48
+		{ 0xE9D71B689DDE71AF, 0xAAB8F01E6E10B4A6 },	// 5^-47
+		{ 0x9226712162AB070D, 0xCAB3961304CA70E8 },	// 5^-46
+		{ 0xB6B00D69BB55C8D1, 0x3D607B97C5FD0D22 },	// 5^-45
+		{ 0xE45C10C42A2B3B05, 0x8CB89A7DB77C506A },	// 5^-44
+		{ 0x8EB98A7A9A5B04E3, 0x77F3608E92ADB242 },	// 5^-43
+		{ 0xB267ED1940F1C61C, 0x55F038B237591ED3 },	// 5^-42
+		{ 0xDF01E85F912E37A3, 0x6B6C46DEC52F6688 },	// 5^-41
+		{ 0x8B61313BBABCE2C6, 0x2323AC4B3B3DA015 },	// 5^-40
+		{ 0xAE397D8AA96C1B77, 0xABEC975E0A0D081A },	// 5^-39
+		{ 0xD9C7DCED53C72255, 0x96E7BD358C904A21 },	// 5^-38
+		{ 0x881CEA14545C7575, 0x7E50D64177DA2E54 },	// 5^-37
+		{ 0xAA242499697392D2, 0xDDE50BD1D5D0B9E9 },	// 5^-36
+		{ 0xD4AD2DBFC3D07787, 0x955E4EC64B44E864 },	// 5^-35
+		{ 0x84EC3C97DA624AB4, 0xBD5AF13BEF0B113E },	// 5^-34
+		{ 0xA6274BBDD0FADD61, 0xECB1AD8AEACDD58E },	// 5^-33
+		{ 0xCFB11EAD453994BA, 0x67DE18EDA5814AF2 },	// 5^-32
+		{ 0x81CEB32C4B43FCF4, 0x80EACF948770CED7 },	// 5^-31
+		{ 0xA2425FF75E14FC31, 0xA1258379A94D028D },	// 5^-30
+		{ 0xCAD2F7F5359A3B3E, 0x096EE45813A04330 },	// 5^-29
+		{ 0xFD87B5F28300CA0D, 0x8BCA9D6E188853FC },	// 5^-28
+		{ 0x9E74D1B791E07E48, 0x775EA264CF55347E },	// 5^-27
+		{ 0xC612062576589DDA, 0x95364AFE032A819E },	// 5^-26
+		{ 0xF79687AED3EEC551, 0x3A83DDBD83F52205 },	// 5^-25
+		{ 0x9ABE14CD44753B52, 0xC4926A9672793543 },	// 5^-24
+		{ 0xC16D9A0095928A27, 0x75B7053C0F178294 },	// 5^-23
+		{ 0xF1C90080BAF72CB1, 0x5324C68B12DD6339 },	// 5^-22
+		{ 0x971DA05074DA7BEE, 0xD3F6FC16EBCA5E04 },	// 5^-21
+		{ 0xBCE5086492111AEA, 0x88F4BB1CA6BCF585 },	// 5^-20
+		{ 0xEC1E4A7DB69561A5, 0x2B31E9E3D06C32E6 },	// 5^-19
+		{ 0x9392EE8E921D5D07, 0x3AFF322E62439FD0 },	// 5^-18
+		{ 0xB877AA3236A4B449, 0x09BEFEB9FAD487C3 },	// 5^-17
+		{ 0xE69594BEC44DE15B, 0x4C2EBE687989A9B4 },	// 5^-16
+		{ 0x901D7CF73AB0ACD9, 0x0F9D37014BF60A11 },	// 5^-15
+		{ 0xB424DC35095CD80F, 0x538484C19EF38C95 },	// 5^-14
+		{ 0xE12E13424BB40E13, 0x2865A5F206B06FBA },	// 5^-13
+		{ 0x8CBCCC096F5088CB, 0xF93F87B7442E45D4 },	// 5^-12
+		{ 0xAFEBFF0BCB24AAFE, 0xF78F69A51539D749 },	// 5^-11
+		{ 0xDBE6FECEBDEDD5BE, 0xB573440E5A884D1C },	// 5^-10
+		{ 0x89705F4136B4A597, 0x31680A88F8953031 },	// 5^-9
+		{ 0xABCC77118461CEFC, 0xFDC20D2B36BA7C3E },	// 5^-8
+		{ 0xD6BF94D5E57A42BC, 0x3D32907604691B4D },	// 5^-7
+		{ 0x8637BD05AF6C69B5, 0xA63F9A49C2C1B110 },	// 5^-6
+		{ 0xA7C5AC471B478423, 0x0FCF80DC33721D54 },	// 5^-5
+		{ 0xD1B71758E219652B, 0xD3C36113404EA4A9 },	// 5^-4
+		{ 0x83126E978D4FDF3B, 0x645A1CAC083126EA },	// 5^-3
+		{ 0xA3D70A3D70A3D70A, 0x3D70A3D70A3D70A4 },	// 5^-2
+		{ 0xCCCCCCCCCCCCCCCC, 0xCCCCCCCCCCCCCCCD },	// 5^-1
+		{ 0x8000000000000000, 0x0000000000000000 },	// 5^0
+		{ 0xA000000000000000, 0x0000000000000000 },	// 5^1
+		{ 0xC800000000000000, 0x0000000000000000 },	// 5^2
+		{ 0xFA00000000000000, 0x0000000000000000 },	// 5^3
+		{ 0x9C40000000000000, 0x0000000000000000 },	// 5^4
+		{ 0xC350000000000000, 0x0000000000000000 },	// 5^5
+		{ 0xF424000000000000, 0x0000000000000000 },	// 5^6
+		{ 0x9896800000000000, 0x0000000000000000 },	// 5^7
+		{ 0xBEBC200000000000, 0x0000000000000000 },	// 5^8
+		{ 0xEE6B280000000000, 0x0000000000000000 },	// 5^9
+		{ 0x9502F90000000000, 0x0000000000000000 },	// 5^10
+		{ 0xBA43B74000000000, 0x0000000000000000 },	// 5^11
+		{ 0xE8D4A51000000000, 0x0000000000000000 },	// 5^12
+		{ 0x9184E72A00000000, 0x0000000000000000 },	// 5^13
+		{ 0xB5E620F480000000, 0x0000000000000000 },	// 5^14
+		{ 0xE35FA931A0000000, 0x0000000000000000 },	// 5^15
+		{ 0x8E1BC9BF04000000, 0x0000000000000000 },	// 5^16
+		{ 0xB1A2BC2EC5000000, 0x0000000000000000 },	// 5^17
+		{ 0xDE0B6B3A76400000, 0x0000000000000000 },	// 5^18
+		{ 0x8AC7230489E80000, 0x0000000000000000 },	// 5^19
+		{ 0xAD78EBC5AC620000, 0x0000000000000000 },	// 5^20
+		{ 0xD8D726B7177A8000, 0x0000000000000000 },	// 5^21
+		{ 0x878678326EAC9000, 0x0000000000000000 },	// 5^22
+		{ 0xA968163F0A57B400, 0x0000000000000000 },	// 5^23
+		{ 0xD3C21BCECCEDA100, 0x0000000000000000 },	// 5^24
+		{ 0x84595161401484A0, 0x0000000000000000 },	// 5^25
+		{ 0xA56FA5B99019A5C8, 0x0000000000000000 },	// 5^26
+		{ 0xCECB8F27F4200F3A, 0x0000000000000000 },	// 5^27
+		{ 0x813F3978F8940984, 0x4000000000000000 },	// 5^28
+		{ 0xA18F07D736B90BE5, 0x5000000000000000 },	// 5^29
+		{ 0xC9F2C9CD04674EDE, 0xA400000000000000 },	// 5^30
+		{ 0xFC6F7C4045812296, 0x4D00000000000000 },	// 5^31
+		{ 0x9DC5ADA82B70B59D, 0xF020000000000000 },	// 5^32
+		{ 0xC5371912364CE305, 0x6C28000000000000 },	// 5^33
+		{ 0xF684DF56C3E01BC6, 0xC732000000000000 },	// 5^34
+		{ 0x9A130B963A6C115C, 0x3C7F400000000000 },	// 5^35
+		{ 0xC097CE7BC90715B3, 0x4B9F100000000000 },	// 5^36
+		{ 0xF0BDC21ABB48DB20, 0x1E86D40000000000 },	// 5^37
+		{ 0x96769950B50D88F4, 0x1314448000000000 },	// 5^38
+	};
+
+	static const uint64 s_PowersOfTen[] =
+	{
+		1ull, 10ull, 100ull, 1000ull, 10000ull, 100000ull, 1000000ull, 10000000ull, 100000000ull, 1000000000ull,
+		10000000000ull, 100000000000ull, 1000000000000ull, 10000000000000ull, 100000000000000ull,
+		1000000000000000ull, 10000000000000000ull, 100000000000000000ull, 1000000000000000000ull, 10000000000000000000ull
+	};
+
+	// Powers of ten that are exact floats
+	static const float s_ExactPowersOfTen[] =
+	{
+		1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f, 1e10f
+	};
+
+	// Digits of a number written in decimal: value = m_Mantissa * 10^m_Exponent
+	struct DecimalNumber
+	{
+		uint64		m_Mantissa			= 0;
+		int64		m_Exponent			= 0;
+		bool		m_Negative			= false;
+		// More than 19 significant digits. m_Mantissa only holds the first ones, the value is above m_Mantissa * 10^m_Exponent
+		bool		m_Truncated			= false;
+
+		// For the slow path
+		const char*	m_IntegerBegin		= nullptr;
+		const char*	m_IntegerEnd		= nullptr;
+		const char*	m_FractionBegin		= nullptr;
+		const char*	m_FractionEnd		= nullptr;
+		int64		m_ExplicitExponent	= 0;
+	};
+
+	static inline uint32 CountLeadingZeros(uint64 inValue)
+	{
+#if defined(_MSC_VER)
+		unsigned long index;
+		_BitScanReverse64(&index, inValue);
+		return 63 - index;
+#else
+		return __builtin_clzll(inValue);
+#endif
+	}
+
+	static inline uint32 CountTrailingZeros(uint64 inValue)
+	{
+#if defined(_MSC_VER)
+		unsigned long index;
+		_BitScanForward64(&index, inValue);
+		return index;
+#else
+		return __builtin_ctzll(inValue);
+#endif
+	}
+
+	// Full 64x64 bits product. Returns the low bits
+	static inline uint64 Multiply128(uint64 inA, uint64 inB, uint64& outHigh)
+	{
+#if defined(_MSC_VER)
+		return _umul128(inA, inB, &outHigh);
+#else
+		const unsigned __int128 product = static_cast<unsigned __int128>(inA) * inB;
+		outHigh = static_cast<uint64>(product >> 64);
+		return static_cast<uint64>(product);
+#endif
+	}
+
+	static inline bool IsDigit(char inChar)
+	{
+		return static_cast<uint8>(inChar - '0') < 10;
+	}
+
+	// SWAR (SIMD within a register) helpers working on 8 characters loaded in a uint64.
+	// Little endian: the first character is the lowest byte
+	static inline uint64 LoadDigits(const char* inChars)
+	{
+		uint64 chars;
+		::memcpy(&chars, inChars, sizeof(chars));
+
+		// '0'..'9' become 0..9
+		return chars ^ 0x3030303030303030ull;
+	}
+
+	// Number of digits at the start of inDigits
+	static inline uint32 CountDigits(uint64 inDigits)
+	{
+		// Bytes that were not digits have a bit set in their high nibble once 6 is added.
+		// Carries only go towards the following characters so the first non digit is always found
+		const uint64 non_digits = (inDigits | (inDigits + 0x0606060606060606ull)) & 0xF0F0F0F0F0F0F0F0ull;
+		return (non_digits == 0) ? 8 : CountTrailingZeros(non_digits) / 8;
+	}
+
+	// Value of 8 digits at once
+	static inline uint32 ParseEightDigits(uint64 inDigits)
+	{
+		uint64 value = (inDigits * 10) + (inDigits >> 8);
+		value = (((value & 0x000000FF000000FFull) * (100 + (1000000ull << 32))) +
+				 (((value >> 16) & 0x000000FF000000FFull) * (1 + (10000ull << 32)))) >> 32;
+		return static_cast<uint32>(value);
+	}
+
+	// Accumulate the digits at ioCursor into ioValue and move the cursor past them.
+	// The value wraps around after 19 digits, callers have to check how many digits were read
+	static inline void ParseDigits(const char*& ioCursor, const char* inEnd, uint64& ioValue)
+	{
+		// Up to 8 digits at a time as long as 8 characters can be loaded. Covers the usual "-1.234567" in two steps
+		while (inEnd - ioCursor >= 8)
+		{
+			const uint64 digits		= LoadDigits(ioCursor);
+			const uint32 num_digits	= CountDigits(digits);
+			if (num_digits == 0)
+				return;
+
+			// Move the digits to the end, the characters before them become leading zeros
+			const uint64 value = ParseEightDigits((num_digits == 8) ? digits : (digits << (8 * (8 - num_digits))));
+
+			ioValue		= ioValue * s_PowersOfTen[num_digits] + value;
+			ioCursor	+= num_digits;
+
+			if (num_digits < 8)
+				return;
+		}
+
+		while (ioCursor < inEnd && IsDigit(*ioCursor))
+		{
+			ioValue = ioValue * 10 + static_cast<uint64>(*ioCursor - '0');
+			ioCursor++;
+		}
+	}
+
+	static const char* ParseDecimal(const char* inBegin, const char* inEnd, DecimalNumber& outNumber)
+	{
+		const char* cursor = inBegin;
+
+		outNumber.m_Negative = (cursor < inEnd && *cursor == '-');
+		if (outNumber.m_Negative)
+			cursor++;
+
+		uint64 mantissa = 0;
+
+		outNumber.m_IntegerBegin = cursor;
+		ParseDigits(cursor, inEnd, mantissa);
+		outNumber.m_IntegerEnd = cursor;
+
+		outNumber.m_FractionBegin	= cursor;
+		outNumber.m_FractionEnd		= cursor;
+		if (cursor < inEnd && *cursor == '.')
+		{
+			cursor++;
+			outNumber.m_FractionBegin = cursor;
+			ParseDigits(cursor, inEnd, mantissa);
+			outNumber.m_FractionEnd = cursor;
+		}
+
+		const int64 num_integer_digits	= outNumber.m_IntegerEnd - outNumber.m_IntegerBegin;
+		const int64 num_fraction_digits	= outNumber.m_FractionEnd - outNumber.m_FractionBegin;
+		if (num_integer_digits + num_fraction_digits == 0)
+			return inBegin;
+
+		// The exponent is only part of the number when digits follow
+		if (cursor < inEnd && (*cursor == 'e' || *cursor == 'E'))
+		{
+			const char* exponent_cursor = cursor + 1;
+
+			const bool negative_exponent = (exponent_cursor < inEnd && *exponent_cursor == '-');
+			if (exponent_cursor < inEnd && (*exponent_cursor == '-' || *exponent_cursor == '+'))
+				exponent_cursor++;
+
+			if (exponent_cursor < inEnd && IsDigit(*exponent_cursor))
+			{
+				int64 exponent = 0;
+				while (exponent_cursor < inEnd && IsDigit(*exponent_cursor))
+				{
+					// Saturate. Anything that large is 0 or infinity
+					if (exponent < 0x10000000)
+						exponent = exponent * 10 + (*exponent_cursor - '0');
+					exponent_cursor++;
+				}
+
+				outNumber.m_ExplicitExponent	= negative_exponent ? -exponent : exponent;
+				cursor							= exponent_cursor;
+			}
+		}
+
+		outNumber.m_Mantissa = mantissa;
+		outNumber.m_Exponent = outNumber.m_ExplicitExponent - num_fraction_digits;
+
+		int64 num_digits = num_integer_digits + num_fraction_digits;
+		if (num_digits > 19)
+		{
+			// Leading zeros are not significant
+			for (const char* digit = outNumber.m_IntegerBegin; digit < outNumber.m_FractionEnd && (*digit == '0' || *digit == '.'); digit++)
+			{
+				if (*digit == '0')
+					num_digits--;
+			}
+		}
+
+		if (num_digits > 19)
+		{
+			// Keep the first 19 significant digits, leading zeros don't change the value
+			constexpr uint64 MinNineteenDigits = 1000000000000000000ull;
+
+			outNumber.m_Truncated	= true;
+			mantissa				= 0;
+
+			const char* digit = outNumber.m_IntegerBegin;
+			while (mantissa < MinNineteenDigits && digit < outNumber.m_IntegerEnd)
+				mantissa = mantissa * 10 + static_cast<uint64>(*digit++ - '0');
+
+			if (mantissa >= MinNineteenDigits)
+			{
+				outNumber.m_Exponent = outNumber.m_ExplicitExponent + (outNumber.m_IntegerEnd - digit);
+			}
+			else
+			{
+				digit = outNumber.m_FractionBegin;
+				while (mantissa < MinNineteenDigits && digit < outNumber.m_FractionEnd)
+					mantissa = mantissa * 10 + static_cast<uint64>(*digit++ - '0');
+
+				outNumber.m_Exponent = outNumber.m_ExplicitExponent - (digit - outNumber.m_FractionBegin);
+			}
+
+			outNumber.m_Mantissa = mantissa;
+		}
+
+		return cursor;
+	}
+
+	// Eisel-Lemire: bits of the float closest to inMantissa * 10^inExponent, without the sign.
+	// Returns false in the rare cases where the 128 bits approximation of the power of ten can't decide the rounding
+	static bool ComputeFloatBits(uint64 inMantissa, int64 inExponent, uint32& outBits)
+	{
+		constexpr int32 MantissaBits	= 23;
+		constexpr int32 MinimumExponent	= -127;
+		constexpr int32 InfinitePower	= 0xFF;
+
+		if (inMantissa == 0 || inExponent < SmallestPowerOfTen)
+		{
+			outBits = 0;
+			return true;
+		}
+
+		if (inExponent > LargestPowerOfTen)
+		{
+			outBits = static_cast<uint32>(InfinitePower) << MantissaBits;
+			return true;
+		}
+
+		const int32 q = static_cast<int32>(inExponent);
+
+		// Normalize the mantissa so its highest bit is set
+		const uint32 leading_zeros	= CountLeadingZeros(inMantissa);
+		const uint64 mantissa		= inMantissa << leading_zeros;
+
+		// Only the high bits of the product matter. The low half of the power of five is only needed when they are all set
+		const uint64* power_of_five = s_PowersOfFive[q - SmallestPowerOfTen];
+
+		uint64 high;
+		uint64 low = Multiply128(mantissa, power_of_five[0], high);
+
+		constexpr uint64 PrecisionMask = ~0ull >> (MantissaBits + 3);
+		if ((high & PrecisionMask) == PrecisionMask)
+		{
+			uint64 second_high;
+			Multiply128(mantissa, power_of_five[1], second_high);
+
+			low += second_high;
+			if (second_high > low)
+				high++;
+		}
+
+		// The product might be off by one ulp. Powers of ten in [-27, 55] are exact enough to never hit this
+		if (low == ~0ull && (q < -27 || q > 55))
+			return false;
+
+		const uint32 upper_bit	= static_cast<uint32>(high >> 63);
+		const uint32 shift		= upper_bit + 64 - MantissaBits - 3;
+
+		uint64 result_mantissa	= high >> shift;
+		// ((152170 + 65536) * q) >> 16 is floor(q * log2(10)) in this range
+		int32 power2			= ((217706 * q) >> 16) + 63 + static_cast<int32>(upper_bit) - static_cast<int32>(leading_zeros) - MinimumExponent;
+
+		// Subnormals
+		if (power2 <= 0)
+		{
+			if (-power2 + 1 >= 64)
+			{
+				outBits = 0;
+				return true;
+			}
+
+			result_mantissa >>= -power2 + 1;
+			result_mantissa += (result_mantissa & 1);
+			result_mantissa >>= 1;
+
+			// Rounding can bring it back to the smallest normal, the OR then gives the right bits
+			power2	= (result_mantissa < (1ull << MantissaBits)) ? 0 : 1;
+			outBits	= static_cast<uint32>(result_mantissa) | (static_cast<uint32>(power2) << MantissaBits);
+			return true;
+		}
+
+		// Exactly halfway between two floats: round to even instead of up.
+		// Only possible for small powers of ten, where the product is exact
+		if (low <= 1 && q >= -17 && q <= 10 && (result_mantissa & 3) == 1)
+		{
+			if ((result_mantissa << shift) == high)
+				result_mantissa &= ~1ull;
+		}
+
+		result_mantissa += (result_mantissa & 1);
+		result_mantissa >>= 1;
+
+		if (result_mantissa >= (2ull << MantissaBits))
+		{
+			result_mantissa = 1ull << MantissaBits;
+			power2++;
+		}
+
+		result_mantissa &= ~(1ull << MantissaBits);
+
+		if (power2 >= InfinitePower)
+		{
+			power2			= InfinitePower;
+			result_mantissa	= 0;
+		}
+
+		outBits = static_cast<uint32>(result_mantissa) | (static_cast<uint32>(power2) << MantissaBits);
+		return true;
+	}
+
+	// Fallback for the numbers Eisel-Lemire can't round. Very rare, usually more than 19 digits exactly between two floats.
+	// Digits are rewritten without a decimal point so the locale used by strtof doesn't matter
+	static float ParseFloatSlow(const DecimalNumber& inNumber)
+	{
+		// Enough digits to tell apart any two halfway points between floats
+		constexpr int32 MaxDigits = 128;
+
+		char buffer[MaxDigits + 32];
+		int32 num_digits		= 0;
+		int64 exponent			= inNumber.m_ExplicitExponent - (inNumber.m_FractionEnd - inNumber.m_FractionBegin);
+		bool has_dropped_digits	= false;
+
+		auto append_digits = [&](const char* inBegin, const char* inEnd)
+		{
+			for (const char* digit = inBegin; digit < inEnd; digit++)
+			{
+				// Skip leading zeros
+				if (num_digits == 0 && *digit == '0')
+					continue;
+
+				if (num_digits < MaxDigits)
+				{
+					buffer[num_digits++] = *digit;
+				}
+				else
+				{
+					has_dropped_digits |= (*digit != '0');
+					exponent++;
+				}
+			}
+		};
+
+		append_digits(inNumber.m_IntegerBegin, inNumber.m_IntegerEnd);
+		append_digits(inNumber.m_FractionBegin, inNumber.m_FractionEnd);
+
+		if (num_digits == 0)
+			return 0.0f;
+
+		// A trailing 1 keeps the value strictly above the truncated digits
+		if (has_dropped_digits)
+		{
+			buffer[num_digits++] = '1';
+			exponent--;
+		}
+
+		buffer[num_digits++] = 'e';
+		char* exponent_end = std::to_chars(buffer + num_digits, buffer + sizeof(buffer) - 1, exponent).ptr;
+		*exponent_end = '\0';
+
+		return ::strtof(buffer, nullptr);
+	}
+
+	static inline bool MatchNoCase(const char* inBegin, const char* inEnd, const char* inLowerCaseWord)
+	{
+		const size_t length = ::strlen(inLowerCaseWord);
+		if (static_cast<size_t>(inEnd - inBegin) < length)
+			return false;
+
+		for (size_t i = 0; i < length; i++)
+		{
+			if ((inBegin[i] | 0x20) != inLowerCaseWord[i])
+				return false;
+		}
+
+		return true;
+	}
+
+	static const char* ParseInfinityOrNaN(const char* inBegin, const char* inEnd, float& outValue)
+	{
+		const char* cursor = inBegin;
+
+		const bool negative = (cursor < inEnd && *cursor == '-');
+		if (negative)
+			cursor++;
+
+		if (MatchNoCase(cursor, inEnd, "nan"))
+		{
+			outValue = negative ? -std::numeric_limits<float>::quiet_NaN() : std::numeric_limits<float>::quiet_NaN();
+			return cursor + 3;
+		}
+
+		if (MatchNoCase(cursor, inEnd, "inf"))
+		{
+			outValue = negative ? -std::numeric_limits<float>::infinity() : std::numeric_limits<float>::infinity();
+			return MatchNoCase(cursor, inEnd, "infinity") ? cursor + 8 : cursor + 3;
+		}
+
+		return inBegin;
+	}
+
+	const char* ParseFloat(const char* inBegin, const char* inEnd, float& outValue)
+	{
+		DecimalNumber number;
+		const char* end = ParseDecimal(inBegin, inEnd, number);
+		if (end == inBegin)
+			return ParseInfinityOrNaN(inBegin, inEnd, outValue);
+
+		float value;
+
+		// Clinger's fast path: the mantissa and the power of ten are exact floats, a single rounding happens
+		if (!number.m_Truncated && number.m_Mantissa <= (1ull << 24) && number.m_Exponent >= -10 && number.m_Exponent <= 10)
+		{
+			value = static_cast<float>(number.m_Mantissa);
+			if (number.m_Exponent < 0)
+				value /= s_ExactPowersOfTen[-number.m_Exponent];
+			else
+				value *= s_ExactPowersOfTen[number.m_Exponent];
+		}
+		else
+		{
+			uint32 bits			= 0;
+			bool is_rounded		= ComputeFloatBits(number.m_Mantissa, number.m_Exponent, bits);
+
+			// Truncated digits: the value is between m_Mantissa and m_Mantissa + 1, both must round the same way
+			if (is_rounded && number.m_Truncated)
+			{
+				uint32 upper_bits = 0;
+				is_rounded = ComputeFloatBits(number.m_Mantissa + 1, number.m_Exponent, upper_bits) && upper_bits == bits;
+			}
+
+			if (is_rounded)
+				::memcpy(&value, &bits, sizeof(value));
+			else
+				value = ParseFloatSlow(number);
+		}
+
+		outValue = number.m_Negative ? -value : value;
+		return end;
+	}
+
+	const char* ParseInt(const char* inBegin, const char* inEnd, int32& outValue)
+	{
+		const char* cursor = inBegin;
+
+		const bool negative = (cursor < inEnd && *cursor == '-');
+		if (negative)
+			cursor++;
+
+		const char* digits_begin = cursor;
+
+		uint64 value = 0;
+		ParseDigits(cursor, inEnd, value);
+
+		if (cursor == digits_begin)
+			return inBegin;
+
+		// Leading zeros don't count towards the 10 digits of an int32. Below that the value can't have wrapped
+		while (digits_begin < cursor - 1 && *digits_begin == '0')
+			digits_begin++;
+
+		const uint64 max_value = negative ? 2147483648ull : 2147483647ull;
+		if (cursor - digits_begin > 10 || value > max_value)
+			return inBegin;
+
+		outValue = static_cast<int32>(negative ? -static_cast<int64>(value) : static_cast<int64>(value));
+		return cursor;
+	}
+
+	float ToFloat(std::string_view inStr)
+	{
+		float value = 0.0f;
+		const char* end = ParseFloat(inStr.data(), inStr.data() + inStr.size(), value);
+		Assert(!inStr.empty() && end == inStr.data() + inStr.size(), "Not a float");
+
+		return value;
+	}
+
+	int ToInt(std::string_view inStr)
+	{
+		int32 value = 0;
+		const char* end = ParseInt(inStr.data(), inStr.data() + inStr.size(), value);
+		Assert(!inStr.empty() && end == inStr.data() + inStr.size(), "Not an int");
+
+		return value;
+	}
+
+	std::vector<std::string> Split(const std::string& inStr, const std::string& inDelimiter)
+	{
+		std::vector<std::string> result;
+		for (std::string_view part : SplitView(inStr, inDelimiter))
+			result.emplace_back(part);
+
+		return result;
+	}
+
+	std::istream& GetLine(std::istream& inStream, std::string& outLine)
+	{
+		outLine.clear();
+
+		// The characters in the stream are read one-by-one using a std::streambuf.
+		// That is faster than reading them one-by-one using the std::istream.
+		// Code that uses streambuf this way must be guarded by a sentry object.
+		// The sentry object performs various tasks,
+		// such as thread synchronization and updating the stream state.
+
+		std::istream::sentry se(inStream, true);
+		std::streambuf* stream_buffer = inStream.rdbuf();
+
+		// Go through each character one by one to find and handle delimiters
+		for (;;)
+		{
+			int c = stream_buffer->sbumpc();
+			switch (c)
+			{
+			case '\n':
+				return inStream;
+			case '\r':
+				if (stream_buffer->sgetc() == '\n')
+					stream_buffer->sbumpc();
+				return inStream;
+			case std::streambuf::traits_type::eof():
+				// Also handle the case when the last line has no line ending
+				if (outLine.empty())
+					inStream.setstate(std::ios::eofbit);
+				return inStream;
+			default:
+				outLine += (char) c;
+			}
+		}
+	}
+}
@@ -1,78 +1,240 @@
 #pragma once
 
+#include <cstring>
+#include <iterator>
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace String
 {
-	// Convert string to float
-	float ToFloat(const std::string& inStr)
+	// Parse a number at the start of [inBegin, inEnd[ with std::from_chars semantics:
+	// no leading spaces or '+', locale independent, never reads past inEnd.
+	// Returns the end of the number, or inBegin if there is no number to parse. outValue is then left untouched.
+	// Floats are correctly rounded. Also accepts inf, infinity and nan (case insensitive)
+	const char*	ParseFloat(const char* inBegin, const char* inEnd, float& outValue);
+	// Out of range integers are not parsed
+	const char*	ParseInt(const char* inBegin, const char* inEnd, int32& outValue);
+
+	// Convert string to float. The whole string must be a number
+	float ToFloat(std::string_view inStr);
+
+	// Convert string to int. The whole string must be a number
+	int ToInt(std::string_view inStr);
+
+	// Split string into multiple strings using delimiter
+	std::vector<std::string> Split(const std::string& inStr, const std::string& inDelimiter);
+
+	// TODO: Shoundn't be in String.h but oh well
+	// https://stackoverflow.com/questions/6089231/getting-std-ifstream-to-handle-lf-cr-and-crlf
+	std::istream& GetLine(std::istream& inStream, std::string& outLine);
+
+	// Find the end of the line starting at inCursor. LF, CR and CRLF all end a line, like GetLine.
+	// Returns the end of the line (excluding delimiters) and outputs where the next line starts
+	inline const char* FindLineEnd(const char* inCursor, const char* inEnd, const char*& outNextLine)
 	{
-		return std::stof(inStr);
+		const char* line_end = static_cast<const char*>(::memchr(inCursor, '\n', inEnd - inCursor));
+		if (line_end == nullptr)
+			line_end = inEnd;
+
+		// A lone CR also ends a line
+		const char* carriage_return = static_cast<const char*>(::memchr(inCursor, '\r', line_end - inCursor));
+		if (carriage_return != nullptr)
+		{
+			outNextLine = carriage_return + 1;
+			if (outNextLine < inEnd && *outNextLine == '\n')
+				outNextLine++;
+			return carriage_return;
+		}
+
+		outNextLine = (line_end < inEnd) ? line_end + 1 : inEnd;
+		return line_end;
 	}
 
-	// Convert string to int
-	int ToInt(const std::string& inStr)
+	// Lazy iterators over a buffer. They yield views inside of it and never allocate,
+	// the buffer must outlive them. Default constructed iterators are end iterators
+
+	// Lines without their delimiters. Unlike GetLine, a delimiter at the end of the buffer doesn't add an empty line
+	class LineIterator
 	{
-		return std::stoi(inStr);
-	}
+	public:
+		using iterator_category	= std::forward_iterator_tag;
+		using value_type		= std::string_view;
+		using difference_type	= std::ptrdiff_t;
+		using pointer			= const std::string_view*;
+		using reference			= const std::string_view&;
 
-	// Split string into multiple strings using delimiter
-	std::vector<std::string> Split(const std::string& inStr, const std::string& inDelimiter)
+		LineIterator() = default;
+		LineIterator(const char* inBegin, const char* inEnd) :
+			m_Next(inBegin),
+			m_End(inEnd)
+		{
+			++(*this);
+		}
+
+		inline reference	operator*() const	{ return m_Line; }
+		inline pointer		operator->() const	{ return &m_Line; }
+
+		LineIterator& operator++()
+		{
+			if (m_Next == nullptr || m_Next >= m_End)
+			{
+				*this = LineIterator();
+				return *this;
+			}
+
+			const char* next_line	= nullptr;
+			const char* line_end	= FindLineEnd(m_Next, m_End, next_line);
+
+			m_Line = std::string_view(m_Next, line_end - m_Next);
+			m_Next = next_line;
+			return *this;
+		}
+
+		inline LineIterator operator++(int)						{ LineIterator previous = *this; ++(*this); return previous; }
+		inline bool operator==(const LineIterator& inOther) const	{ return m_Line.data() == inOther.m_Line.data() && m_Next == inOther.m_Next; }
+		inline bool operator!=(const LineIterator& inOther) const	{ return !(*this == inOther); }
+
+	private:
+		std::string_view	m_Line;
+		const char*			m_Next	= nullptr;
+		const char*			m_End	= nullptr;
+	};
+
+	// Parts between occurrences of a delimiter, empty parts included. Same parts as Split
+	class SplitIterator
 	{
-		size_t pos_start	= 0;
-		size_t pos_end		= 0;
-		size_t delim_len	= inDelimiter.length();
+	public:
+		using iterator_category	= std::forward_iterator_tag;
+		using value_type		= std::string_view;
+		using difference_type	= std::ptrdiff_t;
+		using pointer			= const std::string_view*;
+		using reference			= const std::string_view&;
 
-		std::string token;
-		std::vector<std::string> result;
+		SplitIterator() = default;
+		SplitIterator(std::string_view inStr, std::string_view inDelimiter) :
+			m_Remaining(inStr),
+			m_Delimiter(inDelimiter),
+			m_IsEnd(false)
+		{
+			++(*this);
+		}
 
-		while ((pos_end = inStr.find(inDelimiter, pos_start)) != std::string::npos)
+		inline reference	operator*() const	{ return m_Part; }
+		inline pointer		operator->() const	{ return &m_Part; }
+
+		SplitIterator& operator++()
 		{
-			token = inStr.substr(pos_start, pos_end - pos_start);
-			pos_start = pos_end + delim_len;
-			result.push_back(token);
+			// The last part has been returned
+			if (m_Remaining.data() == nullptr)
+			{
+				*this = SplitIterator();
+				return *this;
+			}
+
+			const size_t delimiter_pos = m_Delimiter.empty() ? std::string_view::npos : m_Remaining.find(m_Delimiter);
+			if (delimiter_pos == std::string_view::npos)
+			{
+				m_Part		= m_Remaining;
+				m_Remaining	= std::string_view();
+			}
+			else
+			{
+				m_Part		= m_Remaining.substr(0, delimiter_pos);
+				m_Remaining	= m_Remaining.substr(delimiter_pos + m_Delimiter.size());
+			}
+
+			return *this;
 		}
 
-		result.push_back(inStr.substr(pos_start));
-		return result;
-	}
+		inline SplitIterator operator++(int)						{ SplitIterator previous = *this; ++(*this); return previous; }
+		inline bool operator==(const SplitIterator& inOther) const	{ return m_IsEnd == inOther.m_IsEnd && m_Part.data() == inOther.m_Part.data() && m_Remaining.data() == inOther.m_Remaining.data(); }
+		inline bool operator!=(const SplitIterator& inOther) const	{ return !(*this == inOther); }
 
-	// TODO: Shoundn't be in String.h but oh well
-	// https://stackoverflow.com/questions/6089231/getting-std-ifstream-to-handle-lf-cr-and-crlf
-	std::istream& GetLine(std::istream& inStream, std::string& outLine)
+	private:
+		std::string_view	m_Part;
+		std::string_view	m_Remaining;
+		std::string_view	m_Delimiter;
+		bool				m_IsEnd		= true;
+	};
+
+	// Non empty parts between any of the delimiter characters. Runs of delimiters count as one
+	class TokenIterator
 	{
-		outLine.clear();
+	public:
+		using iterator_category	= std::forward_iterator_tag;
+		using value_type		= std::string_view;
+		using difference_type	= std::ptrdiff_t;
+		using pointer			= const std::string_view*;
+		using reference			= const std::string_view&;
 
-		// The characters in the stream are read one-by-one using a std::streambuf.
-		// That is faster than reading them one-by-one using the std::istream.
-		// Code that uses streambuf this way must be guarded by a sentry object.
-		// The sentry object performs various tasks,
-		// such as thread synchronization and updating the stream state.
+		TokenIterator() = default;
+		TokenIterator(std::string_view inStr, std::string_view inDelimiters) :
+			m_Remaining(inStr),
+			m_Delimiters(inDelimiters)
+		{
+			++(*this);
+		}
 
-		std::istream::sentry se(inStream, true);
-		std::streambuf* stream_buffer = inStream.rdbuf();
+		inline reference	operator*() const	{ return m_Token; }
+		inline pointer		operator->() const	{ return &m_Token; }
 
-		// Go through each character one by one to find and handle delimiters
-		for (;;)
+		TokenIterator& operator++()
 		{
-			int c = stream_buffer->sbumpc();
-			switch (c)
+			const size_t token_start = m_Remaining.find_first_not_of(m_Delimiters);
+			if (token_start == std::string_view::npos)
 			{
-			case '\n':
-				return inStream;
-			case '\r':
-				if (stream_buffer->sgetc() == '\n')
-					stream_buffer->sbumpc();
-				return inStream;
-			case std::streambuf::traits_type::eof():
-				// Also handle the case when the last line has no line ending
-				if (outLine.empty())
-					inStream.setstate(std::ios::eofbit);
-				return inStream;
-			default:
-				outLine += (char) c;
+				*this = TokenIterator();
+				return *this;
 			}
+
+			const size_t token_end = m_Remaining.find_first_of(m_Delimiters, token_start);
+
+			m_Token		= m_Remaining.substr(token_start, token_end - token_start);
+			m_Remaining	= (token_end == std::string_view::npos) ? std::string_view() : m_Remaining.substr(token_end);
+			return *this;
 		}
+
+		inline TokenIterator operator++(int)						{ TokenIterator previous = *this; ++(*this); return previous; }
+		inline bool operator==(const TokenIterator& inOther) const	{ return m_Token.data() == inOther.m_Token.data(); }
+		inline bool operator!=(const TokenIterator& inOther) const	{ return !(*this == inOther); }
+
+	private:
+		std::string_view	m_Token;
+		std::string_view	m_Remaining;
+		std::string_view	m_Delimiters;
+	};
+
+	template<typename Iterator>
+	struct Range
+	{
+		Iterator	m_Begin;
+		Iterator	m_End;
+
+		inline Iterator	begin() const	{ return m_Begin; }
+		inline Iterator	end() const		{ return m_End; }
+	};
+
+	// Works directly on the content of a FileReader: Lines(content, content + size)
+	inline Range<LineIterator> Lines(const char* inBegin, const char* inEnd)
+	{
+		return { LineIterator(inBegin, inEnd), LineIterator() };
+	}
+
+	inline Range<LineIterator> Lines(std::string_view inText)
+	{
+		return Lines(inText.data(), inText.data() + inText.size());
+	}
+
+	// Allocation free version of Split
+	inline Range<SplitIterator> SplitView(std::string_view inStr, std::string_view inDelimiter)
+	{
+		return { SplitIterator(inStr, inDelimiter), SplitIterator() };
+	}
+
+	// Words separated by spaces or tabs
+	inline Range<TokenIterator> Tokens(std::string_view inStr, std::string_view inDelimiters = " \t")
+	{
+		return { TokenIterator(inStr, inDelimiters), TokenIterator() };
 	}
-}
\ No newline at end of file
+}
@@ -0,0 +1,89 @@
+#include "Engine.h"
+
+#include "Utils/PackFile.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+// Packs loose files into a pack file (.apak) mounted by the engine with PackFile::Mount.
+// Paths are stored as given, run it from the directory the engine runs from:
+//		AssetPacker Data.apak Data
+// then "Data\\LightBulb.obj" is found in the pack.
+
+static void PrintUsage()
+{
+	printf("Usage: AssetPacker <output.apak> <file or directory>... [-block-size <KB>]\n");
+	printf("\tDirectories are packed recursively. Default block size is %u KB\n", PackFileFormat::DefaultBlockSize / 1024);
+}
+
+int main(int inArgc, char** inArgv)
+{
+	std::string					pack_file;
+	std::vector<std::string>	inputs;
+	uint32						block_size = PackFileFormat::DefaultBlockSize;
+
+	for (int i = 1; i < inArgc; i++)
+	{
+		if (std::strcmp(inArgv[i], "-block-size") == 0 && i + 1 < inArgc)
+			block_size = static_cast<uint32>(std::strtoul(inArgv[++i], nullptr, 10)) * 1024;
+		else if (pack_file.empty())
+			pack_file = inArgv[i];
+		else
+			inputs.push_back(inArgv[i]);
+	}
+
+	if (pack_file.empty() || inputs.empty() || block_size == 0)
+	{
+		PrintUsage();
+		return -1;
+	}
+
+	std::vector<std::string> files;
+	for (const std::string& input : inputs)
+	{
+		std::error_code error_code;
+		if (std::filesystem::is_directory(input, error_code))
+		{
+			for (const auto& directory_entry : std::filesystem::recursive_directory_iterator(input, error_code))
+			{
+				// Don't pack a previous pack written in the same directory
+				if (directory_entry.is_regular_file() && !std::filesystem::equivalent(directory_entry.path(), pack_file, error_code))
+					files.push_back(directory_entry.path().string());
+			}
+		}
+		else if (std::filesystem::is_regular_file(input, error_code))
+		{
+			files.push_back(input);
+		}
+		else
+		{
+			printf("Can't find %s\n", input.c_str());
+			return -2;
+		}
+	}
+
+	// Same pack for the same inputs
+	std::sort(files.begin(), files.end());
+
+	uint64 loose_size = 0;
+	for (const std::string& file : files)
+		loose_size += std::filesystem::file_size(file);
+
+	if (!PackFile::Write(pack_file, files, block_size))
+	{
+		printf("Failed to write %s\n", pack_file.c_str());
+		return -3;
+	}
+
+	const uint64 pack_size = std::filesystem::file_size(pack_file);
+	printf("Packed %zu files into %s: %llu bytes -> %llu bytes (%.1f%%)\n", files.size(), pack_file.c_str(),
+		   static_cast<unsigned long long>(loose_size), static_cast<unsigned long long>(pack_size),
+		   loose_size > 0 ? 100.0 * pack_size / loose_size : 100.0);
+
+	return 0;
+}
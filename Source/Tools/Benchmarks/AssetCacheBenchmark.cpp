@@ -0,0 +1,156 @@
+#include "Engine.h"
+#include "Benchmark.h"
+
+#include "Utils/AssetCache.h"
+#include "Utils/FileReader.h"
+#include "Utils/JobSystem.h"
+#include "Utils/MappedFile.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+// Cold cache: the key is computed, the source is imported and the result stored. Warm cache: the key is computed
+// and the baked file mapped. The importer parses vertex positions out of an OBJ-like file, which stands in for
+// MeshLoader, and the source has a material library dependency like real meshes
+
+static constexpr uint32 NumRuns			= 3;
+static constexpr uint32 ImporterVersion	= 1;
+
+struct BenchmarkAsset
+{
+	std::string		m_Source;
+	std::string		m_MaterialLibrary;
+};
+
+static bool ImportPositions(const std::string& inSource, std::vector<float>& outPositions)
+{
+	FileReader file_reader;
+	if (!file_reader.ReadFile(inSource, FileReadMode::Map))
+		return false;
+
+	const char* line = file_reader.GetContentAsString();
+	while (*line != '\0')
+	{
+		if (line[0] == 'v' && line[1] == ' ')
+		{
+			char* end = const_cast<char*>(line + 2);
+			for (int i = 0; i < 3; i++)
+				outPositions.push_back(strtof(end, &end));
+		}
+
+		line = strchr(line, '\n');
+		if (line == nullptr)
+			break;
+		line++;
+	}
+
+	return true;
+}
+
+static AssetCacheKey MakeKey(const BenchmarkAsset& inAsset)
+{
+	AssetCacheKey key("BenchmarkMesh", ImporterVersion);
+	key.AddValue(1.0f);		// Stands in for the import settings
+
+	const bool success = key.AddFile(inAsset.m_Source) && key.AddFile(inAsset.m_MaterialLibrary);
+	Assert(success);
+
+	return key;
+}
+
+// Returns the number of floats available to the caller, baked or read back from the cache
+static uint64 LoadThroughCache(const BenchmarkAsset& inAsset)
+{
+	const AssetCacheKey key = MakeKey(inAsset);
+
+	MappedFile baked_file;
+	if (baked_file.Open(g_AssetCache.GetPath(key, ".bin")))
+		return baked_file.GetSize() / sizeof(float);
+
+	std::vector<float> positions;
+	const bool imported = ImportPositions(inAsset.m_Source, positions);
+	Assert(imported);
+
+	g_AssetCache.Store(key, ".bin", [&positions](const std::string& inBakedFile)
+	{
+		std::ofstream file(inBakedFile, std::ios::binary);
+		file.write(reinterpret_cast<const char*>(positions.data()), static_cast<std::streamsize>(positions.size() * sizeof(float)));
+		return static_cast<bool>(file);
+	});
+
+	return positions.size();
+}
+
+BENCHMARK(AssetCacheColdAndWarm)
+{
+	g_JobSystem.Init();
+
+	std::error_code error_code;
+	const std::string directory			= GetBenchmarkDirectory() + "/AssetCacheColdAndWarm";
+	const std::string cache_directory	= directory + "/Cache";
+	std::filesystem::create_directories(directory, error_code);
+
+	g_AssetCache.Init(cache_directory);
+
+	const auto clear_cache = [&]()
+	{
+		std::filesystem::remove_all(cache_directory, error_code);
+		std::filesystem::create_directories(cache_directory, error_code);
+	};
+
+	const uint64 sizes[] = { 64 * 1024, 2 * 1024 * 1024, 32 * 1024 * 1024 };
+
+	std::vector<BenchmarkAsset> assets;
+	for (uint64 size : sizes)
+	{
+		BenchmarkAsset asset;
+		asset.m_Source			= directory + "/Mesh" + std::to_string(size / 1024) + "KB.obj";
+		asset.m_MaterialLibrary	= directory + "/Mesh" + std::to_string(size / 1024) + "KB.mtl";
+		WriteObjLikeFile(asset.m_Source, size, static_cast<uint32>(size));
+		std::ofstream(asset.m_MaterialLibrary) << "newmtl Default\nKd 0.8 0.8 0.8\n";
+		assets.push_back(asset);
+	}
+
+	printf("%u runs, the cache is emptied before each cold run\n", NumRuns);
+	printf("%-12s %20s %20s\n", "Source", "Cold (ms)", "Warm (ms)");
+
+	for (size_t i = 0; i < assets.size(); i++)
+	{
+		const BenchmarkAsset& asset = assets[i];
+
+		const BenchmarkTimings cold_timings = MeasureRuns(NumRuns, [&]() { LoadThroughCache(asset); }, clear_cache);
+		const BenchmarkTimings warm_timings = MeasureRuns(NumRuns, [&]() { LoadThroughCache(asset); });
+
+		char source[32];
+		char cold[64];
+		char warm[64];
+		snprintf(source, sizeof(source), "%llu KB", static_cast<unsigned long long>(sizes[i] / 1024));
+		snprintf(cold, sizeof(cold), "%.2f-%.2f", cold_timings.m_MinMs, cold_timings.m_MaxMs);
+		snprintf(warm, sizeof(warm), "%.2f-%.2f", warm_timings.m_MinMs, warm_timings.m_MaxMs);
+		printf("%-12s %20s %20s\n", source, cold, warm);
+	}
+
+	// Every asset baked by several jobs at once, the cache must end up with one valid file per asset
+	const BenchmarkTimings parallel_timings = MeasureRuns(NumRuns, [&]()
+	{
+		g_JobSystem.ParallelFor(assets.size() * 4, [&](size_t inIndex) { LoadThroughCache(assets[inIndex % assets.size()]); });
+	}, clear_cache);
+
+	for (const BenchmarkAsset& asset : assets)
+	{
+		std::vector<float> positions;
+		ImportPositions(asset.m_Source, positions);
+		const bool is_valid = LoadThroughCache(asset) == positions.size();
+		Assert(is_valid, "Concurrent bakes left a bad file in the cache");
+	}
+
+	printf("All assets baked 4 times concurrently on %u workers: %.2f-%.2f ms\n",
+		   g_JobSystem.GetNumWorkers(), parallel_timings.m_MinMs, parallel_timings.m_MaxMs);
+
+	std::filesystem::remove_all(directory, error_code);
+	g_JobSystem.Shutdown();
+}
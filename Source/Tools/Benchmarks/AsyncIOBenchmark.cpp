@@ -0,0 +1,108 @@
+#include "Engine.h"
+#include "Benchmark.h"
+
+#include "Utils/AsyncIO.h"
+#include "Utils/FileReader.h"
+
+#include <cstdio>
+#include <filesystem>
+#include <random>
+
+// Batched AsyncIO reads against one FileReader::ReadFile after the other, on many small files and a few large ones
+
+static constexpr uint32 NumRuns = 3;
+
+static void CompareReads(const char* inName, const std::vector<std::string>& inFiles)
+{
+	uint64 total_size = 0;
+	for (const std::string& file : inFiles)
+		total_size += std::filesystem::file_size(file);
+
+	const auto read_sequential = [&]()
+	{
+		for (const std::string& file : inFiles)
+		{
+			FileReader file_reader;
+			const bool success = file_reader.ReadFile(file);
+			Assert(success);
+		}
+	};
+
+	const auto read_async = [&]()
+	{
+		std::vector<AsyncReadRequest> requests(inFiles.size());
+		for (size_t i = 0; i < inFiles.size(); i++)
+			requests[i].m_Filename = inFiles[i];
+
+		for (std::future<AsyncReadResult>& future : g_AsyncIO.Submit(std::move(requests)))
+		{
+			const AsyncReadResult result = future.get();
+			Assert(result.m_Success);
+		}
+	};
+
+	const auto evict_files = [&]()
+	{
+		for (const std::string& file : inFiles)
+			EvictFromFileCache(file);
+	};
+	const bool can_evict = EvictFromFileCache(inFiles[0]);
+
+	printf("%s: %zu files, %.1f MB\n", inName, inFiles.size(), total_size / (1024.0 * 1024.0));
+	printf("%-12s %20s %20s\n", "Reader", "Cold (ms)", "Warm (ms)");
+
+	const auto print_timings = [&](const char* inReader, const std::function<void()>& inRead)
+	{
+		char cold[64] = "n/a";
+		if (can_evict)
+		{
+			const BenchmarkTimings cold_timings = MeasureRuns(NumRuns, inRead, evict_files);
+			snprintf(cold, sizeof(cold), "%.1f-%.1f", cold_timings.m_MinMs, cold_timings.m_MaxMs);
+		}
+
+		inRead();
+		const BenchmarkTimings warm_timings = MeasureRuns(NumRuns, inRead);
+
+		char warm[64];
+		snprintf(warm, sizeof(warm), "%.1f-%.1f", warm_timings.m_MinMs, warm_timings.m_MaxMs);
+		printf("%-12s %20s %20s\n", inReader, cold, warm);
+	};
+
+	print_timings("FileReader", read_sequential);
+	print_timings("AsyncIO", read_async);
+}
+
+BENCHMARK(AsyncIOManyFiles)
+{
+	g_AsyncIO.Init();
+	printf("AsyncIO backend: %s\n\n", g_AsyncIO.IsUsingIOUring() ? "io_uring" : "thread pool");
+
+	std::error_code error_code;
+	const std::string directory = GetBenchmarkDirectory() + "/AsyncIOManyFiles";
+	std::filesystem::create_directories(directory, error_code);
+
+	// Hundreds of small files, like materials and small textures
+	std::mt19937 random(17);
+	std::uniform_int_distribution<uint64> small_file_size(1024, 64 * 1024);
+
+	std::vector<std::string> small_files;
+	for (uint32 i = 0; i < 500; i++)
+	{
+		small_files.push_back(directory + "/Small" + std::to_string(i) + ".obj");
+		WriteObjLikeFile(small_files.back(), small_file_size(random), i);
+	}
+	CompareReads("Small files", small_files);
+	printf("\n");
+
+	// A few huge ones, like large meshes
+	std::vector<std::string> large_files;
+	for (uint32 i = 0; i < 3; i++)
+	{
+		large_files.push_back(directory + "/Large" + std::to_string(i) + ".obj");
+		WriteObjLikeFile(large_files.back(), 64 * 1024 * 1024, 1000 + i);
+	}
+	CompareReads("Large files", large_files);
+
+	g_AsyncIO.Shutdown();
+	std::filesystem::remove_all(directory, error_code);
+}
@@ -0,0 +1,271 @@
+#include "Engine.h"
+#include "Benchmark.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <random>
+
+#if defined(_WIN32)
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+static std::string s_BenchmarkDirectory;
+static std::atomic<uint64> s_NumAllocations = 0;
+
+// Replaced for the whole executable to count heap allocations. Aligned and nothrow versions aren't counted
+void* operator new(size_t inSize)
+{
+	s_NumAllocations.fetch_add(1, std::memory_order_relaxed);
+	return malloc(inSize != 0 ? inSize : 1);
+}
+
+void operator delete(void* inPointer) noexcept
+{
+	free(inPointer);
+}
+
+void operator delete(void* inPointer, size_t) noexcept
+{
+	free(inPointer);
+}
+
+uint64 GetNumAllocations()
+{
+	return s_NumAllocations.load(std::memory_order_relaxed);
+}
+
+std::vector<BenchmarkInfo>& GetBenchmarks()
+{
+	// Function static, registrars run before main in any order
+	static std::vector<BenchmarkInfo> benchmarks;
+	return benchmarks;
+}
+
+BenchmarkTimings MeasureRuns(uint32 inNumRuns, const std::function<void()>& inRun, const std::function<void()>& inSetup/* = nullptr*/)
+{
+	BenchmarkTimings timings;
+	timings.m_MinMs = 1e30;
+
+	for (uint32 i = 0; i < inNumRuns; i++)
+	{
+		if (inSetup)
+			inSetup();
+
+		const auto start_time = std::chrono::high_resolution_clock::now();
+		inRun();
+		const double elapsed_ms = GetElapsedMs(start_time);
+
+		timings.m_MinMs = std::min(timings.m_MinMs, elapsed_ms);
+		timings.m_MaxMs = std::max(timings.m_MaxMs, elapsed_ms);
+	}
+
+	return timings;
+}
+
+double GetElapsedMs(std::chrono::high_resolution_clock::time_point inStartTime)
+{
+	const std::chrono::duration<double> elapsed = std::chrono::high_resolution_clock::now() - inStartTime;
+	return elapsed.count() * 1000.0;
+}
+
+const std::string& GetBenchmarkDirectory()
+{
+	return s_BenchmarkDirectory;
+}
+
+void SetBenchmarkDirectory(const std::string& inDirectory)
+{
+	s_BenchmarkDirectory = inDirectory;
+}
+
+bool WriteObjLikeFile(const std::string& inFile, uint64 inSize, uint32 inSeed)
+{
+	std::ofstream file(inFile, std::ios::binary);
+	if (!file)
+		return false;
+
+	std::mt19937 random(inSeed);
+	std::uniform_real_distribution<float> position(-100.0f, 100.0f);
+	std::uniform_int_distribution<uint32> index(1, 50000);
+
+	// Vertex lines first, then faces, like exported files
+	std::string buffer;
+	uint64 size = 0;
+	char line[128];
+	while (size < inSize)
+	{
+		const bool is_face = size > inSize / 2;
+		const int length = is_face ?
+			snprintf(line, sizeof(line), "f %u/%u/%u %u/%u/%u %u/%u/%u\n", index(random), index(random), index(random),
+					 index(random), index(random), index(random), index(random), index(random), index(random)) :
+			snprintf(line, sizeof(line), "v %.6f %.6f %.6f\n", position(random), position(random), position(random));
+
+		buffer.append(line, static_cast<size_t>(length));
+		size += static_cast<uint64>(length);
+
+		if (buffer.size() >= 1024 * 1024)
+		{
+			file.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+			buffer.clear();
+		}
+	}
+	file.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+
+	return static_cast<bool>(file);
+}
+
+bool WriteObjMeshFile(const std::string& inFile, uint32 inNumTriangles, uint32 inSeed)
+{
+	std::ofstream file(inFile, std::ios::binary);
+	if (!file)
+		return false;
+
+	std::mt19937 random(inSeed);
+	std::uniform_real_distribution<float> noise(-0.25f, 0.25f);
+
+	// Square grid of quads, two triangles each
+	const uint32 num_quads_per_side		= std::max<uint32>(1, static_cast<uint32>(std::ceil(std::sqrt(inNumTriangles / 2.0))));
+	const uint32 num_vertices_per_side	= num_quads_per_side + 1;
+
+	std::string buffer;
+	char line[128];
+	const auto append = [&](int inLength)
+	{
+		buffer.append(line, static_cast<size_t>(inLength));
+		if (buffer.size() >= 1024 * 1024)
+		{
+			file.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+			buffer.clear();
+		}
+	};
+
+	append(snprintf(line, sizeof(line), "o Grid\n"));
+
+	// Vertex lines first, then faces, like exported files. One position, UV and normal per vertex
+	for (uint32 row = 0; row < num_vertices_per_side; row++)
+		for (uint32 column = 0; column < num_vertices_per_side; column++)
+			append(snprintf(line, sizeof(line), "v %.6f %.6f %.6f\n", column + noise(random), noise(random), row + noise(random)));
+	for (uint32 row = 0; row < num_vertices_per_side; row++)
+		for (uint32 column = 0; column < num_vertices_per_side; column++)
+			append(snprintf(line, sizeof(line), "vt %.6f %.6f\n", column / float(num_quads_per_side), row / float(num_quads_per_side)));
+	for (uint32 row = 0; row < num_vertices_per_side; row++)
+	{
+		for (uint32 column = 0; column < num_vertices_per_side; column++)
+		{
+			const float x = noise(random);
+			const float z = noise(random);
+			const float length = std::sqrt(x * x + 1.0f + z * z);
+			append(snprintf(line, sizeof(line), "vn %.4f %.4f %.4f\n", x / length, 1.0f / length, z / length));
+		}
+	}
+
+	for (uint32 row = 0; row < num_quads_per_side; row++)
+	{
+		for (uint32 column = 0; column < num_quads_per_side; column++)
+		{
+			// 1 based
+			const uint32 v00 = row * num_vertices_per_side + column + 1;
+			const uint32 v10 = v00 + 1;
+			const uint32 v01 = v00 + num_vertices_per_side;
+			const uint32 v11 = v01 + 1;
+			append(snprintf(line, sizeof(line), "f %u/%u/%u %u/%u/%u %u/%u/%u\n", v00, v00, v00, v11, v11, v11, v10, v10, v10));
+			append(snprintf(line, sizeof(line), "f %u/%u/%u %u/%u/%u %u/%u/%u\n", v00, v00, v00, v01, v01, v01, v11, v11, v11));
+		}
+	}
+	file.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+
+	return static_cast<bool>(file);
+}
+
+#if defined(_WIN32)
+
+bool EvictFromFileCache(const std::string& inFile)
+{
+	// Opening a file without buffering purges its pages from the system cache
+	HANDLE file_handle = ::CreateFileA(inFile.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+									   OPEN_EXISTING, FILE_FLAG_NO_BUFFERING, nullptr);
+	if (file_handle == INVALID_HANDLE_VALUE)
+		return false;
+
+	::CloseHandle(file_handle);
+	return true;
+}
+
+uint64 GetResidentMemory()
+{
+	PROCESS_MEMORY_COUNTERS_EX counters = {};
+	if (!::GetProcessMemoryInfo(::GetCurrentProcess(), reinterpret_cast<PROCESS_MEMORY_COUNTERS*>(&counters), sizeof(counters)))
+		return 0;
+
+	return counters.WorkingSetSize;
+}
+
+uint64 GetPrivateMemory()
+{
+	PROCESS_MEMORY_COUNTERS_EX counters = {};
+	if (!::GetProcessMemoryInfo(::GetCurrentProcess(), reinterpret_cast<PROCESS_MEMORY_COUNTERS*>(&counters), sizeof(counters)))
+		return 0;
+
+	// Committed rather than resident, Windows doesn't split the working set
+	return counters.PrivateUsage;
+}
+
+#else
+
+bool EvictFromFileCache(const std::string& inFile)
+{
+	const int file_descriptor = ::open(inFile.c_str(), O_RDONLY);
+	if (file_descriptor < 0)
+		return false;
+
+	// Dirty pages can't be dropped, write them first
+	::fdatasync(file_descriptor);
+	const bool success = ::posix_fadvise(file_descriptor, 0, 0, POSIX_FADV_DONTNEED) == 0;
+
+	::close(file_descriptor);
+	return success;
+}
+
+// Value in kB of a line of /proc/self/status, in bytes
+static inline uint64 ReadProcessStatus(const char* inField)
+{
+	FILE* file = fopen("/proc/self/status", "r");
+	if (file == nullptr)
+		return 0;
+
+	const size_t field_length = strlen(inField);
+	uint64 value = 0;
+	char line[256];
+	while (fgets(line, sizeof(line), file) != nullptr)
+	{
+		if (strncmp(line, inField, field_length) == 0 && line[field_length] == ':')
+		{
+			value = strtoull(line + field_length + 1, nullptr, 10) * 1024;
+			break;
+		}
+	}
+
+	fclose(file);
+	return value;
+}
+
+uint64 GetResidentMemory()
+{
+	return ReadProcessStatus("VmRSS");
+}
+
+uint64 GetPrivateMemory()
+{
+	return ReadProcessStatus("RssAnon");
+}
+
+#endif
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <chrono>
+#include <functional>
+#include <string>
+#include <vector>
+
+// Benchmarks register themselves with BENCHMARK and are run by name from the command line, see Main.cpp.
+// They print their own results, each one measures what makes sense for the code it covers
+
+using BenchmarkFunction = void (*)();
+
+struct BenchmarkInfo
+{
+	const char*			m_Name;
+	BenchmarkFunction	m_Function;
+};
+
+std::vector<BenchmarkInfo>&	GetBenchmarks();
+
+struct BenchmarkRegistrar
+{
+	BenchmarkRegistrar(const char* inName, BenchmarkFunction inFunction)	{ GetBenchmarks().push_back({ inName, inFunction }); }
+};
+
+#define BENCHMARK(inName)																\
+	static void inName();																\
+	static const BenchmarkRegistrar s_##inName##Registrar(#inName, &inName);			\
+	static void inName()
+
+// Fastest and slowest of several runs. Timings on a busy machine spread a lot, the range is more honest than a mean
+struct BenchmarkTimings
+{
+	double	m_MinMs	= 0.0;
+	double	m_MaxMs	= 0.0;
+};
+
+// inSetup runs before each run and isn't timed, e.g. to drop files from the cache
+BenchmarkTimings	MeasureRuns(uint32 inNumRuns, const std::function<void()>& inRun, const std::function<void()>& inSetup = nullptr);
+
+double				GetElapsedMs(std::chrono::high_resolution_clock::time_point inStartTime);
+
+// Where benchmarks write their generated data. Created by Main.cpp and deleted once every benchmark ran
+const std::string&	GetBenchmarkDirectory();
+void				SetBenchmarkDirectory(const std::string& inDirectory);
+
+// Text file of about inSize bytes looking like an OBJ file, so it compresses and parses like real assets
+bool				WriteObjLikeFile(const std::string& inFile, uint64 inSize, uint32 inSeed);
+// OBJ file MeshLoader can load: one object, a noisy grid of at least inNumTriangles triangles with UVs and normals
+bool				WriteObjMeshFile(const std::string& inFile, uint32 inNumTriangles, uint32 inSeed);
+
+// Drop the pages of a file from the OS file cache so the next read comes from the disk. False when it isn't supported
+bool				EvictFromFileCache(const std::string& inFile);
+
+// Bytes of the process currently in physical memory
+uint64				GetResidentMemory();
+// Bytes of the process in physical memory that aren't backed by a file, e.g. heap allocations
+uint64				GetPrivateMemory();
+
+// Calls to operator new since the process started. Compare before and after the code to measure
+uint64				GetNumAllocations();
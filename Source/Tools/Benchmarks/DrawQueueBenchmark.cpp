@@ -0,0 +1,120 @@
+#include "Engine.h"
+#include "Benchmark.h"
+
+#include "Gfx/DrawKey.h"
+#include "Utils/JobSystem.h"
+#include "Utils/RadixSort.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <numeric>
+#include <random>
+#include <utility>
+#include <vector>
+
+// Sorting the draws of a frame the way DrawQueue::Sort does: 64 bit DrawKey keys carrying the index of their packet.
+// RadixSort on the calling thread and over the workers, against std::sort and std::stable_sort of key and index pairs.
+// Submission needs shaders and meshes, RecordingCommandListFrame measures the recording side
+
+static constexpr uint32 NumRuns = 20;
+
+struct SyntheticScene
+{
+	std::vector<RenderPass>	m_Passes;
+	std::vector<uint32>		m_Pipelines;
+	std::vector<uint32>		m_Materials;
+	std::vector<uint32>		m_Geometries;
+	std::vector<float>		m_Depths;
+};
+
+// A tenth of the draws are transparent, 64 pipelines, 256 materials and 4096 meshes at any distance
+static SyntheticScene MakeScene(size_t inNumDraws)
+{
+	std::mt19937 random(static_cast<uint32>(inNumDraws));
+	std::uniform_real_distribution<float> depth(0.1f, 1000.0f);
+
+	SyntheticScene scene;
+	for (size_t i = 0; i < inNumDraws; i++)
+	{
+		scene.m_Passes.push_back(random() % 10 == 0 ? RenderPass::Transparent : RenderPass::OpaqueGeometry);
+		scene.m_Pipelines.push_back(random() % 64);
+		scene.m_Materials.push_back(random() % 256);
+		scene.m_Geometries.push_back(random() % 4096);
+		scene.m_Depths.push_back(depth(random));
+	}
+	return scene;
+}
+
+BENCHMARK(DrawQueueSort)
+{
+	const size_t draw_counts[] = { 1000, 10000, 100000 };
+
+	printf("%-20s %8s %8s %21s %10s\n", "Sort", "Workers", "Draws", "Time (ms)", "ns/draw");
+
+	for (size_t num_draws : draw_counts)
+	{
+		const SyntheticScene scene = MakeScene(num_draws);
+
+		std::vector<uint64> keys(num_draws);
+		const auto make_keys = [&]()
+		{
+			for (size_t i = 0; i < num_draws; i++)
+				keys[i] = DrawKey::Make(scene.m_Passes[i], scene.m_Pipelines[i], scene.m_Materials[i], scene.m_Geometries[i], scene.m_Depths[i]);
+		};
+
+		const auto print_timings = [num_draws](const char* inSort, uint32 inNumWorkers, const BenchmarkTimings& inTimings)
+		{
+			printf("%-20s %8u %8zu %10.3f-%-10.3f %10.1f\n", inSort, inNumWorkers, num_draws, inTimings.m_MinMs, inTimings.m_MaxMs, inTimings.m_MinMs * 1e6 / num_draws);
+		};
+
+		print_timings("DrawKey::Make", 1, MeasureRuns(NumRuns, make_keys));
+
+		// Scratch buffers are kept from one frame to the next, like in DrawQueue
+		std::vector<uint64> sorted_keys(num_draws);
+		std::vector<uint32> packet_indices(num_draws);
+		std::vector<uint64> temp_keys(num_draws);
+		std::vector<uint32> temp_packet_indices(num_draws);
+		const auto radix_sort = [&]()
+		{
+			RadixSort::Sort(sorted_keys.data(), packet_indices.data(), num_draws, temp_keys.data(), temp_packet_indices.data());
+		};
+		const auto reset_radix_sort = [&]()
+		{
+			sorted_keys = keys;
+			std::iota(packet_indices.begin(), packet_indices.end(), 0);
+		};
+
+		std::vector<std::pair<uint64, uint32>> pairs(num_draws);
+		const auto reset_pairs = [&]()
+		{
+			for (size_t i = 0; i < num_draws; i++)
+				pairs[i] = { keys[i], static_cast<uint32>(i) };
+		};
+
+		print_timings("RadixSort", 1, MeasureRuns(NumRuns, radix_sort, reset_radix_sort));
+
+		for (uint32 num_workers : { 2, 4 })
+		{
+			g_JobSystem.Init(num_workers);
+			print_timings("RadixSort", num_workers, MeasureRuns(NumRuns, radix_sort, reset_radix_sort));
+			g_JobSystem.Shutdown();
+		}
+
+		print_timings("std::sort", 1, MeasureRuns(NumRuns, [&]() { std::sort(pairs.begin(), pairs.end()); }, reset_pairs));
+		print_timings("std::stable_sort", 1, MeasureRuns(NumRuns, [&]()
+		{
+			std::stable_sort(pairs.begin(), pairs.end(), [](const std::pair<uint64, uint32>& inLeft, const std::pair<uint64, uint32>& inRight)
+			{
+				return inLeft.first < inRight.first;
+			});
+		}, reset_pairs));
+
+		// Same order as the stable sort, the packet indices break the ties the same way
+		bool same_order = true;
+		for (size_t i = 0; i < num_draws; i++)
+			same_order &= sorted_keys[i] == pairs[i].first && packet_indices[i] == pairs[i].second;
+		Assert(same_order, "RadixSort must match std::stable_sort");
+
+		printf("\n");
+	}
+}
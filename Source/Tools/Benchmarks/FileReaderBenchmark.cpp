@@ -0,0 +1,97 @@
+#include "Engine.h"
+#include "Benchmark.h"
+
+#include "Utils/FileReader.h"
+
+#include <cstdio>
+#include <filesystem>
+
+// Copy against mapped reads of one large asset, consumed the way the OBJ parser does: a single pass over every byte
+
+static constexpr uint64 FileSize	= 128 * 1024 * 1024;
+static constexpr uint32 NumRuns		= 3;
+
+static inline uint64 CountLines(const char* inContent, uint64 inSize)
+{
+	uint64 num_lines = 0;
+	for (uint64 i = 0; i < inSize; i++)
+		num_lines += (inContent[i] == '\n');
+	return num_lines;
+}
+
+BENCHMARK(FileReaderLargeFile)
+{
+	const std::string file = GetBenchmarkDirectory() + "/FileReaderLargeFile.obj";
+	if (!WriteObjLikeFile(file, FileSize, 16))
+	{
+		printf("Can't write %s\n", file.c_str());
+		return;
+	}
+
+	struct Mode
+	{
+		const char*		m_Name;
+		FileReadMode	m_Mode;
+	};
+	const Mode modes[] =
+	{
+		{ "Copy",				FileReadMode::Copy },
+		{ "Map",				FileReadMode::Map },
+		{ "MapWithPrefetch",	FileReadMode::MapWithPrefetch },
+	};
+
+	printf("%.0f MB file, read then scanned once, %u runs\n", FileSize / (1024.0 * 1024.0), NumRuns);
+	printf("%-16s %20s %20s %14s %14s\n", "Mode", "Cold (ms)", "Warm (ms)", "Private (MB)", "Resident (MB)");
+
+	const bool can_evict = EvictFromFileCache(file);
+
+	for (const Mode& mode : modes)
+	{
+		uint64 num_lines		= 0;
+		int64 private_memory	= 0;
+		int64 resident_memory	= 0;
+
+		const auto read_file = [&]()
+		{
+			const int64 private_memory_before	= static_cast<int64>(GetPrivateMemory());
+			const int64 resident_memory_before	= static_cast<int64>(GetResidentMemory());
+
+			FileReader file_reader;
+			if (!file_reader.ReadFile(file, mode.m_Mode))
+				return;
+
+			num_lines = CountLines(file_reader.GetContentAsString(), file_reader.GetContentSize());
+
+			// While the content is still alive, what the reader costs on top of the process
+			private_memory	= static_cast<int64>(GetPrivateMemory()) - private_memory_before;
+			resident_memory	= static_cast<int64>(GetResidentMemory()) - resident_memory_before;
+		};
+
+		BenchmarkTimings cold_timings;
+		if (can_evict)
+			cold_timings = MeasureRuns(NumRuns, read_file, [&]() { EvictFromFileCache(file); });
+
+		// Once to load the cache
+		read_file();
+		const BenchmarkTimings warm_timings = MeasureRuns(NumRuns, read_file);
+
+		char cold[64] = "n/a";
+		if (can_evict)
+			snprintf(cold, sizeof(cold), "%.1f-%.1f", cold_timings.m_MinMs, cold_timings.m_MaxMs);
+
+		char warm[64];
+		snprintf(warm, sizeof(warm), "%.1f-%.1f", warm_timings.m_MinMs, warm_timings.m_MaxMs);
+
+		printf("%-16s %20s %20s %14.1f %14.1f\n", mode.m_Name, cold, warm,
+			   private_memory / (1024.0 * 1024.0), resident_memory / (1024.0 * 1024.0));
+
+		// Same content whatever the mode
+		Assert(num_lines > 0);
+	}
+
+	if (!can_evict)
+		printf("The file cache can't be dropped here, cold timings are skipped\n");
+
+	std::error_code error_code;
+	std::filesystem::remove(file, error_code);
+}
@@ -0,0 +1,173 @@
+#include "Engine.h"
+#include "Benchmark.h"
+
+#include "Utils/JobSystem.h"
+
+#include <atomic>
+#include <cstdio>
+
+// Job system overhead and load balancing: recursive fork-join, tiny items one by one against batches, and items whose
+// cost grows along the range. Each one with several worker counts, utilization comes from the worker statistics
+
+static constexpr uint32 NumRuns			= 5;
+static const uint32 s_WorkerCounts[]	= { 1, 2, 4, 8 };
+
+static uint64 ForkJoinFibonacci(uint32 inN)
+{
+	if (inN < 2)
+		return inN;
+
+	uint64 a = 0;
+	JobCounter counter;
+	g_JobSystem.Schedule([&a, inN]() { a = ForkJoinFibonacci(inN - 1); }, &counter);
+	const uint64 b = ForkJoinFibonacci(inN - 2);
+	g_JobSystem.Wait(counter);
+
+	return a + b;
+}
+
+// Kept out of reach of the optimizer, the work would be folded away otherwise
+static std::atomic<uint64> s_Sink = 0;
+
+static inline uint64 Work(uint64 inNumIterations)
+{
+	uint64 value = inNumIterations;
+	for (uint64 i = 0; i < inNumIterations; i++)
+		value = value * 6364136223846793005ull + 1442695040888963407ull;
+	return value;
+}
+
+static double GetAverageUtilization()
+{
+	const std::vector<JobWorkerStatistics> statistics = g_JobSystem.GetStatistics();
+	if (statistics.empty())
+		return 0.0;
+
+	double utilization = 0.0;
+	for (const JobWorkerStatistics& worker : statistics)
+		utilization += worker.GetUtilization();
+	return utilization / statistics.size();
+}
+
+static void PrintTimings(const char* inName, uint32 inNumWorkers, const BenchmarkTimings& inTimings, const char* inExtra = "")
+{
+	printf("%-24s %8u %10.2f-%-10.2f %s\n", inName, inNumWorkers, inTimings.m_MinMs, inTimings.m_MaxMs, inExtra);
+}
+
+BENCHMARK(JobSystemForkJoin)
+{
+	// fib(25) schedules fib(24) jobs, about 75k jobs each waited on by its parent
+	constexpr uint32 n			= 25;
+	constexpr uint64 num_jobs	= 75024;
+
+	printf("%-24s %8s %21s %s\n", "Fork-join fib(25)", "Workers", "Time (ms)", "ns/job");
+	for (uint32 num_workers : s_WorkerCounts)
+	{
+		g_JobSystem.Init(num_workers);
+
+		const BenchmarkTimings timings = MeasureRuns(NumRuns, []() { s_Sink += ForkJoinFibonacci(n); });
+
+		char ns_per_job[32];
+		snprintf(ns_per_job, sizeof(ns_per_job), "%.0f", timings.m_MinMs * 1e6 / num_jobs);
+		PrintTimings("", num_workers, timings, ns_per_job);
+
+		g_JobSystem.Shutdown();
+	}
+}
+
+BENCHMARK(JobSystemFineGrained)
+{
+	// A few nanoseconds per item, the job system overhead is all there is to see
+	constexpr size_t num_items		= 1000000;
+	constexpr uint64 item_work		= 16;
+
+	const BenchmarkTimings serial_timings = MeasureRuns(NumRuns, []()
+	{
+		uint64 sum = 0;
+		for (size_t i = 0; i < num_items; i++)
+			sum += Work(item_work);
+		s_Sink += sum;
+	});
+
+	printf("%-24s %8s %21s %s\n", "Fine-grained 1M items", "Workers", "Time (ms)", "Utilization");
+	PrintTimings("Serial", 1, serial_timings);
+
+	for (uint32 num_workers : s_WorkerCounts)
+	{
+		g_JobSystem.Init(num_workers);
+
+		const auto run_parallel_for = []()
+		{
+			g_JobSystem.ParallelFor(num_items, [](size_t) { s_Sink.fetch_add(Work(item_work), std::memory_order_relaxed); });
+		};
+
+		const auto run_batches = []()
+		{
+			g_JobSystem.ParallelForBatches(num_items, [](size_t inBegin, size_t inEnd)
+			{
+				uint64 sum = 0;
+				for (size_t i = inBegin; i < inEnd; i++)
+					sum += Work(item_work);
+				s_Sink.fetch_add(sum, std::memory_order_relaxed);
+			}, 4096);
+		};
+
+		char utilization[32];
+
+		g_JobSystem.ResetStatistics();
+		const BenchmarkTimings parallel_for_timings = MeasureRuns(NumRuns, run_parallel_for);
+		snprintf(utilization, sizeof(utilization), "%.0f%%", GetAverageUtilization() * 100.0);
+		PrintTimings("ParallelFor", num_workers, parallel_for_timings, utilization);
+
+		g_JobSystem.ResetStatistics();
+		const BenchmarkTimings batches_timings = MeasureRuns(NumRuns, run_batches);
+		snprintf(utilization, sizeof(utilization), "%.0f%%", GetAverageUtilization() * 100.0);
+		PrintTimings("ParallelForBatches", num_workers, batches_timings, utilization);
+
+		g_JobSystem.Shutdown();
+	}
+}
+
+BENCHMARK(JobSystemImbalanced)
+{
+	// Item i costs i^2 iterations: the last quarter of the range is more than half of the work, static splits
+	// leave most workers idle at the end and stealing has to even it out
+	constexpr size_t num_items = 1000;
+
+	const BenchmarkTimings serial_timings = MeasureRuns(NumRuns, []()
+	{
+		uint64 sum = 0;
+		for (size_t i = 0; i < num_items; i++)
+			sum += Work(i * i);
+		s_Sink += sum;
+	});
+
+	printf("%-24s %8s %21s %s\n", "Imbalanced 1000 items", "Workers", "Time (ms)", "Speedup, utilization, stolen jobs");
+	PrintTimings("Serial", 1, serial_timings);
+
+	for (uint32 num_workers : s_WorkerCounts)
+	{
+		g_JobSystem.Init(num_workers);
+		g_JobSystem.ResetStatistics();
+
+		const BenchmarkTimings timings = MeasureRuns(NumRuns, []()
+		{
+			g_JobSystem.ParallelFor(num_items, [](size_t inIndex) { s_Sink.fetch_add(Work(inIndex * inIndex), std::memory_order_relaxed); });
+		});
+
+		uint64 num_jobs			= 0;
+		uint64 num_stolen_jobs	= 0;
+		for (const JobWorkerStatistics& worker : g_JobSystem.GetStatistics())
+		{
+			num_jobs		+= worker.m_NumJobs;
+			num_stolen_jobs	+= worker.m_NumStolenJobs;
+		}
+
+		char extra[96];
+		snprintf(extra, sizeof(extra), "%.2fx, %.0f%%, %llu/%llu", serial_timings.m_MinMs / timings.m_MinMs, GetAverageUtilization() * 100.0,
+				 static_cast<unsigned long long>(num_stolen_jobs), static_cast<unsigned long long>(num_jobs));
+		PrintTimings("ParallelFor", num_workers, timings, extra);
+
+		g_JobSystem.Shutdown();
+	}
+}
@@ -0,0 +1,91 @@
+#include "Engine.h"
+#include "Benchmark.h"
+
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+// Headless benchmarks of engine systems, runnable wherever the engine's portable code builds:
+//		Benchmarks							runs everything
+//		Benchmarks FileReader AsyncIO		runs the benchmarks whose name contains one of the filters
+// Generated data goes to a temporary directory, -dir picks another one, e.g. on the disk that ships the game
+
+static void PrintUsage()
+{
+	printf("Usage: Benchmarks [filter]... [-dir <directory>] [-list]\n");
+	printf("\tRuns the benchmarks whose name contains one of the filters, all of them without filters\n");
+}
+
+int main(int inArgc, char** inArgv)
+{
+	std::vector<std::string>	filters;
+	std::string					directory;
+	bool						list_only = false;
+
+	for (int i = 1; i < inArgc; i++)
+	{
+		if (std::strcmp(inArgv[i], "-dir") == 0 && i + 1 < inArgc)
+			directory = inArgv[++i];
+		else if (std::strcmp(inArgv[i], "-list") == 0)
+			list_only = true;
+		else if (inArgv[i][0] == '-')
+		{
+			PrintUsage();
+			return -1;
+		}
+		else
+			filters.push_back(inArgv[i]);
+	}
+
+	std::vector<BenchmarkInfo> benchmarks;
+	for (const BenchmarkInfo& benchmark : GetBenchmarks())
+	{
+		bool is_selected = filters.empty();
+		for (const std::string& filter : filters)
+			is_selected |= std::strstr(benchmark.m_Name, filter.c_str()) != nullptr;
+
+		if (is_selected)
+			benchmarks.push_back(benchmark);
+	}
+
+	if (list_only)
+	{
+		for (const BenchmarkInfo& benchmark : benchmarks)
+			printf("%s\n", benchmark.m_Name);
+		return 0;
+	}
+
+	if (benchmarks.empty())
+	{
+		printf("No benchmark matches\n");
+		return -1;
+	}
+
+	std::error_code error_code;
+	const bool is_temporary_directory = directory.empty();
+	if (is_temporary_directory)
+		directory = (std::filesystem::temp_directory_path(error_code) / "AmigoBenchmarks").string();
+
+	std::filesystem::create_directories(directory, error_code);
+	if (!std::filesystem::is_directory(directory, error_code))
+	{
+		printf("Can't create %s\n", directory.c_str());
+		return -1;
+	}
+	SetBenchmarkDirectory(directory);
+
+	for (const BenchmarkInfo& benchmark : benchmarks)
+	{
+		printf("== %s\n", benchmark.m_Name);
+		fflush(stdout);
+		benchmark.m_Function();
+		printf("\n");
+	}
+
+	if (is_temporary_directory)
+		std::filesystem::remove_all(directory, error_code);
+
+	return 0;
+}
@@ -0,0 +1,325 @@
+#include "Engine.h"
+#include "Benchmark.h"
+
+#include "Gfx/BakedMesh.h"
+#include "Gfx/MeshLoader.h"
+#include "Utils/JobSystem.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <cstdio>
+#include <filesystem>
+#include <map>
+#include <random>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// OBJ loading on generated grids, see WriteObjMeshFile. Processing stages are off unless a benchmark is about them,
+// what's left is reading, parsing, merging and the bounds
+
+static constexpr uint32 NumRuns = 3;
+
+static MeshImportSettings GetParseOnlySettings()
+{
+	MeshImportSettings settings;
+	settings.m_OptimizeVertexCache	= false;
+	settings.m_OptimizeOverdraw		= false;
+	return settings;
+}
+
+static double GetFileSizeInMB(const std::string& inFile)
+{
+	return static_cast<double>(std::filesystem::file_size(inFile)) / (1024.0 * 1024.0);
+}
+
+// Single chunk, on the calling thread: the speed of the tokenizer and the vertex deduplication
+BENCHMARK(MeshLoaderParse)
+{
+	constexpr uint32 num_triangles = 10000000;
+
+	const std::string generated_file = GetBenchmarkDirectory() + "/MeshLoaderParse.obj";
+	if (!WriteObjMeshFile(generated_file, num_triangles, 1))
+	{
+		printf("Can't write %s\n", generated_file.c_str());
+		return;
+	}
+
+	// Run from the root of the repository for the assets in Data
+	const std::string files[] = { "Data/Lightbulb.obj", generated_file };
+
+	printf("%u runs, warm file cache\n", NumRuns);
+	printf("%-24s %10s %21s %10s\n", "File", "Size (MB)", "Time (ms)", "MB/s");
+
+	for (const std::string& file : files)
+	{
+		if (!std::filesystem::exists(file))
+		{
+			printf("%-24s missing\n", file.c_str());
+			continue;
+		}
+
+		const double size_in_mb = GetFileSizeInMB(file);
+
+		// Once to load the cache
+		MeshLoader(GetParseOnlySettings()).LoadFromFile(file, 1);
+
+		const BenchmarkTimings timings = MeasureRuns(NumRuns, [&]()
+		{
+			MeshLoader loader(GetParseOnlySettings());
+			loader.LoadFromFile(file, 1);
+		});
+
+		const std::string name = std::filesystem::path(file).filename().string();
+		printf("%-24s %10.1f %10.2f-%-10.2f %10.1f\n", name.c_str(), size_in_mb, timings.m_MinMs, timings.m_MaxMs,
+			   size_in_mb / (timings.m_MinMs * 1e-3));
+	}
+}
+
+BENCHMARK(MeshLoaderScaling)
+{
+	constexpr uint32 num_triangles = 2000000;
+
+	const std::string file = GetBenchmarkDirectory() + "/MeshLoaderScaling.obj";
+	if (!WriteObjMeshFile(file, num_triangles, 2))
+	{
+		printf("Can't write %s\n", file.c_str());
+		return;
+	}
+
+	const double size_in_mb			= GetFileSizeInMB(file);
+	const uint32 max_num_workers	= Math::Max(4u, std::thread::hardware_concurrency());
+
+	printf("%.0f MB, %u triangles, %u runs, %u hardware threads\n", size_in_mb, num_triangles, NumRuns, std::thread::hardware_concurrency());
+	printf("%8s %21s %10s %10s\n", "Workers", "Time (ms)", "MB/s", "Speedup");
+
+	// Once to load the cache
+	MeshLoader(GetParseOnlySettings()).LoadFromFile(file, 1);
+
+	double serial_ms = 0.0;
+	for (uint32 num_workers = 1; num_workers <= max_num_workers; num_workers *= 2)
+	{
+		g_JobSystem.Init(num_workers);
+
+		// One chunk per worker
+		const BenchmarkTimings timings = MeasureRuns(NumRuns, [&]()
+		{
+			MeshLoader loader(GetParseOnlySettings());
+			loader.LoadFromFile(file, num_workers);
+		});
+
+		if (num_workers == 1)
+			serial_ms = timings.m_MinMs;
+
+		printf("%8u %10.2f-%-10.2f %10.1f %9.2fx\n", num_workers, timings.m_MinMs, timings.m_MaxMs,
+			   size_in_mb / (timings.m_MinMs * 1e-3), serial_ms / timings.m_MinMs);
+
+		g_JobSystem.Shutdown();
+	}
+}
+
+// Kept out of reach of the optimizer, the lookups would be folded away otherwise
+static std::atomic<uint64> s_Sink = 0;
+
+// Face corners of a grid like WriteObjMeshFile's, in face order: each vertex is looked up 6 times, 5 are hits
+static std::vector<OBJVertexIndices> MakeGridCorners(uint32 inNumQuadsPerSide)
+{
+	const int32 num_vertices_per_side = static_cast<int32>(inNumQuadsPerSide) + 1;
+
+	std::vector<OBJVertexIndices> corners;
+	corners.reserve(inNumQuadsPerSide * inNumQuadsPerSide * 6);
+	for (int32 row = 0; row + 1 < num_vertices_per_side; row++)
+	{
+		for (int32 column = 0; column + 1 < num_vertices_per_side; column++)
+		{
+			const int32 v00 = row * num_vertices_per_side + column;
+			const int32 v10 = v00 + 1;
+			const int32 v01 = v00 + num_vertices_per_side;
+			const int32 v11 = v01 + 1;
+			for (int32 v : { v00, v11, v10, v00, v01, v11 })
+				corners.push_back({ v, v, v });
+		}
+	}
+	return corners;
+}
+
+static void PrintLookups(const char* inOrder, const char* inMap, size_t inNumLookups, const BenchmarkTimings& inTimings)
+{
+	printf("%-10s %-24s %10.2f-%-10.2f %10.1f %10.1f\n", inOrder, inMap, inTimings.m_MinMs, inTimings.m_MaxMs,
+		   inTimings.m_MinMs * 1e6 / inNumLookups, inNumLookups / (inTimings.m_MinMs * 1e3));
+}
+
+// VertexIndexMap against the standard containers, the way MergeChunks uses it: reserved from the face count,
+// one lookup per face corner, cleared between objects
+BENCHMARK(MeshLoaderVertexLookups)
+{
+	constexpr uint32 num_quads_per_side	= 1000;
+	constexpr uint32 num_objects		= 8;
+
+	std::vector<OBJVertexIndices> file_order = MakeGridCorners(num_quads_per_side);
+
+	// Same lookups, in random order. Every access is a cache miss once the table is larger than the cache
+	std::vector<OBJVertexIndices> random_order = file_order;
+	std::shuffle(random_order.begin(), random_order.end(), std::mt19937(3));
+
+	const size_t num_lookups	= file_order.size();
+	const size_t num_faces		= num_lookups / 3;
+
+	printf("%zu lookups, %u objects, %u runs\n", num_lookups, num_objects, NumRuns);
+	printf("%-10s %-24s %21s %10s %10s\n", "Order", "Map", "Time (ms)", "ns/lookup", "M/s");
+
+	VertexIndexMap index_map;
+	uint64 sink = 0;
+
+	for (const std::vector<OBJVertexIndices>* corners : { &file_order, &random_order })
+	{
+		const char* order = (corners == &file_order) ? "File" : "Random";
+
+		// Same table for every object, like the loader does
+		PrintLookups(order, "VertexIndexMap", num_lookups, MeasureRuns(NumRuns, [&]()
+		{
+			index_map.Reserve(num_faces / num_objects);
+
+			for (uint32 object = 0; object < num_objects; object++)
+			{
+				index_map.Clear();
+
+				uint32 num_vertices = 0;
+				const size_t begin	= num_lookups * object / num_objects;
+				const size_t end	= num_lookups * (object + 1) / num_objects;
+				for (size_t i = begin; i < end; i++)
+				{
+					uint32 index = 0;
+					num_vertices += index_map.FindOrInsert((*corners)[i], num_vertices, index) ? 1 : 0;
+					sink += index;
+				}
+			}
+		}));
+
+		PrintLookups(order, "std::unordered_map", num_lookups, MeasureRuns(NumRuns, [&]()
+		{
+			for (uint32 object = 0; object < num_objects; object++)
+			{
+				std::unordered_map<uint64, uint32> index_map;
+				index_map.reserve(num_faces / num_objects);
+
+				const size_t begin	= num_lookups * object / num_objects;
+				const size_t end	= num_lookups * (object + 1) / num_objects;
+				for (size_t i = begin; i < end; i++)
+				{
+					const OBJVertexIndices& corner = (*corners)[i];
+					const uint64 key = (static_cast<uint64>(corner.m_Position) << 42) ^ (static_cast<uint64>(corner.m_UV) << 21) ^ static_cast<uint64>(corner.m_Normal);
+					sink += index_map.emplace(key, static_cast<uint32>(index_map.size())).first->second;
+				}
+			}
+		}));
+
+		// What the loader used to do: a string key per corner, in a tree
+		PrintLookups(order, "std::map<std::string>", num_lookups, MeasureRuns(NumRuns, [&]()
+		{
+			for (uint32 object = 0; object < num_objects; object++)
+			{
+				std::map<std::string, uint32> index_map;
+
+				const size_t begin	= num_lookups * object / num_objects;
+				const size_t end	= num_lookups * (object + 1) / num_objects;
+				for (size_t i = begin; i < end; i++)
+				{
+					const OBJVertexIndices& corner = (*corners)[i];
+					const std::string key = std::to_string(corner.m_Position + 1) + "/" + std::to_string(corner.m_UV + 1) + "/" + std::to_string(corner.m_Normal + 1);
+					sink += index_map.emplace(key, static_cast<uint32>(index_map.size())).first->second;
+				}
+			}
+		}));
+	}
+
+	s_Sink += sink;
+}
+
+static std::string FormatTimings(const BenchmarkTimings& inTimings)
+{
+	char timings[64];
+	snprintf(timings, sizeof(timings), "%.2f-%.2f", inTimings.m_MinMs, inTimings.m_MaxMs);
+	return timings;
+}
+
+// What MeshAsset pays before Finalize, with the default import settings: the OBJ file parsed and processed,
+// against the baked file mapped and validated. Finalize copies the vertices and indices to the upload buffers,
+// the baked side copies them too or the pages of the mapping would never be read
+BENCHMARK(MeshLoaderStartup)
+{
+	constexpr uint32 num_triangles = 2000000;
+
+	const std::string generated_file = GetBenchmarkDirectory() + "/MeshLoaderStartup.obj";
+	if (!WriteObjMeshFile(generated_file, num_triangles, 5))
+	{
+		printf("Can't write %s\n", generated_file.c_str());
+		return;
+	}
+
+	// Run from the root of the repository for the assets in Data
+	const std::string files[] = { "Data/Lightbulb.obj", generated_file };
+
+	const MeshImportSettings settings;
+
+	printf("Default import settings, %u runs. Cold runs drop the file from the cache first\n", NumRuns);
+	printf("%-24s %-6s %10s %21s %21s\n", "File", "Format", "Size (MB)", "Cold (ms)", "Warm (ms)");
+
+	for (const std::string& file : files)
+	{
+		if (!std::filesystem::exists(file))
+		{
+			printf("%-24s missing\n", file.c_str());
+			continue;
+		}
+
+		const std::string name			= std::filesystem::path(file).filename().string();
+		const std::string baked_file	= GetBenchmarkDirectory() + "/" + std::filesystem::path(file).stem().string() + ".amesh";
+		{
+			MeshLoader loader(settings);
+			loader.LoadFromFile(file);
+			if (!BakedMesh::Bake(loader, baked_file))
+			{
+				printf("Can't write %s\n", baked_file.c_str());
+				continue;
+			}
+		}
+
+		const auto load_obj = [&]()
+		{
+			MeshLoader loader(settings);
+			loader.LoadFromFile(file);
+		};
+
+		std::vector<Byte> upload_buffer;
+		const auto load_baked = [&]()
+		{
+			BakedMesh baked_mesh;
+			if (!baked_mesh.LoadFromFile(baked_file))
+				return;
+
+			const BakedMeshFormat::Header& header = baked_mesh.GetHeader();
+			upload_buffer.resize(header.m_VertexDataSize + header.m_IndexDataSize);
+			memcpy(upload_buffer.data(), baked_mesh.GetSection(header.m_VertexDataOffset), header.m_VertexDataSize);
+			memcpy(upload_buffer.data() + header.m_VertexDataSize, baked_mesh.GetSection(header.m_IndexDataOffset), header.m_IndexDataSize);
+		};
+
+		const auto print_timings = [&](const char* inFormat, const std::string& inFile, const std::function<void()>& inLoad)
+		{
+			std::string cold = "n/a";
+			if (EvictFromFileCache(inFile))
+				cold = FormatTimings(MeasureRuns(NumRuns, inLoad, [&]() { EvictFromFileCache(inFile); }));
+
+			// Once to load the cache
+			inLoad();
+			const std::string warm = FormatTimings(MeasureRuns(NumRuns, inLoad));
+
+			printf("%-24s %-6s %10.1f %21s %21s\n", name.c_str(), inFormat, GetFileSizeInMB(inFile), cold.c_str(), warm.c_str());
+		};
+
+		print_timings("OBJ", file, load_obj);
+		print_timings("amesh", baked_file, load_baked);
+	}
+}
@@ -0,0 +1,107 @@
+#include "Engine.h"
+#include "Benchmark.h"
+
+#include "Utils/FileReader.h"
+#include "Utils/JobSystem.h"
+#include "Utils/PackFile.h"
+
+#include <cstdio>
+#include <filesystem>
+#include <random>
+
+// Size of a pack against the loose files it contains, and FileReader throughput reading them from either
+
+static constexpr uint32 NumRuns = 3;
+
+BENCHMARK(PackFileAgainstLooseFiles)
+{
+	g_JobSystem.Init();
+
+	std::error_code error_code;
+	const std::string directory = GetBenchmarkDirectory() + "/PackFileAgainstLooseFiles";
+	std::filesystem::create_directories(directory, error_code);
+
+	// Many small assets and a large mesh
+	std::mt19937 random(18);
+	std::uniform_int_distribution<uint64> small_file_size(4 * 1024, 256 * 1024);
+
+	std::vector<std::string> files;
+	uint64 loose_size = 0;
+	for (uint32 i = 0; i < 200; i++)
+	{
+		files.push_back(directory + "/Asset" + std::to_string(i) + ".obj");
+		WriteObjLikeFile(files.back(), small_file_size(random), i);
+	}
+	files.push_back(directory + "/LargeMesh.obj");
+	WriteObjLikeFile(files.back(), 64 * 1024 * 1024, 1000);
+
+	for (const std::string& file : files)
+		loose_size += std::filesystem::file_size(file);
+
+	const auto read_files = [&]()
+	{
+		for (const std::string& file : files)
+		{
+			FileReader file_reader;
+			const bool success = file_reader.ReadFile(file);
+			Assert(success);
+		}
+	};
+
+	const auto print_timings = [&](const char* inSource, const std::vector<std::string>& inEvictedFiles)
+	{
+		const bool can_evict = EvictFromFileCache(inEvictedFiles[0]);
+
+		char cold[64] = "n/a";
+		if (can_evict)
+		{
+			const BenchmarkTimings cold_timings = MeasureRuns(NumRuns, read_files, [&]()
+			{
+				for (const std::string& file : inEvictedFiles)
+					EvictFromFileCache(file);
+			});
+			snprintf(cold, sizeof(cold), "%.1f-%.1f", cold_timings.m_MinMs, cold_timings.m_MaxMs);
+		}
+
+		read_files();
+		const BenchmarkTimings warm_timings = MeasureRuns(NumRuns, read_files);
+
+		char warm[64];
+		snprintf(warm, sizeof(warm), "%.1f-%.1f", warm_timings.m_MinMs, warm_timings.m_MaxMs);
+		printf("%-20s %20s %20s %12.2f\n", inSource, cold, warm, loose_size / (1024.0 * 1024.0 * 1024.0) / (warm_timings.m_MinMs / 1000.0));
+	};
+
+	printf("%zu files, %u workers, %u runs\n", files.size(), g_JobSystem.GetNumWorkers(), NumRuns);
+
+	const uint32 block_sizes[] = { 4 * 1024, PackFileFormat::DefaultBlockSize };
+	for (uint32 block_size : block_sizes)
+	{
+		const std::string pack = directory + "/Pack" + std::to_string(block_size / 1024) + "KB.apak";
+		const bool success = PackFile::Write(pack, files, block_size);
+		Assert(success);
+
+		printf("%u KB blocks: %llu bytes loose, %llu bytes packed (%.1f%%)\n", block_size / 1024,
+			   static_cast<unsigned long long>(loose_size), static_cast<unsigned long long>(std::filesystem::file_size(pack)),
+			   100.0 * std::filesystem::file_size(pack) / loose_size);
+	}
+
+	printf("%-20s %20s %20s %12s\n", "Source", "Cold (ms)", "Warm (ms)", "Warm GB/s");
+	print_timings("Loose", files);
+
+	for (uint32 block_size : block_sizes)
+	{
+		const std::string pack = directory + "/Pack" + std::to_string(block_size / 1024) + "KB.apak";
+
+		// Same paths, FileReader finds them in the pack first
+		const bool success = PackFile::Mount(pack);
+		Assert(success);
+
+		const std::string source = "Pack, " + std::to_string(block_size / 1024) + " KB blocks";
+		print_timings(source.c_str(), { pack });
+
+		PackFile::UnmountAll();
+	}
+
+	std::filesystem::remove_all(directory, error_code);
+	g_JobSystem.Shutdown();
+}
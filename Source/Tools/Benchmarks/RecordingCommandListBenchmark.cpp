@@ -0,0 +1,150 @@
+#include "Engine.h"
+#include "Benchmark.h"
+
+#include "Gfx/RecordingCommandList.h"
+
+#include <algorithm>
+#include <climits>
+#include <cstdio>
+#include <random>
+
+// CPU cost of building a frame through the CommandList interface, recorded instead of sent to a GPU.
+// The frame looks like the one of Test.cpp: a G-buffer pass then draws that bind a shader, a mesh, a texture table
+// and a per-draw constant buffer. D3D12 objects are made up pointers, the recording backend never dereferences them
+
+static constexpr uint32 NumRuns			= 10;
+static constexpr uint32 NumShaders		= 16;
+static constexpr uint32 NumMeshPages	= 8;
+static constexpr uint32 NumTextures		= 64;
+
+template <typename T>
+static inline T* MakeFakeObject(uint32 inType, uint32 inIndex)
+{
+	return reinterpret_cast<T*>(static_cast<uintptr_t>((static_cast<uint64>(inType) << 32) | ((inIndex + 1) << 8)));
+}
+
+struct SyntheticDraw
+{
+	uint32	m_Shader;
+	uint32	m_MeshPage;
+	uint32	m_Texture;
+	uint32	m_NumIndices;
+	uint32	m_StartIndex;
+};
+
+// In state order like a sorted DrawQueue, or shuffled like an unsorted one
+static std::vector<SyntheticDraw> MakeDraws(uint32 inNumDraws, bool inSorted)
+{
+	std::mt19937 random(inNumDraws);
+
+	std::vector<SyntheticDraw> draws(inNumDraws);
+	for (uint32 i = 0; i < inNumDraws; i++)
+	{
+		SyntheticDraw& draw	= draws[i];
+		draw.m_Shader		= random() % NumShaders;
+		draw.m_MeshPage		= random() % NumMeshPages;
+		draw.m_Texture		= random() % NumTextures;
+		draw.m_NumIndices	= 3 * (1 + random() % 1000);
+		draw.m_StartIndex	= 3 * (random() % 10000);
+	}
+
+	if (inSorted)
+	{
+		std::sort(draws.begin(), draws.end(), [](const SyntheticDraw& inLeft, const SyntheticDraw& inRight)
+		{
+			if (inLeft.m_Shader != inRight.m_Shader)
+				return inLeft.m_Shader < inRight.m_Shader;
+			if (inLeft.m_MeshPage != inRight.m_MeshPage)
+				return inLeft.m_MeshPage < inRight.m_MeshPage;
+			return inLeft.m_Texture < inRight.m_Texture;
+		});
+	}
+
+	return draws;
+}
+
+static void RecordFrame(CommandList& ioCommandList, const std::vector<SyntheticDraw>& inDraws)
+{
+	ID3D12Resource* back_buffer				= MakeFakeObject<ID3D12Resource>(1, 0);
+	ID3D12DescriptorHeap* descriptor_heap	= MakeFakeObject<ID3D12DescriptorHeap>(2, 0);
+	const D3D12_CPU_DESCRIPTOR_HANDLE rtv	= { 0x1000 };
+	const D3D12_CPU_DESCRIPTOR_HANDLE dsv	= { 0x2000 };
+
+	const CD3DX12_RESOURCE_BARRIER to_render_target = CD3DX12_RESOURCE_BARRIER::Transition(back_buffer, D3D12_RESOURCE_STATE_PRESENT, D3D12_RESOURCE_STATE_RENDER_TARGET);
+	ioCommandList.ResourceBarrier(1, &to_render_target);
+
+	const float clear_color[4] = { 0.0f, 0.0f, 0.0f, 1.0f };
+	ioCommandList.ClearRenderTargetView(rtv, clear_color);
+	ioCommandList.ClearDepthStencilView(dsv, D3D12_CLEAR_FLAG_DEPTH, 1.0f, 0);
+	ioCommandList.OMSetRenderTargets(1, &rtv, false, &dsv);
+
+	const D3D12_RECT		scissor_rect	= CD3DX12_RECT(0, 0, LONG_MAX, LONG_MAX);
+	const D3D12_VIEWPORT	viewport		= CD3DX12_VIEWPORT(0.0f, 0.0f, 1920.0f, 1080.0f);
+	ioCommandList.RSSetViewports(1, &viewport);
+	ioCommandList.RSSetScissorRects(1, &scissor_rect);
+	ioCommandList.SetDescriptorHeaps(1, &descriptor_heap);
+
+	// Textures are copied to the frame's descriptors once, like Test.cpp does
+	D3D12_GPU_DESCRIPTOR_HANDLE texture_tables[NumTextures];
+	for (uint32 i = 0; i < NumTextures; i++)
+		texture_tables[i] = ioCommandList.CopyDescriptor({ 0x10000 + i * 0x20 });
+
+	D3D12_GPU_VIRTUAL_ADDRESS constant_buffer = 0x100000000ull;
+	for (const SyntheticDraw& draw : inDraws)
+	{
+		// Everything bound for every draw, as DrawQueue::Submit does
+		ioCommandList.SetGraphicsRootSignature(MakeFakeObject<ID3D12RootSignature>(3, draw.m_Shader / 4));
+		ioCommandList.SetPipelineState(MakeFakeObject<ID3D12PipelineState>(4, draw.m_Shader));
+
+		const D3D12_VERTEX_BUFFER_VIEW	vertex_buffer	= { 0x200000000ull + draw.m_MeshPage * 0x1000000ull, 0x1000000, 32 };
+		const D3D12_INDEX_BUFFER_VIEW	index_buffer	= { 0x300000000ull + draw.m_MeshPage * 0x1000000ull, 0x1000000, DXGI_FORMAT_R32_UINT };
+		ioCommandList.IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+		ioCommandList.IASetVertexBuffers(0, 1, &vertex_buffer);
+		ioCommandList.IASetIndexBuffer(&index_buffer);
+
+		ioCommandList.SetGraphicsRootDescriptorTable(0, texture_tables[draw.m_Texture]);
+		ioCommandList.SetGraphicsRootConstantBufferView(1, constant_buffer);
+		constant_buffer += D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT;
+
+		ioCommandList.DrawIndexedInstanced(draw.m_NumIndices, 1, draw.m_StartIndex, 0, 0);
+	}
+
+	const CD3DX12_RESOURCE_BARRIER to_present = CD3DX12_RESOURCE_BARRIER::Transition(back_buffer, D3D12_RESOURCE_STATE_RENDER_TARGET, D3D12_RESOURCE_STATE_PRESENT);
+	ioCommandList.ResourceBarrier(1, &to_present);
+}
+
+BENCHMARK(RecordingCommandListFrame)
+{
+	const uint32 draw_counts[] = { 1000, 10000, 100000 };
+
+	printf("%-10s %8s %21s %8s %10s %10s %10s %10s\n", "Order", "Draws", "Frame (ms)", "ns/draw", "Commands", "Stream KB", "Redundant", "PSO swaps");
+
+	RecordingCommandList command_list;
+	for (uint32 num_draws : draw_counts)
+	{
+		for (bool sorted : { true, false })
+		{
+			const std::vector<SyntheticDraw> draws = MakeDraws(num_draws, sorted);
+
+			// Through the interface, like the renderer
+			CommandList& frame_command_list = command_list;
+			const auto record_frame = [&]()
+			{
+				command_list.Reset();
+				RecordFrame(frame_command_list, draws);
+			};
+
+			// The first frame grows the stream, the measured ones reuse it
+			record_frame();
+			const BenchmarkTimings timings = MeasureRuns(NumRuns, record_frame);
+
+			const RecordingStatistics& statistics = command_list.GetStatistics();
+			Assert(statistics.m_NumErrors == 0, "The synthetic frame must be valid");
+			Assert(statistics.m_NumDraws == num_draws);
+
+			printf("%-10s %8u %10.3f-%-10.3f %8.1f %10llu %10.0f %10llu %10llu\n", sorted ? "Sorted" : "Shuffled", num_draws,
+				   timings.m_MinMs, timings.m_MaxMs, timings.m_MinMs * 1e6 / num_draws, statistics.m_NumCommands,
+				   command_list.GetStream().size() / 1024.0, statistics.m_NumRedundantCommands, statistics.m_NumPipelineStateSwitches);
+		}
+	}
+}
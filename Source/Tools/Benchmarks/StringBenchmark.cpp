@@ -0,0 +1,250 @@
+#include "Engine.h"
+#include "Benchmark.h"
+
+#include "Utils/FileReader.h"
+#include "Utils/String.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// String::ParseFloat and ParseInt against the C and C++ libraries on numbers written like OBJ files write them.
+// strtof and ParseFloat walk one buffer of space separated numbers. std::stof and std::stoi need a std::string per number,
+// those are built ahead of time so only the conversion is timed
+
+static constexpr uint32 NumNumbers	= 1000000;
+static constexpr uint32 NumRuns		= 5;
+
+struct NumberSet
+{
+	const char*					m_Name;
+	std::string					m_Text;			// Numbers separated by a space
+	std::vector<std::string>	m_Numbers;
+};
+
+template<typename Generator>
+static NumberSet MakeNumberSet(const char* inName, Generator inGenerator)
+{
+	NumberSet set;
+	set.m_Name = inName;
+
+	char number[64];
+	for (uint32 i = 0; i < NumNumbers; i++)
+	{
+		inGenerator(number, sizeof(number));
+		set.m_Text += number;
+		set.m_Text += ' ';
+		set.m_Numbers.emplace_back(number);
+	}
+	return set;
+}
+
+static void PrintTimings(const NumberSet& inSet, const char* inParser, const BenchmarkTimings& inTimings)
+{
+	printf("%-16s %-16s %10.2f-%-10.2f %10.1f %10.1f\n", inSet.m_Name, inParser, inTimings.m_MinMs, inTimings.m_MaxMs,
+		   inTimings.m_MinMs * 1e6 / NumNumbers, NumNumbers / (inTimings.m_MinMs * 1e3));
+}
+
+BENCHMARK(StringParseFloat)
+{
+	std::mt19937 random(14);
+	std::uniform_real_distribution<float> position(-100.0f, 100.0f);
+	std::uniform_real_distribution<float> exponent(-30.0f, 30.0f);
+
+	const NumberSet sets[] =
+	{
+		// Blender writes 6 decimals
+		MakeNumberSet("Positions %.6f", [&](char* outNumber, size_t inSize) { snprintf(outNumber, inSize, "%.6f", position(random)); }),
+		// Enough digits to get the exact float back, any magnitude
+		MakeNumberSet("Any float %.9g", [&](char* outNumber, size_t inSize) { snprintf(outNumber, inSize, "%.9g", position(random) * std::pow(10.0f, exponent(random))); }),
+	};
+
+	printf("%u numbers, %u runs\n", NumNumbers, NumRuns);
+	printf("%-16s %-16s %21s %10s %10s\n", "Numbers", "Parser", "Time (ms)", "ns/number", "M/s");
+
+	for (const NumberSet& set : sets)
+	{
+		const char* text_begin	= set.m_Text.data();
+		const char* text_end	= text_begin + set.m_Text.size();
+
+		// Sums keep the compiler from dropping the conversions, and tell whether all parsers agree
+		double parse_float_sum	= 0.0;
+		double strtof_sum		= 0.0;
+		double stof_sum			= 0.0;
+
+		PrintTimings(set, "String", MeasureRuns(NumRuns, [&]()
+		{
+			parse_float_sum = 0.0;
+			for (const char* cursor = text_begin; cursor < text_end; cursor++)
+			{
+				float value = 0.0f;
+				cursor = String::ParseFloat(cursor, text_end, value);
+				parse_float_sum += value;
+			}
+		}));
+
+		PrintTimings(set, "strtof", MeasureRuns(NumRuns, [&]()
+		{
+			strtof_sum = 0.0;
+			for (const char* cursor = text_begin; cursor < text_end; cursor++)
+			{
+				char* number_end = nullptr;
+				strtof_sum += ::strtof(cursor, &number_end);
+				cursor = number_end;
+			}
+		}));
+
+		PrintTimings(set, "std::stof", MeasureRuns(NumRuns, [&]()
+		{
+			stof_sum = 0.0;
+			for (const std::string& number : set.m_Numbers)
+				stof_sum += std::stof(number);
+		}));
+
+		// Correctly rounded parsers give the same floats, so the same sums
+		Assert(parse_float_sum == strtof_sum && parse_float_sum == stof_sum, "String::ParseFloat must match strtof");
+
+		printf("\n");
+	}
+
+	// Face indices
+	std::uniform_int_distribution<int32> index(1, 5000000);
+	const NumberSet indices = MakeNumberSet("Indices", [&](char* outNumber, size_t inSize) { snprintf(outNumber, inSize, "%d", index(random)); });
+
+	const char* text_begin	= indices.m_Text.data();
+	const char* text_end	= text_begin + indices.m_Text.size();
+
+	int64 parse_int_sum	= 0;
+	int64 strtol_sum	= 0;
+	int64 stoi_sum		= 0;
+
+	PrintTimings(indices, "String", MeasureRuns(NumRuns, [&]()
+	{
+		parse_int_sum = 0;
+		for (const char* cursor = text_begin; cursor < text_end; cursor++)
+		{
+			int32 value = 0;
+			cursor = String::ParseInt(cursor, text_end, value);
+			parse_int_sum += value;
+		}
+	}));
+
+	PrintTimings(indices, "strtol", MeasureRuns(NumRuns, [&]()
+	{
+		strtol_sum = 0;
+		for (const char* cursor = text_begin; cursor < text_end; cursor++)
+		{
+			char* number_end = nullptr;
+			strtol_sum += ::strtol(cursor, &number_end, 10);
+			cursor = number_end;
+		}
+	}));
+
+	PrintTimings(indices, "std::stoi", MeasureRuns(NumRuns, [&]()
+	{
+		stoi_sum = 0;
+		for (const std::string& number : indices.m_Numbers)
+			stoi_sum += std::stoi(number);
+	}));
+
+	Assert(parse_int_sum == strtol_sum && parse_int_sum == stoi_sum, "String::ParseInt must match strtol");
+}
+
+// Line and token iterators over a FileReader buffer against GetLine and Split, the way the OBJ, MTL and INI
+// parsers used them. Counts heap allocations per line: the iterators must not make any
+BENCHMARK(StringLines)
+{
+	constexpr uint64 file_size = 64 * 1024 * 1024;
+
+	const std::string file = GetBenchmarkDirectory() + "/StringLines.obj";
+	if (!WriteObjLikeFile(file, file_size, 15))
+	{
+		printf("Can't write %s\n", file.c_str());
+		return;
+	}
+
+	FileReader file_reader;
+	if (!file_reader.ReadFile(file))
+	{
+		printf("Can't read %s\n", file.c_str());
+		return;
+	}
+
+	const char* content_begin	= file_reader.GetContentAsString();
+	const char* content_end		= content_begin + file_reader.GetContentSize();
+	const double size_in_mb		= file_reader.GetContentSize() / (1024.0 * 1024.0);
+
+	// Same counts from every version, or they don't split the same way
+	uint64 num_lines	= 0;
+	uint64 num_tokens	= 0;
+
+	struct Result
+	{
+		uint64	m_NumLines;
+		uint64	m_NumTokens;
+		uint64	m_NumAllocations;
+	};
+
+	const auto measure = [&](const char* inName, const std::function<void()>& inRun)
+	{
+		const uint64 num_allocations_before = GetNumAllocations();
+		const BenchmarkTimings timings = MeasureRuns(NumRuns, [&]()
+		{
+			num_lines	= 0;
+			num_tokens	= 0;
+			inRun();
+		});
+		const uint64 num_allocations = (GetNumAllocations() - num_allocations_before) / NumRuns;
+
+		printf("%-24s %10.2f-%-10.2f %10.1f %10.1f %14.2f\n", inName, timings.m_MinMs, timings.m_MaxMs,
+			   timings.m_MinMs * 1e6 / num_lines, size_in_mb / (timings.m_MinMs * 1e-3), static_cast<double>(num_allocations) / num_lines);
+		return Result { num_lines, num_tokens, num_allocations };
+	};
+
+	printf("%.0f MB, %u runs\n", size_in_mb, NumRuns);
+	printf("%-24s %21s %10s %10s %14s\n", "Parser", "Time (ms)", "ns/line", "MB/s", "Allocs/line");
+
+	const Result tokens = measure("Lines + Tokens", [&]()
+	{
+		for (std::string_view line : String::Lines(content_begin, content_end))
+		{
+			num_lines++;
+			for (std::string_view token : String::Tokens(line))
+				num_tokens += !token.empty();
+		}
+	});
+
+	const Result split_view = measure("Lines + SplitView", [&]()
+	{
+		for (std::string_view line : String::Lines(content_begin, content_end))
+		{
+			num_lines++;
+			for (std::string_view part : String::SplitView(line, " "))
+				num_tokens += !part.empty();
+		}
+	});
+
+	const Result split = measure("GetLine + Split", [&]()
+	{
+		std::istringstream stream(std::string(content_begin, content_end));
+		std::string line;
+		while (String::GetLine(stream, line))
+		{
+			// GetLine returns an empty line after the last delimiter
+			if (line.empty() && stream.eof())
+				break;
+
+			num_lines++;
+			for (const std::string& part : String::Split(line, " "))
+				num_tokens += !part.empty();
+		}
+	});
+
+	Assert(tokens.m_NumLines == split_view.m_NumLines && tokens.m_NumLines == split.m_NumLines, "Line iterators must match GetLine");
+	Assert(tokens.m_NumTokens == split_view.m_NumTokens && tokens.m_NumTokens == split.m_NumTokens, "Token iterators must match Split");
+	Assert(tokens.m_NumAllocations == 0 && split_view.m_NumAllocations == 0, "Line and token iterators must not allocate");
+}
@@ -28,7 +28,7 @@ namespace ShaderCompiler
 				engine_type = "uint32";
 				break;
 			case "half":
-				engine_type = "int16";
+				engine_type = (inStructElement.Normalization == "unorm") ? "uint16" : "int16";
 				break;
 			default:
 				engine_type = scalar_type;
@@ -9,6 +9,7 @@ namespace ShaderCompiler
 	class StructElement
 	{
 		public string Interpolation;
+		public string Normalization;
 		public string BaseTypeName;
 		public string VariableName;
 		public string Semantic;
@@ -36,8 +37,16 @@ namespace ShaderCompiler
 			"sample",
 		};
 
+		private static readonly string[] AllNormalizations =
+		{
+			"snorm",
+			"unorm",
+		};
+
 		private static readonly string VariableNameRegex = @"([a-z_][a-z0-9_]*)";
 		private static readonly string InterpolationRegex = "(" + string.Join("|", AllInterpolations) + ")";
+		// Only matches right where the previous match ended
+		private static readonly string NormalizationRegex = @"\G\s*(" + string.Join("|", AllNormalizations) + @")\s+";
 		private static readonly string TypeNameRegex =
 			@"\s*" +										//	Match spaces, if any
 			VariableNameRegex +								// GROUP 1: Full type
@@ -64,6 +73,15 @@ namespace ShaderCompiler
 				current_pos += interpolation_match.Length;
 			}
 
+			// Find normalization modifier, if any. Only relevant for vertex layouts, e.g. "snorm half2 Normal : NORMAL"
+			Regex normalization_reg = new Regex(NormalizationRegex, RegexOptions.None);
+			Match normalization_match = normalization_reg.Match(shaderCode, current_pos);
+			if (normalization_match.Success)
+			{
+				Normalization = normalization_match.Groups[1].ToString();
+				current_pos += normalization_match.Length;
+			}
+
 			// Find Type, Name, ArrayCount (if any)
 			Regex type_reg = new Regex(TypeNameRegex, RegexOptions.IgnoreCase);
 			Match type_match = type_reg.Match(shaderCode, current_pos);
@@ -115,6 +133,7 @@ namespace ShaderCompiler
 			switch (BaseTypeName)
 			{
 			case "float":
+			case "half":
 				dxgi_type = "FLOAT";
 				break;
 			case "int":
@@ -138,8 +157,12 @@ namespace ShaderCompiler
 			if (NumCol > 3)
 				dxgi_channels += "A{0}";
 
-			// Stick with 32bits types only for now
-			int type_size = 32;
+			// Normalized integers are stored with the same size, e.g. "snorm half2" -> R16G16_SNORM
+			if (Normalization != null)
+				dxgi_type = Normalization.ToUpper();
+
+			// Half are stored in 16bits, stick with 32bits types for everything else
+			int type_size = (BaseTypeName == "half") ? 16 : 32;
 			dxgi_channels = String.Format(dxgi_channels, type_size);
 
 			dxgi_format = String.Format(@"DXGI_FORMAT_{0}_{1}", dxgi_channels, dxgi_type);
@@ -0,0 +1,246 @@
+#include "Engine.h"
+#include "UnitTest.h"
+
+#include "Gfx/AssetManager.h"
+#include "Utils/AsyncIO.h"
+#include "Utils/FileReader.h"
+#include "Utils/JobSystem.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <filesystem>
+#include <fstream>
+
+// AssetManager without a renderer: test assets load a text file and upload nothing, their content says whether they fail.
+// Missing files are only tried through AsyncIO, FileReader asserts on them
+
+static std::atomic<uint32> s_NumLoads		= 0;
+static std::atomic<uint32> s_NumLiveAssets	= 0;
+
+static constexpr const char* FailLoadContent	= "FailLoad";
+static constexpr const char* FailUploadContent	= "FailUpload";
+
+class TestAsset : public Asset
+{
+public:
+	static constexpr const char* TypeName = "Test";
+
+	TestAsset()						{ s_NumLiveAssets++; }
+	~TestAsset() override			{ s_NumLiveAssets--; }
+
+	inline const std::string&		GetContent() const		{ return m_Content; }
+
+protected:
+	bool Load(const AssetFile&) override
+	{
+		s_NumLoads++;
+
+		FileReader file_reader;
+		if (!file_reader.ReadFile(GetPath()))
+			return false;
+
+		m_Content.assign(static_cast<const char*>(file_reader.GetContentAsBinary()), static_cast<size_t>(file_reader.GetContentSize()));
+		return m_Content != FailLoadContent;
+	}
+
+	bool Upload(const AssetUploadContext&) override
+	{
+		return m_Content != FailUploadContent;
+	}
+
+	std::string		m_Content;
+};
+
+// Same file, read by the AssetManager
+class WholeFileTestAsset final : public TestAsset
+{
+public:
+	static constexpr const char* TypeName = "WholeFileTest";
+
+protected:
+	bool ReadsWholeFile() const override	{ return true; }
+
+	bool Load(const AssetFile& inFile) override
+	{
+		s_NumLoads++;
+
+		m_Content.assign(reinterpret_cast<const char*>(inFile.m_Data), static_cast<size_t>(inFile.m_Size));
+		return m_Content != FailLoadContent;
+	}
+};
+
+static std::string WriteTestFile(const std::string& inName, const std::string& inContent)
+{
+	const std::string directory = GetTestDirectory() + "/Assets";
+	std::error_code error_code;
+	std::filesystem::create_directories(directory, error_code);
+
+	const std::string file = directory + "/" + inName;
+	std::ofstream stream(file, std::ios::binary);
+	stream << inContent;
+	return file;
+}
+
+// Load everything requested and upload it
+static void LoadAndUpdate()
+{
+	g_AssetManager.WaitForLoads();
+	g_AssetManager.Update(AssetUploadContext());
+}
+
+UNIT_TEST(AssetManagerDeduplicates)
+{
+	g_JobSystem.Init(2);
+	s_NumLoads = 0;
+
+	const std::string file = WriteTestFile("Dedup.txt", "Content");
+
+	// Case, slashes and a leading "./" don't matter
+	std::string other_spelling = "./" + file;
+	std::transform(other_spelling.begin(), other_spelling.end(), other_spelling.begin(), [](char inChar)
+	{
+		return inChar == '/' ? '\\' : static_cast<char>(std::toupper(static_cast<unsigned char>(inChar)));
+	});
+
+	{
+		AssetHandle<TestAsset> handle			= g_AssetManager.Load<TestAsset>(file);
+		AssetHandle<TestAsset> same_handle		= g_AssetManager.Load<TestAsset>(file);
+		AssetHandle<TestAsset> other_spelling_handle = g_AssetManager.Load<TestAsset>(other_spelling);
+		// Another type is another asset
+		AssetHandle<WholeFileTestAsset> other_type_handle = g_AssetManager.Load<WholeFileTestAsset>(file);
+
+		LoadAndUpdate();
+
+		CHECK(handle.IsReady() && same_handle.IsReady() && other_spelling_handle.IsReady() && other_type_handle.IsReady());
+		CHECK(handle.Get() == same_handle.Get());
+		CHECK(handle.Get() == other_spelling_handle.Get());
+		CHECK(static_cast<TestAsset*>(other_type_handle.Get()) != handle.Get());
+		CHECK(s_NumLoads == 2);
+
+		const AssetManagerStatistics statistics = g_AssetManager.GetStatistics();
+		CHECK(statistics.m_NumAssets == 2);
+		CHECK(statistics.m_NumRequests == 4);
+		CHECK(statistics.m_NumDeduplicated == 2);
+	}
+
+	g_AssetManager.Shutdown();
+	CHECK(s_NumLiveAssets == 0);
+	g_JobSystem.Shutdown();
+}
+
+UNIT_TEST(AssetManagerStates)
+{
+	g_JobSystem.Init(2);
+
+	const std::string file				= WriteTestFile("Valid.txt", "Content");
+	const std::string fail_upload_file	= WriteTestFile("FailUpload.txt", FailUploadContent);
+	const std::string fail_load_file	= WriteTestFile("FailLoad.txt", FailLoadContent);
+
+	{
+		AssetHandle<TestAsset> handle				= g_AssetManager.Load<TestAsset>(file);
+		AssetHandle<TestAsset> fail_upload_handle	= g_AssetManager.Load<TestAsset>(fail_upload_file);
+		AssetHandle<TestAsset> fail_load_handle		= g_AssetManager.Load<TestAsset>(fail_load_file);
+
+		// Loaded assets stay Pending until Update uploads them, failed loads don't wait for it
+		g_AssetManager.WaitForLoads();
+		CHECK(handle.GetState() == AssetState::Pending);
+		CHECK(fail_upload_handle.GetState() == AssetState::Pending);
+		CHECK(fail_load_handle.GetState() == AssetState::Failed);
+
+		CHECK(g_AssetManager.Update(AssetUploadContext()) == 2);
+		CHECK(handle.GetState() == AssetState::Ready);
+		CHECK(handle->GetContent() == "Content");
+		CHECK(fail_upload_handle.GetState() == AssetState::Failed);
+		CHECK(fail_load_handle.GetState() == AssetState::Failed);
+
+		const AssetManagerStatistics statistics = g_AssetManager.GetStatistics();
+		CHECK(statistics.m_NumPending == 0);
+		CHECK(statistics.m_NumReady == 1);
+		CHECK(statistics.m_NumFailed == 2);
+
+		// An empty handle is Failed
+		AssetHandle<TestAsset> empty_handle;
+		CHECK(!empty_handle.IsValid());
+		CHECK(empty_handle.GetState() == AssetState::Failed);
+	}
+
+	g_AssetManager.Shutdown();
+	CHECK(s_NumLiveAssets == 0);
+	g_JobSystem.Shutdown();
+}
+
+UNIT_TEST(AssetManagerRelease)
+{
+	g_JobSystem.Init(2);
+	s_NumLoads = 0;
+
+	const std::string file = WriteTestFile("Release.txt", "Content");
+
+	AssetHandle<TestAsset> handle = g_AssetManager.Load<TestAsset>(file);
+	LoadAndUpdate();
+	CHECK(handle.IsReady());
+	const TestAsset* asset = handle.Get();
+
+	// Unreferenced but kept for the frames the GPU can be behind, loading it again revives it without reading it again
+	handle.Reset();
+	for (uint32 i = 0; i < AssetManager::FramesBeforeRelease - 1; i++)
+		g_AssetManager.Update(AssetUploadContext());
+	CHECK(s_NumLiveAssets == 1);
+
+	handle = g_AssetManager.Load<TestAsset>(file);
+	CHECK(handle.IsReady());
+	CHECK(handle.Get() == asset);
+	CHECK(s_NumLoads == 1);
+
+	// Revived for good: more frames than FramesBeforeRelease don't delete it
+	for (uint32 i = 0; i < AssetManager::FramesBeforeRelease + 1; i++)
+		g_AssetManager.Update(AssetUploadContext());
+	CHECK(handle.IsReady());
+	CHECK(s_NumLiveAssets == 1);
+
+	// Deleted FramesBeforeRelease frames after the last handle is gone
+	handle.Reset();
+	for (uint32 i = 0; i < AssetManager::FramesBeforeRelease - 1; i++)
+		g_AssetManager.Update(AssetUploadContext());
+	CHECK(s_NumLiveAssets == 1);
+
+	g_AssetManager.Update(AssetUploadContext());
+	CHECK(s_NumLiveAssets == 0);
+	CHECK(g_AssetManager.GetStatistics().m_NumAssets == 0);
+
+	// Loading it now is a new asset
+	handle = g_AssetManager.Load<TestAsset>(file);
+	LoadAndUpdate();
+	CHECK(handle.IsReady());
+	CHECK(s_NumLoads == 2);
+	handle.Reset();
+
+	g_AssetManager.Shutdown();
+	CHECK(s_NumLiveAssets == 0);
+	g_JobSystem.Shutdown();
+}
+
+UNIT_TEST(AssetManagerAsyncIO)
+{
+	g_JobSystem.Init(2);
+	g_AsyncIO.Init();
+
+	const std::string file			= WriteTestFile("AsyncIO.txt", "Read by AsyncIO");
+	const std::string missing_file	= GetTestDirectory() + "/Assets/MissingAsyncIO.txt";
+
+	{
+		AssetHandle<WholeFileTestAsset> handle			= g_AssetManager.Load<WholeFileTestAsset>(file);
+		AssetHandle<WholeFileTestAsset> missing_handle	= g_AssetManager.Load<WholeFileTestAsset>(missing_file);
+
+		LoadAndUpdate();
+		CHECK(handle.IsReady());
+		CHECK(handle->GetContent() == "Read by AsyncIO");
+		CHECK(missing_handle.GetState() == AssetState::Failed);
+	}
+
+	g_AssetManager.Shutdown();
+	CHECK(s_NumLiveAssets == 0);
+	g_AsyncIO.Shutdown();
+	g_JobSystem.Shutdown();
+}
@@ -0,0 +1,195 @@
+#include "Engine.h"
+#include "UnitTest.h"
+
+#include "Math/BoundingVolumes.h"
+#include "Utils/FileReader.h"
+#include "Utils/String.h"
+
+#include <cmath>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+// BoundingVolumes against brute force bounds of the meshes in Data. Tests run from the root of the repository
+
+struct ObjPositions
+{
+	std::vector<Vec3>	m_Positions;
+	std::vector<uint32>	m_Indices;		// Position index of every face corner, in file order
+};
+
+// Only "v" and "f" lines matter, the rest of the file is skipped
+static bool LoadObjPositions(const std::string& inFile, ObjPositions& outPositions)
+{
+	if (!std::filesystem::exists(inFile))
+		return false;
+
+	FileReader file_reader;
+	if (!file_reader.ReadFile(inFile))
+		return false;
+
+	const char* content = file_reader.GetContentAsString();
+	for (std::string_view line : String::Lines(content, content + file_reader.GetContentSize()))
+	{
+		String::Range<String::TokenIterator> tokens = String::Tokens(line);
+		String::TokenIterator token = tokens.begin();
+		if (token == tokens.end())
+			continue;
+
+		const std::string_view keyword = *token++;
+		if (keyword == "v")
+		{
+			Vec3 position;
+			for (int32 k = 0; k < 3 && token != tokens.end(); k++, token++)
+				position[k] = String::ToFloat(*token);
+			outPositions.m_Positions.push_back(position);
+		}
+		else if (keyword == "f")
+		{
+			for (; token != tokens.end(); token++)
+			{
+				const std::string_view position_index = token->substr(0, token->find('/'));
+				outPositions.m_Indices.push_back(static_cast<uint32>(String::ToInt(position_index) - 1));
+			}
+		}
+	}
+
+	return !outPositions.m_Positions.empty() && !outPositions.m_Indices.empty();
+}
+
+static AABB BruteForceAABB(const std::vector<Vec3>& inPositions, const uint32* inIndices, size_t inNumIndices)
+{
+	AABB aabb;
+	for (size_t i = 0; i < inNumIndices; i++)
+	{
+		for (int32 k = 0; k < 3; k++)
+		{
+			aabb.m_Min[k] = Math::Min(aabb.m_Min[k], inPositions[inIndices[i]][k]);
+			aabb.m_Max[k] = Math::Max(aabb.m_Max[k], inPositions[inIndices[i]][k]);
+		}
+	}
+	return aabb;
+}
+
+static bool IsSameAABB(const AABB& inLeft, const AABB& inRight)
+{
+	for (int32 k = 0; k < 3; k++)
+		if (inLeft.m_Min[k] != inRight.m_Min[k] || inLeft.m_Max[k] != inRight.m_Max[k])
+			return false;
+	return true;
+}
+
+// Bounds of the first inNumIndices indices, from tightly packed positions and from a full vertex layout
+static void CheckBounds(const ObjPositions& inMesh, size_t inNumIndices)
+{
+	struct Vertex
+	{
+		Vec3	m_Position;
+		Vec2	m_UV;
+		Vec3	m_Normal;
+	};
+
+	std::vector<Vertex> vertices(inMesh.m_Positions.size());
+	for (size_t v = 0; v < vertices.size(); v++)
+		vertices[v].m_Position = inMesh.m_Positions[v];
+
+	const uint32* indices	= inMesh.m_Indices.data();
+	const AABB expected		= BruteForceAABB(inMesh.m_Positions, indices, inNumIndices);
+
+	// Stride 12 is the case where a 16 byte load of the last position would read past the buffer
+	const AABB packed_aabb	= BoundingVolumes::ComputeAABB(indices, inNumIndices, &inMesh.m_Positions[0].x, sizeof(Vec3));
+	const AABB vertex_aabb	= BoundingVolumes::ComputeAABB(indices, inNumIndices, &vertices[0].m_Position.x, sizeof(Vertex));
+	CHECK(IsSameAABB(packed_aabb, expected));
+	CHECK(IsSameAABB(vertex_aabb, expected));
+
+	const BoundingSphere sphere = BoundingVolumes::ComputeSphere(indices, inNumIndices, &vertices[0].m_Position.x, sizeof(Vertex), vertex_aabb);
+	if (inNumIndices == 0)
+	{
+		CHECK(expected.IsEmpty() && vertex_aabb.IsEmpty() && sphere.IsEmpty());
+		return;
+	}
+
+	// Never larger than the sphere around the box, and every vertex is inside both volumes
+	const float aabb_radius	= expected.GetHalfExtents().Length();
+	const float epsilon		= 1e-5f * Math::Max(1.0f, aabb_radius);
+	CHECK(sphere.m_Radius >= 0.0f && sphere.m_Radius <= aabb_radius + epsilon);
+
+	bool all_contained = true;
+	for (size_t i = 0; i < inNumIndices; i++)
+	{
+		const Vec3& position = inMesh.m_Positions[indices[i]];
+		all_contained &= vertex_aabb.Contains(position) && sphere.Contains(position, epsilon);
+	}
+	CHECK(all_contained);
+}
+
+static void CheckMesh(const char* inFile)
+{
+	ObjPositions mesh;
+	const bool is_loaded = LoadObjPositions(inFile, mesh);
+	CHECK(is_loaded);
+	if (!is_loaded)
+		return;
+
+	// Pairs of vertices go through SSE2, an odd count leaves one for the scalar tail
+	const size_t num_indices = mesh.m_Indices.size();
+	for (size_t count : { size_t(0), size_t(1), size_t(2), size_t(3), size_t(4), size_t(7), num_indices - 1, num_indices })
+		CheckBounds(mesh, count);
+
+	// The last index of the buffer points at the last position, right at the end of the allocation
+	mesh.m_Indices.push_back(static_cast<uint32>(mesh.m_Positions.size() - 1));
+	CheckBounds(mesh, mesh.m_Indices.size());
+}
+
+UNIT_TEST(BoundingVolumesCornellBox)
+{
+	CheckMesh("Data/Cornell_fake_box.obj");
+}
+
+UNIT_TEST(BoundingVolumesLightbulb)
+{
+	CheckMesh("Data/Lightbulb.obj");
+}
+
+UNIT_TEST(BoundingVolumesTransform)
+{
+	ObjPositions mesh;
+	CHECK(LoadObjPositions("Data/Lightbulb.obj", mesh));
+	if (mesh.m_Indices.empty())
+		return;
+
+	const size_t num_indices	= mesh.m_Indices.size();
+	const float* positions		= &mesh.m_Positions[0].x;
+	const AABB aabb				= BoundingVolumes::ComputeAABB(mesh.m_Indices.data(), num_indices, positions, sizeof(Vec3));
+	const BoundingSphere sphere	= BoundingVolumes::ComputeSphere(mesh.m_Indices.data(), num_indices, positions, sizeof(Vec3), aabb);
+
+	// Rotation around Z, non uniform scale and a translation
+	const float cos_angle = std::cos(0.7f);
+	const float sin_angle = std::sin(0.7f);
+	const float rows[3][4] =
+	{
+		{ 2.0f * cos_angle,	-sin_angle,	0.0f,	3.0f },
+		{ 2.0f * sin_angle,	cos_angle,	0.0f,	-2.0f },
+		{ 0.0f,				0.0f,		0.5f,	10.0f },
+	};
+
+	Mat4x4 matrix = Mat4x4::Identity();
+	for (int32 r = 0; r < 3; r++)
+		for (int32 c = 0; c < 4; c++)
+			matrix(r, c) = rows[r][c];
+
+	AABB world_aabb;
+	BoundingSphere world_sphere;
+	BoundingVolumes::Transform(&aabb, 1, matrix, &world_aabb);
+	BoundingVolumes::Transform(&sphere, 1, matrix, &world_sphere);
+
+	// The transformed volumes still enclose the transformed vertices
+	const float epsilon = 1e-4f * world_sphere.m_Radius;
+	bool all_contained = true;
+	for (uint32 index : mesh.m_Indices)
+	{
+		const Vec3 position = matrix * mesh.m_Positions[index];
+		all_contained &= world_aabb.Contains(position, epsilon) && world_sphere.Contains(position, epsilon);
+	}
+	CHECK(all_contained);
+}
@@ -0,0 +1,236 @@
+#include "Engine.h"
+#include "UnitTest.h"
+
+#include "Utils/JobSystem.h"
+
+#include <atomic>
+#include <memory>
+#include <random>
+#include <thread>
+#include <vector>
+
+// Stress tests of the job system, each one with several worker counts. Worker counts above the number of cores
+// are on purpose: preemption in the middle of a steal is what breaks deques
+
+static const uint32 s_WorkerCounts[] = { 1, 2, 3, 4, 8 };
+
+static uint64 ForkJoinFibonacci(uint32 inN)
+{
+	if (inN < 2)
+		return inN;
+
+	// One half on a job, the other one here, then help until the job is done
+	uint64 a = 0;
+	JobCounter counter;
+	g_JobSystem.Schedule([&a, inN]() { a = ForkJoinFibonacci(inN - 1); }, &counter);
+	const uint64 b = ForkJoinFibonacci(inN - 2);
+	g_JobSystem.Wait(counter);
+
+	return a + b;
+}
+
+UNIT_TEST(JobSystemForkJoin)
+{
+	for (uint32 num_workers : s_WorkerCounts)
+	{
+		g_JobSystem.Init(num_workers);
+		CHECK(ForkJoinFibonacci(22) == 17711);
+		g_JobSystem.Shutdown();
+	}
+}
+
+UNIT_TEST(JobSystemFineGrained)
+{
+	constexpr size_t num_items = 1000000;
+
+	for (uint32 num_workers : s_WorkerCounts)
+	{
+		g_JobSystem.Init(num_workers);
+
+		// Every index exactly once, whatever the batches
+		std::unique_ptr<std::atomic<uint8>[]> visits(new std::atomic<uint8>[num_items]);
+		for (size_t i = 0; i < num_items; i++)
+			visits[i] = 0;
+
+		g_JobSystem.ParallelFor(num_items, [&visits](size_t inIndex) { visits[inIndex]++; });
+		g_JobSystem.ParallelForBatches(num_items, [&visits](size_t inBegin, size_t inEnd)
+		{
+			for (size_t i = inBegin; i < inEnd; i++)
+				visits[i]++;
+		}, 1000);
+
+		bool all_visited_twice = true;
+		for (size_t i = 0; i < num_items; i++)
+			all_visited_twice &= (visits[i] == 2);
+		CHECK(all_visited_twice);
+
+		g_JobSystem.Shutdown();
+	}
+}
+
+UNIT_TEST(JobSystemImbalanced)
+{
+	// Item i costs i^2 iterations, the last items are most of the work
+	constexpr size_t num_items = 400;
+
+	uint64 expected_sum = 0;
+	for (uint64 i = 0; i < num_items; i++)
+		expected_sum += i * i;
+
+	for (uint32 num_workers : s_WorkerCounts)
+	{
+		g_JobSystem.Init(num_workers);
+
+		std::atomic<uint64> sum = 0;
+		g_JobSystem.ParallelFor(num_items, [&sum](size_t inIndex)
+		{
+			uint64 local_sum = 0;
+			for (size_t i = 0; i < inIndex * inIndex; i++)
+				local_sum++;
+			sum += local_sum;
+		});
+		CHECK(sum == expected_sum);
+
+		g_JobSystem.Shutdown();
+	}
+}
+
+UNIT_TEST(JobSystemNestedParallelFor)
+{
+	constexpr size_t num_outer = 64;
+	constexpr size_t num_inner = 1000;
+
+	for (uint32 num_workers : s_WorkerCounts)
+	{
+		g_JobSystem.Init(num_workers);
+
+		std::atomic<uint64> count = 0;
+		g_JobSystem.ParallelFor(num_outer, [&count](size_t)
+		{
+			g_JobSystem.ParallelFor(num_inner, [&count](size_t) { count++; });
+		});
+		CHECK(count == num_outer * num_inner);
+
+		g_JobSystem.Shutdown();
+	}
+}
+
+UNIT_TEST(JobSystemDependencies)
+{
+	constexpr uint32 num_jobs = 200;
+
+	for (uint32 num_workers : s_WorkerCounts)
+	{
+		g_JobSystem.Init(num_workers);
+
+		// Random DAG: each job waits for the counter of an earlier one, which must be complete when it starts
+		std::mt19937 random(num_workers);
+		std::vector<std::unique_ptr<JobCounter>> counters(num_jobs);
+		std::unique_ptr<std::atomic<bool>[]> is_done(new std::atomic<bool>[num_jobs]);
+		std::atomic<uint32> num_violations = 0;
+
+		JobCounter all_jobs;
+		for (uint32 i = 0; i < num_jobs; i++)
+		{
+			counters[i] = std::make_unique<JobCounter>();
+			is_done[i] = false;
+
+			const int32 dependency = (i > 0 && random() % 4 != 0) ? static_cast<int32>(random() % i) : -1;
+			JobCounter* dependency_counter = dependency >= 0 ? counters[dependency].get() : nullptr;
+
+			g_JobSystem.Schedule([&, i, dependency]()
+			{
+				if (dependency >= 0 && !is_done[dependency])
+					num_violations++;
+
+				// Long enough for dependents to be scheduled before it ends
+				std::this_thread::yield();
+				is_done[i] = true;
+			}, counters[i].get(), dependency_counter);
+
+			// The job's counter is for its dependents, an empty job chained on it is counted in all_jobs
+			g_JobSystem.Schedule([]() {}, &all_jobs, counters[i].get());
+		}
+
+		g_JobSystem.Wait(all_jobs);
+
+		bool all_done = true;
+		for (uint32 i = 0; i < num_jobs; i++)
+			all_done &= is_done[i].load();
+
+		CHECK(all_done);
+		CHECK(num_violations == 0);
+
+		g_JobSystem.Shutdown();
+	}
+}
+
+UNIT_TEST(JobSystemExternalThreads)
+{
+	constexpr uint32 num_threads		= 4;
+	constexpr uint32 jobs_per_thread	= 2000;
+
+	for (uint32 num_workers : s_WorkerCounts)
+	{
+		g_JobSystem.Init(num_workers);
+
+		// Threads that aren't workers go through the shared queue, and wait without running jobs of their own deque
+		std::atomic<uint32> count = 0;
+		std::vector<std::thread> threads;
+		for (uint32 t = 0; t < num_threads; t++)
+		{
+			threads.emplace_back([&count]()
+			{
+				JobCounter counter;
+				for (uint32 i = 0; i < jobs_per_thread; i++)
+					g_JobSystem.Schedule([&count]() { count++; }, &counter);
+				g_JobSystem.Wait(counter);
+			});
+		}
+
+		for (std::thread& thread : threads)
+			thread.join();
+
+		CHECK(count == num_threads * jobs_per_thread);
+
+		g_JobSystem.Shutdown();
+	}
+}
+
+UNIT_TEST(JobSystemDequeOverflow)
+{
+	// More jobs than a deque holds, from a single job: the overflow runs right away
+	constexpr uint32 num_jobs = 20000;
+
+	for (uint32 num_workers : s_WorkerCounts)
+	{
+		g_JobSystem.Init(num_workers);
+
+		std::atomic<uint32> count = 0;
+		JobCounter counter;
+		g_JobSystem.Schedule([&count, &counter]()
+		{
+			for (uint32 i = 0; i < num_jobs; i++)
+				g_JobSystem.Schedule([&count]() { count++; }, &counter);
+		}, &counter);
+		g_JobSystem.Wait(counter);
+
+		CHECK(count == num_jobs);
+
+		g_JobSystem.Shutdown();
+	}
+}
+
+UNIT_TEST(JobSystemNotInitialized)
+{
+	// Jobs run right away on the calling thread
+	bool has_run = false;
+	JobCounter counter;
+	g_JobSystem.Schedule([&has_run]() { has_run = true; }, &counter);
+	CHECK(has_run);
+	CHECK(counter.IsDone());
+
+	size_t sum = 0;
+	g_JobSystem.ParallelFor(100, [&sum](size_t inIndex) { sum += inIndex; });
+	CHECK(sum == 4950);
+}
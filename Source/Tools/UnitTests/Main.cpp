@@ -0,0 +1,75 @@
+#include "Engine.h"
+#include "UnitTest.h"
+
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+// Headless tests of engine systems, runnable wherever the engine's portable code builds:
+//		UnitTests							runs everything
+//		UnitTests PackFile RingAllocator	runs the tests whose name contains one of the filters
+// Returns the number of failed tests, 0 when everything passed
+
+static std::string	s_TestDirectory;
+static uint32		s_NumCheckFailures = 0;
+
+std::vector<UnitTestInfo>& GetUnitTests()
+{
+	// Function static, registrars run before main in any order
+	static std::vector<UnitTestInfo> unit_tests;
+	return unit_tests;
+}
+
+void ReportCheckFailure(const char* inFileName, int inLineNumber, const char* inExpression)
+{
+	printf("\t%s(%d): CHECK(%s) failed\n", inFileName, inLineNumber, inExpression);
+	fflush(stdout);
+	s_NumCheckFailures++;
+}
+
+const std::string& GetTestDirectory()
+{
+	return s_TestDirectory;
+}
+
+int main(int inArgc, char** inArgv)
+{
+	std::vector<std::string> filters(inArgv + 1, inArgv + inArgc);
+
+	std::error_code error_code;
+	s_TestDirectory = (std::filesystem::temp_directory_path(error_code) / "AmigoUnitTests").string();
+	std::filesystem::remove_all(s_TestDirectory, error_code);
+	std::filesystem::create_directories(s_TestDirectory, error_code);
+
+	int num_failed_tests	= 0;
+	int num_run_tests		= 0;
+	for (const UnitTestInfo& unit_test : GetUnitTests())
+	{
+		bool is_selected = filters.empty();
+		for (const std::string& filter : filters)
+			is_selected |= std::strstr(unit_test.m_Name, filter.c_str()) != nullptr;
+
+		if (!is_selected)
+			continue;
+
+		printf("%s\n", unit_test.m_Name);
+		fflush(stdout);
+
+		const uint32 num_check_failures = s_NumCheckFailures;
+		unit_test.m_Function();
+
+		num_run_tests++;
+		if (s_NumCheckFailures != num_check_failures)
+		{
+			printf("\tFAILED\n");
+			num_failed_tests++;
+		}
+	}
+
+	std::filesystem::remove_all(s_TestDirectory, error_code);
+
+	printf("%d tests, %d failed\n", num_run_tests, num_failed_tests);
+	return num_failed_tests;
+}
@@ -0,0 +1,520 @@
+#include "Engine.h"
+#include "UnitTest.h"
+
+#include "Gfx/BakedMesh.h"
+#include "Gfx/MeshLoader.h"
+#include "Utils/FileReader.h"
+#include "Utils/JobSystem.h"
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+// MeshLoader and BakedMesh on the meshes in Data and on generated OBJ files: a flat grid of quads with integer positions,
+// so every vertex can be found back exactly from its column and row.
+// Loaders are compared through their baked files, which hold everything they produce
+
+// inWidth * inHeight vertices, positions (column, row, 0). Faces reference the same position and UV index
+static std::string WriteGridObj(const std::string& inName, uint32 inWidth, uint32 inHeight)
+{
+	const std::string file = GetTestDirectory() + "/" + inName + ".obj";
+
+	FILE* stream = fopen(file.c_str(), "wb");
+	CHECK(stream != nullptr);
+	if (stream == nullptr)
+		return file;
+
+	fprintf(stream, "o %s\n", inName.c_str());
+	for (uint32 row = 0; row < inHeight; row++)
+		for (uint32 column = 0; column < inWidth; column++)
+			fprintf(stream, "v %u %u 0\n", column, row);
+	for (uint32 row = 0; row < inHeight; row++)
+		for (uint32 column = 0; column < inWidth; column++)
+			fprintf(stream, "vt %.6f %.6f\n", column / float(inWidth - 1), row / float(inHeight - 1));
+	fprintf(stream, "vn 0 0 1\n");
+
+	for (uint32 row = 0; row + 1 < inHeight; row++)
+	{
+		for (uint32 column = 0; column + 1 < inWidth; column++)
+		{
+			// 1 based
+			const uint32 v00 = row * inWidth + column + 1;
+			const uint32 v10 = v00 + 1;
+			const uint32 v01 = v00 + inWidth;
+			const uint32 v11 = v01 + 1;
+			fprintf(stream, "f %u/%u/1 %u/%u/1 %u/%u/1\n", v00, v00, v10, v10, v11, v11);
+			fprintf(stream, "f %u/%u/1 %u/%u/1 %u/%u/1\n", v00, v00, v11, v11, v01, v01);
+		}
+	}
+
+	fclose(stream);
+	return file;
+}
+
+// Position of the corners of the faces written by WriteGridObj, in file order
+static Vec3 GetGridCorner(uint32 inWidth, uint32 inFace, uint32 inCorner)
+{
+	const uint32 quad	= inFace / 2;
+	const uint32 row	= quad / (inWidth - 1);
+	const uint32 column	= quad % (inWidth - 1);
+
+	static const uint32 offsets[2][3][2] =
+	{
+		{ { 0, 0 }, { 1, 0 }, { 1, 1 } },
+		{ { 0, 0 }, { 1, 1 }, { 0, 1 } },
+	};
+	const uint32* offset = offsets[inFace % 2][inCorner];
+	return Vec3(float(column + offset[0]), float(row + offset[1]), 0.0f);
+}
+
+// Load and bake a grid without reordering, then check the baked index format and that every index of the
+// baked buffer still points at the vertex the OBJ face referenced
+static void CheckGridIndices(uint32 inWidth, uint32 inHeight, DXGI_FORMAT inExpectedFormat)
+{
+	const std::string name	= "Grid" + std::to_string(inWidth) + "x" + std::to_string(inHeight);
+	const std::string file	= WriteGridObj(name, inWidth, inHeight);
+
+	MeshImportSettings settings;
+	settings.m_OptimizeVertexCache	= false;
+	settings.m_OptimizeOverdraw		= false;
+
+	MeshLoader loader(settings);
+	loader.LoadFromFile(file);
+
+	const std::string baked_file = GetTestDirectory() + "/" + name + ".amesh";
+	CHECK(BakedMesh::Bake(loader, baked_file));
+
+	BakedMesh baked_mesh;
+	CHECK(baked_mesh.LoadFromFile(baked_file));
+
+	const BakedMeshFormat::Header& header = baked_mesh.GetHeader();
+	CHECK(header.m_NumObjects == 1);
+	if (header.m_NumObjects != 1)
+		return;
+
+	const uint32 num_faces					= 2 * (inWidth - 1) * (inHeight - 1);
+	const BakedMeshFormat::Object& object	= baked_mesh.GetObjects()[0];
+	CHECK(object.m_NumVertices == inWidth * inHeight);
+	CHECK(object.m_NumIndices == num_faces * 3);
+	CHECK(object.m_IndexFormat == static_cast<uint32>(inExpectedFormat));
+	if (object.m_IndexFormat != static_cast<uint32>(inExpectedFormat) || object.m_NumIndices != num_faces * 3)
+		return;
+
+	const VertexPosUVNormal* vertices	= reinterpret_cast<const VertexPosUVNormal*>(baked_mesh.GetSection(header.m_VertexDataOffset) + object.m_VertexOffset);
+	const Byte* index_data				= baked_mesh.GetSection(header.m_IndexDataOffset) + object.m_IndexOffset;
+
+	bool are_indices_intact	= true;
+	uint32 max_index		= 0;
+	for (uint32 face = 0; face < num_faces; face++)
+	{
+		for (uint32 corner = 0; corner < 3; corner++)
+		{
+			const uint32 i		= face * 3 + corner;
+			const uint32 index	= (inExpectedFormat == DXGI_FORMAT_R16_UINT) ? reinterpret_cast<const uint16*>(index_data)[i]
+																		 : reinterpret_cast<const uint32*>(index_data)[i];
+			max_index = Math::Max(max_index, index);
+			if (index >= object.m_NumVertices)
+			{
+				are_indices_intact = false;
+				continue;
+			}
+
+			// The loader reverses the winding, corners 0 and 2 swap, and mirrors X around 0.5
+			const Vec3 expected	= GetGridCorner(inWidth, face, 2 - corner);
+			const Vec3 position	= vertices[index].Position;
+			are_indices_intact &= position.x == 1.0f - expected.x && position.y == expected.y && position.z == expected.z;
+		}
+	}
+	CHECK(are_indices_intact);
+
+	// Without reordering, vertices come in the order faces first reference them and the last one is used
+	CHECK(max_index == object.m_NumVertices - 1);
+}
+
+UNIT_TEST(MeshLoaderIndexFormat)
+{
+	CHECK(Mesh::GetIndexFormat(0) == DXGI_FORMAT_R16_UINT);
+	CHECK(Mesh::GetIndexFormat(65535) == DXGI_FORMAT_R16_UINT);
+	CHECK(Mesh::GetIndexFormat(65536) == DXGI_FORMAT_R16_UINT);
+	CHECK(Mesh::GetIndexFormat(65537) == DXGI_FORMAT_R32_UINT);
+
+	// Exactly 65536 vertices, index 65535 is the largest and still fits 16 bits
+	CheckGridIndices(256, 256, DXGI_FORMAT_R16_UINT);
+	// One more row, past 16 bits
+	CheckGridIndices(256, 257, DXGI_FORMAT_R32_UINT);
+}
+
+UNIT_TEST(MeshLoaderLargeIndices)
+{
+	// 200704 vertices, about 400k triangles
+	CheckGridIndices(448, 448, DXGI_FORMAT_R32_UINT);
+}
+
+static bool LoadAndBake(const std::string& inFile, const MeshImportSettings& inSettings, uint32 inNumChunks, const std::string& inBakedFile)
+{
+	MeshLoader loader(inSettings);
+	loader.LoadFromFile(inFile, inNumChunks);
+	return BakedMesh::Bake(loader, inBakedFile);
+}
+
+static bool AreFilesEqual(const std::string& inLeft, const std::string& inRight)
+{
+	FileReader left, right;
+	if (!left.ReadFile(inLeft) || !right.ReadFile(inRight))
+		return false;
+
+	return left.GetContentSize() == right.GetContentSize() &&
+		   memcmp(left.GetContentAsBinary(), right.GetContentAsBinary(), static_cast<size_t>(left.GetContentSize())) == 0;
+}
+
+// Chunks split objects, material changes and faces anywhere. Merged results must not depend on it
+UNIT_TEST(MeshLoaderSerialParallel)
+{
+	MeshImportSettings settings;
+	settings.m_NumLODs = 2;
+
+	for (const char* file : { "Data/Cornell_fake_box.obj", "Data/Lightbulb.obj" })
+	{
+		const std::string serial_file = GetTestDirectory() + "/Serial.amesh";
+		CHECK(LoadAndBake(file, settings, 1, serial_file));
+
+		g_JobSystem.Init(4);
+		for (uint32 num_chunks : { 2u, 3u, 7u, 16u, 0u })
+		{
+			const std::string parallel_file = GetTestDirectory() + "/Parallel" + std::to_string(num_chunks) + ".amesh";
+			CHECK(LoadAndBake(file, settings, num_chunks, parallel_file));
+			CHECK(AreFilesEqual(serial_file, parallel_file));
+		}
+		g_JobSystem.Shutdown();
+	}
+}
+
+// Unit sphere of inNumRings rings of inNumSegments quads, UVs wrap around so the vertices of the first meridian are duplicated.
+// Upper half uses material Top, lower half Bottom, both in a material library next to the OBJ
+static std::string WriteSphereObj(const std::string& inName, uint32 inNumRings, uint32 inNumSegments)
+{
+	const std::string file = GetTestDirectory() + "/" + inName + ".obj";
+
+	FILE* stream = fopen((GetTestDirectory() + "/" + inName + ".mtl").c_str(), "wb");
+	CHECK(stream != nullptr);
+	if (stream == nullptr)
+		return file;
+
+	fprintf(stream, "newmtl Top\nillum 2\nnewmtl Bottom\nillum 2\n");
+	fclose(stream);
+
+	stream = fopen(file.c_str(), "wb");
+	CHECK(stream != nullptr);
+	if (stream == nullptr)
+		return file;
+
+	fprintf(stream, "mtllib %s.mtl\no %s\n", inName.c_str(), inName.c_str());
+
+	// Poles first, then every ring but the poles. Normals are the positions
+	fprintf(stream, "v 0 1 0\nv 0 -1 0\nvn 0 1 0\nvn 0 -1 0\n");
+	for (uint32 ring = 1; ring < inNumRings; ring++)
+	{
+		for (uint32 segment = 0; segment < inNumSegments; segment++)
+		{
+			const float theta	= Math::Pi * ring / inNumRings;
+			const float phi		= 2.0f * Math::Pi * segment / inNumSegments;
+			const float x = sinf(theta) * cosf(phi), y = cosf(theta), z = sinf(theta) * sinf(phi);
+			fprintf(stream, "v %.6f %.6f %.6f\nvn %.6f %.6f %.6f\n", x, y, z, x, y, z);
+		}
+	}
+
+	// One UV per pole, inNumSegments + 1 per ring
+	fprintf(stream, "vt 0.5 0\nvt 0.5 1\n");
+	for (uint32 ring = 1; ring < inNumRings; ring++)
+		for (uint32 segment = 0; segment <= inNumSegments; segment++)
+			fprintf(stream, "vt %.6f %.6f\n", segment / float(inNumSegments), ring / float(inNumRings));
+
+	// 1 based position and UV of a corner
+	const auto get_position = [&](uint32 inRing, uint32 inSegment)
+	{
+		return inRing == 0 ? 1 : inRing == inNumRings ? 2 : 3 + (inRing - 1) * inNumSegments + inSegment % inNumSegments;
+	};
+	const auto get_uv = [&](uint32 inRing, uint32 inSegment)
+	{
+		return inRing == 0 ? 1 : inRing == inNumRings ? 2 : 3 + (inRing - 1) * (inNumSegments + 1) + inSegment;
+	};
+	const auto write_face = [&](const uint32 (&inCorners)[3][2])
+	{
+		fprintf(stream, "f");
+		for (const uint32* corner : inCorners)
+		{
+			const uint32 position = get_position(corner[0], corner[1]);
+			fprintf(stream, " %u/%u/%u", position, get_uv(corner[0], corner[1]), position);
+		}
+		fprintf(stream, "\n");
+	};
+
+	for (uint32 ring = 0; ring < inNumRings; ring++)
+	{
+		if (ring == 0 || ring == inNumRings / 2)
+			fprintf(stream, "usemtl %s\n", ring == 0 ? "Top" : "Bottom");
+
+		for (uint32 segment = 0; segment < inNumSegments; segment++)
+		{
+			if (ring != inNumRings - 1)
+				write_face({ { ring, segment }, { ring + 1, segment }, { ring + 1, segment + 1 } });
+			if (ring != 0)
+				write_face({ { ring, segment }, { ring + 1, segment + 1 }, { ring, segment + 1 } });
+		}
+	}
+
+	fclose(stream);
+	return file;
+}
+
+// Bake the sphere with inSettings and check its LOD chains. Returns whether m_LODMaxError stopped any of them
+static bool CheckSphereLODs(const MeshImportSettings& inSettings)
+{
+	const std::string file = WriteSphereObj("Sphere", 32, 64);
+
+	MeshLoader loader(inSettings);
+	loader.LoadFromFile(file);
+
+	const std::string baked_file = GetTestDirectory() + "/Sphere.amesh";
+	CHECK(BakedMesh::Bake(loader, baked_file));
+
+	BakedMesh baked_mesh;
+	CHECK(baked_mesh.LoadFromFile(baked_file));
+
+	const BakedMeshFormat::Header& header = baked_mesh.GetHeader();
+	CHECK(header.m_NumObjects == 1 && header.m_NumSubMeshes == 2);
+	if (header.m_NumObjects != 1 || header.m_NumSubMeshes != 2)
+		return false;
+
+	const BakedMeshFormat::Object& object	= baked_mesh.GetObjects()[0];
+	const VertexPosUVNormal* vertices		= reinterpret_cast<const VertexPosUVNormal*>(baked_mesh.GetSection(header.m_VertexDataOffset) + object.m_VertexOffset);
+	const Byte* index_data					= baked_mesh.GetSection(header.m_IndexDataOffset) + object.m_IndexOffset;
+
+	const auto get_index = [&](uint32 inIndex)
+	{
+		return object.m_IndexFormat == DXGI_FORMAT_R16_UINT ? reinterpret_cast<const uint16*>(index_data)[inIndex] : reinterpret_cast<const uint32*>(index_data)[inIndex];
+	};
+	const auto get_vertices = [&](const BakedMeshFormat::LOD& inLOD)
+	{
+		std::vector<bool> is_used(object.m_NumVertices, false);
+		for (uint32 i = inLOD.m_StartIndex; i < inLOD.m_StartIndex + inLOD.m_NumIndices; i++)
+			is_used[get_index(i)] = true;
+		return is_used;
+	};
+
+	// The loader bounds the error by m_LODMaxError times half the diagonal of the object
+	Vec3 min_position = vertices[0].Position;
+	Vec3 max_position = vertices[0].Position;
+	for (uint32 v = 1; v < object.m_NumVertices; v++)
+	{
+		for (int32 k = 0; k < 3; k++)
+		{
+			min_position[k] = Math::Min(min_position[k], vertices[v].Position[k]);
+			max_position[k] = Math::Max(max_position[k], vertices[v].Position[k]);
+		}
+	}
+	const float max_error = inSettings.m_LODMaxError * (max_position - min_position).Length() * 0.5f;
+
+	// Seams: vertices sharing their position with another one. Material boundary: vertices used by both submeshes
+	std::vector<bool> is_locked(object.m_NumVertices, false);
+	for (uint32 v = 0; v < object.m_NumVertices; v++)
+		for (uint32 w = v + 1; w < object.m_NumVertices; w++)
+			if (vertices[v].Position.x == vertices[w].Position.x && vertices[v].Position.y == vertices[w].Position.y && vertices[v].Position.z == vertices[w].Position.z)
+				is_locked[v] = is_locked[w] = true;
+
+	const BakedMeshFormat::SubMesh* sub_meshes	= baked_mesh.GetSubMeshes() + object.m_FirstSubMesh;
+	const BakedMeshFormat::LOD* lods			= baked_mesh.GetLODs();
+
+	const std::vector<bool> top_vertices	= get_vertices(lods[sub_meshes[0].m_FirstLOD]);
+	const std::vector<bool> bottom_vertices	= get_vertices(lods[sub_meshes[1].m_FirstLOD]);
+	uint32 num_boundary_vertices = 0;
+	for (uint32 v = 0; v < object.m_NumVertices; v++)
+	{
+		if (top_vertices[v] && bottom_vertices[v])
+		{
+			is_locked[v] = true;
+			num_boundary_vertices++;
+		}
+	}
+	CHECK(num_boundary_vertices == 64 + 1);
+
+	bool is_stopped_by_error = false;
+	for (uint32 s = 0; s < 2; s++)
+	{
+		const BakedMeshFormat::SubMesh& sub_mesh = sub_meshes[s];
+		CHECK(sub_mesh.m_NumLODs >= 2 && sub_mesh.m_NumLODs <= inSettings.m_NumLODs + 1);
+		CHECK(lods[sub_mesh.m_FirstLOD].m_Error == 0.0f);
+
+		const std::vector<bool> full_vertices = get_vertices(lods[sub_mesh.m_FirstLOD]);
+		is_stopped_by_error |= sub_mesh.m_NumLODs < inSettings.m_NumLODs + 1;
+
+		for (uint32 l = 1; l < sub_mesh.m_NumLODs; l++)
+		{
+			const BakedMeshFormat::LOD& previous	= lods[sub_mesh.m_FirstLOD + l - 1];
+			const BakedMeshFormat::LOD& lod			= lods[sub_mesh.m_FirstLOD + l];
+
+			// Within the 1% tolerance of SimplifyMesh, or stopped early because of the error
+			const uint32 target_num_indices = static_cast<uint32>(previous.m_NumIndices / 3 * inSettings.m_LODTriangleRatio) * 3;
+			CHECK(lod.m_NumIndices < previous.m_NumIndices);
+			is_stopped_by_error |= lod.m_NumIndices > target_num_indices + target_num_indices / 100;
+
+			CHECK(lod.m_Error >= previous.m_Error);
+			CHECK(lod.m_Error <= max_error);
+
+			// Locked vertices of the submesh are all still there
+			const std::vector<bool> lod_vertices = get_vertices(lod);
+			bool are_locked_vertices_kept = true;
+			for (uint32 v = 0; v < object.m_NumVertices; v++)
+				are_locked_vertices_kept &= !(full_vertices[v] && is_locked[v]) || lod_vertices[v];
+			CHECK(are_locked_vertices_kept);
+		}
+	}
+
+	return is_stopped_by_error;
+}
+
+UNIT_TEST(MeshLoaderLODs)
+{
+	MeshImportSettings settings;
+	settings.m_NumLODs			= 3;
+	settings.m_LODTriangleRatio	= 0.5f;
+
+	// Large enough error for every LOD to reach the ratio
+	settings.m_LODMaxError = 1.0f;
+	CHECK(!CheckSphereLODs(settings));
+
+	// Too small to remove half of the sphere
+	settings.m_LODMaxError = 0.002f;
+	CHECK(CheckSphereLODs(settings));
+}
+
+// Compressed vertices are baked next to the full precision ones and decode back to them
+UNIT_TEST(MeshLoaderCompressedVertices)
+{
+	for (VertexCompressionMode compression : { VertexCompressionMode::None, VertexCompressionMode::Packed, VertexCompressionMode::Quantized })
+	{
+		MeshImportSettings settings;
+		settings.m_VertexCompression = compression;
+
+		const std::string baked_file = GetTestDirectory() + "/Compressed" + std::to_string(static_cast<uint32>(compression)) + ".amesh";
+		CHECK(LoadAndBake("Data/Lightbulb.obj", settings, 1, baked_file));
+
+		BakedMesh baked_mesh;
+		const bool is_loaded = baked_mesh.LoadFromFile(baked_file);
+		CHECK(is_loaded);
+		if (!is_loaded)
+			continue;
+
+		const BakedMeshFormat::Header& header = baked_mesh.GetHeader();
+		CHECK(header.m_CompressedVertexFormat == static_cast<uint32>(compression));
+		CHECK(header.m_CompressedVertexDataSize == header.m_VertexDataSize / header.m_VertexStride * header.m_CompressedVertexStride);
+
+		if (compression == VertexCompressionMode::None)
+		{
+			CHECK(header.m_CompressedVertexStride == 0);
+			continue;
+		}
+
+		VertexCompression::EncodingError error;
+		float max_position_error	= 0.0f;
+		float max_uv				= 1.0f;
+
+		for (uint32 i = 0; i < header.m_NumObjects; i++)
+		{
+			const BakedMeshFormat::Object& object	= baked_mesh.GetObjects()[i];
+			const VertexPosUVNormal* vertices		= reinterpret_cast<const VertexPosUVNormal*>(baked_mesh.GetSection(header.m_VertexDataOffset) + object.m_VertexOffset);
+			const Byte* compressed_vertices			= baked_mesh.GetSection(header.m_CompressedVertexDataOffset) + object.m_CompressedVertexOffset;
+
+			for (uint32 v = 0; v < object.m_NumVertices; v++)
+				max_uv = Math::Max(max_uv, Math::Max(Math::Abs(vertices[v].UV.x), Math::Abs(vertices[v].UV.y)));
+
+			if (compression == VertexCompressionMode::Packed)
+			{
+				CHECK(header.m_CompressedVertexStride == sizeof(VertexPosUVNormalPacked));
+				error.Accumulate(VertexCompression::ComputeError(vertices, reinterpret_cast<const VertexPosUVNormalPacked*>(compressed_vertices), object.m_NumVertices));
+			}
+			else
+			{
+				CHECK(header.m_CompressedVertexStride == sizeof(VertexPosUVNormalQuantized));
+
+				VertexCompression::QuantizationBounds bounds;
+				bounds.m_Center		= Vec3(object.m_QuantizationCenter[0], object.m_QuantizationCenter[1], object.m_QuantizationCenter[2]);
+				bounds.m_Extents	= Vec3(object.m_QuantizationExtents[0], object.m_QuantizationExtents[1], object.m_QuantizationExtents[2]);
+				error.Accumulate(VertexCompression::ComputeError(vertices, reinterpret_cast<const VertexPosUVNormalQuantized*>(compressed_vertices), object.m_NumVertices, bounds));
+
+				// Half a snorm16 step along each axis, plus float rounding
+				max_position_error = Math::Max(max_position_error, bounds.m_Extents.Length() * 0.5f / 32767.0f + bounds.m_Center.Length() * 1e-6f);
+			}
+		}
+
+		CHECK(error.m_MaxPositionError <= max_position_error);
+		// Half floats are within half of their 2^-10 relative step
+		CHECK(error.m_MaxUVError <= max_uv / 2048.0f);
+		CHECK(error.m_MaxNormalError <= 0.005f);
+	}
+}
+
+// Baked meshlets cover the full resolution indices of their submesh, with bounds around the baked vertices
+UNIT_TEST(MeshLoaderMeshlets)
+{
+	for (bool build_meshlets : { false, true })
+	{
+		MeshImportSettings settings;
+		settings.m_BuildMeshlets = build_meshlets;
+
+		const std::string baked_file = GetTestDirectory() + "/Meshlets" + std::to_string(build_meshlets) + ".amesh";
+		CHECK(LoadAndBake("Data/Lightbulb.obj", settings, 1, baked_file));
+
+		BakedMesh baked_mesh;
+		const bool is_loaded = baked_mesh.LoadFromFile(baked_file);
+		CHECK(is_loaded);
+		if (!is_loaded)
+			continue;
+
+		const BakedMeshFormat::Header& header = baked_mesh.GetHeader();
+		CHECK((header.m_NumMeshlets > 0) == build_meshlets);
+
+		// Validate works on a MeshletData, the file holds the same arrays
+		MeshletData data;
+		data.m_Meshlets.assign(baked_mesh.GetMeshlets(), baked_mesh.GetMeshlets() + header.m_NumMeshlets);
+		data.m_Bounds.assign(baked_mesh.GetMeshletBounds(), baked_mesh.GetMeshletBounds() + header.m_NumMeshlets);
+
+		const uint32* vertex_indices	= reinterpret_cast<const uint32*>(baked_mesh.GetSection(header.m_MeshletVertexIndicesOffset));
+		const uint8* triangle_indices	= reinterpret_cast<const uint8*>(baked_mesh.GetSection(header.m_MeshletTriangleIndicesOffset));
+		data.m_VertexIndices.assign(vertex_indices, vertex_indices + header.m_MeshletVertexIndicesSize / sizeof(uint32));
+		data.m_TriangleIndices.assign(triangle_indices, triangle_indices + header.m_MeshletTriangleIndicesSize);
+
+		uint32 num_sub_mesh_meshlets	= 0;
+		bool are_meshlets_valid			= true;
+
+		for (uint32 i = 0; i < header.m_NumObjects; i++)
+		{
+			const BakedMeshFormat::Object& object	= baked_mesh.GetObjects()[i];
+			const VertexPosUVNormal* vertices		= reinterpret_cast<const VertexPosUVNormal*>(baked_mesh.GetSection(header.m_VertexDataOffset) + object.m_VertexOffset);
+			const Byte* index_data					= baked_mesh.GetSection(header.m_IndexDataOffset) + object.m_IndexOffset;
+
+			for (uint32 s = 0; s < object.m_NumSubMeshes; s++)
+			{
+				const BakedMeshFormat::SubMesh& sub_mesh	= baked_mesh.GetSubMeshes()[object.m_FirstSubMesh + s];
+				const BakedMeshFormat::LOD& lod				= baked_mesh.GetLODs()[sub_mesh.m_FirstLOD];
+
+				std::vector<uint32> indices(lod.m_NumIndices);
+				for (uint32 k = 0; k < lod.m_NumIndices; k++)
+				{
+					const uint32 index = lod.m_StartIndex + k;
+					indices[k] = (object.m_IndexFormat == DXGI_FORMAT_R16_UINT) ? reinterpret_cast<const uint16*>(index_data)[index] : reinterpret_cast<const uint32*>(index_data)[index];
+				}
+
+				num_sub_mesh_meshlets += sub_mesh.m_NumMeshlets;
+
+				if (build_meshlets)
+					are_meshlets_valid &= Meshlets::Validate(data, sub_mesh.m_FirstMeshlet, sub_mesh.m_NumMeshlets, indices.data(), indices.size(),
+															 &vertices[0].Position.x, sizeof(VertexPosUVNormal));
+			}
+		}
+
+		// Every meshlet belongs to one submesh
+		CHECK(num_sub_mesh_meshlets == header.m_NumMeshlets);
+		CHECK(are_meshlets_valid);
+	}
+}
@@ -0,0 +1,255 @@
+#include "Engine.h"
+#include "UnitTest.h"
+
+#include "Gfx/MeshOptimizer.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <random>
+#include <vector>
+
+// Vertex cache, overdraw and vertex fetch passes on generated meshes. Passes only reorder: the set of triangles,
+// each with its winding, must be the same before and after
+
+struct TestMesh
+{
+	std::vector<Vec3>	m_Positions;
+	std::vector<uint32>	m_Indices;
+};
+
+// Flat grid of inSize x inSize quads in the XY plane, triangles in row order
+static void AddGrid(TestMesh& ioMesh, uint32 inSize)
+{
+	const uint32 first_vertex = static_cast<uint32>(ioMesh.m_Positions.size());
+	for (uint32 row = 0; row <= inSize; row++)
+		for (uint32 column = 0; column <= inSize; column++)
+			ioMesh.m_Positions.push_back(Vec3(float(column), float(row), 0.0f));
+
+	for (uint32 row = 0; row < inSize; row++)
+	{
+		for (uint32 column = 0; column < inSize; column++)
+		{
+			const uint32 v00 = first_vertex + row * (inSize + 1) + column;
+			const uint32 v10 = v00 + 1;
+			const uint32 v01 = v00 + inSize + 1;
+			const uint32 v11 = v01 + 1;
+			ioMesh.m_Indices.insert(ioMesh.m_Indices.end(), { v00, v11, v10, v00, v01, v11 });
+		}
+	}
+}
+
+// UV sphere, front faces outwards as seen by AnalyzeOverdraw
+static void AddSphere(TestMesh& ioMesh, const Vec3& inCenter, float inRadius, uint32 inNumRings, uint32 inNumSegments)
+{
+	const uint32 first_vertex = static_cast<uint32>(ioMesh.m_Positions.size());
+
+	// Poles first, then rings from top to bottom
+	ioMesh.m_Positions.push_back(inCenter + Vec3(0.0f, inRadius, 0.0f));
+	ioMesh.m_Positions.push_back(inCenter - Vec3(0.0f, inRadius, 0.0f));
+	for (uint32 ring = 1; ring < inNumRings; ring++)
+	{
+		const float theta = Math::Pi * ring / inNumRings;
+		for (uint32 segment = 0; segment < inNumSegments; segment++)
+		{
+			const float phi = 2.0f * Math::Pi * segment / inNumSegments;
+			ioMesh.m_Positions.push_back(inCenter + Vec3(std::sin(theta) * std::cos(phi), std::cos(theta), std::sin(theta) * std::sin(phi)) * inRadius);
+		}
+	}
+
+	const auto ring_vertex = [&](uint32 inRing, uint32 inSegment)
+	{
+		return first_vertex + 2 + (inRing - 1) * inNumSegments + (inSegment % inNumSegments);
+	};
+
+	for (uint32 segment = 0; segment < inNumSegments; segment++)
+	{
+		ioMesh.m_Indices.insert(ioMesh.m_Indices.end(), { first_vertex, ring_vertex(1, segment + 1), ring_vertex(1, segment) });
+		for (uint32 ring = 1; ring + 1 < inNumRings; ring++)
+		{
+			const uint32 v00 = ring_vertex(ring, segment);
+			const uint32 v10 = ring_vertex(ring, segment + 1);
+			const uint32 v01 = ring_vertex(ring + 1, segment);
+			const uint32 v11 = ring_vertex(ring + 1, segment + 1);
+			ioMesh.m_Indices.insert(ioMesh.m_Indices.end(), { v00, v10, v11, v00, v11, v01 });
+		}
+		ioMesh.m_Indices.insert(ioMesh.m_Indices.end(), { first_vertex + 1, ring_vertex(inNumRings - 1, segment), ring_vertex(inNumRings - 1, segment + 1) });
+	}
+}
+
+static void ShuffleTriangles(TestMesh& ioMesh, uint32 inSeed)
+{
+	std::vector<std::array<uint32, 3>> triangles(ioMesh.m_Indices.size() / 3);
+	for (size_t t = 0; t < triangles.size(); t++)
+		triangles[t] = { ioMesh.m_Indices[t * 3], ioMesh.m_Indices[t * 3 + 1], ioMesh.m_Indices[t * 3 + 2] };
+
+	std::shuffle(triangles.begin(), triangles.end(), std::mt19937(inSeed));
+
+	for (size_t t = 0; t < triangles.size(); t++)
+		for (uint32 k = 0; k < 3; k++)
+			ioMesh.m_Indices[t * 3 + k] = triangles[t][k];
+}
+
+// Sorted triangles, each rotated to start with its smallest index so the winding is kept
+static std::vector<std::array<uint32, 3>> GetSortedTriangles(const std::vector<uint32>& inIndices)
+{
+	std::vector<std::array<uint32, 3>> triangles(inIndices.size() / 3);
+	for (size_t t = 0; t < triangles.size(); t++)
+	{
+		const uint32* triangle	= &inIndices[t * 3];
+		const uint32 first		= (triangle[0] <= triangle[1] && triangle[0] <= triangle[2]) ? 0 : (triangle[1] <= triangle[2] ? 1 : 2);
+		triangles[t] = { triangle[first], triangle[(first + 1) % 3], triangle[(first + 2) % 3] };
+	}
+	std::sort(triangles.begin(), triangles.end());
+	return triangles;
+}
+
+static MeshOptimizer::VertexCacheStatistics AnalyzeVertexCache(const TestMesh& inMesh)
+{
+	return MeshOptimizer::AnalyzeVertexCache(inMesh.m_Indices.data(), inMesh.m_Indices.size(), inMesh.m_Positions.size());
+}
+
+static MeshOptimizer::OverdrawStatistics AnalyzeOverdraw(const TestMesh& inMesh)
+{
+	return MeshOptimizer::AnalyzeOverdraw(inMesh.m_Indices.data(), inMesh.m_Indices.size(), &inMesh.m_Positions[0].x, inMesh.m_Positions.size(), sizeof(Vec3));
+}
+
+// Forsyth's pass never makes the cache behave worse than the input order, and keeps the triangles
+static void CheckVertexCache(const TestMesh& inMesh, float inMaxACMR)
+{
+	TestMesh optimized = inMesh;
+	MeshOptimizer::OptimizeVertexCache(optimized.m_Indices.data(), optimized.m_Indices.size(), optimized.m_Positions.size());
+
+	const MeshOptimizer::VertexCacheStatistics before	= AnalyzeVertexCache(inMesh);
+	const MeshOptimizer::VertexCacheStatistics after	= AnalyzeVertexCache(optimized);
+
+	CHECK(GetSortedTriangles(optimized.m_Indices) == GetSortedTriangles(inMesh.m_Indices));
+	CHECK(after.m_NumVertices == before.m_NumVertices);
+	CHECK(after.GetACMR() <= before.GetACMR());
+	CHECK(after.GetATVR() <= before.GetATVR());
+	CHECK(after.GetACMR() <= inMaxACMR);
+}
+
+UNIT_TEST(MeshOptimizerVertexCache)
+{
+	// Row order is already fair with 16 entries, random order is the worst case
+	TestMesh grid;
+	AddGrid(grid, 100);
+	CheckVertexCache(grid, 0.8f);
+
+	ShuffleTriangles(grid, 6);
+	CHECK(AnalyzeVertexCache(grid).GetACMR() > 2.0f);
+	CheckVertexCache(grid, 0.8f);
+
+	TestMesh sphere;
+	AddSphere(sphere, Vec3(0.0f, 0.0f, 0.0f), 1.0f, 32, 64);
+	CheckVertexCache(sphere, 0.8f);
+
+	ShuffleTriangles(sphere, 6);
+	CheckVertexCache(sphere, 0.8f);
+}
+
+UNIT_TEST(MeshOptimizerVertexFetch)
+{
+	TestMesh sphere;
+	AddSphere(sphere, Vec3(0.0f, 0.0f, 0.0f), 1.0f, 16, 32);
+	ShuffleTriangles(sphere, 6);
+
+	// One unreferenced vertex, it must end up last
+	sphere.m_Positions.insert(sphere.m_Positions.begin(), Vec3(5.0f, 5.0f, 5.0f));
+	for (uint32& index : sphere.m_Indices)
+		index++;
+
+	TestMesh optimized = sphere;
+	MeshOptimizer::OptimizeVertexFetch(optimized.m_Positions.data(), optimized.m_Positions.size(), sizeof(Vec3),
+									   optimized.m_Indices.data(), optimized.m_Indices.size());
+
+	// Same triangles in the same order, they just reference the vertices at their new place
+	bool is_same_mesh = true;
+	for (size_t i = 0; i < sphere.m_Indices.size(); i++)
+	{
+		const Vec3& before	= sphere.m_Positions[sphere.m_Indices[i]];
+		const Vec3& after	= optimized.m_Positions[optimized.m_Indices[i]];
+		is_same_mesh &= before.x == after.x && before.y == after.y && before.z == after.z;
+	}
+	CHECK(is_same_mesh);
+
+	// Vertices in the order they are first referenced
+	uint32 next_vertex = 0;
+	bool is_in_order = true;
+	for (uint32 index : optimized.m_Indices)
+	{
+		is_in_order &= index <= next_vertex;
+		if (index == next_vertex)
+			next_vertex++;
+	}
+	CHECK(is_in_order);
+	CHECK(next_vertex == optimized.m_Positions.size() - 1);
+	CHECK(optimized.m_Positions.back().x == 5.0f);
+}
+
+// Two concentric spheres. Drawing the inner one first shades it for nothing, the outer one covers it from every side
+static TestMesh MakeNestedSpheres(bool inIsInnerFirst)
+{
+	TestMesh inner, outer;
+	AddSphere(inner, Vec3(0.0f, 0.0f, 0.0f), 0.5f, 24, 48);
+	AddSphere(outer, Vec3(0.0f, 0.0f, 0.0f), 1.0f, 24, 48);
+
+	TestMesh& first		= inIsInnerFirst ? inner : outer;
+	const TestMesh& last	= inIsInnerFirst ? outer : inner;
+
+	const uint32 num_first_vertices = static_cast<uint32>(first.m_Positions.size());
+	first.m_Positions.insert(first.m_Positions.end(), last.m_Positions.begin(), last.m_Positions.end());
+	for (uint32 index : last.m_Indices)
+		first.m_Indices.push_back(index + num_first_vertices);
+	return first;
+}
+
+UNIT_TEST(MeshOptimizerOverdrawEstimate)
+{
+	// Convex, every covered pixel is shaded once whatever the order
+	TestMesh sphere;
+	AddSphere(sphere, Vec3(1.0f, 2.0f, 3.0f), 2.0f, 24, 48);
+	ShuffleTriangles(sphere, 6);
+	const MeshOptimizer::OverdrawStatistics sphere_overdraw = AnalyzeOverdraw(sphere);
+	CHECK(sphere_overdraw.m_NumPixelsCovered > 0);
+	CHECK(sphere_overdraw.m_NumPixelsShaded == sphere_overdraw.m_NumPixelsCovered);
+
+	// The inner sphere covers a quarter of the outer one's pixels, shaded twice when it goes first
+	const MeshOptimizer::OverdrawStatistics inner_first	= AnalyzeOverdraw(MakeNestedSpheres(true));
+	const MeshOptimizer::OverdrawStatistics outer_first	= AnalyzeOverdraw(MakeNestedSpheres(false));
+	CHECK(inner_first.m_NumPixelsCovered == outer_first.m_NumPixelsCovered);
+	CHECK(outer_first.GetOverdraw() == 1.0f);
+	CHECK(inner_first.GetOverdraw() > 1.2f && inner_first.GetOverdraw() < 1.3f);
+}
+
+// Overdraw pass after the vertex cache pass, like MeshLoader runs them. Nested spheres with the inner one drawn first, as
+// generated and shuffled. Sorting clusters must draw the outer sphere first whatever the threshold allows to split
+UNIT_TEST(MeshOptimizerOverdraw)
+{
+	for (bool is_shuffled : { false, true })
+	{
+		TestMesh mesh = MakeNestedSpheres(true);
+		if (is_shuffled)
+			ShuffleTriangles(mesh, 6);
+		MeshOptimizer::OptimizeVertexCache(mesh.m_Indices.data(), mesh.m_Indices.size(), mesh.m_Positions.size());
+
+		const MeshOptimizer::VertexCacheStatistics cache_before	= AnalyzeVertexCache(mesh);
+		const MeshOptimizer::OverdrawStatistics overdraw_before	= AnalyzeOverdraw(mesh);
+
+		for (float acmr_threshold : { 1.0f, 1.05f, 1.5f })
+		{
+			TestMesh optimized = mesh;
+			MeshOptimizer::OptimizeOverdraw(optimized.m_Indices.data(), optimized.m_Indices.size(),
+											&optimized.m_Positions[0].x, optimized.m_Positions.size(), sizeof(Vec3), acmr_threshold);
+
+			const MeshOptimizer::VertexCacheStatistics cache_after	= AnalyzeVertexCache(optimized);
+			const MeshOptimizer::OverdrawStatistics overdraw_after	= AnalyzeOverdraw(optimized);
+
+			CHECK(GetSortedTriangles(optimized.m_Indices) == GetSortedTriangles(mesh.m_Indices));
+			CHECK(cache_after.m_NumTransforms <= cache_before.m_NumTransforms * acmr_threshold);
+			CHECK(overdraw_after.m_NumPixelsCovered == overdraw_before.m_NumPixelsCovered);
+			CHECK(overdraw_after.GetOverdraw() == 1.0f);
+		}
+	}
+}
@@ -0,0 +1,257 @@
+#include "Engine.h"
+#include "UnitTest.h"
+
+#include "Gfx/Meshlet.h"
+#include "Gfx/MeshOptimizer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+// Meshlets built from generated meshes, checked against the triangle lists they come from
+
+struct TestMesh
+{
+	std::vector<Vec3>	m_Positions;
+	std::vector<uint32>	m_Indices;
+};
+
+// UV sphere, front faces outwards: (p1 - p0) x (p2 - p0) points away from the center
+static TestMesh MakeSphere(const Vec3& inCenter, float inRadius, uint32 inNumRings, uint32 inNumSegments)
+{
+	TestMesh mesh;
+
+	mesh.m_Positions.push_back(inCenter + Vec3(0.0f, inRadius, 0.0f));
+	mesh.m_Positions.push_back(inCenter - Vec3(0.0f, inRadius, 0.0f));
+	for (uint32 ring = 1; ring < inNumRings; ring++)
+	{
+		const float theta = Math::Pi * ring / inNumRings;
+		for (uint32 segment = 0; segment < inNumSegments; segment++)
+		{
+			const float phi = 2.0f * Math::Pi * segment / inNumSegments;
+			mesh.m_Positions.push_back(inCenter + Vec3(std::sin(theta) * std::cos(phi), std::cos(theta), std::sin(theta) * std::sin(phi)) * inRadius);
+		}
+	}
+
+	const auto ring_vertex = [&](uint32 inRing, uint32 inSegment)
+	{
+		return 2 + (inRing - 1) * inNumSegments + (inSegment % inNumSegments);
+	};
+
+	for (uint32 segment = 0; segment < inNumSegments; segment++)
+	{
+		mesh.m_Indices.insert(mesh.m_Indices.end(), { 0u, ring_vertex(1, segment + 1), ring_vertex(1, segment) });
+		for (uint32 ring = 1; ring + 1 < inNumRings; ring++)
+		{
+			const uint32 v00 = ring_vertex(ring, segment);
+			const uint32 v10 = ring_vertex(ring, segment + 1);
+			const uint32 v01 = ring_vertex(ring + 1, segment);
+			const uint32 v11 = ring_vertex(ring + 1, segment + 1);
+			mesh.m_Indices.insert(mesh.m_Indices.end(), { v00, v10, v11, v00, v11, v01 });
+		}
+		mesh.m_Indices.insert(mesh.m_Indices.end(), { 1u, ring_vertex(inNumRings - 1, segment), ring_vertex(inNumRings - 1, segment + 1) });
+	}
+
+	return mesh;
+}
+
+static void ShuffleTriangles(TestMesh& ioMesh, uint32 inSeed)
+{
+	std::vector<uint32> triangles(ioMesh.m_Indices.size() / 3);
+	for (uint32 t = 0; t < triangles.size(); t++)
+		triangles[t] = t;
+	std::shuffle(triangles.begin(), triangles.end(), std::mt19937(inSeed));
+
+	std::vector<uint32> indices;
+	for (uint32 t : triangles)
+		indices.insert(indices.end(), ioMesh.m_Indices.begin() + t * 3, ioMesh.m_Indices.begin() + t * 3 + 3);
+	ioMesh.m_Indices = indices;
+}
+
+static MeshletData BuildMeshlets(const TestMesh& inMesh)
+{
+	MeshletData data;
+	Meshlets::Build(inMesh.m_Indices.data(), inMesh.m_Indices.size(), &inMesh.m_Positions[0].x, inMesh.m_Positions.size(), sizeof(Vec3), data);
+	return data;
+}
+
+// Brute force checks of everything Meshlets::Validate checks, and of how tight the spheres are.
+// Returns the average ratio between the radius of the sphere and the smallest radius any sphere could have
+static float CheckMeshlets(const TestMesh& inMesh, const MeshletData& inData)
+{
+	CHECK(inData.m_Bounds.size() == inData.m_Meshlets.size());
+	CHECK(Meshlets::Validate(inData, 0, inData.m_Meshlets.size(), inMesh.m_Indices.data(), inMesh.m_Indices.size(), &inMesh.m_Positions[0].x, sizeof(Vec3)));
+
+	std::vector<uint32> indices;
+	bool are_within_limits		= true;
+	bool are_vertices_unique	= true;
+	bool are_vertices_contained	= true;
+	bool are_spheres_tight		= true;
+	double total_tightness		= 0.0;
+
+	for (size_t m = 0; m < inData.m_Meshlets.size(); m++)
+	{
+		const Meshlet& meshlet			= inData.m_Meshlets[m];
+		const MeshletBounds& bounds		= inData.m_Bounds[m];
+		const uint32* vertex_indices	= &inData.m_VertexIndices[meshlet.m_VertexOffset];
+
+		are_within_limits &= meshlet.m_NumVertices > 0 && meshlet.m_NumVertices <= Meshlets::MaxVertices;
+		are_within_limits &= meshlet.m_NumTriangles > 0 && meshlet.m_NumTriangles <= Meshlets::MaxTriangles;
+
+		for (uint32 t = 0; t < meshlet.m_NumTriangles * 3; t++)
+		{
+			const uint8 local_index = inData.m_TriangleIndices[meshlet.m_TriangleOffset + t];
+			are_within_limits &= local_index < meshlet.m_NumVertices;
+			indices.push_back(vertex_indices[local_index]);
+		}
+
+		// A vertex listed twice would be transformed twice
+		std::vector<uint32> sorted_vertices(vertex_indices, vertex_indices + meshlet.m_NumVertices);
+		std::sort(sorted_vertices.begin(), sorted_vertices.end());
+		are_vertices_unique &= std::adjacent_find(sorted_vertices.begin(), sorted_vertices.end()) == sorted_vertices.end();
+
+		const float tolerance = 1e-5f * Math::Max(1.0f, bounds.m_SphereRadius);
+
+		float max_distance = 0.0f;
+		for (uint32 v = 0; v < meshlet.m_NumVertices; v++)
+		{
+			const Vec3& position = inMesh.m_Positions[vertex_indices[v]];
+
+			are_vertices_contained &= (position - bounds.m_SphereCenter).Length() <= bounds.m_SphereRadius + tolerance;
+			for (int32 k = 0; k < 3; k++)
+				are_vertices_contained &= position[k] >= bounds.m_AABBMin[k] && position[k] <= bounds.m_AABBMax[k];
+
+			for (uint32 w = v + 1; w < meshlet.m_NumVertices; w++)
+				max_distance = Math::Max(max_distance, (inMesh.m_Positions[vertex_indices[w]] - position).Length());
+		}
+
+		// No sphere is smaller than half the largest distance between 2 vertices, and the sphere around the box always works
+		const float min_radius	= max_distance * 0.5f;
+		const float aabb_radius	= (bounds.m_AABBMax - bounds.m_AABBMin).Length() * 0.5f;
+		are_spheres_tight &= bounds.m_SphereRadius >= min_radius - tolerance && bounds.m_SphereRadius <= aabb_radius + tolerance;
+
+		total_tightness += min_radius > 0.0f ? bounds.m_SphereRadius / min_radius : 1.0f;
+	}
+
+	CHECK(are_within_limits);
+	CHECK(are_vertices_unique);
+	CHECK(are_vertices_contained);
+	CHECK(are_spheres_tight);
+
+	// Meshlets hold the triangles of the input, in order, each exactly once
+	CHECK(indices == inMesh.m_Indices);
+
+	return static_cast<float>(total_tightness / Math::Max<size_t>(1, inData.m_Meshlets.size()));
+}
+
+UNIT_TEST(MeshletBuild)
+{
+	// In vertex cache order, meshlets fill up to the triangle limit first
+	TestMesh sphere = MakeSphere(Vec3(3.0f, -1.0f, 2.0f), 5.0f, 32, 64);
+	ShuffleTriangles(sphere, 10);
+	MeshOptimizer::OptimizeVertexCache(sphere.m_Indices.data(), sphere.m_Indices.size(), sphere.m_Positions.size());
+
+	const MeshletData optimized_data	= BuildMeshlets(sphere);
+	const float optimized_tightness		= CheckMeshlets(sphere, optimized_data);
+
+	// In random order, every meshlet runs out of vertices long before the triangle limit
+	ShuffleTriangles(sphere, 11);
+	const MeshletData shuffled_data		= BuildMeshlets(sphere);
+	const float shuffled_tightness		= CheckMeshlets(sphere, shuffled_data);
+
+	CHECK(optimized_data.m_Meshlets.size() < shuffled_data.m_Meshlets.size());
+	CHECK(shuffled_data.m_Meshlets.size() > sphere.m_Indices.size() / 3 / 30);
+
+	// Half the largest distance is a lower bound, not always reachable. On these meshlets the spheres are within 1% and 4% of it
+	CHECK(optimized_tightness >= 1.0f && optimized_tightness < 1.1f);
+	CHECK(shuffled_tightness >= 1.0f && shuffled_tightness < 1.1f);
+
+	// Appending to existing data keeps the offsets of the first mesh
+	MeshletData appended_data = optimized_data;
+	Meshlets::Build(sphere.m_Indices.data(), sphere.m_Indices.size(), &sphere.m_Positions[0].x, sphere.m_Positions.size(), sizeof(Vec3), appended_data);
+	CHECK(appended_data.m_Meshlets.size() == optimized_data.m_Meshlets.size() + shuffled_data.m_Meshlets.size());
+	CHECK(Meshlets::Validate(appended_data, optimized_data.m_Meshlets.size(), shuffled_data.m_Meshlets.size(),
+							 sphere.m_Indices.data(), sphere.m_Indices.size(), &sphere.m_Positions[0].x, sizeof(Vec3)));
+
+	// Bounds that miss a vertex are caught
+	MeshletData shrunk_data = shuffled_data;
+	shrunk_data.m_Bounds[0].m_SphereRadius *= 0.9f;
+	CHECK(!Meshlets::Validate(shrunk_data, 0, shrunk_data.m_Meshlets.size(), sphere.m_Indices.data(), sphere.m_Indices.size(), &sphere.m_Positions[0].x, sizeof(Vec3)));
+
+	// Empty input, no meshlet
+	MeshletData empty_data;
+	Meshlets::Build(nullptr, 0, &sphere.m_Positions[0].x, sphere.m_Positions.size(), sizeof(Vec3), empty_data);
+	CHECK(empty_data.m_Meshlets.empty() && empty_data.m_Bounds.empty());
+}
+
+// Culled meshlets must not have any visible triangle: either all outside a plane, or all facing away from the camera
+UNIT_TEST(MeshletCull)
+{
+	const Vec3 center(3.0f, -1.0f, 2.0f);
+	TestMesh sphere = MakeSphere(center, 5.0f, 32, 64);
+	MeshOptimizer::OptimizeVertexCache(sphere.m_Indices.data(), sphere.m_Indices.size(), sphere.m_Positions.size());
+
+	const MeshletData data = BuildMeshlets(sphere);
+	CheckMeshlets(sphere, data);
+
+	// Only keeps x >= center.x. The other planes never cull
+	Vec4 planes[6];
+	planes[0] = Vec4(1.0f, 0.0f, 0.0f, -center.x);
+	for (int32 i = 1; i < 6; i++)
+		planes[i] = Vec4(0.0f, 0.0f, 0.0f, 1.0f);
+
+	std::mt19937 random(12);
+	std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+
+	size_t num_back_face_culled	= 0;
+	bool is_culling_safe		= true;
+	bool is_plane_culling_exact	= true;
+
+	for (uint32 c = 0; c < 32; c++)
+	{
+		const Vec3 camera = center + Vec3(unit(random), unit(random), unit(random)).Normalized() * (10.0f + 20.0f * (unit(random) + 1.0f));
+
+		std::vector<uint32> visible_meshlets;
+		Meshlets::Cull(data, 0, data.m_Meshlets.size(), camera, planes, visible_meshlets);
+
+		std::vector<bool> is_visible(data.m_Meshlets.size(), false);
+		for (uint32 m : visible_meshlets)
+			is_visible[m] = true;
+
+		for (size_t m = 0; m < data.m_Meshlets.size(); m++)
+		{
+			// Spheres behind the plane are always culled, whatever the camera
+			const MeshletBounds& bounds = data.m_Bounds[m];
+			if (bounds.m_SphereCenter.x - center.x < -bounds.m_SphereRadius)
+				is_plane_culling_exact &= !is_visible[m];
+
+			if (is_visible[m])
+				continue;
+
+			const Meshlet& meshlet			= data.m_Meshlets[m];
+			const uint32* vertex_indices	= &data.m_VertexIndices[meshlet.m_VertexOffset];
+
+			bool is_outside		= true;
+			bool is_back_facing	= true;
+			for (uint32 t = 0; t < meshlet.m_NumTriangles; t++)
+			{
+				const uint8* triangle	= &data.m_TriangleIndices[meshlet.m_TriangleOffset + t * 3];
+				const Vec3& p0			= sphere.m_Positions[vertex_indices[triangle[0]]];
+				const Vec3& p1			= sphere.m_Positions[vertex_indices[triangle[1]]];
+				const Vec3& p2			= sphere.m_Positions[vertex_indices[triangle[2]]];
+
+				is_outside		&= p0.x < center.x && p1.x < center.x && p2.x < center.x;
+				is_back_facing	&= Vec3::DotProduct(Vec3::CrossProduct(p1 - p0, p2 - p0), camera - p0) <= 1e-4f;
+			}
+
+			is_culling_safe &= is_outside || is_back_facing;
+			num_back_face_culled += is_outside ? 0 : 1;
+		}
+	}
+
+	CHECK(is_culling_safe);
+	CHECK(is_plane_culling_exact);
+	// The cones catch a good part of the meshlets facing away from the camera on the side the plane keeps (about 1 in 4)
+	CHECK(num_back_face_culled > 32 * data.m_Meshlets.size() / 8);
+}
@@ -0,0 +1,195 @@
+#include "Engine.h"
+#include "UnitTest.h"
+
+#include "Utils/Compression.h"
+#include "Utils/FileReader.h"
+#include "Utils/JobSystem.h"
+#include "Utils/PackFile.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <vector>
+
+static std::vector<Byte> MakeRandomData(uint64 inSize, uint32 inSeed)
+{
+	std::mt19937 random(inSeed);
+	std::vector<Byte> data(static_cast<size_t>(inSize));
+	for (Byte& value : data)
+		value = static_cast<Byte>(random());
+	return data;
+}
+
+// Repeated words with some noise, compresses like text assets
+static std::vector<Byte> MakeTextData(uint64 inSize, uint32 inSeed)
+{
+	static const char* const words[] = { "v ", "vt ", "vn ", "f ", "usemtl ", "0.000000 ", "1.000000 ", "-0.5 ", "12/7/3 ", "\n" };
+
+	std::mt19937 random(inSeed);
+	std::vector<Byte> data;
+	data.reserve(static_cast<size_t>(inSize));
+	while (data.size() < inSize)
+	{
+		const char* word = words[random() % std::size(words)];
+		data.insert(data.end(), word, word + strlen(word));
+	}
+	data.resize(static_cast<size_t>(inSize));
+	return data;
+}
+
+static bool RoundTrip(const std::vector<Byte>& inData)
+{
+	std::vector<Byte> compressed(static_cast<size_t>(Compression::GetMaxCompressedSize(inData.size())));
+	const uint64 compressed_size = Compression::Compress(inData.data(), inData.size(), compressed.data(), compressed.size());
+	if (compressed_size == 0 && !inData.empty())
+		return false;
+
+	std::vector<Byte> decompressed(inData.size());
+	if (!Compression::Decompress(compressed.data(), compressed_size, decompressed.data(), decompressed.size()))
+		return false;
+
+	return decompressed == inData;
+}
+
+UNIT_TEST(CompressionRoundTrip)
+{
+	const uint64 sizes[] = { 1, 4, 12, 13, 64, 1000, 4096, 65535, 65536, 65537, 1 << 20 };
+
+	for (uint64 size : sizes)
+	{
+		CHECK(RoundTrip(MakeRandomData(size, static_cast<uint32>(size))));
+		CHECK(RoundTrip(MakeTextData(size, static_cast<uint32>(size))));
+		CHECK(RoundTrip(std::vector<Byte>(static_cast<size_t>(size), 0x42)));
+	}
+}
+
+UNIT_TEST(CompressionRejectsBadInput)
+{
+	const std::vector<Byte> data = MakeTextData(64 * 1024, 1);
+
+	std::vector<Byte> compressed(static_cast<size_t>(Compression::GetMaxCompressedSize(data.size())));
+	const uint64 compressed_size = Compression::Compress(data.data(), data.size(), compressed.data(), compressed.size());
+	CHECK(compressed_size > 0 && compressed_size < data.size());
+
+	// Text must shrink, random data must not fit when only smaller output is accepted
+	const std::vector<Byte> random_data = MakeRandomData(64 * 1024, 2);
+	CHECK(Compression::Compress(random_data.data(), random_data.size(), compressed.data(), random_data.size() - 1) == 0);
+
+	std::vector<Byte> decompressed(data.size());
+	CHECK(!Compression::Decompress(compressed.data(), compressed_size / 2, decompressed.data(), decompressed.size()));
+	CHECK(!Compression::Decompress(compressed.data(), compressed_size, decompressed.data(), decompressed.size() - 1));
+
+	// Corrupted streams are rejected or decode to something, never out of bounds
+	std::mt19937 random(3);
+	for (uint32 i = 0; i < 1000; i++)
+	{
+		std::vector<Byte> corrupted(compressed.begin(), compressed.begin() + static_cast<size_t>(compressed_size));
+		corrupted[random() % corrupted.size()] = static_cast<Byte>(random());
+		Compression::Decompress(corrupted.data(), corrupted.size(), decompressed.data(), decompressed.size());
+	}
+}
+
+UNIT_TEST(PackFileReadRanges)
+{
+	constexpr uint32 block_size = 4096;
+
+	struct TestFile
+	{
+		std::string			m_Path;
+		std::vector<Byte>	m_Data;
+	};
+
+	// Sizes around block boundaries, compressible and incompressible blocks
+	std::vector<TestFile> test_files =
+	{
+		{ GetTestDirectory() + "/Empty.bin",		{} },
+		{ GetTestDirectory() + "/OneByte.bin",		MakeRandomData(1, 1) },
+		{ GetTestDirectory() + "/BlockMinus1.txt",	MakeTextData(block_size - 1, 2) },
+		{ GetTestDirectory() + "/Block.txt",		MakeTextData(block_size, 3) },
+		{ GetTestDirectory() + "/BlockPlus1.bin",	MakeRandomData(block_size + 1, 4) },
+		{ GetTestDirectory() + "/Mixed.bin",		MakeTextData(block_size * 7 / 2, 5) },
+		// Enough blocks for Read to split them over jobs
+		{ GetTestDirectory() + "/Large.txt",		MakeTextData(block_size * 40 + 123, 6) },
+	};
+
+	// Half text, half random
+	std::vector<Byte>& mixed = test_files[5].m_Data;
+	const std::vector<Byte> random_half = MakeRandomData(mixed.size() / 2, 7);
+	std::copy(random_half.begin(), random_half.end(), mixed.begin());
+
+	std::vector<std::string> paths;
+	for (const TestFile& test_file : test_files)
+	{
+		std::ofstream file(test_file.m_Path, std::ios::binary);
+		file.write(reinterpret_cast<const char*>(test_file.m_Data.data()), static_cast<std::streamsize>(test_file.m_Data.size()));
+		paths.push_back(test_file.m_Path);
+	}
+
+	const std::string pack_path = GetTestDirectory() + "/Test.apak";
+	CHECK(PackFile::Write(pack_path, paths, block_size));
+
+	PackFile pack_file;
+	CHECK(pack_file.Open(pack_path));
+	if (!pack_file.IsOpen())
+		return;
+
+	// Large reads decompress their blocks on several workers
+	g_JobSystem.Init(4);
+
+	std::mt19937 random(8);
+	for (const TestFile& test_file : test_files)
+	{
+		const PackFileFormat::Entry* entry = pack_file.Find(test_file.m_Path);
+		CHECK(entry != nullptr);
+		if (entry == nullptr)
+			continue;
+
+		const uint64 size = test_file.m_Data.size();
+		CHECK(entry->m_Size == size);
+
+		std::vector<Byte> content(static_cast<size_t>(size) + 1);
+		CHECK(pack_file.Read(*entry, 0, size, content.data()));
+		CHECK(std::equal(test_file.m_Data.begin(), test_file.m_Data.end(), content.begin()));
+
+		// Partial ranges, starting and ending anywhere in a block
+		for (uint32 i = 0; i < 200 && size > 0; i++)
+		{
+			const uint64 offset		= random() % size;
+			const uint64 range_size	= random() % (size - offset + 1);
+
+			std::fill(content.begin(), content.end(), Byte(0xCD));
+			CHECK(pack_file.Read(*entry, offset, range_size, content.data()));
+			CHECK(std::equal(content.begin(), content.begin() + static_cast<size_t>(range_size), test_file.m_Data.begin() + static_cast<size_t>(offset)));
+			// Nothing written past the range
+			CHECK(content[static_cast<size_t>(range_size)] == 0xCD);
+		}
+
+		// Ranges going past the end of the file fail
+		CHECK(!pack_file.Read(*entry, size, 1, content.data()));
+		CHECK(!pack_file.Read(*entry, 0, size + 1, content.data()));
+	}
+
+	CHECK(pack_file.Find(GetTestDirectory() + "/Missing.bin") == nullptr);
+	pack_file.Close();
+
+	// Mounted packs are read by FileReader, whatever the spelling of the path
+	CHECK(PackFile::Mount(pack_path));
+	for (const TestFile& test_file : test_files)
+		std::remove(test_file.m_Path.c_str());
+
+	std::string upper_case_path = test_files[3].m_Path;
+	for (char& c : upper_case_path)
+		c = static_cast<char>(toupper(c));
+
+	FileReader file_reader;
+	CHECK(file_reader.ReadFile(upper_case_path));
+	CHECK(file_reader.GetContentSize() == test_files[3].m_Data.size());
+	CHECK(memcmp(file_reader.GetContentAsBinary(), test_files[3].m_Data.data(), test_files[3].m_Data.size()) == 0);
+
+	PackFile::UnmountAll();
+	g_JobSystem.Shutdown();
+}
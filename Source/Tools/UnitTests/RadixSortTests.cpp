@@ -0,0 +1,116 @@
+#include "Engine.h"
+#include "UnitTest.h"
+
+#include "Gfx/DrawKey.h"
+#include "Utils/JobSystem.h"
+#include "Utils/RadixSort.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <random>
+#include <utility>
+#include <vector>
+
+// Values are the original positions, so stability is checked along with the order
+static bool MatchesStableSort(std::vector<uint64> inKeys)
+{
+	const size_t count = inKeys.size();
+
+	std::vector<std::pair<uint64, uint32>> expected(count);
+	for (size_t i = 0; i < count; i++)
+		expected[i] = { inKeys[i], static_cast<uint32>(i) };
+	std::stable_sort(expected.begin(), expected.end(), [](const std::pair<uint64, uint32>& inLeft, const std::pair<uint64, uint32>& inRight)
+	{
+		return inLeft.first < inRight.first;
+	});
+
+	std::vector<uint32> values(count);
+	std::iota(values.begin(), values.end(), 0);
+	std::vector<uint64> temp_keys(count);
+	std::vector<uint32> temp_values(count);
+	RadixSort::Sort(inKeys.data(), values.data(), count, temp_keys.data(), temp_values.data());
+
+	for (size_t i = 0; i < count; i++)
+		if (inKeys[i] != expected[i].first || values[i] != expected[i].second)
+			return false;
+	return true;
+}
+
+static void CheckKeyDistributions(uint32 inSeed)
+{
+	// Around MinKeysPerJob, where large arrays start being split over the workers
+	const size_t counts[] = { 0, 1, 2, 255, RadixSort::MinKeysPerJob - 1, RadixSort::MinKeysPerJob, 4 * RadixSort::MinKeysPerJob + 7, 300001 };
+
+	std::mt19937_64 random(inSeed);
+	for (size_t count : counts)
+	{
+		std::vector<uint64> keys(count);
+
+		for (uint64& key : keys)
+			key = random();
+		CHECK(MatchesStableSort(keys));
+
+		// Few varying digits and many ties, most passes are skipped
+		for (uint64& key : keys)
+			key = (random() % 5) << 60 | (random() % 40) << 22 | (random() & 0xfff);
+		CHECK(MatchesStableSort(keys));
+
+		for (uint64& key : keys)
+			key = 42;
+		CHECK(MatchesStableSort(keys));
+
+		for (size_t i = 0; i < count; i++)
+			keys[i] = count - i;
+		CHECK(MatchesStableSort(keys));
+
+		// Keys of a frame: a few pipelines and materials, many meshes, any depth
+		std::uniform_real_distribution<float> depth(0.1f, 1000.0f);
+		for (uint64& key : keys)
+		{
+			const RenderPass pass = random() % 10 == 0 ? RenderPass::Transparent : RenderPass::OpaqueGeometry;
+			key = DrawKey::Make(pass, random() % 64, random() % 256, random() % 4096, depth(random));
+		}
+		CHECK(MatchesStableSort(keys));
+	}
+}
+
+UNIT_TEST(RadixSortMatchesStableSort)
+{
+	// On the calling thread, then split over the workers
+	CheckKeyDistributions(1);
+
+	for (uint32 num_workers : { 2, 4 })
+	{
+		g_JobSystem.Init(num_workers);
+		CheckKeyDistributions(num_workers);
+		g_JobSystem.Shutdown();
+	}
+}
+
+UNIT_TEST(DrawKeyOrder)
+{
+	// Depth keeps the order of positive floats and clamps the rest to 0
+	CHECK(DrawKey::QuantizeDepth(-1.0f) == 0);
+	CHECK(DrawKey::QuantizeDepth(0.0f) == 0);
+	CHECK(DrawKey::QuantizeDepth(std::nanf("")) == 0);
+	CHECK(DrawKey::QuantizeDepth(0.5f) < DrawKey::QuantizeDepth(1.0f));
+	CHECK(DrawKey::QuantizeDepth(10.0f) < DrawKey::QuantizeDepth(1000.0f));
+	CHECK(DrawKey::QuantizeDepth(1000.0f) < (1u << DrawKey::DepthBits));
+
+	// Opaque: state first, then front to back
+	const uint64 near_opaque	= DrawKey::Make(RenderPass::OpaqueGeometry, 1, 0, 0, 1.0f);
+	const uint64 far_opaque		= DrawKey::Make(RenderPass::OpaqueGeometry, 1, 0, 0, 100.0f);
+	const uint64 other_pipeline	= DrawKey::Make(RenderPass::OpaqueGeometry, 2, 0, 0, 0.5f);
+	CHECK(near_opaque < far_opaque);
+	CHECK(far_opaque < other_pipeline);
+
+	// Transparent: after every opaque draw, back to front whatever the state
+	const uint64 near_transparent	= DrawKey::Make(RenderPass::Transparent, 0, 0, 0, 1.0f);
+	const uint64 far_transparent	= DrawKey::Make(RenderPass::Transparent, 3, 0, 0, 100.0f);
+	CHECK(other_pipeline < far_transparent);
+	CHECK(far_transparent < near_transparent);
+
+	CHECK(DrawKey::GetPass(near_opaque) == RenderPass::OpaqueGeometry);
+	CHECK(DrawKey::GetPass(near_transparent) == RenderPass::Transparent);
+}
@@ -0,0 +1,194 @@
+#include "Engine.h"
+#include "UnitTest.h"
+
+#include "Utils/RangeAllocator.h"
+
+#include <iterator>
+#include <map>
+#include <random>
+#include <utility>
+#include <vector>
+
+// RangeAllocator placement and merging, and its statistics against a model of the live ranges
+
+UNIT_TEST(RangeAllocatorBestFit)
+{
+	RangeAllocator allocator(1024);
+
+	CHECK(allocator.Allocate(100) == 0);
+	CHECK(allocator.Allocate(64) == 100);
+	CHECK(allocator.Allocate(100) == 164);
+	CHECK(allocator.Allocate(40) == 264);
+	CHECK(allocator.Allocate(100) == 304);
+
+	// Free blocks: 64 at 100, 40 at 264 and 620 at 404
+	allocator.Free(100, 64);
+	allocator.Free(264, 40);
+	CHECK(allocator.GetStatistics().m_NumFreeBlocks == 3);
+
+	// Smallest block that fits, not the first one
+	CHECK(allocator.Allocate(30) == 264);
+
+	// 10 at 294 is too small, 64 at 100 fits once aligned to 128
+	CHECK(allocator.Allocate(16, 32) == 128);
+
+	// Aligned to 64, 20 at 144 and 28 at 100 are large enough but not once aligned
+	CHECK(allocator.Allocate(20, 64) == 448);
+
+	// Alignments don't need to be powers of two
+	CHECK(allocator.Allocate(10, 3) == 294);
+	CHECK(allocator.Allocate(5, 7) == 147);
+
+	// Free blocks: 28 at 100, 3 at 144, 12 at 152, 44 at 404 and 556 at 468
+	const RangeAllocator::Statistics statistics = allocator.GetStatistics();
+	CHECK(statistics.m_NumFreeBlocks == 5);
+	CHECK(statistics.m_LargestFreeBlock == 556);
+	CHECK(statistics.m_NumAllocations == 8);
+	CHECK(statistics.GetFreeSize() == 28 + 3 + 12 + 44 + 556);
+
+	CHECK(allocator.Allocate(557) == RangeAllocator::InvalidOffset);
+	CHECK(allocator.Allocate(556, 8) == RangeAllocator::InvalidOffset);
+	CHECK(allocator.Allocate(556) == 468);
+	CHECK(allocator.GetStatistics().m_LargestFreeBlock == 44);
+}
+
+UNIT_TEST(RangeAllocatorMerge)
+{
+	RangeAllocator allocator(500);
+	for (uint64 i = 0; i < 5; i++)
+		CHECK(allocator.Allocate(100) == i * 100);
+	CHECK(allocator.GetStatistics().m_NumFreeBlocks == 0);
+	CHECK(allocator.GetStatistics().m_LargestFreeBlock == 0);
+
+	// Isolated blocks
+	allocator.Free(0, 100);
+	allocator.Free(200, 100);
+	CHECK(allocator.GetStatistics().m_NumFreeBlocks == 2);
+	CHECK(allocator.GetStatistics().m_LargestFreeBlock == 100);
+
+	// Merged with the previous block only
+	allocator.Free(300, 100);
+	CHECK(allocator.GetStatistics().m_NumFreeBlocks == 2);
+	CHECK(allocator.GetStatistics().m_LargestFreeBlock == 200);
+
+	// Merged with the blocks on both sides
+	allocator.Free(100, 100);
+	CHECK(allocator.GetStatistics().m_NumFreeBlocks == 1);
+	CHECK(allocator.GetStatistics().m_LargestFreeBlock == 400);
+
+	// Merged with the next block only
+	CHECK(allocator.Allocate(400) == 0);
+	allocator.Free(400, 100);
+	allocator.Free(0, 400);
+	CHECK(allocator.IsEmpty());
+	CHECK(allocator.GetStatistics().m_NumFreeBlocks == 1);
+	CHECK(allocator.GetStatistics().m_LargestFreeBlock == 500);
+	CHECK(allocator.GetStatistics().GetFragmentation() == 0.0f);
+}
+
+UNIT_TEST(RangeAllocatorInvalidFree)
+{
+	// Free asserts on the ranges IsAllocated rejects
+	RangeAllocator allocator(400);
+	CHECK(allocator.Allocate(100) == 0);
+	CHECK(allocator.Allocate(100) == 100);
+	CHECK(allocator.Allocate(100) == 200);
+
+	allocator.Free(100, 100);
+
+	// Freed twice
+	CHECK(!allocator.IsAllocated(100, 100));
+	// Overlapping the free block in the middle, from either side or from the inside
+	CHECK(!allocator.IsAllocated(50, 100));
+	CHECK(!allocator.IsAllocated(150, 100));
+	CHECK(!allocator.IsAllocated(120, 10));
+	CHECK(!allocator.IsAllocated(0, 300));
+	// Overlapping the free block at the end, or out of range
+	CHECK(!allocator.IsAllocated(250, 100));
+	CHECK(!allocator.IsAllocated(300, 1));
+	CHECK(!allocator.IsAllocated(350, 100));
+	CHECK(!allocator.IsAllocated(0, 0));
+
+	// Live ranges, touching free blocks is fine
+	CHECK(allocator.IsAllocated(0, 100));
+	CHECK(allocator.IsAllocated(200, 100));
+	CHECK(allocator.IsAllocated(99, 1));
+	CHECK(allocator.IsAllocated(200, 1));
+}
+
+UNIT_TEST(RangeAllocatorStatistics)
+{
+	constexpr uint64 capacity = 64 * 1024;
+
+	RangeAllocator allocator(capacity);
+	std::map<uint64, uint64> live_ranges;
+	std::mt19937 random(7);
+
+	bool is_consistent = true;
+	for (uint32 step = 0; step < 20000; step++)
+	{
+		// Mostly allocations while it is empty, mostly frees once it fills up
+		const bool should_allocate = live_ranges.empty() || random() % capacity >= allocator.GetUsedSize();
+		if (should_allocate)
+		{
+			const uint64 size		= 1 + random() % 2000;
+			const uint64 alignment	= uint64(1) << (random() % 9);
+			const uint64 offset		= allocator.Allocate(size, alignment);
+			if (offset != RangeAllocator::InvalidOffset)
+			{
+				is_consistent &= (offset % alignment) == 0 && offset + size <= capacity;
+
+				// No overlap with the live ranges around it
+				auto next = live_ranges.lower_bound(offset);
+				is_consistent &= next == live_ranges.end() || next->first >= offset + size;
+				is_consistent &= next == live_ranges.begin() || std::prev(next)->first + std::prev(next)->second <= offset;
+
+				live_ranges.emplace(offset, size);
+			}
+		}
+		else
+		{
+			auto it = live_ranges.begin();
+			std::advance(it, random() % live_ranges.size());
+
+			is_consistent &= allocator.IsAllocated(it->first, it->second);
+			allocator.Free(it->first, it->second);
+			is_consistent &= !allocator.IsAllocated(it->first, it->second);
+			live_ranges.erase(it);
+		}
+
+		// Free blocks are always merged, so there is exactly one per gap between live ranges
+		uint64 used_size			= 0;
+		uint64 largest_gap			= 0;
+		uint32 num_gaps				= 0;
+		uint64 previous_range_end	= 0;
+		for (const std::pair<const uint64, uint64>& range : live_ranges)
+		{
+			if (range.first > previous_range_end)
+			{
+				largest_gap = Math::Max(largest_gap, range.first - previous_range_end);
+				num_gaps++;
+			}
+			used_size			+= range.second;
+			previous_range_end	= range.first + range.second;
+		}
+		if (capacity > previous_range_end)
+		{
+			largest_gap = Math::Max(largest_gap, capacity - previous_range_end);
+			num_gaps++;
+		}
+
+		const RangeAllocator::Statistics statistics = allocator.GetStatistics();
+		is_consistent &= statistics.m_UsedSize == used_size;
+		is_consistent &= statistics.m_NumAllocations == live_ranges.size();
+		is_consistent &= statistics.m_NumFreeBlocks == num_gaps;
+		is_consistent &= statistics.m_LargestFreeBlock == largest_gap;
+	}
+	CHECK(is_consistent);
+
+	for (const std::pair<const uint64, uint64>& range : live_ranges)
+		allocator.Free(range.first, range.second);
+	CHECK(allocator.IsEmpty());
+	CHECK(allocator.GetStatistics().m_NumFreeBlocks == 1);
+	CHECK(allocator.GetStatistics().m_LargestFreeBlock == capacity);
+}
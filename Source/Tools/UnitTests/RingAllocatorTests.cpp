@@ -0,0 +1,195 @@
+#include "Engine.h"
+#include "UnitTest.h"
+
+#include "Utils/JobSystem.h"
+#include "Utils/RingAllocator.h"
+
+#include <algorithm>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+
+// RingAllocator against a made up fence: frame N is signaled with fence value N and the GPU completes it a few frames later
+
+UNIT_TEST(RingAllocatorWrapAround)
+{
+	RingAllocator ring(1024);
+
+	CHECK(ring.Allocate(100, 256) == 0);
+	CHECK(ring.Allocate(100, 256) == 256);
+	// Would cross the end of the ring, restarting at the beginning runs into the tail
+	CHECK(ring.Allocate(600, 256) == RingAllocator::InvalidOffset);
+	CHECK(ring.Allocate(512, 256) == 512);
+	CHECK(ring.GetStatistics().m_UsedSize == 1024);
+
+	// Nothing comes back until the fence of the frame is complete
+	ring.EndFrame(1);
+	CHECK(ring.Allocate(1) == RingAllocator::InvalidOffset);
+	ring.Reclaim(0);
+	CHECK(ring.Allocate(1) == RingAllocator::InvalidOffset);
+	ring.Reclaim(1);
+	CHECK(ring.GetStatistics().m_UsedSize == 0);
+	CHECK(ring.GetStatistics().m_NumPendingFrames == 0);
+
+	// Second lap
+	CHECK(ring.Allocate(300, 256) == 0);
+	ring.EndFrame(2);
+	CHECK(ring.Allocate(800, 256) == RingAllocator::InvalidOffset);
+	CHECK(ring.Allocate(512, 256) == 512);
+	ring.EndFrame(3);
+
+	// Frame 2 is complete, its range at the start of the ring is free again but not the padding after it
+	ring.Reclaim(2);
+	CHECK(ring.Allocate(200, 256) == 0);
+	CHECK(ring.Allocate(100, 256) == RingAllocator::InvalidOffset);
+	CHECK(ring.GetStatistics().m_NumPendingFrames == 1);
+
+	const RingAllocator::Statistics statistics = ring.GetStatistics();
+	CHECK(statistics.m_NumFailedAllocations == 5);
+	CHECK(statistics.m_PeakUsedSize == 1024);
+}
+
+UNIT_TEST(RingAllocatorFull)
+{
+	// A GPU that never completes anything
+	RingAllocator ring(4096);
+
+	uint32 num_allocated = 0;
+	for (uint32 i = 0; i < 100; i++)
+	{
+		if (ring.Allocate(256, 256) != RingAllocator::InvalidOffset)
+			num_allocated++;
+	}
+
+	CHECK(num_allocated == 16);
+	CHECK(ring.GetStatistics().m_NumFailedAllocations == 84);
+	CHECK(ring.GetStatistics().m_UsedSize == 4096);
+
+	// Failed allocations take nothing, the ring is usable again once the frame is complete
+	ring.EndFrame(1);
+	ring.Reclaim(1);
+	CHECK(ring.Allocate(4096) == 0);
+
+	// Init forgets everything, statistics included
+	ring.Init(4096);
+	CHECK(ring.GetStatistics().m_NumFailedAllocations == 0);
+	CHECK(ring.GetStatistics().m_UsedSize == 0);
+}
+
+struct AllocatedRange
+{
+	uint64	m_Begin;
+	uint64	m_End;
+};
+
+// Ranges still in use must not overlap, whatever their frame
+static bool HasOverlap(std::vector<AllocatedRange> ioRanges)
+{
+	std::sort(ioRanges.begin(), ioRanges.end(), [](const AllocatedRange& inLeft, const AllocatedRange& inRight) { return inLeft.m_Begin < inRight.m_Begin; });
+	for (size_t i = 1; i < ioRanges.size(); i++)
+		if (ioRanges[i].m_Begin < ioRanges[i - 1].m_End)
+			return true;
+	return false;
+}
+
+UNIT_TEST(RingAllocatorFenceTimeline)
+{
+	constexpr uint64 capacity		= 1 << 20;
+	constexpr uint64 alignment		= 256;
+	constexpr uint32 num_frames		= 500;
+	constexpr uint32 frames_behind	= 3;
+
+	g_JobSystem.Init(4);
+
+	RingAllocator ring(capacity);
+	std::mt19937 random(1);
+	std::vector<std::vector<AllocatedRange>> frame_ranges(num_frames);
+	std::mutex mutex;
+	uint32 num_misaligned = 0;
+
+	for (uint32 frame = 0; frame < num_frames; frame++)
+	{
+		// Fence value frame + 1 is signaled at the end of the frame, the GPU is frames_behind frames late
+		const uint64 completed_fence_value = frame >= frames_behind ? frame - frames_behind + 1 : 0;
+		ring.Reclaim(completed_fence_value);
+
+		// Constant buffers of the frame, allocated while recording on the workers
+		std::vector<uint64> sizes(100 + random() % 300);
+		for (uint64& size : sizes)
+			size = 16 + random() % 700;
+
+		g_JobSystem.ParallelFor(sizes.size(), [&](size_t inIndex)
+		{
+			const uint64 offset = ring.Allocate(sizes[inIndex], alignment);
+
+			std::lock_guard<std::mutex> lock(mutex);
+			if (offset == RingAllocator::InvalidOffset)
+				return;
+			if (offset % alignment != 0 || offset + sizes[inIndex] > capacity)
+				num_misaligned++;
+			frame_ranges[frame].push_back({ offset, offset + sizes[inIndex] });
+		});
+
+		ring.EndFrame(frame + 1);
+
+		// Frames from the first one not complete to this one are in use
+		std::vector<AllocatedRange> live_ranges;
+		for (uint64 live_frame = completed_fence_value; live_frame <= frame; live_frame++)
+			live_ranges.insert(live_ranges.end(), frame_ranges[live_frame].begin(), frame_ranges[live_frame].end());
+		CHECK(!HasOverlap(live_ranges));
+	}
+
+	// Four frames of at most 400 * 768 bytes fit, nothing should have failed
+	const RingAllocator::Statistics statistics = ring.GetStatistics();
+	CHECK(statistics.m_NumFailedAllocations == 0);
+	CHECK(num_misaligned == 0);
+	CHECK(statistics.m_NumPendingFrames == frames_behind);
+	CHECK(statistics.m_PeakUsedSize <= capacity);
+
+	g_JobSystem.Shutdown();
+}
+
+UNIT_TEST(RingAllocatorMultithreaded)
+{
+	// Threads race to fill an empty ring: every slot is handed out exactly once, the rest fails
+	constexpr uint64 capacity			= 1 << 16;
+	constexpr uint64 size				= 64;
+	constexpr uint32 num_threads		= 4;
+	constexpr uint64 num_slots			= capacity / size;
+	constexpr uint64 attempts_per_thread	= num_slots;
+
+	RingAllocator ring(capacity);
+	std::vector<std::vector<uint64>> thread_offsets(num_threads);
+
+	std::vector<std::thread> threads;
+	for (uint32 t = 0; t < num_threads; t++)
+	{
+		threads.emplace_back([&ring, &offsets = thread_offsets[t]]()
+		{
+			for (uint64 i = 0; i < attempts_per_thread; i++)
+			{
+				const uint64 offset = ring.Allocate(size, size);
+				if (offset != RingAllocator::InvalidOffset)
+					offsets.push_back(offset);
+			}
+		});
+	}
+
+	for (std::thread& thread : threads)
+		thread.join();
+
+	std::vector<uint64> offsets;
+	for (const std::vector<uint64>& thread_offset : thread_offsets)
+		offsets.insert(offsets.end(), thread_offset.begin(), thread_offset.end());
+	std::sort(offsets.begin(), offsets.end());
+
+	CHECK(offsets.size() == num_slots);
+	bool all_slots_once = offsets.size() == num_slots;
+	for (size_t i = 0; i < offsets.size() && all_slots_once; i++)
+		all_slots_once = offsets[i] == i * size;
+	CHECK(all_slots_once);
+
+	CHECK(ring.GetStatistics().m_NumFailedAllocations == num_threads * attempts_per_thread - num_slots);
+	CHECK(ring.GetStatistics().m_UsedSize == capacity);
+}
@@ -0,0 +1,196 @@
+#include "Engine.h"
+#include "UnitTest.h"
+
+#include "Gfx/RecordingCommandList.h"
+#include "Gfx/StateCacheCommandList.h"
+
+#include <algorithm>
+#include <climits>
+#include <random>
+#include <vector>
+
+// StateCacheCommandList in front of RecordingCommandList: what the cache elides must be exactly what the recorder
+// would have found redundant. D3D12 objects are made up pointers, neither of them dereferences them
+
+template <typename T>
+static inline T* MakeFakeObject(uint32 inType, uint32 inIndex)
+{
+	return reinterpret_cast<T*>(static_cast<uintptr_t>((static_cast<uint64>(inType) << 32) | ((inIndex + 1) << 8)));
+}
+
+UNIT_TEST(StateCacheCommandListRules)
+{
+	RecordingCommandList recording_command_list;
+	StateCacheCommandList command_list(recording_command_list);
+
+	// Every call here binds state, the recorder gets the issued ones only
+	const auto check_counts = [&](uint64 inNumIssued, uint64 inNumElided)
+	{
+		CHECK(command_list.GetStatistics().m_NumIssued == inNumIssued);
+		CHECK(command_list.GetStatistics().m_NumElided == inNumElided);
+		CHECK(recording_command_list.GetStatistics().m_NumCommands == inNumIssued);
+	};
+
+	ID3D12RootSignature* root_signatures[]	= { MakeFakeObject<ID3D12RootSignature>(1, 0), MakeFakeObject<ID3D12RootSignature>(1, 1) };
+	ID3D12PipelineState* pipeline_state		= MakeFakeObject<ID3D12PipelineState>(2, 0);
+	ID3D12DescriptorHeap* heaps[]			= { MakeFakeObject<ID3D12DescriptorHeap>(3, 0), MakeFakeObject<ID3D12DescriptorHeap>(3, 1) };
+
+	command_list.SetDescriptorHeaps(1, &heaps[0]);
+	command_list.SetDescriptorHeaps(1, &heaps[0]);
+	check_counts(1, 1);
+
+	command_list.SetGraphicsRootSignature(root_signatures[0]);
+	command_list.SetGraphicsRootDescriptorTable(0, { 7 });
+	command_list.SetGraphicsRootDescriptorTable(0, { 7 });
+	command_list.SetGraphicsRootConstantBufferView(1, 0x100);
+	check_counts(4, 2);
+
+	// A root signature change unbinds the root parameters
+	command_list.SetGraphicsRootSignature(root_signatures[1]);
+	command_list.SetGraphicsRootDescriptorTable(0, { 7 });
+	check_counts(6, 2);
+
+	// So does a descriptor heap change, tables point in the previous heap
+	command_list.SetDescriptorHeaps(1, &heaps[1]);
+	command_list.SetGraphicsRootDescriptorTable(0, { 7 });
+	check_counts(8, 2);
+
+	command_list.SetGraphicsRootSignature(root_signatures[1]);
+	command_list.SetPipelineState(pipeline_state);
+	command_list.SetPipelineState(pipeline_state);
+	check_counts(9, 4);
+
+	// Null bindings are always forwarded, the recorder traces them as errors
+	command_list.SetPipelineState(nullptr);
+	command_list.SetGraphicsRootSignature(nullptr);
+	command_list.SetGraphicsRootSignature(nullptr);
+	command_list.SetGraphicsRootSignature(root_signatures[0]);
+	check_counts(13, 4);
+
+	const D3D12_VERTEX_BUFFER_VIEW vertex_buffers[2] = { { 0x10, 64, 16 }, { 0x20, 64, 16 } };
+	command_list.IASetVertexBuffers(0, 1, &vertex_buffers[0]);
+	command_list.IASetVertexBuffers(0, 1, &vertex_buffers[0]);
+	check_counts(14, 5);
+
+	// Other slots don't change slot 0, ranges covering it make it unknown
+	command_list.IASetVertexBuffers(1, 1, &vertex_buffers[1]);
+	command_list.IASetVertexBuffers(0, 1, &vertex_buffers[0]);
+	check_counts(15, 6);
+	command_list.IASetVertexBuffers(0, 2, vertex_buffers);
+	command_list.IASetVertexBuffers(0, 1, &vertex_buffers[0]);
+	check_counts(17, 6);
+
+	const D3D12_INDEX_BUFFER_VIEW index_buffer = { 0x30, 60, DXGI_FORMAT_R16_UINT };
+	command_list.IASetIndexBuffer(&index_buffer);
+	command_list.IASetIndexBuffer(&index_buffer);
+	command_list.IASetIndexBuffer(nullptr);
+	command_list.IASetIndexBuffer(nullptr);
+	check_counts(19, 8);
+
+	command_list.IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+	command_list.IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+	check_counts(20, 9);
+
+	// Root parameters past MaxRootParameters aren't tracked
+	command_list.SetGraphicsRootConstantBufferView(StateCacheCommandList::MaxRootParameters, 0x200);
+	command_list.SetGraphicsRootConstantBufferView(StateCacheCommandList::MaxRootParameters, 0x200);
+	check_counts(22, 9);
+
+	// Nothing is known after a reset, like on a new command list
+	command_list.Reset();
+	recording_command_list.Reset();
+	command_list.SetGraphicsRootSignature(root_signatures[1]);
+	check_counts(1, 0);
+}
+
+struct TestDraw
+{
+	uint32	m_Shader;
+	uint32	m_MeshPage;
+	uint32	m_Texture;
+};
+
+// Binds everything for every draw, like DrawQueue::Submit, and leaves the filtering to the command list
+static void RecordFrame(CommandList& ioCommandList, const std::vector<TestDraw>& inDraws)
+{
+	ID3D12DescriptorHeap* descriptor_heap	= MakeFakeObject<ID3D12DescriptorHeap>(3, 0);
+	const D3D12_CPU_DESCRIPTOR_HANDLE rtv	= { 0x1000 };
+	const D3D12_CPU_DESCRIPTOR_HANDLE dsv	= { 0x2000 };
+
+	ioCommandList.OMSetRenderTargets(1, &rtv, false, &dsv);
+
+	const D3D12_RECT		scissor_rect	= CD3DX12_RECT(0, 0, LONG_MAX, LONG_MAX);
+	const D3D12_VIEWPORT	viewport		= CD3DX12_VIEWPORT(0.0f, 0.0f, 1920.0f, 1080.0f);
+	ioCommandList.RSSetViewports(1, &viewport);
+	ioCommandList.RSSetScissorRects(1, &scissor_rect);
+
+	const D3D12_GPU_DESCRIPTOR_HANDLE texture_tables[] = { ioCommandList.CopyDescriptor({ 0x10000 }), ioCommandList.CopyDescriptor({ 0x10020 }) };
+
+	for (const TestDraw& draw : inDraws)
+	{
+		ioCommandList.SetDescriptorHeaps(1, &descriptor_heap);
+		ioCommandList.SetGraphicsRootSignature(MakeFakeObject<ID3D12RootSignature>(1, draw.m_Shader / 2));
+		ioCommandList.SetPipelineState(MakeFakeObject<ID3D12PipelineState>(2, draw.m_Shader));
+
+		const D3D12_VERTEX_BUFFER_VIEW	vertex_buffer	= { 0x100000 + draw.m_MeshPage * 0x10000ull, 0x10000, 32 };
+		const D3D12_INDEX_BUFFER_VIEW	index_buffer	= { 0x200000 + draw.m_MeshPage * 0x10000ull, 0x10000, DXGI_FORMAT_R32_UINT };
+		ioCommandList.IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+		ioCommandList.IASetVertexBuffers(0, 1, &vertex_buffer);
+		ioCommandList.IASetIndexBuffer(&index_buffer);
+
+		ioCommandList.SetGraphicsRootDescriptorTable(0, texture_tables[draw.m_Texture]);
+		ioCommandList.SetGraphicsRootConstantBufferView(1, 0x300000);
+
+		ioCommandList.DrawIndexedInstanced(300, 1, 0, 0, 0);
+	}
+}
+
+UNIT_TEST(StateCacheCommandListFrame)
+{
+	std::mt19937 random(3);
+	std::vector<TestDraw> draws(2000);
+	for (TestDraw& draw : draws)
+		draw = { static_cast<uint32>(random() % 8), static_cast<uint32>(random() % 4), static_cast<uint32>(random() % 2) };
+
+	for (bool sorted : { true, false })
+	{
+		if (sorted)
+		{
+			std::sort(draws.begin(), draws.end(), [](const TestDraw& inLeft, const TestDraw& inRight)
+			{
+				if (inLeft.m_Shader != inRight.m_Shader)
+					return inLeft.m_Shader < inRight.m_Shader;
+				if (inLeft.m_MeshPage != inRight.m_MeshPage)
+					return inLeft.m_MeshPage < inRight.m_MeshPage;
+				return inLeft.m_Texture < inRight.m_Texture;
+			});
+		}
+
+		// Without the cache for reference
+		RecordingCommandList reference_command_list;
+		RecordFrame(reference_command_list, draws);
+		const RecordingStatistics reference = reference_command_list.GetStatistics();
+		CHECK(reference.m_NumErrors == 0);
+		CHECK(reference.m_NumRedundantCommands > 0);
+
+		RecordingCommandList recording_command_list;
+		StateCacheCommandList command_list(recording_command_list);
+		RecordFrame(command_list, draws);
+		const RecordingStatistics& recorded			= recording_command_list.GetStatistics();
+		const StateCacheStatistics& state_cache		= command_list.GetStatistics();
+
+		// No redundant command reaches the stream, and every one of them was elided
+		CHECK(recorded.m_NumErrors == 0);
+		CHECK(recorded.m_NumRedundantCommands == 0);
+		CHECK(state_cache.m_NumElided == reference.m_NumRedundantCommands);
+		CHECK(recorded.m_NumCommands == reference.m_NumCommands - state_cache.m_NumElided);
+		CHECK(recording_command_list.GetStream().size() < reference_command_list.GetStream().size());
+
+		// Same draws with the same state
+		CHECK(recorded.m_NumDraws == reference.m_NumDraws);
+		CHECK(recorded.m_NumVertices == reference.m_NumVertices);
+		CHECK(recorded.m_NumPipelineStateSwitches == reference.m_NumPipelineStateSwitches);
+		CHECK(recorded.m_NumRootSignatureSwitches == reference.m_NumRootSignatureSwitches);
+		CHECK(recorded.m_NumDescriptorAllocations == reference.m_NumDescriptorAllocations);
+	}
+}
@@ -0,0 +1,281 @@
+#include "Engine.h"
+#include "UnitTest.h"
+
+#include "Utils/String.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <vector>
+
+// String::ParseFloat and ParseInt against the C library. strtof is correctly rounded, so any difference is a bug of ours.
+// Text is copied to a buffer of its exact size, reading past inEnd shows up in address sanitizer builds
+
+static inline uint32 GetBits(float inValue)
+{
+	uint32 bits;
+	::memcpy(&bits, &inValue, sizeof(bits));
+	return bits;
+}
+
+static inline float FromBits(uint32 inBits)
+{
+	float value;
+	::memcpy(&value, &inBits, sizeof(value));
+	return value;
+}
+
+// Number of characters parsed, 0 when nothing was
+static size_t ParseFloat(const std::string& inText, float& outValue)
+{
+	const std::vector<char> buffer(inText.begin(), inText.end());
+	const char* begin = buffer.data();
+	return String::ParseFloat(begin, begin + buffer.size(), outValue) - begin;
+}
+
+static size_t ParseInt(const std::string& inText, int32& outValue)
+{
+	const std::vector<char> buffer(inText.begin(), inText.end());
+	const char* begin = buffer.data();
+	return String::ParseInt(begin, begin + buffer.size(), outValue) - begin;
+}
+
+// The whole text is a float and gives the same bits as strtof
+static bool MatchesStrtof(const std::string& inText)
+{
+	float value = 0.0f;
+	if (ParseFloat(inText, value) != inText.size())
+		return false;
+
+	return GetBits(value) == GetBits(::strtof(inText.c_str(), nullptr));
+}
+
+static bool ParsesTo(const std::string& inText, float inExpected)
+{
+	float value = 0.0f;
+	return ParseFloat(inText, value) == inText.size() && GetBits(value) == GetBits(inExpected);
+}
+
+static std::string Format(const char* inFormat, double inValue)
+{
+	char buffer[256];
+	snprintf(buffer, sizeof(buffer), inFormat, inValue);
+	return buffer;
+}
+
+UNIT_TEST(StringParseFloatRoundTrip)
+{
+	// %.9g is enough digits to get any float back. Every exponent, a spread of mantissas, both signs
+	bool all_round_trip		= true;
+	bool all_match_strtof	= true;
+	for (uint64 bits = 0; bits < 0x7F800000; bits += 4099)
+	{
+		for (uint32 sign : { 0u, 0x80000000u })
+		{
+			const float value = FromBits(static_cast<uint32>(bits) | sign);
+
+			float parsed = 0.0f;
+			const std::string text = Format("%.9g", value);
+			all_round_trip &= ParseFloat(text, parsed) == text.size() && GetBits(parsed) == GetBits(value);
+
+			// Fewer digits land anywhere between two floats, more digits go through the truncated path
+			all_match_strtof &= MatchesStrtof(Format("%.6g", value));
+			all_match_strtof &= MatchesStrtof(Format("%.25g", value));
+		}
+	}
+	CHECK(all_round_trip);
+	CHECK(all_match_strtof);
+
+	// The way OBJ exporters write them
+	CHECK(ParsesTo("0.328156", 0.328156f));
+	CHECK(ParsesTo("-0.000000", -0.0f));
+	CHECK(ParsesTo("4.899987", 4.899987f));
+	CHECK(ParsesTo("1e10", 1e10f));
+	CHECK(ParsesTo("1E-10", 1e-10f));
+	CHECK(ParsesTo("5.", 5.0f));
+	CHECK(ParsesTo(".5", 0.5f));
+	CHECK(ParsesTo("1e+3", 1000.0f));
+}
+
+UNIT_TEST(StringParseFloatHalfway)
+{
+	// Integers past 2^24 are halfway between two floats, ties go to the even mantissa
+	CHECK(ParsesTo("16777217", 16777216.0f));
+	CHECK(ParsesTo("16777219", 16777220.0f));
+	CHECK(ParsesTo("16777217.000000000001", 16777218.0f));
+	CHECK(ParsesTo("1.000000059604644775390625", 1.0f));
+	CHECK(ParsesTo("1.000000059604644775390626", 1.00000012f));
+	CHECK(ParsesTo("1.000000178813934326171875", 1.00000024f));
+
+	// Exact midpoints between consecutive floats, and the doubles right below and above them
+	bool all_ties_to_even	= true;
+	bool all_round_nearest	= true;
+	for (uint32 bits = 0; bits < 0x7F7FFFFF; bits += 65537)
+	{
+		const float lower	= FromBits(bits);
+		const float upper	= FromBits(bits + 1);
+		const double middle	= (static_cast<double>(lower) + upper) * 0.5;
+
+		// Printed digit for digit, every midpoint of a float has an exact decimal representation of less than 128 digits
+		float value = 0.0f;
+		ParseFloat(Format("%.160e", middle), value);
+		all_ties_to_even &= GetBits(value) == ((bits & 1) ? bits + 1 : bits);
+
+		ParseFloat(Format("%.160e", std::nextafter(middle, 0.0)), value);
+		all_round_nearest &= GetBits(value) == bits;
+
+		ParseFloat(Format("%.160e", std::nextafter(middle, 1e300)), value);
+		all_round_nearest &= GetBits(value) == bits + 1;
+	}
+	CHECK(all_ties_to_even);
+	CHECK(all_round_nearest);
+}
+
+UNIT_TEST(StringParseFloatSubnormals)
+{
+	const float smallest_subnormal	= std::numeric_limits<float>::denorm_min();
+	const float largest_subnormal	= FromBits(0x007FFFFF);
+	const float smallest_normal		= std::numeric_limits<float>::min();
+
+	CHECK(ParsesTo("1.40129846e-45", smallest_subnormal));
+	CHECK(ParsesTo("1e-45", smallest_subnormal));
+	CHECK(ParsesTo("1.17549421e-38", largest_subnormal));
+	CHECK(ParsesTo("1.17549435e-38", smallest_normal));
+	CHECK(ParsesTo("-1.40129846e-45", -smallest_subnormal));
+
+	// Half of the smallest subnormal rounds to even, that is 0. Anything above rounds up
+	CHECK(ParsesTo("7.00649232162408535461864791644958065640130970938257885878534141944895541342930300743319094181060791015625e-46", 0.0f));
+	CHECK(ParsesTo("7.00649232162408535461864791644958065640130970938257885878534141944895541342930300743319094181060791015626e-46", smallest_subnormal));
+	CHECK(ParsesTo("7.1e-46", smallest_subnormal));
+	CHECK(ParsesTo("7e-46", 0.0f));
+
+	// Underflow to zero, keeping the sign
+	CHECK(ParsesTo("1e-50", 0.0f));
+	CHECK(ParsesTo("-1e-50", -0.0f));
+	CHECK(ParsesTo("1e-400", 0.0f));
+	CHECK(ParsesTo("0e999999999999", 0.0f));
+
+	// Every subnormal, spread over the mantissas
+	bool all_round_trip = true;
+	for (uint32 bits = 1; bits < 0x00800000; bits += 257)
+	{
+		float value = 0.0f;
+		const std::string text = Format("%.9g", FromBits(bits));
+		all_round_trip &= ParseFloat(text, value) == text.size() && GetBits(value) == bits;
+	}
+	CHECK(all_round_trip);
+}
+
+UNIT_TEST(StringParseFloatOverflow)
+{
+	const float max_value	= std::numeric_limits<float>::max();
+	const float infinity	= std::numeric_limits<float>::infinity();
+
+	CHECK(ParsesTo("3.40282347e38", max_value));
+	CHECK(ParsesTo("3.4028235e38", max_value));
+	// Halfway between the largest float and 2^128 rounds to even, that is infinity
+	CHECK(ParsesTo("340282356779733661637539395458142568447", max_value));
+	CHECK(ParsesTo("340282356779733661637539395458142568448", infinity));
+	CHECK(ParsesTo("3.4028236e38", infinity));
+	CHECK(ParsesTo("1e39", infinity));
+	CHECK(ParsesTo("-1e39", -infinity));
+	CHECK(ParsesTo("1e400", infinity));
+	CHECK(ParsesTo("1e99999999999999999999", infinity));
+	CHECK(ParsesTo("0.00000000000000000000000000000000000000001e80", infinity));
+}
+
+UNIT_TEST(StringParseFloatManyDigits)
+{
+	// More than 19 significant digits only keep the first ones, the value must still be correctly rounded
+	const char* texts[] =
+	{
+		"12345678901234567890",
+		"123456789012345678901234567890123456789",
+		"1234567890123456789012345678901234567890123456789012345678901234567890",
+		"0.1000000000000000000000000001",
+		"0.000000000000000000000000000000000012345678901234567890123",
+		"00000000000000000000000000000000000000001.5",
+		"3.14159265358979323846264338327950288419716939937510",
+		"9999999999999999999999999999999999999",
+		"1.00000005960464477539062500000000000000000000000000000001",
+		"1.00000005960464477539062499999999999999999999999999999999",
+		"4.7019774032891500318749461488889827112746622270883500860350068251e-38",
+		"2.2250738585072013e-308",
+	};
+
+	bool all_match_strtof = true;
+	for (const char* text : texts)
+		all_match_strtof &= MatchesStrtof(text);
+	CHECK(all_match_strtof);
+
+	// Leading zeros never count as significant digits
+	CHECK(ParsesTo("0.0000000000000000000000000001", 1e-28f));
+	CHECK(ParsesTo("000000000000000000000000000000000000000000000000123", 123.0f));
+}
+
+UNIT_TEST(StringParseFloatSpecialValues)
+{
+	float value = 0.0f;
+
+	CHECK(ParsesTo("inf", std::numeric_limits<float>::infinity()));
+	CHECK(ParsesTo("-inf", -std::numeric_limits<float>::infinity()));
+	CHECK(ParsesTo("INF", std::numeric_limits<float>::infinity()));
+	CHECK(ParsesTo("Infinity", std::numeric_limits<float>::infinity()));
+	CHECK(ParseFloat("infinit", value) == 3);
+
+	CHECK(ParseFloat("nan", value) == 3 && std::isnan(value) && !std::signbit(value));
+	CHECK(ParseFloat("NaN", value) == 3 && std::isnan(value));
+	CHECK(ParseFloat("-nan", value) == 4 && std::isnan(value) && std::signbit(value));
+
+	// Not numbers: nothing is parsed and the value is left untouched
+	value = 42.0f;
+	for (const char* text : { "", "-", ".", "-.", "e5", "+1", " 1", "in", "na", "x" })
+		CHECK(ParseFloat(text, value) == 0 && value == 42.0f);
+
+	// The number stops where its syntax does
+	CHECK(ParseFloat("1e", value) == 1 && value == 1.0f);
+	CHECK(ParseFloat("2e+", value) == 1 && value == 2.0f);
+	CHECK(ParseFloat("3.5/7", value) == 3 && value == 3.5f);
+	CHECK(ParseFloat("-0.5 1", value) == 4 && value == -0.5f);
+	CHECK(ParseFloat("12345678.5x", value) == 10 && value == 12345678.0f);
+
+	// Never reads past inEnd, even in the middle of a number
+	const char text[] = "1.25e3";
+	CHECK(String::ParseFloat(text, text + 3, value) == text + 3 && value == 1.2f);
+	CHECK(String::ParseFloat(text, text + 5, value) == text + 4 && value == 1.25f);
+}
+
+UNIT_TEST(StringParseInt)
+{
+	int32 value = 0;
+
+	CHECK(ParseInt("0", value) == 1 && value == 0);
+	CHECK(ParseInt("-0", value) == 2 && value == 0);
+	CHECK(ParseInt("2147483647", value) == 10 && value == std::numeric_limits<int32>::max());
+	CHECK(ParseInt("-2147483648", value) == 11 && value == std::numeric_limits<int32>::min());
+	CHECK(ParseInt("0000000000000000000000000000002147483647", value) == 40 && value == std::numeric_limits<int32>::max());
+	CHECK(ParseInt("12/34", value) == 2 && value == 12);
+	CHECK(ParseInt("123456789 ", value) == 9 && value == 123456789);
+
+	// Out of range or not a number: nothing is parsed and the value is left untouched
+	value = 42;
+	for (const char* text : { "2147483648", "-2147483649", "4294967296", "99999999999999999999", "18446744073709551617", "", "-", "+1", " 1", "a" })
+		CHECK(ParseInt(text, value) == 0 && value == 42);
+
+	// Any int32 goes back and forth through its decimal representation
+	bool all_round_trip = true;
+	for (int64 i = std::numeric_limits<int32>::min(); i <= std::numeric_limits<int32>::max(); i += 65521)
+	{
+		const std::string text = std::to_string(i);
+		all_round_trip &= ParseInt(text, value) == text.size() && value == i;
+	}
+	for (int32 i = -100000; i <= 100000; i++)
+	{
+		const std::string text = std::to_string(i);
+		all_round_trip &= ParseInt(text, value) == text.size() && value == i;
+	}
+	CHECK(all_round_trip);
+}
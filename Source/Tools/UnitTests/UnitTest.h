@@ -0,0 +1,33 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+// Tests register themselves with UNIT_TEST and are run by Main.cpp, all of them or the ones matching the command line.
+// A failed CHECK fails the test and the test goes on, so one run reports every broken expectation
+
+using UnitTestFunction = void (*)();
+
+struct UnitTestInfo
+{
+	const char*			m_Name;
+	UnitTestFunction	m_Function;
+};
+
+std::vector<UnitTestInfo>&	GetUnitTests();
+void						ReportCheckFailure(const char* inFileName, int inLineNumber, const char* inExpression);
+
+struct UnitTestRegistrar
+{
+	UnitTestRegistrar(const char* inName, UnitTestFunction inFunction)	{ GetUnitTests().push_back({ inName, inFunction }); }
+};
+
+#define UNIT_TEST(inName)																\
+	static void inName();																\
+	static const UnitTestRegistrar s_##inName##Registrar(#inName, &inName);			\
+	static void inName()
+
+#define CHECK(expression) do { if (!(expression)) ReportCheckFailure(__FILE__, __LINE__, #expression); } while (0)
+
+// Where tests write their files. Created by Main.cpp and deleted once every test ran
+const std::string&			GetTestDirectory();
@@ -0,0 +1,158 @@
+#include "Engine.h"
+#include "UnitTest.h"
+
+#include "Gfx/VertexCompression.h"
+
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <vector>
+
+// VertexCompression encodes blocks of 4 vertices with SSE2 and the rest one at a time. Encoding vertices one by one only
+// takes the scalar path, so both can be compared on the same input
+
+// Random vertices in a box of inExtents around inCenter, then the values where rounding or special cases could differ
+static std::vector<VertexPosUVNormal> MakeTestVertices(const Vec3& inCenter, const Vec3& inExtents, uint32 inSeed)
+{
+	std::mt19937 random(inSeed);
+	std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+	std::uniform_real_distribution<float> uv(0.0f, 1.0f);
+
+	std::vector<VertexPosUVNormal> vertices;
+	for (uint32 i = 0; i < 10000; i++)
+	{
+		VertexPosUVNormal vertex;
+		vertex.Position	= inCenter + Vec3(unit(random) * inExtents.x, unit(random) * inExtents.y, unit(random) * inExtents.z);
+		vertex.UV		= Vec2(uv(random), uv(random));
+		vertex.Normal	= Vec3(unit(random), unit(random), unit(random)).Normalized();
+		vertices.push_back(vertex);
+	}
+
+	const float uvs[] =
+	{
+		0.0f, -0.0f, 1.0f, -1.0f, 0.5f, 65504.0f, 65520.0f, 1e10f, -1e10f, 6.1e-5f, 6e-8f, 1e-10f, 1.0f + 1.0f / 2048.0f,
+		std::numeric_limits<float>::infinity(), -std::numeric_limits<float>::infinity(), std::numeric_limits<float>::quiet_NaN(),
+	};
+	const Vec3 normals[] =
+	{
+		Vec3(0.0f, 0.0f, 0.0f),		Vec3(1.0f, 0.0f, 0.0f),		Vec3(-1.0f, 0.0f, 0.0f),	Vec3(0.0f, 1.0f, 0.0f),
+		Vec3(0.0f, -1.0f, 0.0f),	Vec3(0.0f, 0.0f, 1.0f),		Vec3(0.0f, 0.0f, -1.0f),	Vec3(-0.0f, -0.0f, -1.0f),
+		Vec3(0.5f, -0.5f, -0.0f),	Vec3(3.0f, 4.0f, -12.0f),	Vec3(1e-30f, 0.0f, -1e-30f),
+	};
+	const float corners[] = { -1.0f, 1.0f, 0.0f };
+
+	for (size_t i = 0; i < std::size(uvs) * std::size(normals); i++)
+	{
+		VertexPosUVNormal vertex;
+		for (int32 k = 0; k < 3; k++)
+			vertex.Position[k] = inCenter[k] + corners[(i + k) % std::size(corners)] * inExtents[k];
+		vertex.UV		= Vec2(uvs[i % std::size(uvs)], uvs[(i / std::size(uvs) + i) % std::size(uvs)]);
+		vertex.Normal	= normals[i / std::size(uvs)];
+		vertices.push_back(vertex);
+	}
+
+	return vertices;
+}
+
+UNIT_TEST(VertexCompressionHalf)
+{
+	// Every half but NaNs survives a round trip through float
+	bool are_halves_exact = true;
+	for (uint32 i = 0; i <= 0xFFFF; i++)
+	{
+		const uint16 half = static_cast<uint16>(i);
+		const bool is_nan = (half & 0x7C00) == 0x7C00 && (half & 0x03FF) != 0;
+		if (!is_nan)
+			are_halves_exact &= VertexCompression::FloatToHalf(VertexCompression::HalfToFloat(half)) == half;
+	}
+	CHECK(are_halves_exact);
+
+	// Round to nearest even, overflow to infinity
+	CHECK(VertexCompression::FloatToHalf(1.0f + 1.0f / 2048.0f) == 0x3C00);
+	CHECK(VertexCompression::FloatToHalf(1.0f + 3.0f / 2048.0f) == 0x3C02);
+	CHECK(VertexCompression::FloatToHalf(65520.0f) == 0x7C00);
+	CHECK(VertexCompression::FloatToHalf(-1e10f) == 0xFC00);
+	CHECK(VertexCompression::FloatToHalf(std::numeric_limits<float>::quiet_NaN()) == 0x7E00);
+}
+
+UNIT_TEST(VertexCompressionSIMD)
+{
+	const std::vector<VertexPosUVNormal> vertices = MakeTestVertices(Vec3(10.0f, -3.0f, 0.5f), Vec3(2.0f, 0.25f, 100.0f), 8);
+	const size_t num_vertices = vertices.size();
+
+	std::vector<VertexPosUVNormalPacked> packed_block(num_vertices), packed_single(num_vertices);
+	VertexCompression::Encode(vertices.data(), num_vertices, packed_block.data());
+	for (size_t i = 0; i < num_vertices; i++)
+		VertexCompression::Encode(&vertices[i], 1, &packed_single[i]);
+	CHECK(memcmp(packed_block.data(), packed_single.data(), num_vertices * sizeof(VertexPosUVNormalPacked)) == 0);
+
+	const VertexCompression::QuantizationBounds bounds = VertexCompression::ComputeQuantizationBounds(vertices.data(), num_vertices);
+
+	std::vector<VertexPosUVNormalQuantized> quantized_block(num_vertices), quantized_single(num_vertices);
+	VertexCompression::Encode(vertices.data(), num_vertices, bounds, quantized_block.data());
+	for (size_t i = 0; i < num_vertices; i++)
+		VertexCompression::Encode(&vertices[i], 1, bounds, &quantized_single[i]);
+	CHECK(memcmp(quantized_block.data(), quantized_single.data(), num_vertices * sizeof(VertexPosUVNormalQuantized)) == 0);
+
+	// Flat along Y: the degenerate axis encodes as 0 and decodes exactly
+	std::vector<VertexPosUVNormal> flat_vertices = vertices;
+	for (VertexPosUVNormal& vertex : flat_vertices)
+		vertex.Position.y = 2.0f;
+
+	const VertexCompression::QuantizationBounds flat_bounds = VertexCompression::ComputeQuantizationBounds(flat_vertices.data(), num_vertices);
+	VertexCompression::Encode(flat_vertices.data(), num_vertices, flat_bounds, quantized_block.data());
+	for (size_t i = 0; i < num_vertices; i++)
+		VertexCompression::Encode(&flat_vertices[i], 1, flat_bounds, &quantized_single[i]);
+	CHECK(memcmp(quantized_block.data(), quantized_single.data(), num_vertices * sizeof(VertexPosUVNormalQuantized)) == 0);
+
+	bool is_flat_axis_exact = true;
+	for (const VertexPosUVNormalQuantized& vertex : quantized_block)
+		is_flat_axis_exact &= vertex.Position[1] == 0 && VertexCompression::Decode(vertex, flat_bounds).Position.y == 2.0f;
+	CHECK(is_flat_axis_exact);
+}
+
+UNIT_TEST(VertexCompressionError)
+{
+	// UVs in [0, 1] and unit normals only, what meshes hold
+	const Vec3 center(-50.0f, 7.0f, 1000.0f);
+	const Vec3 extents(0.5f, 20.0f, 3.0f);
+
+	std::vector<VertexPosUVNormal> vertices = MakeTestVertices(center, extents, 12);
+	vertices.resize(10000);
+
+	// Half floats have 11 significant bits: below 1, rounding is off by at most 2^-12
+	constexpr float max_uv_error		= 1.0f / 4096.0f;
+	// Octahedral encoding in 2 x 16 bits is off by up to about 0.0036 degrees
+	constexpr float max_normal_error	= 0.005f;
+
+	std::vector<VertexPosUVNormalPacked> packed(vertices.size());
+	VertexCompression::Encode(vertices.data(), vertices.size(), packed.data());
+	const VertexCompression::EncodingError packed_error = VertexCompression::ComputeError(vertices.data(), packed.data(), vertices.size());
+	CHECK(packed_error.m_MaxPositionError == 0.0f);
+	CHECK(packed_error.m_MaxUVError <= max_uv_error);
+	CHECK(packed_error.m_MaxNormalError <= max_normal_error);
+
+	const VertexCompression::QuantizationBounds bounds = VertexCompression::ComputeQuantizationBounds(vertices.data(), vertices.size());
+
+	std::vector<VertexPosUVNormalQuantized> quantized(vertices.size());
+	VertexCompression::Encode(vertices.data(), vertices.size(), bounds, quantized.data());
+	const VertexCompression::EncodingError quantized_error = VertexCompression::ComputeError(vertices.data(), quantized.data(), vertices.size(), bounds);
+	CHECK(quantized_error.m_MaxUVError <= max_uv_error);
+	CHECK(quantized_error.m_MaxNormalError <= max_normal_error);
+
+	// snorm16 rounds to the nearest of 65535 steps over the box. Some float error on top since the box is far from the origin
+	bool are_positions_within_bounds = true;
+	for (size_t i = 0; i < vertices.size(); i++)
+	{
+		const Vec3 decoded = VertexCompression::Decode(quantized[i], bounds).Position;
+		for (int32 k = 0; k < 3; k++)
+		{
+			const float max_error = bounds.m_Extents[k] * 0.5f / 32767.0f + ::fabsf(center[k]) * 4.0f * std::numeric_limits<float>::epsilon();
+			are_positions_within_bounds &= ::fabsf(decoded[k] - vertices[i].Position[k]) <= max_error;
+		}
+	}
+	CHECK(are_positions_within_bounds);
+	CHECK(quantized_error.m_MaxPositionError <= extents.Length() * 0.5f / 32767.0f + center.Length() * 8.0f * std::numeric_limits<float>::epsilon());
+	CHECK(quantized_error.m_MaxPositionError > 0.0f);
+}